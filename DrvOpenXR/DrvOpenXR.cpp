@@ -229,6 +229,23 @@ IBackend* DrvOpenXR::CreateOpenXRBackend(const char* startupInfo)
 	if (availableExtensions.contains(XR_EXT_HP_MIXED_REALITY_CONTROLLER_EXTENSION_NAME))
 		extensions.push_back(XR_EXT_HP_MIXED_REALITY_CONTROLLER_EXTENSION_NAME);
 
+	// Used to convert our clock to XrTime, for the time since the last vsync
+#ifdef XR_USE_TIMESPEC
+	if (availableExtensions.contains(XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME))
+		extensions.push_back(XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME);
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+	if (availableExtensions.contains(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME))
+		extensions.push_back(XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME);
+#endif
+
+	if (availableExtensions.contains(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME))
+		extensions.push_back(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME);
+
+	// Lets the runtime use the game's depth buffer for reprojection, if the game submits one
+	if (availableExtensions.contains(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME))
+		extensions.push_back(XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME);
+
 	const char* const layers[] = {
 #ifdef XR_VALIDATION_LAYER_PATH
 		"XR_APILAYER_LUNARG_core_validation",
@@ -318,7 +335,9 @@ void DrvOpenXR::SetupSession()
 	// SetupSession is used to restart the session, and as such, we want to prevent other threads from attempting to use the session
 	// while we're rebuilding it (otherwise we get gross nondescript crashes), so we will put a lock on it here.
 	auto lock = xr_session.lock();
-	if (xr_gbl) {
+	auto start = std::chrono::steady_clock::now();
+	bool restarting = xr_gbl != nullptr;
+	if (restarting) {
 		ShutdownSession();
 	}
 
@@ -341,6 +360,9 @@ void DrvOpenXR::SetupSession()
 		input->BindInputsForSession();
 
 	currentBackend->OnSessionCreated();
+
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	OOVR_LOGF("Session %s took %.1fms", restarting ? "restart" : "setup", elapsedMs);
 }
 
 void DrvOpenXR::ShutdownSession()
@@ -360,19 +382,11 @@ void DrvOpenXR::ShutdownSession()
 
 	if (currentBackend->sessionActive) {
 		// Hey it turns out that xrDestroySession can be called whenever - how convenient
+		// PumpEvents ends the session as soon as the stopping state arrives, and the session can then be
+		// destroyed once it reaches the exiting state. If the runtime never gets there, destroy it anyway.
 		OOVR_FAILED_XR_ABORT(xrRequestExitSession(xr_session.get()));
-		int count = 0;
-		while (currentBackend->GetSessionState() != XR_SESSION_STATE_EXITING && count++ < 10) {
-			const int durationMs = 250;
-			OOVR_LOGF("Session Exit state has not been reached yet, waiting %dms ...", durationMs);
-#ifdef _WIN32
-			Sleep(durationMs);
-#else
-			struct timespec ts = { 0, durationMs * 1000000 };
-			nanosleep(&ts, &ts);
-#endif
-			currentBackend->PumpEvents();
-		}
+		auto hasExited = [](XrSessionState state) { return state == XR_SESSION_STATE_EXITING; };
+		currentBackend->WaitForSessionState(hasExited, std::chrono::milliseconds(2500), "session exit");
 	}
 
 	OOVR_FAILED_XR_ABORT(xrDestroySession(xr_session.get()));
@@ -22,7 +22,11 @@
 #include "../OpenOVR/Misc/android_api.h"
 #endif
 
+#include "../OpenOVR/Misc/Config.h"
+
 // FIXME find a better way to send the OnPostFrame call?
+#include "../OpenOVR/Reimpl/BaseApplications.h"
+#include "../OpenOVR/Reimpl/BaseCompositor.h"
 #include "../OpenOVR/Reimpl/BaseInput.h"
 #include "../OpenOVR/Reimpl/BaseOverlay.h"
 #include "../OpenOVR/Reimpl/BaseSystem.h"
@@ -44,7 +48,10 @@
 #include <algorithm>
 #include <chrono>
 #include <cinttypes>
+#include <cmath>
+#include <cstring>
 #include <mutex>
+#include <vector>
 
 using namespace vr;
 
@@ -53,6 +60,7 @@ std::unique_ptr<TemporaryGraphics> XrBackend::temporaryGraphics = nullptr;
 XrBackend::XrBackend(bool useVulkanTmpGfx, bool useD3D11TmpGfx)
 {
 	memset(projectionViews, 0, sizeof(projectionViews));
+	memset(depthInfos, 0, sizeof(depthInfos));
 
 	// setup temporaryGraphics
 
@@ -70,13 +78,10 @@ XrBackend::XrBackend(bool useVulkanTmpGfx, bool useD3D11TmpGfx)
 
 	OOVR_FALSE_ABORT(temporaryGraphics);
 
-	// setup the device indexes
-	for (vr::TrackedDeviceIndex_t i = 0; i < vr::k_unMaxTrackedDeviceCount; i++) {
-		std::shared_ptr<ITrackedDevice> dev = GetDevice(i);
-
-		if (dev)
-			dev->InitialiseDevice(i);
-	}
+	// The HMD is the only device present at startup, the rest are added with the interaction profile
+	std::lock_guard lock(deviceTableWriteMutex);
+	hmd->InitialiseDevice(vr::k_unTrackedDeviceIndex_Hmd);
+	PublishDeviceTable();
 }
 
 XrBackend::~XrBackend()
@@ -92,6 +97,10 @@ XrBackend::~XrBackend()
 	// This must happen after session destruction (which occurs in FullShutdown), as runtimes (namely Monado)
 	// may try to access these resources while destroying the session.
 	temporaryGraphics.reset();
+
+	// No readers can be left at this point, so the tables can be freed regardless of the epoch
+	retiredDeviceTables.clear();
+	delete deviceTable.exchange(nullptr);
 }
 
 XrSessionState XrBackend::GetSessionState()
@@ -104,40 +113,82 @@ std::shared_ptr<IHMD> XrBackend::GetPrimaryHMD()
 	return hmd;
 }
 
-std::shared_ptr<ITrackedDevice> XrBackend::GetDevice(
+ITrackedDevice* XrBackend::GetDevice(
     vr::TrackedDeviceIndex_t index)
 {
-	switch (index) {
-	case vr::k_unTrackedDeviceIndex_Hmd:
-		return GetPrimaryHMD();
-	case 1:
-		return hand_left;
-	case 2:
-		return hand_right;
-	default:
-		std::shared_lock lock(generic_trackers_mutex);
-		vr::TrackedDeviceIndex_t corrected_index = index - RESERVED_DEVICE_INDICES;
-		if (corrected_index >= generic_trackers.size())
-			return nullptr;
+	if (index >= vr::k_unMaxTrackedDeviceCount)
+		return nullptr;
 
-		return generic_trackers.at(corrected_index);
-	}
+	// Pairs with the release store in PublishDeviceTable
+	const DeviceTable* table = deviceTable.load(std::memory_order_acquire);
+	return table ? table->devices[index] : nullptr;
 }
 
-std::shared_ptr<ITrackedDevice> XrBackend::GetDeviceByHand(
+ITrackedDevice* XrBackend::GetDeviceByHand(
     ITrackedDevice::TrackedDeviceType hand)
 {
 	switch (hand) {
 	case ITrackedDevice::HAND_LEFT:
-		return hand_left;
+		return GetDevice(1);
 	case ITrackedDevice::HAND_RIGHT:
-		return hand_right;
+		return GetDevice(2);
 	default:
 		OOVR_SOFT_ABORTF("Cannot get hand by type '%d'", (int)hand);
 		return nullptr;
 	}
 }
 
+void XrBackend::PublishDeviceTable()
+{
+	auto table = std::make_unique<DeviceTable>();
+
+	auto add = [&table](vr::TrackedDeviceIndex_t index, std::shared_ptr<ITrackedDevice> dev) {
+		if (!dev)
+			return;
+		table->devices.at(index) = dev.get();
+		table->owners.push_back(std::move(dev));
+	};
+
+	add(vr::k_unTrackedDeviceIndex_Hmd, hmd);
+	add(1, hand_left);
+	add(2, hand_right);
+	for (const std::shared_ptr<XrGenericTracker>& tracker : generic_trackers) {
+		if (tracker)
+			add(tracker->DeviceIndex(), tracker);
+	}
+
+	const DeviceTable* old = deviceTable.exchange(table.release(), std::memory_order_acq_rel);
+	if (old) {
+		retiredDeviceTables.push_back(RetiredDeviceTable{
+		    .table = std::unique_ptr<const DeviceTable>(old),
+		    .retiredAtEpoch = deviceTableEpoch.load(std::memory_order_relaxed),
+		});
+	}
+}
+
+void XrBackend::AdvanceDeviceTableEpoch()
+{
+	uint64_t epoch = deviceTableEpoch.fetch_add(1, std::memory_order_relaxed) + 1;
+
+	std::lock_guard lock(deviceTableWriteMutex);
+	lastDeviceTableEpochAdvance = std::chrono::steady_clock::now();
+
+	// A table retired during epoch N may still be in use by a reader that looked it up during that
+	// same frame. Once the following frame boundary has also passed, every such reader is done with it.
+	std::erase_if(retiredDeviceTables, [epoch](const RetiredDeviceTable& retired) {
+		return retired.retiredAtEpoch + 2 <= epoch;
+	});
+
+	// The property tables retire their entries on the same schedule. Devices that have been removed don't need
+	// this, as their tables are freed along with them.
+	if (const DeviceTable* table = deviceTable.load(std::memory_order_acquire)) {
+		for (ITrackedDevice* dev : table->devices) {
+			if (dev)
+				dev->GetPropertyTable().AdvanceEpoch();
+		}
+	}
+}
+
 void XrBackend::GetDeviceToAbsoluteTrackingPose(
     vr::ETrackingUniverseOrigin toOrigin,
     float predictedSecondsToPhotonsFromNow,
@@ -145,7 +196,7 @@ void XrBackend::GetDeviceToAbsoluteTrackingPose(
     uint32_t poseArrayCount)
 {
 	for (uint32_t i = 0; i < poseArrayCount; ++i) {
-		std::shared_ptr<ITrackedDevice> dev = GetDevice(i);
+		ITrackedDevice* dev = GetDevice(i);
 		if (dev) {
 			dev->GetPose(toOrigin, &poseArray[i], ETrackingStateType::TrackingStateType_Rendering);
 		} else {
@@ -391,12 +442,22 @@ void XrBackend::CheckOrInitCompositors(const vr::Texture_t* tex)
 
 void XrBackend::WaitForTrackingData()
 {
+	// WaitGetPoses marks the start of a new frame for the application
+	AdvanceDeviceTableEpoch();
+
+	// Pick up any edits to opencomposite.ini between frames
+	bool configChanged = oovr_global_configuration.ApplyPendingReload();
+
 	// Make sure the OpenXR session is active before doing anything else, and if not then skip
 	if (!sessionActive) {
 		renderingFrame = false;
 		return;
 	}
 
+	// The refresh rate is otherwise only requested when the session is created
+	if (configChanged)
+		SetupDisplayRefreshRate();
+
 	XrFrameWaitInfo waitInfo{ XR_TYPE_FRAME_WAIT_INFO };
 	XrFrameState state{ XR_TYPE_FRAME_STATE };
 
@@ -404,6 +465,8 @@ void XrBackend::WaitForTrackingData()
 		auto lock = xr_session.lock_shared();
 		OOVR_FAILED_XR_ABORT(xrWaitFrame(xr_session.get(), &waitInfo, &state));
 		xr_gbl->nextPredictedFrameTime = state.predictedDisplayTime;
+		xr_gbl->predictedDisplayPeriod = state.predictedDisplayPeriod;
+		xr_gbl->lastFrameWaitTime = std::chrono::steady_clock::now();
 
 		// FIXME loop until this returns true?
 		// OOVR_FALSE_ABORT(state.shouldRender);
@@ -457,15 +520,27 @@ void XrBackend::StoreEyeTexture(
 
 	XrCompositionLayerProjectionView& layer = projectionViews[eye];
 	layer.type = XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW;
+	layer.next = nullptr;
 
 	std::unique_ptr<Compositor>& compPtr = compositors[eye];
 	OOVR_FALSE_ABORT(compPtr.get() != nullptr);
 	Compositor& comp = *compPtr;
 
 	// If the session is inactive, we may be unable to write to the surface
-	if (sessionActive && renderingFrame)
+	if (sessionActive && renderingFrame) {
 		comp.Invoke(texture, bounds, layer.subImage, (XruEye)eye, submitFlags);
 
+		// If the game gave us its depth buffer, pass it on so the runtime can use it for reprojection
+		if ((submitFlags & vr::Submit_TextureWithDepth) && xr_ext->CompositionLayerDepth_Available()) {
+			const vr::VRTextureDepthInfo_t& depth = (submitFlags & vr::Submit_TextureWithPose)
+			    ? ((const vr::VRTextureWithPoseAndDepth_t*)texture)->depth
+			    : ((const vr::VRTextureWithDepth_t*)texture)->depth;
+
+			if (comp.InvokeDepth(depth, bounds, depthInfos[eye]))
+				layer.next = &depthInfos[eye];
+		}
+	}
+
 	submittedEyeTextures = true;
 
 	// TODO store view somewhere and use it for submitting our frame
@@ -554,8 +629,7 @@ void XrBackend::SubmitFrames(bool showSkybox, bool postPresent)
 		sys->_OnPostFrame();
 	}
 
-	auto now = std::chrono::system_clock::now().time_since_epoch();
-	frameSubmitTimeUs = (double)std::chrono::duration_cast<std::chrono::microseconds>(now).count() / 1000000.0;
+	frameSubmitTime = BackendManager::GetTimeInSeconds();
 
 	nFrameIndex++;
 }
@@ -577,6 +651,8 @@ IBackend::openvr_enum_t XrBackend::SetSkyboxOverride(const vr::Texture_t* pTextu
 
 		OOVR_FAILED_XR_ABORT(xrWaitFrame(xr_session.get(), &waitInfo, &state));
 		xr_gbl->nextPredictedFrameTime = state.predictedDisplayTime;
+		xr_gbl->predictedDisplayPeriod = state.predictedDisplayPeriod;
+		xr_gbl->lastFrameWaitTime = std::chrono::steady_clock::now();
 
 		// This submits a frame when a skybox override is set. This is designed around rFactor2 where the skybox is used as
 		// a loading screen and is frequently updated, and most other games probably behave in a similar manner. It'd be
@@ -642,7 +718,7 @@ bool XrBackend::GetFrameTiming(OOVR_Compositor_FrameTiming* pTiming, uint32_t un
 	memset(reinterpret_cast<unsigned char*>(pTiming) + sizeof(pTiming->m_nSize), 0, pTiming->m_nSize - sizeof(pTiming->m_nSize));
 
 	if (pTiming->m_nSize >= sizeof(IVRCompositor_018::Compositor_FrameTiming)) {
-		pTiming->m_flSystemTimeInSeconds = frameSubmitTimeUs;
+		pTiming->m_flSystemTimeInSeconds = frameSubmitTime;
 		pTiming->m_nFrameIndex = nFrameIndex;
 
 		// A lot of these values we can't get the data for so just use sensible values
@@ -664,7 +740,7 @@ bool XrBackend::GetFrameTiming(OOVR_Compositor_FrameTiming* pTiming, uint32_t un
 		pTiming->m_flCompositorIdleCpuMs = 0.1f;
 
 		/** Miscellaneous measured intervals. */
-		pTiming->m_flClientFrameIntervalMs = 11.1f; // time between calls to WaitGetPoses
+		pTiming->m_flClientFrameIntervalMs = xr_gbl ? 1000.0f / xr_gbl->GetDisplayRefreshRate() : 11.1f; // time between calls to WaitGetPoses
 		pTiming->m_flPresentCallCpuMs = 0.0f; // time blocked on call to present (usually 0.0, but can go long)
 		pTiming->m_flWaitForPresentCpuMs = 0.0f; // time spent spin-waiting for frame index to change (not near-zero indicates wait object failure)
 		pTiming->m_flSubmitFrameMs = 0.0f; // time spent in IVRCompositor::Submit (not near-zero indicates driver issue)
@@ -689,14 +765,109 @@ bool XrBackend::GetFrameTiming(OOVR_Compositor_FrameTiming* pTiming, uint32_t un
 /* #if defined(SUPPORT_DX) */
 IBackend::openvr_enum_t XrBackend::GetMirrorTextureD3D11(vr::EVREye eEye, void* pD3D11DeviceOrResource, void** ppD3D11ShaderResourceView)
 {
-	OOVR_SOFT_ABORT("No implementation");
-	return 0;
+#if defined(SUPPORT_DX) && defined(SUPPORT_DX11)
+	if (!ppD3D11ShaderResourceView || !pD3D11DeviceOrResource || eEye < 0 || eEye >= XruEyeCount)
+		return IVRCompositor_018::VRCompositorError_RequestFailed;
+	*ppD3D11ShaderResourceView = nullptr;
+
+	// The compositors (and thus the mirrors) are created when the game submits its first frame
+	auto* compositor = dynamic_cast<DX11Compositor*>(compositors[eEye].get());
+	if (!compositor)
+		return IVRCompositor_018::VRCompositorError_RequestFailed;
+
+	// This is usually the consumer's device, but it may be a resource created on that device
+	ComPtr<ID3D11Device> device;
+	auto* unknown = (IUnknown*)pD3D11DeviceOrResource;
+	if (FAILED(unknown->QueryInterface(IID_PPV_ARGS(&device)))) {
+		ComPtr<ID3D11DeviceChild> resource;
+		if (FAILED(unknown->QueryInterface(IID_PPV_ARGS(&resource))))
+			return IVRCompositor_018::VRCompositorError_RequestFailed;
+		resource->GetDevice(&device);
+	}
+
+	ID3D11ShaderResourceView* view = nullptr;
+	std::shared_ptr<CompositorMirror> mirror;
+	HRESULT hr = compositor->CreateMirrorView(device.Get(), &view, mirror);
+	if (FAILED(hr)) {
+		OOVR_LOGF("Failed to create D3D11 mirror texture view: %08x", (unsigned int)hr);
+		return IVRCompositor_018::VRCompositorError_SharedTexturesNotSupported;
+	}
+
+	std::lock_guard<std::mutex> lock(mirrorsMutex);
+	mirrorViews[view] = std::move(mirror);
+	*ppD3D11ShaderResourceView = view;
+	return IVRCompositor_018::VRCompositorError_None;
+#else
+	OOVR_SOFT_ABORT("Cannot get D3D11 mirror texture - D3D11 support disabled");
+	return IVRCompositor_018::VRCompositorError_RequestFailed;
+#endif
 }
 void XrBackend::ReleaseMirrorTextureD3D11(void* pD3D11ShaderResourceView)
 {
-	OOVR_SOFT_ABORT("No implementation");
+#if defined(SUPPORT_DX) && defined(SUPPORT_DX11)
+	if (!pD3D11ShaderResourceView)
+		return;
+
+	std::shared_ptr<CompositorMirror> mirror;
+	{
+		std::lock_guard<std::mutex> lock(mirrorsMutex);
+		auto iter = mirrorViews.find(pD3D11ShaderResourceView);
+		if (iter == mirrorViews.end()) {
+			OOVR_LOG_ONCE("WARNING: Releasing a D3D11 mirror texture that wasn't created by GetMirrorTextureD3D11");
+			return;
+		}
+		mirror = std::move(iter->second);
+		mirrorViews.erase(iter);
+	}
+
+	((ID3D11ShaderResourceView*)pD3D11ShaderResourceView)->Release();
+	mirror->ReleaseReference();
+#endif
 }
 /* #endif */
+IBackend::openvr_enum_t XrBackend::GetMirrorTextureGL(vr::EVREye eEye, vr::glUInt_t* pglTextureId, vr::glSharedTextureHandle_t* pglSharedTextureHandle)
+{
+#if defined(SUPPORT_GL) || defined(SUPPORT_GLES)
+	if (!pglTextureId || eEye < 0 || eEye >= XruEyeCount)
+		return IVRCompositor_018::VRCompositorError_RequestFailed;
+
+	auto* compositor = dynamic_cast<GLBaseCompositor*>(compositors[eEye].get());
+	if (!compositor)
+		return IVRCompositor_018::VRCompositorError_RequestFailed;
+
+	// We run in the game's process and context, so the texture doesn't actually need sharing. Each call
+	// hands out the same texture, and the shared handle is just its name.
+	std::shared_ptr<CompositorMirror> mirror = compositor->AcquireMirror(pglTextureId);
+	{
+		// If the name was used by a mirror whose compositor has been destroyed, that texture has already been
+		// deleted and this is a new one.
+		std::lock_guard<std::mutex> lock(mirrorsMutex);
+		glMirrors[*pglTextureId] = std::move(mirror);
+	}
+
+	if (pglSharedTextureHandle)
+		*pglSharedTextureHandle = (vr::glSharedTextureHandle_t)(intptr_t)*pglTextureId;
+	return IVRCompositor_018::VRCompositorError_None;
+#else
+	OOVR_SOFT_ABORT("Cannot get GL mirror texture - GL support disabled");
+	return IVRCompositor_018::VRCompositorError_RequestFailed;
+#endif
+}
+bool XrBackend::ReleaseMirrorTextureGL(vr::glUInt_t glTextureId, vr::glSharedTextureHandle_t glSharedTextureHandle)
+{
+#if defined(SUPPORT_GL) || defined(SUPPORT_GLES)
+	std::lock_guard<std::mutex> lock(mirrorsMutex);
+	auto iter = glMirrors.find(glTextureId);
+	if (iter != glMirrors.end()) {
+		if (iter->second->ReleaseReference() == 0)
+			glMirrors.erase(iter);
+		return true;
+	}
+#endif
+
+	OOVR_LOG_ONCE("WARNING: Releasing a GL mirror texture that wasn't created by GetMirrorTextureGL");
+	return false;
+}
 /** Returns the points of the Play Area. */
 bool XrBackend::GetPlayAreaPoints(vr::HmdVector3_t* points, int* count)
 {
@@ -743,6 +914,24 @@ bool XrBackend::IsInputAvailable()
 	return sessionState == XR_SESSION_STATE_FOCUSED;
 }
 
+// What IVRApplications reports about the game, as seen by overlays and launchers
+static OOVR_EVRSceneApplicationState SceneStateFromSessionState(XrSessionState state)
+{
+	switch (state) {
+	case XR_SESSION_STATE_READY:
+		return EVRSceneApplicationState_Starting;
+	case XR_SESSION_STATE_VISIBLE:
+	case XR_SESSION_STATE_FOCUSED:
+		return EVRSceneApplicationState_Running;
+	case XR_SESSION_STATE_EXITING:
+	case XR_SESSION_STATE_LOSS_PENDING:
+		return EVRSceneApplicationState_Quitting;
+	default:
+		// Idle, synchronised or stopping: the game is still running, but nothing it draws is being shown
+		return EVRSceneApplicationState_Waiting;
+	}
+}
+
 void XrBackend::PumpEvents()
 {
 	// Poll for OpenXR events
@@ -767,6 +956,7 @@ void XrBackend::PumpEvents()
 				xr_gbl->latestTime = changed->time;
 
 			OOVR_LOGF("Switch to OpenXR state %d", sessionState);
+			BaseApplications::_SetSceneApplicationState(SceneStateFromSessionState(sessionState));
 
 			switch (sessionState) {
 			case XR_SESSION_STATE_READY: {
@@ -807,10 +997,34 @@ void XrBackend::PumpEvents()
 			}
 		} else if (ev.type == XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED) {
 			UpdateInteractionProfile();
+		} else if (ev.type == XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB) {
+			auto* changed = (XrEventDataDisplayRefreshRateChangedFB*)&ev;
+			OnDisplayRefreshRateChanged(changed->toDisplayRefreshRate);
 		}
 
 	} // while loop
 
+	// Check if any generic trackers have been connected or disconnected. This isn't done while the session
+	// is being shut down, as the session is no longer usable.
+	auto now = std::chrono::steady_clock::now();
+	bool epochStalled;
+	{
+		std::lock_guard lock(deviceTableWriteMutex);
+		if (xr_gbl && now >= nextGenericTrackerPoll) {
+			nextGenericTrackerPoll = now + std::chrono::seconds(2);
+			if (UpdateGenericTrackers())
+				PublishDeviceTable();
+		}
+
+		epochStalled = now - lastDeviceTableEpochAdvance >= std::chrono::seconds(1);
+	}
+
+	// Only WaitGetPoses marks frame boundaries, and overlay applications never call it, so nothing would free the
+	// tables retired by the poll above. Advance the epoch here if it hasn't moved for a while: a second is far
+	// longer than any call can hold on to a device it looked up.
+	if (epochStalled)
+		AdvanceDeviceTableEpoch();
+
 	/*
 	   We check for AreActionsLoaded here because:
 	   1. Games using legacy input call xrSyncActions every frame anyway, so the runtime should
@@ -830,7 +1044,8 @@ void XrBackend::PumpEvents()
 	   the temporary session.
    */
 	BaseInput* input = GetUnsafeBaseInput();
-	if (input && !input->AreActionsLoaded() && sessionState == XR_SESSION_STATE_FOCUSED && !hand_left && !hand_right) {
+	// hand_left and hand_right are only safe to read while holding deviceTableWriteMutex, so check the table instead
+	if (input && !input->AreActionsLoaded() && sessionState == XR_SESSION_STATE_FOCUSED && !GetDevice(1) && !GetDevice(2)) {
 		QueryForInteractionProfile();
 	}
 }
@@ -841,15 +1056,81 @@ void XrBackend::OnSessionCreated()
 	sessionActive = false;
 	renderingFrame = false;
 
-	PumpEvents();
-
 	// Wait until we transition to the idle state.
 	// This sets the time, so OpenXR calls which use that will work correctly.
-	while (sessionState == XR_SESSION_STATE_UNKNOWN) {
-		const int durationMs = 250;
+	// There's nothing useful we can do without it, so keep waiting if the runtime is slow.
+	auto hasTransitioned = [](XrSessionState state) { return state != XR_SESSION_STATE_UNKNOWN; };
+	while (!WaitForSessionState(hasTransitioned, std::chrono::milliseconds(2500), "initial session transition")) {
+		OOVR_LOG("No session transition yet received, still waiting...");
+	}
+
+	SetupDisplayRefreshRate();
+}
+
+void XrBackend::SetupDisplayRefreshRate()
+{
+	if (!xr_ext->displayRefreshRateExtensionAvailable())
+		return;
+
+	float requested = oovr_global_configuration.RefreshRate();
+	if (requested > 0) {
+		uint32_t rateCount = 0;
+		OOVR_FAILED_XR_ABORT(xr_ext->xrEnumerateDisplayRefreshRatesFB(xr_session.get(), 0, &rateCount, nullptr));
+		std::vector<float> rates(rateCount);
+		OOVR_FAILED_XR_ABORT(xr_ext->xrEnumerateDisplayRefreshRatesFB(xr_session.get(), rates.size(), &rateCount, rates.data()));
+
+		// The runtime will only accept one of its listed rates, so pick the closest
+		float best = 0;
+		for (float rate : rates) {
+			if (best == 0 || std::abs(rate - requested) < std::abs(best - requested))
+				best = rate;
+		}
+
+		if (best > 0) {
+			OOVR_LOGF("Requesting display refresh rate of %.2fHz (%.2fHz configured)", best, requested);
+			OOVR_FAILED_XR_SOFT_ABORT(xr_ext->xrRequestDisplayRefreshRateFB(xr_session.get(), best));
+		}
+	}
+
+	float current = 0;
+	OOVR_FAILED_XR_SOFT_ABORT(xr_ext->xrGetDisplayRefreshRateFB(xr_session.get(), &current));
+	OnDisplayRefreshRateChanged(current);
+}
+
+void XrBackend::OnDisplayRefreshRateChanged(float rate)
+{
+	if (!xr_gbl || rate <= 0 || rate == xr_gbl->displayRefreshRate)
+		return;
+
+	OOVR_LOGF("Display refresh rate is now %.2fHz", rate);
+	xr_gbl->displayRefreshRate = rate;
+
+	BaseSystem* system = GetUnsafeBaseSystem();
+	if (system) {
+		VREvent_t event = {
+			.eventType = VREvent_PropertyChanged,
+			.trackedDeviceIndex = vr::k_unTrackedDeviceIndex_Hmd,
+		};
+		event.data.property.prop = vr::Prop_DisplayFrequency_Float;
+		system->_EnqueueEvent(event);
+	}
+}
 
-		OOVR_LOGF("No session transition yet received, waiting %dms ...", durationMs);
+bool XrBackend::WaitForSessionState(const std::function<bool(XrSessionState)>& condition, std::chrono::milliseconds timeout, const char* reason)
+{
+	auto start = std::chrono::steady_clock::now();
+	auto elapsedMs = [start]() {
+		return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	};
 
+	PumpEvents();
+	while (!condition(sessionState)) {
+		if (std::chrono::steady_clock::now() - start >= timeout) {
+			OOVR_LOGF("Timed out after %.1fms waiting for %s (current state %d)", elapsedMs(), reason, sessionState);
+			return false;
+		}
+
+		const int durationMs = 2;
 #ifdef _WIN32
 		Sleep(durationMs);
 #else
@@ -859,6 +1140,9 @@ void XrBackend::OnSessionCreated()
 
 		PumpEvents();
 	}
+
+	OOVR_LOGF("Waited %.1fms for %s", elapsedMs(), reason);
+	return true;
 }
 
 void XrBackend::PrepareForSessionShutdown()
@@ -868,6 +1152,27 @@ void XrBackend::PrepareForSessionShutdown()
 	}
 	skybox_compositor.reset();
 	overlay_compositors.clear();
+
+	// The tracker spaces belong to the session, so they'll be re-created in the next one
+	{
+		std::lock_guard lock(deviceTableWriteMutex);
+		for (const std::shared_ptr<XrGenericTracker>& tracker : generic_trackers) {
+			if (tracker) {
+				tracker->SetSpace(XR_NULL_HANDLE);
+				genericTrackerSpacesLost = true;
+			}
+		}
+
+		// Disconnected trackers can outlive the session in a retired device table, and would otherwise destroy
+		// their space once that table is freed - by which point the session (and so the space) is long gone.
+		for (const RetiredDeviceTable& retired : retiredDeviceTables) {
+			for (const std::shared_ptr<ITrackedDevice>& dev : retired.table->owners) {
+				if (auto* tracker = dynamic_cast<XrGenericTracker*>(dev.get()))
+					tracker->SetSpace(XR_NULL_HANDLE);
+			}
+		}
+	}
+
 	if (infoSet != XR_NULL_HANDLE) {
 		OOVR_FAILED_XR_ABORT(xrDestroyActionSet(infoSet));
 		infoSet = XR_NULL_HANDLE;
@@ -908,6 +1213,8 @@ void XrBackend::UnregisterOverlayCompositor(std::shared_ptr<Compositor> composit
 
 void XrBackend::UpdateInteractionProfile()
 {
+	std::lock_guard lock(deviceTableWriteMutex);
+
 	struct hand_info {
 		const char* pathstr;
 		std::shared_ptr<XrController>& controller;
@@ -973,105 +1280,111 @@ void XrBackend::UpdateInteractionProfile()
 		}
 	}
 
-	CreateGenericTrackers();
+	UpdateGenericTrackers();
+	PublishDeviceTable();
 }
 
-void XrBackend::CreateGenericTrackers()
+static std::vector<std::string> GetForcedTrackerSerials()
 {
-	if (!xr_ext->xrMndxXdevSpace_Available())
-		return;
-
-	std::unique_lock lock(generic_trackers_mutex);
+	std::vector<std::string> forced_tracker_serials{};
+	auto forced_tracker_serials_str = GetEnv("OPENCOMPOSITE_TRACKER_SERIALS");
+	if (!forced_tracker_serials_str.empty()) {
+		size_t separator_pos{ std::string::npos };
+		while ((separator_pos = forced_tracker_serials_str.find(';')) != std::string::npos) {
+			auto serial = forced_tracker_serials_str.substr(0, separator_pos);
+			forced_tracker_serials.push_back(serial);
+			forced_tracker_serials_str.erase(0, separator_pos + 1);
+		}
+		if (!forced_tracker_serials_str.empty()) {
+			forced_tracker_serials.push_back(forced_tracker_serials_str);
+		}
+	}
+	return forced_tracker_serials;
+}
 
-	OOVR_LOGF("Checking for generic trackers...");
+bool XrBackend::UpdateGenericTrackers()
+{
+	// This is reached from both the periodic poll and interaction profile changes. Neither may touch the session
+	// while it's being shut down (or before it exists), since creating tracker spaces on it would also clear
+	// genericTrackerSpacesLost for the session that replaces it.
+	if (!xr_gbl)
+		return false;
 
-	// should get cleared every time this function is run to avoid stale trackers
-	generic_trackers.clear();
+	if (!xr_ext->xrMndxXdevSpace_Available())
+		return false;
 
 	// list containing all generic tracked devices
 	XrXDevListMNDX generic_tracker_list;
-	std::vector<XrXDevIdMNDX> generic_tracker_ids(MAX_GENERIC_TRACKERS);
-	InteractionProfile* profile = InteractionProfile::GetProfileByPath("/interaction_profiles/htc/vive_tracker_htcx");
-
-	uint32_t xdev_count = 0;
-
 	XrCreateXDevListInfoMNDX create_info = {
 		.type = XR_TYPE_CREATE_XDEV_LIST_INFO_MNDX
 	};
-
-	XrXDevPropertiesMNDX cur_properties = {
-		.type = XR_TYPE_XDEV_PROPERTIES_MNDX,
-	};
-
-	XrGetXDevInfoMNDX cur_info = {
-		.type = XR_TYPE_GET_XDEV_INFO_MNDX,
-	};
-
 	OOVR_FAILED_XR_ABORT(xr_ext->xrCreateXDevListMNDX(xr_session.get(), &create_info, &generic_tracker_list));
-	OOVR_FAILED_XR_ABORT(xr_ext->xrEnumerateXDevsMNDX(generic_tracker_list, MAX_GENERIC_TRACKERS, &xdev_count, generic_tracker_ids.data()));
 
-	std::vector<std::string> forced_tracker_serials{};
-	{
-		auto forced_tracker_serials_str = GetEnv("OPENCOMPOSITE_TRACKER_SERIALS");
-		if (!forced_tracker_serials_str.empty()) {
-			size_t separator_pos{ std::string::npos };
-			while ((separator_pos = forced_tracker_serials_str.find(';')) != std::string::npos) {
-				auto serial = forced_tracker_serials_str.substr(0, separator_pos);
-				forced_tracker_serials.push_back(serial);
-				forced_tracker_serials_str.erase(0, separator_pos + 1);
-			}
-			if (!forced_tracker_serials_str.empty()) {
-				forced_tracker_serials.push_back(forced_tracker_serials_str);
-			}
-		}
+	// The generation number changes whenever devices are added or removed, so if it's the same as last time
+	// then there's nothing to do - unless the session was restarted, and the trackers need new spaces.
+	uint64_t generation;
+	OOVR_FAILED_XR_ABORT(xr_ext->xrGetXDevListGenerationNumberMNDX(generic_tracker_list, &generation));
+	if (xdevListGeneration == generation && !genericTrackerSpacesLost) {
+		xr_ext->xrDestroyXDevListMNDX(generic_tracker_list);
+		return false;
 	}
+	xdevListGeneration = generation;
+	genericTrackerSpacesLost = false;
 
-	// filter out non-tracker devices
-	std::erase_if(generic_tracker_ids, [&](XrXDevIdMNDX id) {
-		if (xdev_count == 0) {
-			return true;
-		}
-		cur_info.id = id;
+	OOVR_LOGF("Checking for generic trackers...");
 
-		OOVR_FAILED_XR_ABORT(xr_ext->xrGetXDevPropertiesMNDX(generic_tracker_list, &cur_info, &cur_properties));
+	uint32_t xdev_count = 0;
+	std::vector<XrXDevIdMNDX> xdev_ids(MAX_GENERIC_TRACKERS);
+	OOVR_FAILED_XR_ABORT(xr_ext->xrEnumerateXDevsMNDX(generic_tracker_list, MAX_GENERIC_TRACKERS, &xdev_count, xdev_ids.data()));
+	xdev_ids.resize(xdev_count);
 
-		xdev_count--;
+	static const std::vector<std::string> forced_tracker_serials = GetForcedTrackerSerials();
+
+	// filter out non-tracker devices, fetching the properties of each device only once
+	struct FoundTracker {
+		XrXDevIdMNDX id;
+		XrXDevPropertiesMNDX properties;
+	};
+	std::vector<FoundTracker> found;
+	for (XrXDevIdMNDX id : xdev_ids) {
+		XrGetXDevInfoMNDX cur_info = {
+			.type = XR_TYPE_GET_XDEV_INFO_MNDX,
+			.id = id,
+		};
+		XrXDevPropertiesMNDX cur_properties = {
+			.type = XR_TYPE_XDEV_PROPERTIES_MNDX,
+		};
+		OOVR_FAILED_XR_ABORT(xr_ext->xrGetXDevPropertiesMNDX(generic_tracker_list, &cur_info, &cur_properties));
 
 		std::string name = cur_properties.name;
 		std::string serial = cur_properties.serial;
 
 		if (!cur_properties.canCreateSpace)
-			return true;
+			continue;
 
 		OOVR_LOGF("Found usable xdev '%s', serial '%s'", name.c_str(), serial.c_str());
 
-		if (forced_tracker_serials.size() > 0 && std::find(forced_tracker_serials.cbegin(), forced_tracker_serials.cend(), serial) != forced_tracker_serials.cend()) {
-			return false;
-		}
-		return name.find("Tracker") == std::string::npos;
-	});
-
-	OOVR_LOGF("Found %zu generic trackers", generic_tracker_ids.size());
-
-	OOVR_LOG("Creating generic trackers...");
-	for (const XrXDevIdMNDX id : generic_tracker_ids) {
-		int index = generic_trackers.size();
-
-		if (index >= MAX_GENERIC_TRACKERS) {
-			OOVR_LOGF("More trackers present than allowed (%d), skipping..", MAX_GENERIC_TRACKERS);
-			break;
-		}
-
-		cur_info.id = id;
+		bool forced = std::find(forced_tracker_serials.cbegin(), forced_tracker_serials.cend(), serial) != forced_tracker_serials.cend();
+		if (!forced && name.find("Tracker") == std::string::npos)
+			continue;
 
-		OOVR_FAILED_XR_ABORT(xr_ext->xrGetXDevPropertiesMNDX(generic_tracker_list, &cur_info, &cur_properties));
+		found.push_back(FoundTracker{ id, cur_properties });
+	}
 
-		std::string serial = cur_properties.serial;
-		std::string name = cur_properties.name;
+	OOVR_LOGF("Found %zu generic trackers", found.size());
 
-		OOVR_LOGF("Generic Tracker: %s, Serial: %s, Index: %d, ID: %" PRIu64, cur_properties.name, cur_properties.serial, index, id);
+	BaseSystem* system = GetUnsafeBaseSystem();
+	auto sendEvent = [system](EVREventType type, const std::shared_ptr<XrGenericTracker>& tracker) {
+		if (!system)
+			return;
+		VREvent_t event = {
+			.eventType = type,
+			.trackedDeviceIndex = (TrackedDeviceIndex_t)tracker->DeviceIndex()
+		};
+		system->_EnqueueEvent(event);
+	};
 
-		// create space
+	auto createSpace = [&](XrXDevIdMNDX id) {
 		XrSpace space;
 		XrPosef pose = { .orientation = { 0, 0, 0, 1 }, .position = { 0, 0, 0 } };
 		XrCreateXDevSpaceInfoMNDX create_space_info = {
@@ -1081,23 +1394,56 @@ void XrBackend::CreateGenericTrackers()
 			.id = id,
 			.offset = pose,
 		};
-
 		OOVR_FAILED_XR_ABORT(xr_ext->xrCreateXDevSpaceMNDX(xr_session.get(), &create_space_info, &space));
+		return space;
+	};
 
-		generic_trackers.push_back(std::make_unique<XrGenericTracker>(*profile, cur_properties, index, space));
+	bool changed = false;
 
-		BaseSystem* system = GetUnsafeBaseSystem();
-		if (system) {
-			VREvent_t event = {
-				.eventType = VREvent_TrackedDeviceActivated,
-				.trackedDeviceIndex = (TrackedDeviceIndex_t)generic_trackers.at(index)->DeviceIndex()
-			};
-			system->_EnqueueEvent(event);
+	// Remove the trackers that have gone away, and re-create the spaces of those that haven't if necessary
+	for (std::shared_ptr<XrGenericTracker>& tracker : generic_trackers) {
+		if (!tracker)
+			continue;
+
+		auto iter = std::find_if(found.begin(), found.end(), [&](const FoundTracker& ft) {
+			return strcmp(ft.properties.serial, tracker->GetSerial()) == 0;
+		});
+
+		if (iter == found.end()) {
+			OOVR_LOGF("Generic tracker %s (index %d) disconnected", tracker->GetSerial(), tracker->DeviceIndex());
+			sendEvent(VREvent_TrackedDeviceDeactivated, tracker);
+			tracker.reset();
+			changed = true;
+			continue;
+		}
+
+		if (!tracker->GetSpace())
+			tracker->SetSpace(createSpace(iter->id));
+
+		found.erase(iter);
+	}
+
+	// Anything left over is a new tracker, which goes in the first free slot
+	InteractionProfile* profile = InteractionProfile::GetProfileByPath("/interaction_profiles/htc/vive_tracker_htcx");
+	for (const FoundTracker& ft : found) {
+		auto slot = std::find(generic_trackers.begin(), generic_trackers.end(), nullptr);
+		if (slot == generic_trackers.end()) {
+			OOVR_LOGF("More trackers present than allowed (%d), skipping..", MAX_GENERIC_TRACKERS);
+			break;
 		}
+
+		int index = (int)(slot - generic_trackers.begin());
+		OOVR_LOGF("Generic Tracker: %s, Serial: %s, Index: %d, ID: %" PRIu64, ft.properties.name, ft.properties.serial, index, ft.id);
+
+		*slot = std::make_shared<XrGenericTracker>(*profile, ft.properties, index, createSpace(ft.id));
+		sendEvent(VREvent_TrackedDeviceActivated, *slot);
+		changed = true;
 	}
 
-	// cleanup
+	// cleanup - the spaces remain valid after the list is destroyed
 	xr_ext->xrDestroyXDevListMNDX(generic_tracker_list);
+
+	return changed;
 }
 
 void XrBackend::MaybeRestartForInputs()
@@ -9,9 +9,15 @@
 #include "XrController.h"
 #include "XrHMD.h"
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
-#include <vector>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 class XrGenericTracker;
 
@@ -44,11 +50,25 @@ public:
 
 	void PrepareForSessionShutdown();
 
+	/**
+	 * Pump events until the session state satisfies the given condition, or the timeout expires. Rather than
+	 * sleeping for a fixed period between checks, this polls frequently so it returns as soon as the state changes.
+	 *
+	 * Returns true if the condition was met. The time spent waiting is logged either way.
+	 */
+	bool WaitForSessionState(const std::function<bool(XrSessionState)>& condition, std::chrono::milliseconds timeout, const char* reason);
+
 	const void* GetCurrentGraphicsBinding();
 
 	void RegisterOverlayCompositor(std::shared_ptr<Compositor> compositor);
 	void UnregisterOverlayCompositor(std::shared_ptr<Compositor> compositor);
 
+	/**
+	 * The compositor for the game's left eye, or null if the game hasn't submitted a frame yet. This uses the
+	 * game's graphics API and device, so it's used to draw OpenComposite's own images with WritePixels.
+	 */
+	Compositor* GetSceneCompositor() { return compositors[XruEyeLeft].get(); }
+
 	/**
 	 * Restarts the session to allow for inputs to be attached to the session, if necessary.
 	 * To be called from BaseInput whenever it's attempting to attach the game actions.
@@ -65,14 +85,74 @@ private:
 	std::shared_ptr<XrController> hand_left;
 	std::shared_ptr<XrController> hand_right;
 
-	std::vector<std::shared_ptr<XrGenericTracker>> generic_trackers;
-	std::shared_mutex generic_trackers_mutex;
+	// Indexed by the tracker's device index minus RESERVED_DEVICE_INDICES. Trackers keep their slot for as long as
+	// the runtime reports them, so their device index (and thus any role the game assigned them) stays the same.
+	std::array<std::shared_ptr<XrGenericTracker>, MAX_GENERIC_TRACKERS> generic_trackers;
+
+	// The generation number of the xdev list the trackers were last updated from
+	std::optional<uint64_t> xdevListGeneration;
+
+	// Set when the session is being shut down, which destroys the tracker spaces
+	bool genericTrackerSpacesLost = false;
+
+	// XR_MNDX_xdev_space doesn't have an event for devices being added or removed, so poll for that periodically
+	std::chrono::steady_clock::time_point nextGenericTrackerPoll;
+
+	/**
+	 * An immutable snapshot of every tracked device, indexed by OpenVR device index.
+	 *
+	 * This is read on every property and pose query, so lookups must be as cheap as possible. Rather than
+	 * locking and copying a shared_ptr, readers load the current table with a single atomic load and get
+	 * a raw pointer back. Whenever the set of devices changes a new table is built and published, and
+	 * the old one is retired. Retired tables (and thus the devices they own) are only destroyed once every
+	 * reader has passed a frame boundary, so a raw device pointer remains valid for at least the rest of
+	 * the frame it was obtained in.
+	 */
+	struct DeviceTable {
+		std::array<ITrackedDevice*, vr::k_unMaxTrackedDeviceCount> devices = {};
+
+		// Keeps the devices alive for as long as this table may be read
+		std::vector<std::shared_ptr<ITrackedDevice>> owners;
+	};
+
+	struct RetiredDeviceTable {
+		std::unique_ptr<const DeviceTable> table;
+		uint64_t retiredAtEpoch;
+	};
+
+	std::atomic<const DeviceTable*> deviceTable = nullptr;
+	std::atomic<uint64_t> deviceTableEpoch = 0;
+
+	// Held across changing hand_left, hand_right or generic_trackers and publishing the new table, so two threads
+	// pumping events (eg the game's render thread and an overlay polling for events) can't interleave their
+	// changes or publish a table that's missing the other's. Also guards the fields below.
+	std::mutex deviceTableWriteMutex;
+	std::vector<RetiredDeviceTable> retiredDeviceTables;
+	std::chrono::steady_clock::time_point lastDeviceTableEpochAdvance;
+
+	/**
+	 * Builds a new device table from hmd, hand_left, hand_right and generic_trackers and publishes it.
+	 * Must be called after any of those are changed, without releasing deviceTableWriteMutex in between.
+	 */
+	void PublishDeviceTable();
+
+	/**
+	 * Marks a frame boundary, freeing any retired device tables that no reader can still be using.
+	 */
+	void AdvanceDeviceTableEpoch();
 
 	void CheckOrInitCompositors(const vr::Texture_t* tex);
 	std::unique_ptr<Compositor> compositors[XruEyeCount];
 	std::unique_ptr<Compositor> skybox_compositor;
 	std::vector<std::shared_ptr<Compositor>> overlay_compositors;
 
+	// The mirror each texture handed out by GetMirrorTextureD3D11 and GetMirrorTextureGL was taken from, so releasing
+	// it drops the reference on that mirror even if its compositor has since been replaced. GL textures are the same
+	// for each call on the same mirror, so their references are counted by the mirror.
+	std::mutex mirrorsMutex;
+	std::unordered_map<void*, std::shared_ptr<CompositorMirror>> mirrorViews;
+	std::unordered_map<vr::glUInt_t, std::shared_ptr<CompositorMirror>> glMirrors;
+
 	/**
 	 * Updates the current interaction profile in use according to the runtime.
 	 * This will set the XrHMD's interaction profile, as well as create the XrControllers
@@ -85,8 +165,26 @@ private:
 	/**
 	 * Queries xdevs from MNDX_xdev_space, if the runtime supports it. Ignores HMD & Controllers.
 	 * These "Generic Trackers" act like an HTC vive tracker, but support no bindings.
+	 *
+	 * Trackers are matched up with the existing ones by serial number: existing trackers are kept as-is, new
+	 * trackers take the first free device index, and trackers that are no longer present are deactivated.
+	 * This does nothing if the runtime's device list hasn't changed since the last call.
+	 *
+	 * Returns true if any trackers were added or removed, in which case the device table must be republished.
+	 * Must be called with deviceTableWriteMutex held.
+	 */
+	bool UpdateGenericTrackers();
+
+	/**
+	 * If XR_FB_display_refresh_rate is available, request the refresh rate set in the config file (if any)
+	 * and read the current refresh rate.
 	 */
-	void CreateGenericTrackers();
+	void SetupDisplayRefreshRate();
+
+	/**
+	 * Store a new refresh rate, and let the game know the HMD's display frequency property has changed.
+	 */
+	void OnDisplayRefreshRateChanged(float rate);
 
 	/**
 	 * Attempts to force the runtime to expose an interaction profile
@@ -105,6 +203,9 @@ private:
 	// The views for the two main eye layers
 	XrCompositionLayerProjectionView projectionViews[XruEyeCount];
 
+	// The depth info chained onto each of projectionViews, for games that submit depth
+	XrCompositionLayerDepthInfoKHR depthInfos[XruEyeCount];
+
 	// Have we started rendering a frame yet? If not, calling xrEndFrame would result in an error
 	bool renderingFrame = false;
 
@@ -123,7 +224,8 @@ private:
 	// Number of frames rendered for use in frame timing data
 	uint32_t nFrameIndex = 0;
 
-	double frameSubmitTimeUs = 0.0;
+	// When the last frame was submitted, from BackendManager::GetTimeInSeconds
+	double frameSubmitTime = 0.0;
 
 	// Action set and action used for querying for the interaction profile
 	inline static XrActionSet infoSet = XR_NULL_HANDLE;
@@ -205,30 +205,8 @@ void XrController::GetPose(vr::ETrackingUniverseOrigin origin, vr::TrackedDevice
 
 void XrController::GetPoseFromHandTracking(BaseInput* input, vr::TrackedDevicePose_t* pose)
 {
-	if (!xr_gbl->handTrackingProperties.supportsHandTracking)
-		return;
-
-	if (!input->handTrackers[(int)GetHand()])
-		return;
-
-	XrHandJointsLocateInfoEXT locateInfo = { XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT };
-	locateInfo.baseSpace = xr_gbl->floorSpace;
-	locateInfo.time = xr_gbl->GetBestTime();
-
-	XrHandJointVelocitiesEXT velocities = { XR_TYPE_HAND_JOINT_VELOCITIES_EXT };
-	velocities.jointCount = XR_HAND_JOINT_COUNT_EXT;
-	std::vector<XrHandJointVelocityEXT> jointVelocities(velocities.jointCount);
-	velocities.jointVelocities = jointVelocities.data();
-
-	XrHandJointLocationsEXT locations = { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
-	locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
-	std::vector<XrHandJointLocationEXT> jointLocations(locations.jointCount);
-	locations.jointLocations = jointLocations.data();
-	locations.next = &velocities;
-
-	OOVR_FAILED_XR_ABORT(xr_ext->xrLocateHandJointsEXT(input->handTrackers[(int)GetHand()], &locateInfo, &locations));
-
-	xr_utils::PoseFromHandTracking(pose, locations, velocities, GetHand() == HAND_RIGHT);
+	// The joints are shared with the skeletal input functions, so they're only located once per frame
+	input->GetHandTrackingPose(GetHand(), pose);
 }
 
 vr::ETrackedDeviceClass XrController::GetTrackedDeviceClass()
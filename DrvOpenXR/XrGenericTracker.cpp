@@ -12,7 +12,14 @@ XrGenericTracker::XrGenericTracker(const InteractionProfile& profile, XrXDevProp
 
 XrGenericTracker::~XrGenericTracker()
 {
-	xrDestroySpace(genericTrackerSpace);
+	SetSpace(XR_NULL_HANDLE);
+}
+
+void XrGenericTracker::SetSpace(XrSpace space)
+{
+	if (genericTrackerSpace)
+		xrDestroySpace(genericTrackerSpace);
+	genericTrackerSpace = space;
 }
 
 void XrGenericTracker::GetPose(vr::ETrackingUniverseOrigin origin, vr::TrackedDevicePose_t* pose, ETrackingStateType trackingState)
@@ -7,8 +7,6 @@
 #include <set>
 #include <string>
 
-constexpr int MAX_GENERIC_TRACKERS = vr::k_unMaxTrackedDeviceCount - RESERVED_DEVICE_INDICES;
-
 class XrGenericTracker : public virtual XrTrackedDevice {
 public:
 	explicit XrGenericTracker(const InteractionProfile& profile, XrXDevPropertiesMNDX properties, uint32_t index, XrSpace space);
@@ -27,6 +25,16 @@ public:
 	uint64_t GetUint64TrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pErrorL) override;
 	uint32_t GetStringTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, char* pchValue, uint32_t unBufferSize, vr::ETrackedPropertyError* pErrorL) override;
 
+	const char* GetSerial() const { return xdevProperties.serial; }
+
+	XrSpace GetSpace() const { return genericTrackerSpace; }
+
+	/**
+	 * Replace this tracker's space, destroying the old one. The space must be cleared before the session is
+	 * destroyed, and a new one supplied once the tracker has been found in the new session.
+	 */
+	void SetSpace(XrSpace space);
+
 private:
 	const InteractionProfile& profile;
 	XrXDevPropertiesMNDX xdevProperties;
@@ -153,12 +153,20 @@ vr::HmdMatrix34_t XrHMD::GetEyeToHeadTransform(vr::EVREye eEye)
 
 bool XrHMD::GetTimeSinceLastVsync(float* pfSecondsSinceLastVsync, uint64_t* pulFrameCounter)
 {
-	// TODO: Use frame time statistics to give proper data
-	OOVR_LOG_ONCE("Warning: static value returned");
+	double seconds;
+	uint64_t counter;
+	if (!xr_gbl || !xr_gbl->GetTimeSinceLastVsync(seconds, counter)) {
+		if (pfSecondsSinceLastVsync)
+			*pfSecondsSinceLastVsync = 0.011f;
+		return false;
+	}
+
 	if (pfSecondsSinceLastVsync)
-		*pfSecondsSinceLastVsync = 0.011f;
+		*pfSecondsSinceLastVsync = (float)seconds;
+	if (pulFrameCounter)
+		*pulFrameCounter = counter;
 
-	return false;
+	return true;
 }
 
 vr::HiddenAreaMesh_t XrHMD::GetHiddenAreaMesh(vr::EVREye eEye, vr::EHiddenAreaMeshType type)
@@ -329,7 +337,7 @@ float XrHMD::GetFloatTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::
 
 	switch (prop) {
 	case vr::Prop_DisplayFrequency_Float:
-		return 90.0; // TODO use the real value
+		return xr_gbl ? xr_gbl->GetDisplayRefreshRate() : 90.0f;
 	case vr::Prop_LensCenterLeftU_Float:
 	case vr::Prop_LensCenterLeftV_Float:
 	case vr::Prop_LensCenterRightU_Float:
@@ -341,7 +349,10 @@ float XrHMD::GetFloatTrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr::
 	case vr::Prop_UserIpdMeters_Float:
 		return BaseSystem::SGetIpd();
 	case vr::Prop_SecondsFromVsyncToPhotons_Float:
-		// Seems to be used by croteam games, IDK what the real value is, 100us should do
+		// Seems to be used by croteam games. OpenXR doesn't expose this directly, but the runtime's predicted display
+		// time is (roughly) one frame period after the vsync where we start rendering, which is what SteamVR reports too.
+		if (xr_gbl && xr_gbl->predictedDisplayPeriod > 0)
+			return (float)((double)xr_gbl->predictedDisplayPeriod / 1e9);
 		return 0.0001f;
 	case vr::Prop_UserHeadToEyeDepthMeters_Float:
 		// TODO ensure this has the correct sign, though it seems to always be zero anyway
@@ -414,6 +425,13 @@ int32_t XrHMD::GetInt32TrackedDeviceProperty(vr::ETrackedDeviceProperty prop, vr
 
 void XrHMD::SetInteractionProfile(const InteractionProfile* profile)
 {
-	std::unique_lock lock(profile_mutex);
-	this->profile = profile;
+	{
+		std::unique_lock lock(profile_mutex);
+		if (this->profile == profile)
+			return;
+		this->profile = profile;
+	}
+
+	// Most of our properties come from the interaction profile
+	GetPropertyTable().Invalidate();
 }
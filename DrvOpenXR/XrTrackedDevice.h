@@ -9,6 +9,9 @@
 // HMD, and two controllers are reserved
 constexpr int RESERVED_DEVICE_INDICES = 3;
 
+// All the other indices can be used by generic trackers
+constexpr int MAX_GENERIC_TRACKERS = vr::k_unMaxTrackedDeviceCount - RESERVED_DEVICE_INDICES;
+
 class XrTrackedDevice : public virtual ITrackedDevice {
 public:
 	void GetPose(
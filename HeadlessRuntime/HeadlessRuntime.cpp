@@ -0,0 +1,1915 @@
+//
+// A stand-in OpenXR runtime with no headset attached.
+//
+// This lets OpenComposite (and the games running on it) be run on a machine without any VR hardware, or
+// even a GPU - with lavapipe as the Vulkan driver, everything runs on the CPU. The headset and controllers
+// follow a script, and every OpenXR call is counted and timed so the hot paths can be measured.
+//
+// It only implements what OpenComposite needs: XR_KHR_vulkan_enable for graphics, and a single
+// instance and session at a time. See the 'Headless runtime' section of the README for how to use it.
+//
+
+// We only support Vulkan, and don't want to pull in the X11 and GL headers for the other bindings
+#undef XR_USE_PLATFORM_XLIB
+#undef XR_USE_GRAPHICS_API_OPENGL
+#undef XR_USE_GRAPHICS_API_OPENGL_ES
+#ifndef XR_USE_GRAPHICS_API_VULKAN
+#define XR_USE_GRAPHICS_API_VULKAN
+#endif
+#ifndef XR_USE_TIMESPEC
+#define XR_USE_TIMESPEC
+#endif
+
+// Our entry points have the same names as the OpenXR functions, and live in a namespace
+#define XR_NO_PROTOTYPES
+
+#include <time.h>
+#include <vulkan/vulkan.h>
+
+#include <openxr/openxr.h>
+#include <openxr/openxr_platform.h>
+#include <openxr/openxr_reflection.h>
+
+#if __has_include(<openxr/openxr_loader_negotiation.h>)
+#include <openxr/openxr_loader_negotiation.h>
+#else
+#include "loader_interfaces.h"
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace headless {
+
+// ---------------  Utilities   --------------- //
+
+static void Log(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, "[OC headless] ");
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+}
+
+static XrTime Now()
+{
+	timespec ts{};
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (XrTime)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Copy a list out using the OpenXR two-call idiom
+template <typename T>
+static XrResult TwoCall(uint32_t capacity, uint32_t* countOutput, T* output, const std::vector<T>& values)
+{
+	if (!countOutput)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	*countOutput = (uint32_t)values.size();
+	if (capacity == 0)
+		return XR_SUCCESS;
+	if (capacity < values.size())
+		return XR_ERROR_SIZE_INSUFFICIENT;
+
+	std::copy(values.begin(), values.end(), output);
+	return XR_SUCCESS;
+}
+
+static XrResult TwoCallString(uint32_t capacity, uint32_t* countOutput, char* output, const std::string& value)
+{
+	std::vector<char> chars(value.begin(), value.end());
+	chars.push_back(0);
+	return TwoCall(capacity, countOutput, output, chars);
+}
+
+static XrResult CopyString(char* dest, size_t size, const std::string& src)
+{
+	if (src.size() >= size)
+		return XR_ERROR_SIZE_INSUFFICIENT;
+	memcpy(dest, src.c_str(), src.size() + 1);
+	return XR_SUCCESS;
+}
+
+// Find a structure of the given type in a next chain
+template <typename T>
+static T* FindNext(const void* next, XrStructureType type)
+{
+	auto* header = (XrBaseOutStructure*)next;
+	while (header) {
+		if (header->type == type)
+			return (T*)header;
+		header = header->next;
+	}
+	return nullptr;
+}
+
+// ---------------  Pose maths   --------------- //
+
+static XrQuaternionf QuatMul(const XrQuaternionf& a, const XrQuaternionf& b)
+{
+	return {
+		a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+		a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+		a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+		a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+	};
+}
+
+static XrVector3f Rotate(const XrQuaternionf& q, const XrVector3f& v)
+{
+	// v + w*t + cross(q, t) where t = 2*cross(q, v)
+	XrVector3f t = { 2 * (q.y * v.z - q.z * v.y), 2 * (q.z * v.x - q.x * v.z), 2 * (q.x * v.y - q.y * v.x) };
+	return {
+		v.x + q.w * t.x + (q.y * t.z - q.z * t.y),
+		v.y + q.w * t.y + (q.z * t.x - q.x * t.z),
+		v.z + q.w * t.z + (q.x * t.y - q.y * t.x),
+	};
+}
+
+// The pose b, in the space of a
+static XrPosef PoseMul(const XrPosef& a, const XrPosef& b)
+{
+	XrVector3f offset = Rotate(a.orientation, b.position);
+	return {
+		QuatMul(a.orientation, b.orientation),
+		{ a.position.x + offset.x, a.position.y + offset.y, a.position.z + offset.z },
+	};
+}
+
+static XrPosef PoseInverse(const XrPosef& p)
+{
+	XrQuaternionf inv = { -p.orientation.x, -p.orientation.y, -p.orientation.z, p.orientation.w };
+	XrVector3f pos = Rotate(inv, { -p.position.x, -p.position.y, -p.position.z });
+	return { inv, pos };
+}
+
+static const XrPosef identityPose = { { 0, 0, 0, 1 }, { 0, 0, 0 } };
+
+// ---------------  Scripts   --------------- //
+
+/**
+ * The script the headset and controllers follow.
+ *
+ * Each line of the script is a keyframe, made up of a time in seconds (from when the session started running),
+ * a path and some values. Values are linearly interpolated between keyframes, and held before the first and after
+ * the last one. Blank lines and lines starting with a # are ignored.
+ *
+ * For the headset and hands (/user/head, /user/hand/left and /user/hand/right) the values are a position and
+ * optionally an orientation quaternion in x y z w order. A specific pose input can also be scripted (for example
+ * /user/hand/left/input/aim/pose), otherwise all the poses on a hand follow the hand.
+ *
+ * For inputs the path is the binding path, such as /user/hand/right/input/trigger/value, and the values
+ * are one float (for buttons and triggers, with anything above 0.5 counting as pressed) or two (for thumbsticks).
+ */
+class Script {
+public:
+	bool Load(const std::string& filename)
+	{
+		std::ifstream file(filename);
+		if (!file) {
+			Log("Could not open script file '%s'", filename.c_str());
+			return false;
+		}
+
+		std::string line;
+		int lineNumber = 0;
+		while (std::getline(file, line)) {
+			lineNumber++;
+
+			size_t comment = line.find('#');
+			if (comment != std::string::npos)
+				line.erase(comment);
+
+			std::istringstream stream(line);
+			Keyframe frame;
+			std::string path;
+			if (!(stream >> frame.time))
+				continue; // Blank line
+
+			if (!(stream >> path)) {
+				Log("Script line %d: missing path", lineNumber);
+				return false;
+			}
+
+			float value;
+			while (stream >> value)
+				frame.values.push_back(value);
+
+			if (!stream.eof() || frame.values.empty()) {
+				Log("Script line %d: invalid values for '%s'", lineNumber, path.c_str());
+				return false;
+			}
+
+			std::vector<Keyframe>& timeline = timelines[path];
+			timeline.push_back(frame);
+			std::stable_sort(timeline.begin(), timeline.end(), [](const Keyframe& a, const Keyframe& b) { return a.time < b.time; });
+		}
+
+		Log("Loaded %d timelines from script '%s'", (int)timelines.size(), filename.c_str());
+		return true;
+	}
+
+	bool Has(const std::string& path) const { return timelines.contains(path); }
+
+	/**
+	 * Get the values for a path at the given time. Returns an empty list if the path isn't scripted.
+	 */
+	std::vector<float> Sample(const std::string& path, double time) const
+	{
+		auto iter = timelines.find(path);
+		if (iter == timelines.end())
+			return {};
+
+		const std::vector<Keyframe>& timeline = iter->second;
+		if (time <= timeline.front().time)
+			return timeline.front().values;
+		if (time >= timeline.back().time)
+			return timeline.back().values;
+
+		auto next = std::upper_bound(timeline.begin(), timeline.end(), time, [](double t, const Keyframe& frame) { return t < frame.time; });
+		const Keyframe& a = *(next - 1);
+		const Keyframe& b = *next;
+
+		float factor = (float)((time - a.time) / (b.time - a.time));
+		std::vector<float> result = a.values;
+		for (size_t i = 0; i < result.size() && i < b.values.size(); i++)
+			result[i] += (b.values[i] - result[i]) * factor;
+		return result;
+	}
+
+	/**
+	 * Sample a pose, which is a position optionally followed by an orientation.
+	 */
+	bool SamplePose(const std::string& path, double time, XrPosef& pose) const
+	{
+		std::vector<float> values = Sample(path, time);
+		if (values.size() < 3)
+			return false;
+
+		pose = identityPose;
+		pose.position = { values[0], values[1], values[2] };
+
+		if (values.size() >= 7) {
+			XrQuaternionf q = { values[3], values[4], values[5], values[6] };
+			float length = sqrtf(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+			if (length > 0)
+				pose.orientation = { q.x / length, q.y / length, q.z / length, q.w / length };
+		}
+
+		return true;
+	}
+
+private:
+	struct Keyframe {
+		double time = 0;
+		std::vector<float> values;
+	};
+
+	std::unordered_map<std::string, std::vector<Keyframe>> timelines;
+};
+
+// ---------------  Call statistics   --------------- //
+
+struct CallStats {
+	uint64_t count = 0;
+	uint64_t totalNs = 0;
+	uint64_t maxNs = 0;
+};
+
+static std::mutex statsMutex;
+static std::map<std::string, CallStats> callStats;
+
+class CallTimer {
+public:
+	explicit CallTimer(const char* name)
+	    : name(name), start(std::chrono::steady_clock::now()) {}
+
+	~CallTimer()
+	{
+		uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+		std::lock_guard lock(statsMutex);
+		CallStats& stats = callStats[name];
+		stats.count++;
+		stats.totalNs += ns;
+		stats.maxNs = std::max(stats.maxNs, ns);
+	}
+
+private:
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+};
+
+#define HR_TIMED() CallTimer callTimer(__func__)
+
+/**
+ * Write the call statistics to the file named by OC_HEADLESS_STATS, as a tab-separated table.
+ */
+static void WriteStats()
+{
+	const char* filename = getenv("OC_HEADLESS_STATS");
+	if (!filename || !*filename)
+		return;
+
+	FILE* file = fopen(filename, "w");
+	if (!file) {
+		Log("Could not open stats file '%s'", filename);
+		return;
+	}
+
+	std::lock_guard lock(statsMutex);
+	fprintf(file, "function\tcalls\ttotal_us\tmean_us\tmax_us\n");
+	for (const auto& [name, stats] : callStats) {
+		double totalUs = stats.totalNs / 1000.0;
+		fprintf(file, "%s\t%llu\t%.1f\t%.3f\t%.1f\n", name.c_str(), (unsigned long long)stats.count, totalUs,
+		    totalUs / (double)stats.count, stats.maxNs / 1000.0);
+	}
+	fclose(file);
+
+	Log("Wrote call statistics to '%s'", filename);
+}
+
+// ---------------  Objects   --------------- //
+
+struct Session;
+
+struct Action;
+
+struct ActionSet {
+	Session* attachedTo = nullptr;
+	std::string name;
+	std::vector<Action*> actions;
+};
+
+struct Action {
+	ActionSet* set = nullptr;
+	std::string name;
+	XrActionType type = XR_ACTION_TYPE_BOOLEAN_INPUT;
+	std::vector<XrPath> subactionPaths;
+};
+
+struct ActionState {
+	bool isActive = false;
+	float values[2] = {};
+	bool changedSinceLastSync = false;
+	XrTime lastChangeTime = 0;
+};
+
+struct Space {
+	Session* session = nullptr;
+	XrReferenceSpaceType referenceType = XR_REFERENCE_SPACE_TYPE_STAGE;
+	Action* action = nullptr; // Null for reference spaces
+	XrPath subactionPath = XR_NULL_PATH;
+	XrPosef offset = identityPose;
+};
+
+struct Swapchain {
+	Session* session = nullptr;
+	XrSwapchainCreateInfo info = {};
+	std::vector<VkImage> images;
+	std::vector<VkDeviceMemory> memory;
+
+	uint32_t nextImage = 0;
+	std::deque<uint32_t> acquired;
+	bool waited = false;
+};
+
+struct Session {
+	XrGraphicsBindingVulkanKHR binding = {};
+
+	XrSessionState state = XR_SESSION_STATE_UNKNOWN;
+	bool running = false;
+	bool exitRequested = false;
+	XrTime beginTime = 0;
+
+	bool frameBegun = false;
+	XrTime lastDisplayTime = 0;
+	XrTime lastWaitTime = 0;
+
+	std::string interactionProfile;
+	std::map<std::pair<Action*, XrPath>, ActionState> actionStates;
+
+	std::set<Space*> spaces;
+	std::set<Swapchain*> swapchains;
+};
+
+struct Instance {
+	Script script;
+	std::vector<std::string> paths;
+	std::unordered_map<std::string, XrPath> pathIds;
+
+	// Keyed by interaction profile path, values are (action, binding path)
+	std::map<std::string, std::vector<std::pair<Action*, std::string>>> suggestedBindings;
+	std::vector<std::string> suggestedProfileOrder;
+
+	std::deque<XrEventDataBuffer> events;
+
+	bool systemRequested = false;
+	bool graphicsRequirementsQueried = false;
+
+	std::set<ActionSet*> actionSets;
+	Session* session = nullptr;
+
+	float frameRate = 90;
+	bool throttle = true;
+};
+
+static std::mutex runtimeMutex;
+static Instance* instance = nullptr;
+
+static constexpr XrSystemId systemId = 1;
+
+static const char* supportedExtensions[] = {
+	XR_KHR_VULKAN_ENABLE_EXTENSION_NAME,
+	XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME,
+};
+
+// ---------------  Paths   --------------- //
+
+static XrPath GetPath(const std::string& str)
+{
+	auto iter = instance->pathIds.find(str);
+	if (iter != instance->pathIds.end())
+		return iter->second;
+
+	instance->paths.push_back(str);
+	XrPath path = instance->paths.size();
+	instance->pathIds[str] = path;
+	return path;
+}
+
+static const std::string* PathString(XrPath path)
+{
+	if (path == XR_NULL_PATH || path > instance->paths.size())
+		return nullptr;
+	return &instance->paths[path - 1];
+}
+
+// Get the top-level user path of a binding, eg /user/hand/left for /user/hand/left/input/trigger/value
+static std::string TopLevelPath(const std::string& binding)
+{
+	for (const char* component : { "/input/", "/output/" }) {
+		size_t pos = binding.find(component);
+		if (pos != std::string::npos)
+			return binding.substr(0, pos);
+	}
+	return binding;
+}
+
+// ---------------  Events and state   --------------- //
+
+static void QueueEvent(const XrEventDataBaseHeader* event, size_t size)
+{
+	XrEventDataBuffer buffer = { XR_TYPE_EVENT_DATA_BUFFER };
+	memcpy(&buffer, event, std::min(size, sizeof(buffer)));
+	instance->events.push_back(buffer);
+}
+
+static void SetSessionState(Session* session, XrSessionState state)
+{
+	session->state = state;
+
+	XrEventDataSessionStateChanged event = { XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED };
+	event.session = (XrSession)session;
+	event.state = state;
+	event.time = Now();
+	QueueEvent((XrEventDataBaseHeader*)&event, sizeof(event));
+}
+
+// Seconds into the script, which starts when the session starts running
+static double ScriptTime(const Session* session, XrTime time)
+{
+	if (!session || session->beginTime == 0)
+		return 0;
+	return std::max(0.0, (double)(time - session->beginTime) / 1e9);
+}
+
+static XrPosef DefaultPose(const std::string& topLevelPath)
+{
+	XrPosef pose = identityPose;
+	if (topLevelPath == "/user/head")
+		pose.position = { 0, 1.6f, 0 };
+	else if (topLevelPath == "/user/hand/left")
+		pose.position = { -0.2f, 1.0f, -0.3f };
+	else if (topLevelPath == "/user/hand/right")
+		pose.position = { 0.2f, 1.0f, -0.3f };
+	return pose;
+}
+
+static XrPosef DevicePose(const Session* session, const std::string& path, XrTime time)
+{
+	XrPosef pose;
+	if (instance->script.SamplePose(path, ScriptTime(session, time), pose))
+		return pose;
+
+	std::string topLevel = TopLevelPath(path);
+	if (instance->script.SamplePose(topLevel, ScriptTime(session, time), pose))
+		return pose;
+
+	return DefaultPose(topLevel);
+}
+
+// The bindings for an action in the current interaction profile, limited to a subaction path if one is given
+static std::vector<std::string> GetBindings(const Session* session, const Action* action, XrPath subactionPath)
+{
+	std::vector<std::string> result;
+	auto iter = instance->suggestedBindings.find(session->interactionProfile);
+	if (iter == instance->suggestedBindings.end())
+		return result;
+
+	const std::string* subactionStr = PathString(subactionPath);
+	for (const auto& [boundAction, binding] : iter->second) {
+		if (boundAction != action)
+			continue;
+		if (subactionStr && TopLevelPath(binding) != *subactionStr)
+			continue;
+		result.push_back(binding);
+	}
+	return result;
+}
+
+static ActionState ComputeActionState(const Session* session, const Action* action, XrPath subactionPath, XrTime time)
+{
+	ActionState state;
+	std::vector<std::string> bindings = GetBindings(session, action, subactionPath);
+	state.isActive = !bindings.empty();
+
+	for (const std::string& binding : bindings) {
+		std::vector<float> values = instance->script.Sample(binding, ScriptTime(session, time));
+		if (values.empty())
+			continue;
+
+		switch (action->type) {
+		case XR_ACTION_TYPE_BOOLEAN_INPUT:
+			if (values[0] > 0.5f)
+				state.values[0] = 1;
+			break;
+		case XR_ACTION_TYPE_FLOAT_INPUT:
+			if (fabsf(values[0]) > fabsf(state.values[0]))
+				state.values[0] = values[0];
+			break;
+		case XR_ACTION_TYPE_VECTOR2F_INPUT: {
+			float x = values[0];
+			float y = values.size() > 1 ? values[1] : 0;
+			if (x * x + y * y > state.values[0] * state.values[0] + state.values[1] * state.values[1]) {
+				state.values[0] = x;
+				state.values[1] = y;
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	return state;
+}
+
+static bool SpacePose(const Space* space, XrTime time, XrPosef& pose)
+{
+	const Session* session = space->session;
+
+	if (space->action) {
+		std::vector<std::string> bindings = GetBindings(session, space->action, space->subactionPath);
+		if (bindings.empty())
+			return false;
+		pose = PoseMul(DevicePose(session, bindings.front(), time), space->offset);
+		return true;
+	}
+
+	switch (space->referenceType) {
+	case XR_REFERENCE_SPACE_TYPE_VIEW:
+		pose = PoseMul(DevicePose(session, "/user/head", time), space->offset);
+		return true;
+	case XR_REFERENCE_SPACE_TYPE_LOCAL: {
+		// The local space is centred where the headset started, at head height
+		XrPosef origin = identityPose;
+		origin.position = DevicePose(session, "/user/head", session->beginTime).position;
+		pose = PoseMul(origin, space->offset);
+		return true;
+	}
+	case XR_REFERENCE_SPACE_TYPE_STAGE:
+	default:
+		pose = space->offset;
+		return true;
+	}
+}
+
+// ---------------  Instance   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function);
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateInstanceExtensionProperties(const char* layerName, uint32_t propertyCapacityInput,
+    uint32_t* propertyCountOutput, XrExtensionProperties* properties)
+{
+	HR_TIMED();
+
+	std::vector<XrExtensionProperties> extensions;
+	for (const char* name : supportedExtensions) {
+		XrExtensionProperties ext = { XR_TYPE_EXTENSION_PROPERTIES };
+		strncpy(ext.extensionName, name, XR_MAX_EXTENSION_NAME_SIZE - 1);
+		ext.extensionVersion = 1;
+		extensions.push_back(ext);
+	}
+
+	return TwoCall(propertyCapacityInput, propertyCountOutput, properties, extensions);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateApiLayerProperties(uint32_t propertyCapacityInput, uint32_t* propertyCountOutput, XrApiLayerProperties* properties)
+{
+	HR_TIMED();
+	return TwoCall(propertyCapacityInput, propertyCountOutput, properties, {});
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (!createInfo || !out)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	if (instance)
+		return XR_ERROR_LIMIT_REACHED;
+
+	for (uint32_t i = 0; i < createInfo->enabledExtensionCount; i++) {
+		const char* name = createInfo->enabledExtensionNames[i];
+		bool found = std::any_of(std::begin(supportedExtensions), std::end(supportedExtensions), [&](const char* ext) { return strcmp(ext, name) == 0; });
+		if (!found) {
+			Log("Application requested unsupported extension '%s'", name);
+			return XR_ERROR_EXTENSION_NOT_PRESENT;
+		}
+	}
+
+	auto created = std::make_unique<Instance>();
+
+	const char* script = getenv("OC_HEADLESS_SCRIPT");
+	if (script && *script && !created->script.Load(script))
+		return XR_ERROR_RUNTIME_FAILURE;
+
+	const char* rate = getenv("OC_HEADLESS_FRAME_RATE");
+	if (rate && *rate) {
+		// Zero means run as fast as possible, while still reporting 90Hz to the application
+		float value = strtof(rate, nullptr);
+		created->throttle = value > 0;
+		if (value > 0)
+			created->frameRate = value;
+	}
+
+	{
+		std::lock_guard statsLock(statsMutex);
+		callStats.clear();
+	}
+
+	instance = created.release();
+	*out = (XrInstance)instance;
+
+	Log("Created instance for '%s'", createInfo->applicationInfo.applicationName);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyInstance(XrInstance handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (!instance || (Instance*)handle != instance)
+		return XR_ERROR_HANDLE_INVALID;
+
+	if (instance->session)
+		Log("Instance destroyed while a session is still alive");
+
+	for (ActionSet* set : instance->actionSets) {
+		for (Action* action : set->actions)
+			delete action;
+		delete set;
+	}
+
+	delete instance;
+	instance = nullptr;
+
+	WriteStats();
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProperties(XrInstance handle, XrInstanceProperties* properties)
+{
+	HR_TIMED();
+	properties->runtimeVersion = XR_MAKE_VERSION(0, 1, 0);
+	return CopyString(properties->runtimeName, XR_MAX_RUNTIME_NAME_SIZE, "OpenComposite Headless");
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrPollEvent(XrInstance handle, XrEventDataBuffer* eventData)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (instance->events.empty())
+		return XR_EVENT_UNAVAILABLE;
+
+	*eventData = instance->events.front();
+	instance->events.pop_front();
+	return XR_SUCCESS;
+}
+
+// Both functions name their output buffer and its size the same way, so they can share this
+#define HR_ENUM_TO_STRING_CASE(name, value) \
+	case name:                              \
+		return CopyString(buffer, bufferSize, #name);
+
+XRAPI_ATTR XrResult XRAPI_CALL xrResultToString(XrInstance handle, XrResult value, char buffer[XR_MAX_RESULT_STRING_SIZE])
+{
+	HR_TIMED();
+	const size_t bufferSize = XR_MAX_RESULT_STRING_SIZE;
+	switch (value) {
+		XR_LIST_ENUM_XrResult(HR_ENUM_TO_STRING_CASE);
+	default:
+		return CopyString(buffer, bufferSize, (value < 0 ? "XR_UNKNOWN_FAILURE_" : "XR_UNKNOWN_SUCCESS_") + std::to_string((int)value));
+	}
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStructureTypeToString(XrInstance handle, XrStructureType value, char buffer[XR_MAX_STRUCTURE_NAME_SIZE])
+{
+	HR_TIMED();
+	const size_t bufferSize = XR_MAX_STRUCTURE_NAME_SIZE;
+	switch (value) {
+		XR_LIST_ENUM_XrStructureType(HR_ENUM_TO_STRING_CASE);
+	default:
+		return CopyString(buffer, bufferSize, "XR_UNKNOWN_STRUCTURE_TYPE_" + std::to_string((int)value));
+	}
+}
+
+#undef HR_ENUM_TO_STRING_CASE
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStringToPath(XrInstance handle, const char* pathString, XrPath* path)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (!pathString || pathString[0] != '/')
+		return XR_ERROR_PATH_FORMAT_INVALID;
+
+	*path = GetPath(pathString);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrPathToString(XrInstance handle, XrPath path, uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	const std::string* str = PathString(path);
+	if (!str)
+		return XR_ERROR_PATH_INVALID;
+
+	return TwoCallString(bufferCapacityInput, bufferCountOutput, buffer, *str);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrConvertTimespecTimeToTimeKHR(XrInstance handle, const struct timespec* timespecTime, XrTime* time)
+{
+	HR_TIMED();
+	*time = (XrTime)timespecTime->tv_sec * 1000000000 + timespecTime->tv_nsec;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrConvertTimeToTimespecTimeKHR(XrInstance handle, XrTime time, struct timespec* timespecTime)
+{
+	HR_TIMED();
+	timespecTime->tv_sec = time / 1000000000;
+	timespecTime->tv_nsec = time % 1000000000;
+	return XR_SUCCESS;
+}
+
+// ---------------  System   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetSystem(XrInstance handle, const XrSystemGetInfo* getInfo, XrSystemId* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY)
+		return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+
+	instance->systemRequested = true;
+	*out = systemId;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetSystemProperties(XrInstance handle, XrSystemId system, XrSystemProperties* properties)
+{
+	HR_TIMED();
+	if (system != systemId)
+		return XR_ERROR_SYSTEM_INVALID;
+
+	properties->systemId = systemId;
+	properties->vendorId = 0;
+	strncpy(properties->systemName, "OpenComposite Headless", XR_MAX_SYSTEM_NAME_SIZE - 1);
+	properties->graphicsProperties.maxSwapchainImageWidth = 4096;
+	properties->graphicsProperties.maxSwapchainImageHeight = 4096;
+	properties->graphicsProperties.maxLayerCount = XR_MIN_COMPOSITION_LAYERS_SUPPORTED;
+	properties->trackingProperties.orientationTracking = XR_TRUE;
+	properties->trackingProperties.positionTracking = XR_TRUE;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateEnvironmentBlendModes(XrInstance handle, XrSystemId system, XrViewConfigurationType viewConfigurationType,
+    uint32_t environmentBlendModeCapacityInput, uint32_t* environmentBlendModeCountOutput, XrEnvironmentBlendMode* environmentBlendModes)
+{
+	HR_TIMED();
+	return TwoCall(environmentBlendModeCapacityInput, environmentBlendModeCountOutput, environmentBlendModes, { XR_ENVIRONMENT_BLEND_MODE_OPAQUE });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateViewConfigurations(XrInstance handle, XrSystemId system, uint32_t viewConfigurationTypeCapacityInput,
+    uint32_t* viewConfigurationTypeCountOutput, XrViewConfigurationType* viewConfigurationTypes)
+{
+	HR_TIMED();
+	return TwoCall(viewConfigurationTypeCapacityInput, viewConfigurationTypeCountOutput, viewConfigurationTypes, { XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetViewConfigurationProperties(XrInstance handle, XrSystemId system, XrViewConfigurationType viewConfigurationType,
+    XrViewConfigurationProperties* configurationProperties)
+{
+	HR_TIMED();
+	if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO)
+		return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+	configurationProperties->viewConfigurationType = viewConfigurationType;
+	configurationProperties->fovMutable = XR_FALSE;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateViewConfigurationViews(XrInstance handle, XrSystemId system, XrViewConfigurationType viewConfigurationType,
+    uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrViewConfigurationView* views)
+{
+	HR_TIMED();
+	if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO)
+		return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+	// Keep the resolution small, since everything may well be rendered on the CPU
+	XrViewConfigurationView view = { XR_TYPE_VIEW_CONFIGURATION_VIEW };
+	view.recommendedImageRectWidth = 1024;
+	view.recommendedImageRectHeight = 1024;
+	view.maxImageRectWidth = 4096;
+	view.maxImageRectHeight = 4096;
+	view.recommendedSwapchainSampleCount = 1;
+	view.maxSwapchainSampleCount = 1;
+	return TwoCall(viewCapacityInput, viewCountOutput, views, { view, view });
+}
+
+// ---------------  Vulkan   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetVulkanGraphicsRequirementsKHR(XrInstance handle, XrSystemId system, XrGraphicsRequirementsVulkanKHR* graphicsRequirements)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	instance->graphicsRequirementsQueried = true;
+	graphicsRequirements->minApiVersionSupported = XR_MAKE_VERSION(1, 0, 0);
+	graphicsRequirements->maxApiVersionSupported = XR_MAKE_VERSION(1, 3, 0);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetVulkanInstanceExtensionsKHR(XrInstance handle, XrSystemId system, uint32_t bufferCapacityInput,
+    uint32_t* bufferCountOutput, char* buffer)
+{
+	HR_TIMED();
+	return TwoCallString(bufferCapacityInput, bufferCountOutput, buffer, "");
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetVulkanDeviceExtensionsKHR(XrInstance handle, XrSystemId system, uint32_t bufferCapacityInput,
+    uint32_t* bufferCountOutput, char* buffer)
+{
+	HR_TIMED();
+	return TwoCallString(bufferCapacityInput, bufferCountOutput, buffer, "");
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetVulkanGraphicsDeviceKHR(XrInstance handle, XrSystemId system, VkInstance vkInstance, VkPhysicalDevice* vkPhysicalDevice)
+{
+	HR_TIMED();
+
+	// Nothing is displayed, so any device will do - on a CI machine this will probably be lavapipe
+	uint32_t count = 1;
+	VkResult result = vkEnumeratePhysicalDevices(vkInstance, &count, vkPhysicalDevice);
+	if ((result != VK_SUCCESS && result != VK_INCOMPLETE) || count == 0) {
+		Log("No Vulkan physical devices available (%d)", result);
+		return XR_ERROR_RUNTIME_FAILURE;
+	}
+
+	return XR_SUCCESS;
+}
+
+// ---------------  Session   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSession(XrInstance handle, const XrSessionCreateInfo* createInfo, XrSession* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	if (createInfo->systemId != systemId || !instance->systemRequested)
+		return XR_ERROR_SYSTEM_INVALID;
+
+	if (instance->session)
+		return XR_ERROR_LIMIT_REACHED;
+
+	auto* binding = FindNext<XrGraphicsBindingVulkanKHR>(createInfo->next, XR_TYPE_GRAPHICS_BINDING_VULKAN_KHR);
+	if (!binding) {
+		Log("Only Vulkan sessions are supported");
+		return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+	}
+
+	if (!instance->graphicsRequirementsQueried)
+		return XR_ERROR_GRAPHICS_REQUIREMENTS_CALL_MISSING;
+
+	auto* session = new Session();
+	session->binding = *binding;
+	session->binding.next = nullptr;
+	instance->session = session;
+
+	SetSessionState(session, XR_SESSION_STATE_IDLE);
+	SetSessionState(session, XR_SESSION_STATE_READY);
+
+	*out = (XrSession)session;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySession(XrSession handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session || session != instance->session)
+		return XR_ERROR_HANDLE_INVALID;
+
+	for (Swapchain* swapchain : session->swapchains) {
+		for (size_t i = 0; i < swapchain->images.size(); i++) {
+			vkDestroyImage(session->binding.device, swapchain->images[i], nullptr);
+			vkFreeMemory(session->binding.device, swapchain->memory[i], nullptr);
+		}
+		delete swapchain;
+	}
+
+	for (Space* space : session->spaces)
+		delete space;
+
+	for (ActionSet* set : instance->actionSets) {
+		if (set->attachedTo == session)
+			set->attachedTo = nullptr;
+	}
+
+	// Drop any events for this session that haven't been read yet
+	std::erase_if(instance->events, [session](const XrEventDataBuffer& event) {
+		return event.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED && ((XrEventDataSessionStateChanged*)&event)->session == (XrSession)session;
+	});
+
+	instance->session = nullptr;
+	delete session;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrBeginSession(XrSession handle, const XrSessionBeginInfo* beginInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (session->running)
+		return XR_ERROR_SESSION_RUNNING;
+	if (session->state != XR_SESSION_STATE_READY)
+		return XR_ERROR_SESSION_NOT_READY;
+	if (beginInfo->primaryViewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO)
+		return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+	session->running = true;
+	session->beginTime = Now();
+	session->lastDisplayTime = session->beginTime;
+
+	SetSessionState(session, XR_SESSION_STATE_SYNCHRONIZED);
+	SetSessionState(session, XR_SESSION_STATE_VISIBLE);
+	SetSessionState(session, XR_SESSION_STATE_FOCUSED);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrRequestExitSession(XrSession handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session->running)
+		return XR_ERROR_SESSION_NOT_RUNNING;
+
+	session->exitRequested = true;
+	if (session->state == XR_SESSION_STATE_FOCUSED)
+		SetSessionState(session, XR_SESSION_STATE_VISIBLE);
+	if (session->state == XR_SESSION_STATE_VISIBLE)
+		SetSessionState(session, XR_SESSION_STATE_SYNCHRONIZED);
+	SetSessionState(session, XR_SESSION_STATE_STOPPING);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEndSession(XrSession handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session->running)
+		return XR_ERROR_SESSION_NOT_RUNNING;
+	if (session->state != XR_SESSION_STATE_STOPPING)
+		return XR_ERROR_SESSION_NOT_STOPPING;
+
+	session->running = false;
+	session->frameBegun = false;
+	SetSessionState(session, XR_SESSION_STATE_IDLE);
+	if (session->exitRequested)
+		SetSessionState(session, XR_SESSION_STATE_EXITING);
+	return XR_SUCCESS;
+}
+
+// ---------------  Frames   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitFrame(XrSession handle, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState)
+{
+	HR_TIMED();
+
+	XrTime wakeTime;
+	{
+		std::lock_guard lock(runtimeMutex);
+
+		auto* session = (Session*)handle;
+		if (!session->running)
+			return XR_ERROR_SESSION_NOT_RUNNING;
+
+		XrDuration period = (XrDuration)(1e9 / instance->frameRate);
+		XrTime now = Now();
+
+		// Pace the application at the frame rate, unless we've been asked to run as fast as possible
+		wakeTime = instance->throttle ? session->lastWaitTime + period : now;
+		XrTime displayTime = std::max(session->lastDisplayTime, std::max(now, wakeTime)) + period;
+
+		session->lastWaitTime = std::max(now, wakeTime);
+		session->lastDisplayTime = displayTime;
+
+		frameState->predictedDisplayTime = displayTime;
+		frameState->predictedDisplayPeriod = period;
+		frameState->shouldRender = session->state == XR_SESSION_STATE_VISIBLE || session->state == XR_SESSION_STATE_FOCUSED;
+	}
+
+	XrTime now = Now();
+	if (wakeTime > now)
+		std::this_thread::sleep_for(std::chrono::nanoseconds(wakeTime - now));
+
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrBeginFrame(XrSession handle, const XrFrameBeginInfo* frameBeginInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session->running)
+		return XR_ERROR_SESSION_NOT_RUNNING;
+
+	if (session->frameBegun)
+		return XR_FRAME_DISCARDED;
+
+	session->frameBegun = true;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEndFrame(XrSession handle, const XrFrameEndInfo* frameEndInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session->running)
+		return XR_ERROR_SESSION_NOT_RUNNING;
+	if (!session->frameBegun)
+		return XR_ERROR_CALL_ORDER_INVALID;
+	session->frameBegun = false;
+
+	if (frameEndInfo->layerCount > XR_MIN_COMPOSITION_LAYERS_SUPPORTED)
+		return XR_ERROR_LAYER_LIMIT_EXCEEDED;
+
+	// Nothing is displayed, but check the layers refer to real swapchains so mistakes still show up
+	for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+		const XrCompositionLayerBaseHeader* layer = frameEndInfo->layers[i];
+		if (!layer)
+			return XR_ERROR_LAYER_INVALID;
+
+		if (layer->type == XR_TYPE_COMPOSITION_LAYER_PROJECTION) {
+			auto* projection = (const XrCompositionLayerProjection*)layer;
+			if (projection->viewCount != 2)
+				return XR_ERROR_VALIDATION_FAILURE;
+			for (uint32_t v = 0; v < projection->viewCount; v++) {
+				if (!session->swapchains.contains((Swapchain*)projection->views[v].subImage.swapchain))
+					return XR_ERROR_HANDLE_INVALID;
+			}
+		} else if (layer->type == XR_TYPE_COMPOSITION_LAYER_QUAD) {
+			auto* quad = (const XrCompositionLayerQuad*)layer;
+			if (!session->swapchains.contains((Swapchain*)quad->subImage.swapchain))
+				return XR_ERROR_HANDLE_INVALID;
+		}
+	}
+
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateViews(XrSession handle, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState,
+    uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	auto* base = (Space*)viewLocateInfo->space;
+
+	XrPosef basePose;
+	if (!SpacePose(base, viewLocateInfo->displayTime, basePose)) {
+		viewState->viewStateFlags = 0;
+		return TwoCall(viewCapacityInput, viewCountOutput, views, std::vector<XrView>(2, { XR_TYPE_VIEW }));
+	}
+
+	XrPosef head = PoseMul(PoseInverse(basePose), DevicePose(session, "/user/head", viewLocateInfo->displayTime));
+
+	std::vector<XrView> result(2, { XR_TYPE_VIEW });
+	for (int eye = 0; eye < 2; eye++) {
+		XrPosef eyeOffset = identityPose;
+		eyeOffset.position.x = eye == 0 ? -0.0315f : 0.0315f;
+
+		result[eye].pose = PoseMul(head, eyeOffset);
+		result[eye].fov = { -0.785f, 0.785f, 0.785f, -0.785f };
+	}
+
+	viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT
+	    | XR_VIEW_STATE_ORIENTATION_TRACKED_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT;
+	return TwoCall(viewCapacityInput, viewCountOutput, views, result);
+}
+
+// ---------------  Spaces   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateReferenceSpaces(XrSession handle, uint32_t spaceCapacityInput, uint32_t* spaceCountOutput, XrReferenceSpaceType* spaces)
+{
+	HR_TIMED();
+	return TwoCall(spaceCapacityInput, spaceCountOutput, spaces,
+	    { XR_REFERENCE_SPACE_TYPE_VIEW, XR_REFERENCE_SPACE_TYPE_LOCAL, XR_REFERENCE_SPACE_TYPE_STAGE });
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateReferenceSpace(XrSession handle, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	switch (createInfo->referenceSpaceType) {
+	case XR_REFERENCE_SPACE_TYPE_VIEW:
+	case XR_REFERENCE_SPACE_TYPE_LOCAL:
+	case XR_REFERENCE_SPACE_TYPE_STAGE:
+		break;
+	default:
+		return XR_ERROR_REFERENCE_SPACE_UNSUPPORTED;
+	}
+
+	auto* space = new Space();
+	space->session = session;
+	space->referenceType = createInfo->referenceSpaceType;
+	space->offset = createInfo->poseInReferenceSpace;
+	session->spaces.insert(space);
+
+	*out = (XrSpace)space;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetReferenceSpaceBoundsRect(XrSession handle, XrReferenceSpaceType referenceSpaceType, XrExtent2Df* bounds)
+{
+	HR_TIMED();
+	if (referenceSpaceType != XR_REFERENCE_SPACE_TYPE_STAGE) {
+		*bounds = { 0, 0 };
+		return XR_SPACE_BOUNDS_UNAVAILABLE;
+	}
+
+	*bounds = { 2, 2 };
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSpace(XrSession handle, const XrActionSpaceCreateInfo* createInfo, XrSpace* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	auto* action = (Action*)createInfo->action;
+	if (!action || action->type != XR_ACTION_TYPE_POSE_INPUT)
+		return XR_ERROR_ACTION_TYPE_MISMATCH;
+
+	auto* space = new Space();
+	space->session = session;
+	space->action = action;
+	space->subactionPath = createInfo->subactionPath;
+	space->offset = createInfo->poseInActionSpace;
+	session->spaces.insert(space);
+
+	*out = (XrSpace)space;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrLocateSpace(XrSpace spaceHandle, XrSpace baseSpaceHandle, XrTime time, XrSpaceLocation* location)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* space = (Space*)spaceHandle;
+	auto* base = (Space*)baseSpaceHandle;
+	if (!space || !base)
+		return XR_ERROR_HANDLE_INVALID;
+
+	auto* velocity = FindNext<XrSpaceVelocity>(location->next, XR_TYPE_SPACE_VELOCITY);
+	if (velocity) {
+		velocity->velocityFlags = 0;
+		velocity->linearVelocity = { 0, 0, 0 };
+		velocity->angularVelocity = { 0, 0, 0 };
+	}
+
+	XrPosef spacePose, basePose;
+	if (!SpacePose(space, time, spacePose) || !SpacePose(base, time, basePose)) {
+		location->locationFlags = 0;
+		location->pose = identityPose;
+		return XR_SUCCESS;
+	}
+
+	XrPosef baseInverse = PoseInverse(basePose);
+	location->pose = PoseMul(baseInverse, spacePose);
+	location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT
+	    | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+
+	// Find the linear velocity from where the space will be shortly after this
+	if (velocity) {
+		const XrDuration step = 1000000; // 1ms
+		XrPosef nextSpacePose, nextBasePose;
+		if (SpacePose(space, time + step, nextSpacePose) && SpacePose(base, time + step, nextBasePose)) {
+			XrPosef next = PoseMul(PoseInverse(nextBasePose), nextSpacePose);
+			velocity->linearVelocity = {
+				(next.position.x - location->pose.position.x) * 1000,
+				(next.position.y - location->pose.position.y) * 1000,
+				(next.position.z - location->pose.position.z) * 1000,
+			};
+			velocity->velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT;
+		}
+	}
+
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySpace(XrSpace handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* space = (Space*)handle;
+	if (!space || !space->session->spaces.erase(space))
+		return XR_ERROR_HANDLE_INVALID;
+
+	delete space;
+	return XR_SUCCESS;
+}
+
+// ---------------  Swapchains   --------------- //
+
+static const std::vector<int64_t> swapchainFormats = {
+	VK_FORMAT_R8G8B8A8_SRGB,
+	VK_FORMAT_B8G8R8A8_SRGB,
+	VK_FORMAT_R8G8B8A8_UNORM,
+	VK_FORMAT_B8G8R8A8_UNORM,
+	VK_FORMAT_D32_SFLOAT,
+	VK_FORMAT_D16_UNORM,
+};
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainFormats(XrSession handle, uint32_t formatCapacityInput, uint32_t* formatCountOutput, int64_t* formats)
+{
+	HR_TIMED();
+	return TwoCall(formatCapacityInput, formatCountOutput, formats, swapchainFormats);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateSwapchain(XrSession handle, const XrSwapchainCreateInfo* createInfo, XrSwapchain* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (std::find(swapchainFormats.begin(), swapchainFormats.end(), createInfo->format) == swapchainFormats.end())
+		return XR_ERROR_SWAPCHAIN_FORMAT_UNSUPPORTED;
+
+	bool depth = createInfo->format == VK_FORMAT_D32_SFLOAT || createInfo->format == VK_FORMAT_D16_UNORM;
+
+	VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = (VkFormat)createInfo->format;
+	imageInfo.extent = { createInfo->width, createInfo->height, 1 };
+	imageInfo.mipLevels = std::max(createInfo->mipCount, 1u);
+	imageInfo.arrayLayers = std::max(createInfo->arraySize, 1u);
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageInfo.usage |= depth ? VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT : VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+	if (createInfo->usageFlags & XR_SWAPCHAIN_USAGE_UNORDERED_ACCESS_BIT)
+		imageInfo.usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(session->binding.physicalDevice, &memoryProperties);
+
+	auto swapchain = std::make_unique<Swapchain>();
+	swapchain->session = session;
+	swapchain->info = *createInfo;
+	swapchain->info.next = nullptr;
+
+	VkDevice device = session->binding.device;
+	auto cleanup = [&]() {
+		for (size_t i = 0; i < swapchain->images.size(); i++)
+			vkDestroyImage(device, swapchain->images[i], nullptr);
+		for (size_t i = 0; i < swapchain->memory.size(); i++)
+			vkFreeMemory(device, swapchain->memory[i], nullptr);
+	};
+
+	// Nothing ever reads these images, so their layout never has to be transitioned. Applications (including
+	// OpenComposite) transition them from VK_IMAGE_LAYOUT_UNDEFINED before writing to them anyway.
+	uint32_t imageCount = (createInfo->createFlags & XR_SWAPCHAIN_CREATE_STATIC_IMAGE_BIT) ? 1 : 3;
+	for (uint32_t i = 0; i < imageCount; i++) {
+		VkImage image;
+		if (vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+			cleanup();
+			return XR_ERROR_RUNTIME_FAILURE;
+		}
+		swapchain->images.push_back(image);
+
+		VkMemoryRequirements requirements;
+		vkGetImageMemoryRequirements(device, image, &requirements);
+
+		// Prefer device-local memory, but take anything that fits
+		uint32_t memoryType = UINT32_MAX;
+		for (uint32_t type = 0; type < memoryProperties.memoryTypeCount; type++) {
+			if (!(requirements.memoryTypeBits & (1u << type)))
+				continue;
+			if (memoryType == UINT32_MAX || (memoryProperties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+				memoryType = type;
+			if (memoryProperties.memoryTypes[type].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)
+				break;
+		}
+
+		VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+		allocInfo.allocationSize = requirements.size;
+		allocInfo.memoryTypeIndex = memoryType;
+
+		VkDeviceMemory memory;
+		if (memoryType == UINT32_MAX || vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+			cleanup();
+			return XR_ERROR_RUNTIME_FAILURE;
+		}
+		swapchain->memory.push_back(memory);
+
+		if (vkBindImageMemory(device, image, memory, 0) != VK_SUCCESS) {
+			cleanup();
+			return XR_ERROR_RUNTIME_FAILURE;
+		}
+	}
+
+	session->swapchains.insert(swapchain.get());
+	*out = (XrSwapchain)swapchain.release();
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroySwapchain(XrSwapchain handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* swapchain = (Swapchain*)handle;
+	if (!swapchain || !swapchain->session->swapchains.erase(swapchain))
+		return XR_ERROR_HANDLE_INVALID;
+
+	VkDevice device = swapchain->session->binding.device;
+	for (size_t i = 0; i < swapchain->images.size(); i++) {
+		vkDestroyImage(device, swapchain->images[i], nullptr);
+		vkFreeMemory(device, swapchain->memory[i], nullptr);
+	}
+
+	delete swapchain;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateSwapchainImages(XrSwapchain handle, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* swapchain = (Swapchain*)handle;
+	std::vector<XrSwapchainImageVulkanKHR> result;
+	for (VkImage image : swapchain->images) {
+		XrSwapchainImageVulkanKHR item = { XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR };
+		item.image = image;
+		result.push_back(item);
+	}
+
+	return TwoCall(imageCapacityInput, imageCountOutput, (XrSwapchainImageVulkanKHR*)images, result);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAcquireSwapchainImage(XrSwapchain handle, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* swapchain = (Swapchain*)handle;
+	if (swapchain->acquired.size() >= swapchain->images.size())
+		return XR_ERROR_CALL_ORDER_INVALID;
+
+	*index = swapchain->nextImage;
+	swapchain->acquired.push_back(swapchain->nextImage);
+	swapchain->nextImage = (swapchain->nextImage + 1) % swapchain->images.size();
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrWaitSwapchainImage(XrSwapchain handle, const XrSwapchainImageWaitInfo* waitInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* swapchain = (Swapchain*)handle;
+	if (swapchain->acquired.empty() || swapchain->waited)
+		return XR_ERROR_CALL_ORDER_INVALID;
+
+	swapchain->waited = true;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrReleaseSwapchainImage(XrSwapchain handle, const XrSwapchainImageReleaseInfo* releaseInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* swapchain = (Swapchain*)handle;
+	if (swapchain->acquired.empty() || !swapchain->waited)
+		return XR_ERROR_CALL_ORDER_INVALID;
+
+	swapchain->acquired.pop_front();
+	swapchain->waited = false;
+	return XR_SUCCESS;
+}
+
+// ---------------  Actions   --------------- //
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateActionSet(XrInstance handle, const XrActionSetCreateInfo* createInfo, XrActionSet* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* set = new ActionSet();
+	set->name = createInfo->actionSetName;
+	instance->actionSets.insert(set);
+
+	*out = (XrActionSet)set;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyActionSet(XrActionSet handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* set = (ActionSet*)handle;
+	if (!set || !instance->actionSets.erase(set))
+		return XR_ERROR_HANDLE_INVALID;
+
+	for (Action* action : set->actions) {
+		for (auto& [profile, bindings] : instance->suggestedBindings)
+			std::erase_if(bindings, [action](const auto& binding) { return binding.first == action; });
+		delete action;
+	}
+
+	delete set;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrCreateAction(XrActionSet setHandle, const XrActionCreateInfo* createInfo, XrAction* out)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* set = (ActionSet*)setHandle;
+	if (set->attachedTo)
+		return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+
+	auto* action = new Action();
+	action->set = set;
+	action->name = createInfo->actionName;
+	action->type = createInfo->actionType;
+	action->subactionPaths.assign(createInfo->subactionPaths, createInfo->subactionPaths + createInfo->countSubactionPaths);
+	set->actions.push_back(action);
+
+	*out = (XrAction)action;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrDestroyAction(XrAction handle)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* action = (Action*)handle;
+	std::erase(action->set->actions, action);
+	for (auto& [profile, bindings] : instance->suggestedBindings)
+		std::erase_if(bindings, [action](const auto& binding) { return binding.first == action; });
+
+	delete action;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSuggestInteractionProfileBindings(XrInstance handle, const XrInteractionProfileSuggestedBinding* suggestedBindings)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	const std::string* profile = PathString(suggestedBindings->interactionProfile);
+	if (!profile)
+		return XR_ERROR_PATH_INVALID;
+
+	std::vector<std::pair<Action*, std::string>> bindings;
+	for (uint32_t i = 0; i < suggestedBindings->countSuggestedBindings; i++) {
+		const XrActionSuggestedBinding& binding = suggestedBindings->suggestedBindings[i];
+		const std::string* path = PathString(binding.binding);
+		if (!path)
+			return XR_ERROR_PATH_INVALID;
+
+		auto* action = (Action*)binding.action;
+		if (action->set->attachedTo)
+			return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+
+		bindings.emplace_back(action, *path);
+	}
+
+	// Each suggestion replaces the last one for the same profile
+	if (!instance->suggestedBindings.contains(*profile))
+		instance->suggestedProfileOrder.push_back(*profile);
+	instance->suggestedBindings[*profile] = std::move(bindings);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrAttachSessionActionSets(XrSession handle, const XrSessionActionSetsAttachInfo* attachInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (!session->interactionProfile.empty())
+		return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+
+	for (uint32_t i = 0; i < attachInfo->countActionSets; i++)
+		((ActionSet*)attachInfo->actionSets[i])->attachedTo = session;
+
+	// Pick which controllers we're pretending to have: the one requested by the user, otherwise Touch controllers
+	// (since most games have bindings for those), otherwise whatever the application suggested first.
+	const char* requested = getenv("OC_HEADLESS_PROFILE");
+	if (requested && instance->suggestedBindings.contains(requested))
+		session->interactionProfile = requested;
+	else if (instance->suggestedBindings.contains("/interaction_profiles/oculus/touch_controller"))
+		session->interactionProfile = "/interaction_profiles/oculus/touch_controller";
+	else if (!instance->suggestedProfileOrder.empty())
+		session->interactionProfile = instance->suggestedProfileOrder.front();
+
+	if (session->interactionProfile.empty()) {
+		Log("No interaction profiles suggested, controllers will be inactive");
+		session->interactionProfile = "/interaction_profiles/khr/simple_controller";
+	} else {
+		Log("Using interaction profile %s", session->interactionProfile.c_str());
+	}
+
+	XrEventDataInteractionProfileChanged event = { XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED };
+	event.session = handle;
+	QueueEvent((XrEventDataBaseHeader*)&event, sizeof(event));
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetCurrentInteractionProfile(XrSession handle, XrPath topLevelUserPath, XrInteractionProfileState* interactionProfile)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	const std::string* path = PathString(topLevelUserPath);
+	if (!path)
+		return XR_ERROR_PATH_INVALID;
+
+	interactionProfile->interactionProfile = XR_NULL_PATH;
+	if (!session->interactionProfile.empty() && (*path == "/user/hand/left" || *path == "/user/hand/right"))
+		interactionProfile->interactionProfile = GetPath(session->interactionProfile);
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrSyncActions(XrSession handle, const XrActionsSyncInfo* syncInfo)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	if (session->state != XR_SESSION_STATE_FOCUSED)
+		return XR_SESSION_NOT_FOCUSED;
+
+	XrTime now = Now();
+
+	// Inputs only change when they're synced, so work out all the states here
+	for (uint32_t i = 0; i < syncInfo->countActiveActionSets; i++) {
+		auto* set = (ActionSet*)syncInfo->activeActionSets[i].actionSet;
+		if (set->attachedTo != session)
+			return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+
+		for (Action* action : set->actions) {
+			if (action->type == XR_ACTION_TYPE_VIBRATION_OUTPUT)
+				continue;
+
+			std::vector<XrPath> subactionPaths = action->subactionPaths;
+			subactionPaths.push_back(XR_NULL_PATH);
+
+			for (XrPath subactionPath : subactionPaths) {
+				ActionState& state = session->actionStates[{ action, subactionPath }];
+				ActionState newState = ComputeActionState(session, action, subactionPath, now);
+
+				newState.changedSinceLastSync = newState.isActive && state.isActive
+				    && (newState.values[0] != state.values[0] || newState.values[1] != state.values[1]);
+				newState.lastChangeTime = newState.changedSinceLastSync ? now : state.lastChangeTime;
+				state = newState;
+			}
+		}
+	}
+
+	return XR_SUCCESS;
+}
+
+static const ActionState* GetActionState(const XrActionStateGetInfo* getInfo, XrActionType type, XrResult& result)
+{
+	auto* action = (Action*)getInfo->action;
+	if (!action) {
+		result = XR_ERROR_HANDLE_INVALID;
+		return nullptr;
+	}
+
+	if (action->type != type) {
+		result = XR_ERROR_ACTION_TYPE_MISMATCH;
+		return nullptr;
+	}
+
+	Session* session = action->set->attachedTo;
+	if (!session) {
+		result = XR_ERROR_ACTIONSET_NOT_ATTACHED;
+		return nullptr;
+	}
+
+	result = XR_SUCCESS;
+	auto iter = session->actionStates.find({ action, getInfo->subactionPath });
+	if (iter == session->actionStates.end()) {
+		static const ActionState inactive;
+		return &inactive;
+	}
+	return &iter->second;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateBoolean(XrSession handle, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* state)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	XrResult result;
+	const ActionState* actionState = GetActionState(getInfo, XR_ACTION_TYPE_BOOLEAN_INPUT, result);
+	if (!actionState)
+		return result;
+
+	state->isActive = actionState->isActive;
+	state->currentState = actionState->values[0] != 0;
+	state->changedSinceLastSync = actionState->changedSinceLastSync;
+	state->lastChangeTime = actionState->lastChangeTime;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateFloat(XrSession handle, const XrActionStateGetInfo* getInfo, XrActionStateFloat* state)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	XrResult result;
+	const ActionState* actionState = GetActionState(getInfo, XR_ACTION_TYPE_FLOAT_INPUT, result);
+	if (!actionState)
+		return result;
+
+	state->isActive = actionState->isActive;
+	state->currentState = actionState->values[0];
+	state->changedSinceLastSync = actionState->changedSinceLastSync;
+	state->lastChangeTime = actionState->lastChangeTime;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStateVector2f(XrSession handle, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* state)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	XrResult result;
+	const ActionState* actionState = GetActionState(getInfo, XR_ACTION_TYPE_VECTOR2F_INPUT, result);
+	if (!actionState)
+		return result;
+
+	state->isActive = actionState->isActive;
+	state->currentState = { actionState->values[0], actionState->values[1] };
+	state->changedSinceLastSync = actionState->changedSinceLastSync;
+	state->lastChangeTime = actionState->lastChangeTime;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetActionStatePose(XrSession handle, const XrActionStateGetInfo* getInfo, XrActionStatePose* state)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	XrResult result;
+	const ActionState* actionState = GetActionState(getInfo, XR_ACTION_TYPE_POSE_INPUT, result);
+	if (!actionState)
+		return result;
+
+	state->isActive = actionState->isActive;
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrEnumerateBoundSourcesForAction(XrSession handle, const XrBoundSourcesForActionEnumerateInfo* enumerateInfo,
+    uint32_t sourceCapacityInput, uint32_t* sourceCountOutput, XrPath* sources)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	auto* session = (Session*)handle;
+	std::vector<XrPath> result;
+	for (const std::string& binding : GetBindings(session, (Action*)enumerateInfo->action, XR_NULL_PATH))
+		result.push_back(GetPath(binding));
+
+	return TwoCall(sourceCapacityInput, sourceCountOutput, sources, result);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInputSourceLocalizedName(XrSession handle, const XrInputSourceLocalizedNameGetInfo* getInfo,
+    uint32_t bufferCapacityInput, uint32_t* bufferCountOutput, char* buffer)
+{
+	HR_TIMED();
+	std::lock_guard lock(runtimeMutex);
+
+	const std::string* path = PathString(getInfo->sourcePath);
+	if (!path)
+		return XR_ERROR_PATH_INVALID;
+
+	return TwoCallString(bufferCapacityInput, bufferCountOutput, buffer, *path);
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrApplyHapticFeedback(XrSession handle, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback)
+{
+	HR_TIMED();
+	return XR_SUCCESS;
+}
+
+XRAPI_ATTR XrResult XRAPI_CALL xrStopHapticFeedback(XrSession handle, const XrHapticActionInfo* hapticActionInfo)
+{
+	HR_TIMED();
+	return XR_SUCCESS;
+}
+
+// ---------------  Function lookup   --------------- //
+
+#define HR_FUNCTION(name) { #name, (PFN_xrVoidFunction)name }
+
+static const std::unordered_map<std::string, PFN_xrVoidFunction> functions = {
+	HR_FUNCTION(xrGetInstanceProcAddr),
+	HR_FUNCTION(xrEnumerateInstanceExtensionProperties),
+	HR_FUNCTION(xrEnumerateApiLayerProperties),
+	HR_FUNCTION(xrCreateInstance),
+	HR_FUNCTION(xrDestroyInstance),
+	HR_FUNCTION(xrGetInstanceProperties),
+	HR_FUNCTION(xrPollEvent),
+	HR_FUNCTION(xrResultToString),
+	HR_FUNCTION(xrStructureTypeToString),
+	HR_FUNCTION(xrStringToPath),
+	HR_FUNCTION(xrPathToString),
+	HR_FUNCTION(xrConvertTimespecTimeToTimeKHR),
+	HR_FUNCTION(xrConvertTimeToTimespecTimeKHR),
+	HR_FUNCTION(xrGetSystem),
+	HR_FUNCTION(xrGetSystemProperties),
+	HR_FUNCTION(xrEnumerateEnvironmentBlendModes),
+	HR_FUNCTION(xrEnumerateViewConfigurations),
+	HR_FUNCTION(xrGetViewConfigurationProperties),
+	HR_FUNCTION(xrEnumerateViewConfigurationViews),
+	HR_FUNCTION(xrGetVulkanGraphicsRequirementsKHR),
+	HR_FUNCTION(xrGetVulkanInstanceExtensionsKHR),
+	HR_FUNCTION(xrGetVulkanDeviceExtensionsKHR),
+	HR_FUNCTION(xrGetVulkanGraphicsDeviceKHR),
+	HR_FUNCTION(xrCreateSession),
+	HR_FUNCTION(xrDestroySession),
+	HR_FUNCTION(xrBeginSession),
+	HR_FUNCTION(xrRequestExitSession),
+	HR_FUNCTION(xrEndSession),
+	HR_FUNCTION(xrWaitFrame),
+	HR_FUNCTION(xrBeginFrame),
+	HR_FUNCTION(xrEndFrame),
+	HR_FUNCTION(xrLocateViews),
+	HR_FUNCTION(xrEnumerateReferenceSpaces),
+	HR_FUNCTION(xrCreateReferenceSpace),
+	HR_FUNCTION(xrGetReferenceSpaceBoundsRect),
+	HR_FUNCTION(xrCreateActionSpace),
+	HR_FUNCTION(xrLocateSpace),
+	HR_FUNCTION(xrDestroySpace),
+	HR_FUNCTION(xrEnumerateSwapchainFormats),
+	HR_FUNCTION(xrCreateSwapchain),
+	HR_FUNCTION(xrDestroySwapchain),
+	HR_FUNCTION(xrEnumerateSwapchainImages),
+	HR_FUNCTION(xrAcquireSwapchainImage),
+	HR_FUNCTION(xrWaitSwapchainImage),
+	HR_FUNCTION(xrReleaseSwapchainImage),
+	HR_FUNCTION(xrCreateActionSet),
+	HR_FUNCTION(xrDestroyActionSet),
+	HR_FUNCTION(xrCreateAction),
+	HR_FUNCTION(xrDestroyAction),
+	HR_FUNCTION(xrSuggestInteractionProfileBindings),
+	HR_FUNCTION(xrAttachSessionActionSets),
+	HR_FUNCTION(xrGetCurrentInteractionProfile),
+	HR_FUNCTION(xrSyncActions),
+	HR_FUNCTION(xrGetActionStateBoolean),
+	HR_FUNCTION(xrGetActionStateFloat),
+	HR_FUNCTION(xrGetActionStateVector2f),
+	HR_FUNCTION(xrGetActionStatePose),
+	HR_FUNCTION(xrEnumerateBoundSourcesForAction),
+	HR_FUNCTION(xrGetInputSourceLocalizedName),
+	HR_FUNCTION(xrApplyHapticFeedback),
+	HR_FUNCTION(xrStopHapticFeedback),
+};
+
+#undef HR_FUNCTION
+
+XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance handle, const char* name, PFN_xrVoidFunction* function)
+{
+	if (!name || !function)
+		return XR_ERROR_VALIDATION_FAILURE;
+
+	auto iter = functions.find(name);
+	if (iter == functions.end()) {
+		*function = nullptr;
+		return XR_ERROR_FUNCTION_UNSUPPORTED;
+	}
+
+	*function = iter->second;
+	return XR_SUCCESS;
+}
+
+} // namespace headless
+
+extern "C" __attribute__((visibility("default"))) XRAPI_ATTR XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(
+    const XrNegotiateLoaderInfo* loaderInfo, XrNegotiateRuntimeRequest* runtimeRequest)
+{
+	if (!loaderInfo || !runtimeRequest || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO
+	    || runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST)
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION)
+		return XR_ERROR_INITIALIZATION_FAILED;
+
+	runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+	runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+	runtimeRequest->getInstanceProcAddr = headless::xrGetInstanceProcAddr;
+	return XR_SUCCESS;
+}
+
+/**
+ * The total number of OpenXR calls made so far on the current instance, for benchmarks that want to know how
+ * many runtime calls each OpenVR call costs. This is looked up with dlsym, and isn't part of OpenXR.
+ */
+extern "C" __attribute__((visibility("default"))) uint64_t OCHeadlessGetCallCount()
+{
+	std::lock_guard lock(headless::statsMutex);
+
+	uint64_t total = 0;
+	for (const auto& [name, stats] : headless::callStats)
+		total += stats.count;
+	return total;
+}
@@ -9,6 +9,8 @@
 #include "generated/GVRClientCore.gen.h"
 #include "generated/version.h"
 
+#include "Misc/CallCapture.h"
+#include "Misc/Config.h"
 #include "Misc/backtrace.h"
 #include "logging.h"
 #include "steamvr_abi.h"
@@ -355,6 +357,11 @@ VR_INTERFACE void VR_CALLTYPE VR_ShutdownInternal()
 	BackendManager::Reset();
 
 	running = false;
+
+	// Stop these regardless of the current options, which may have changed since they were started. Neither
+	// does anything if it isn't running.
+	CallCapture::Shutdown();
+	oovr_global_configuration.StopWatching();
 }
 
 VR_INTERFACE void* VRClientCoreFactory(const char* pInterfaceName, int* pReturnCode)
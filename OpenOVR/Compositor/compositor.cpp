@@ -3,12 +3,53 @@
 #include "../Misc/Config.h"
 #include "compositor.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <vector>
+
 Compositor::~Compositor()
 {
 	if (chain) {
 		OOVR_FAILED_XR_SOFT_ABORT(xrDestroySwapchain(chain));
 		chain = XR_NULL_HANDLE;
 	}
+	if (depthChain) {
+		OOVR_FAILED_XR_SOFT_ABORT(xrDestroySwapchain(depthChain));
+		depthChain = XR_NULL_HANDLE;
+	}
+	if (pixelChain) {
+		OOVR_FAILED_XR_SOFT_ABORT(xrDestroySwapchain(pixelChain));
+		pixelChain = XR_NULL_HANDLE;
+	}
+}
+
+void CompositorMirror::AddReference()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	references++;
+}
+
+int CompositorMirror::ReleaseReference()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (references == 0) {
+		OOVR_LOG_ONCE("WARNING: Mirror texture released more times than it was acquired");
+		return 0;
+	}
+
+	if (--references == 0)
+		FreeImage();
+	return references;
+}
+
+void CompositorMirror::Detach()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	detached = true;
+	FreeImage();
 }
 
 void Compositor::Invoke(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, XrSwapchainSubImage& subImage, std::optional<XruEye> eye, vr::EVRSubmitFlags submitFlags)
@@ -50,3 +91,114 @@ bool Compositor::CalculateViewport(const vr::VRTextureBounds_t* ptrBounds, int32
 	}
 	return submitVerticallyFlipped;
 }
+
+bool Compositor::InvokeDepth(const vr::VRTextureDepthInfo_t& depth, const vr::VRTextureBounds_t* bounds, XrCompositionLayerDepthInfoKHR& info)
+{
+	if (!depth.handle)
+		return false;
+
+	// With the inversion done in the compositor the colour image is cropped while it's copied, which we don't
+	// do for depth, so the two wouldn't line up.
+	if (oovr_global_configuration.InvertUsingShaders()) {
+		OOVR_LOG_ONCE("Not submitting depth, as it's not supported with invertUsingShaders");
+		return false;
+	}
+
+	// The projection matrix maps view-space depth to [0,1] - work backwards from that to find the distances
+	// of the planes the depth buffer's 0 and 1 values correspond to. This is what the runtime needs, and works
+	// regardless of whether the game uses reversed Z or not.
+	// With the D3D convention OpenVR uses, depth = (m22 * z + m23) / -z where z is the view-space Z coordinate.
+	// Infinite projections (with the infinite plane at either end) are allowed by the extension.
+	float m22 = depth.mProjection.m[2][2];
+	float m23 = depth.mProjection.m[2][3];
+	float nearZ = m22 == 0 ? std::numeric_limits<float>::infinity() : m23 / m22;
+	float farZ = m22 == -1 ? std::numeric_limits<float>::infinity() : m23 / (m22 + 1);
+	if (!(nearZ > 0) || !(farZ > 0) || nearZ == farZ) {
+		OOVR_LOG_ONCE("Not submitting depth, as the game's depth projection matrix is unsupported");
+		return false;
+	}
+
+	if (!CopyDepthToSwapchain(depth))
+		return false;
+
+	info = { XR_TYPE_COMPOSITION_LAYER_DEPTH_INFO_KHR };
+	info.subImage.swapchain = depthChain;
+	info.subImage.imageArrayIndex = 0;
+	CalculateViewport(bounds, (int32_t)depthCreateInfo.width, (int32_t)depthCreateInfo.height, true, info.subImage.imageRect);
+
+	// vRange is the range of values the game wrote into the depth buffer, ie the viewport's depth range
+	info.minDepth = depth.vRange.v[0];
+	info.maxDepth = depth.vRange.v[1];
+	if (info.minDepth >= info.maxDepth) {
+		info.minDepth = 0;
+		info.maxDepth = 1;
+	}
+	info.nearZ = nearZ;
+	info.farZ = farZ;
+
+	return true;
+}
+
+bool Compositor::IsSwapchainFormatSupported(int64_t format)
+{
+	uint32_t formatCount;
+	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainFormats(xr_session.get(), 0, &formatCount, nullptr));
+	std::vector<int64_t> formats(formatCount);
+	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainFormats(xr_session.get(), formatCount, &formatCount, formats.data()));
+
+	return std::count(formats.begin(), formats.end(), format) != 0;
+}
+
+bool Compositor::CheckCreatePixelSwapchain(int64_t format, int32_t width, int32_t height)
+{
+	XrSwapchainCreateInfo desc = { XR_TYPE_SWAPCHAIN_CREATE_INFO };
+	// Vulkan and D3D12 hand the images back to the runtime in the colour attachment layout/state, which needs this usage
+	desc.usageFlags = XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT | XR_SWAPCHAIN_USAGE_SAMPLED_BIT | XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT;
+	desc.format = format;
+	desc.sampleCount = 1;
+	desc.width = width;
+	desc.height = height;
+	desc.faceCount = 1;
+	desc.arraySize = 1;
+	desc.mipCount = 1;
+
+	if (pixelChain && memcmp(&desc, &pixelCreateInfo, sizeof(desc)) == 0)
+		return false;
+
+	if (pixelChain) {
+		OOVR_FAILED_XR_ABORT(xrDestroySwapchain(pixelChain));
+		pixelChain = XR_NULL_HANDLE;
+	}
+
+	OOVR_LOGF("Creating swapchain for OpenComposite's own images: %dx%d with format %" PRIi64, width, height, format);
+	pixelCreateInfo = desc;
+	OOVR_FAILED_XR_ABORT(xrCreateSwapchain(xr_session.get(), &desc, &pixelChain));
+	return true;
+}
+
+uint32_t Compositor::AcquirePixelImage()
+{
+	XrSwapchainImageAcquireInfo acquireInfo{ XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+	uint32_t index = 0;
+	OOVR_FAILED_XR_ABORT(xrAcquireSwapchainImage(pixelChain, &acquireInfo, &index));
+
+	XrSwapchainImageWaitInfo waitInfo{ XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+	waitInfo.timeout = 500000000; // 500ms, retried until the runtime is done with the image
+	XrResult res;
+	do {
+		OOVR_FAILED_XR_ABORT(res = xrWaitSwapchainImage(pixelChain, &waitInfo));
+	} while (res == XR_TIMEOUT_EXPIRED);
+
+	return index;
+}
+
+void Compositor::ReleasePixelImage(XrSwapchainSubImage& subImage)
+{
+	XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(pixelChain, &releaseInfo));
+
+	subImage.swapchain = pixelChain;
+	subImage.imageArrayIndex = 0;
+	subImage.imageRect.offset = { 0, 0 };
+	subImage.imageRect.extent = { (int32_t)pixelCreateInfo.width, (int32_t)pixelCreateInfo.height };
+}
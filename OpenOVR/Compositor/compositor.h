@@ -11,6 +11,7 @@
 #include "../Misc/xrutil.h"
 
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -20,6 +21,53 @@ using Microsoft::WRL::ComPtr;
 
 typedef unsigned int GLuint;
 
+/**
+ * A copy of the images a compositor submits, for GetMirrorTextureD3D11 and GetMirrorTextureGL. The image itself is
+ * API-specific, and implemented by the compositors that support it.
+ *
+ * This is shared between the compositor that fills it in and each reference handed out to the game, so releasing a
+ * reference always releases the mirror it was taken from, even if the compositor has since been replaced. Images
+ * are only copied into it while at least one reference is held, so games pay nothing for it unless a streaming or
+ * spectator tool is actually using it.
+ */
+class CompositorMirror {
+public:
+	virtual ~CompositorMirror() = default;
+
+	void AddReference();
+
+	/**
+	 * Drop a reference, freeing the image if it was the last one. Returns the number of references left.
+	 */
+	int ReleaseReference();
+
+	/**
+	 * Free the image, for when the compositor that owns it is destroyed. Any references the game still holds keep
+	 * this object alive so they can be released, but nothing is copied into it any more.
+	 */
+	void Detach();
+
+	/**
+	 * Check if images should be copied into the mirror. This must be called with mutex held.
+	 */
+	bool IsActive() const { return references > 0 && !detached; }
+
+	// Held while the image is created, copied into or freed. References may be released from any thread, so this
+	// stops the image being freed part way through a submit.
+	std::mutex mutex;
+
+protected:
+	/**
+	 * Free the image. This is called with mutex held, and may be called more than once.
+	 */
+	virtual void FreeImage() = 0;
+
+private:
+	// Both guarded by mutex
+	int references = 0;
+	bool detached = false;
+};
+
 class Compositor {
 public:
 	virtual ~Compositor();
@@ -27,6 +75,16 @@ public:
 	void Invoke(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, XrSwapchainSubImage& subImage, std::optional<XruEye> eye = std::nullopt, vr::EVRSubmitFlags submitFlags = vr::Submit_Default);
 	bool CalculateViewport(const vr::VRTextureBounds_t* bounds, int32_t width, int32_t height, bool supportsInvert, XrRect2Di& viewport);
 
+	/**
+	 * Copy the depth texture submitted alongside a colour texture (with Submit_TextureWithDepth) into
+	 * a depth swapchain, and fill out the info required to attach it to the projection view with
+	 * XR_KHR_composition_layer_depth.
+	 *
+	 * This must be called after Invoke for the same frame. Returns false if the depth can't be submitted, in
+	 * which case the projection view should be submitted without depth.
+	 */
+	bool InvokeDepth(const vr::VRTextureDepthInfo_t& depth, const vr::VRTextureBounds_t* bounds, XrCompositionLayerDepthInfoKHR& info);
+
 	virtual void InvokeCubemap(const vr::Texture_t* textures) = 0;
 	virtual bool SupportsCubemap() { return false; }
 
@@ -41,9 +99,49 @@ public:
 	virtual void LoadSubmitContext() {};
 	virtual void ResetSubmitContext() {};
 
+	/**
+	 * Write an image OpenComposite has drawn itself (such as the keyboard) into a separate swapchain owned by this
+	 * compositor, and set subImage to cover it. The pixels are tightly-packed 8-bit sRGB RGBA, top row first. The
+	 * swapchain is (re)created if the size changes, and it keeps showing the image until this is next called, so
+	 * this only needs calling when the image changes.
+	 *
+	 * This must be called from the same thread as Invoke. Returns false if it's not supported for this graphics API.
+	 */
+	virtual bool WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage) { return false; }
+
+	XrSwapchain GetPixelSwapchain() const { return pixelChain; }
+
 protected:
+	/**
+	 * Create pixelChain for WritePixels with the given format and size, if it doesn't already match. Returns
+	 * true if a new swapchain was created, in which case its images need enumerating again.
+	 */
+	bool CheckCreatePixelSwapchain(int64_t format, int32_t width, int32_t height);
+
+	/**
+	 * Acquire and wait for the next image of pixelChain, returning its index.
+	 */
+	uint32_t AcquirePixelImage();
+
+	/**
+	 * Release the image from AcquirePixelImage, and point subImage at it.
+	 */
+	void ReleasePixelImage(XrSwapchainSubImage& subImage);
+
 	virtual void CopyToSwapchain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, std::optional<XruEye> eye, vr::EVRSubmitFlags submitFlags) = 0;
 
+	/**
+	 * Copy the whole of a depth texture (of the same type as the colour texture) into depthChain, creating
+	 * or recreating it as required. Returns false if this compositor or the runtime can't handle the texture,
+	 * in which case depthChain is left untouched.
+	 */
+	virtual bool CopyDepthToSwapchain(const vr::VRTextureDepthInfo_t& depth) { return false; }
+
+	/**
+	 * Check if the runtime can create a swapchain with the given format.
+	 */
+	static bool IsSwapchainFormatSupported(int64_t format);
+
 	XrSwapchain chain = XR_NULL_HANDLE;
 
 	// The request used to create the current swapchain. This can be used to check if the swapchain needs recreating.
@@ -52,4 +150,13 @@ protected:
 	// The format specified by the game when creating the swapchain. This is used for verifying the format hasn't changed, since
 	// we do fiddle with it a bit to get the SRGB stuff done correctly.
 	int64_t createInfoFormat;
+
+	// The swapchain holding the depth textures, if the game submits them. This is created the same way as
+	// chain, except with a depth format and usage.
+	XrSwapchain depthChain = XR_NULL_HANDLE;
+	XrSwapchainCreateInfo depthCreateInfo{};
+
+	// The swapchain used by WritePixels
+	XrSwapchain pixelChain = XR_NULL_HANDLE;
+	XrSwapchainCreateInfo pixelCreateInfo{};
 };
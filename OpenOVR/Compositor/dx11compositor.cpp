@@ -143,6 +143,8 @@ DX11Compositor::~DX11Compositor()
 
 	resolvedMSAATextures.clear();
 
+	mirror->Detach();
+
 	context->Release();
 	device->Release();
 }
@@ -397,11 +399,130 @@ void DX11Compositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::VRT
 		}
 	}
 
+	// Copy from the swapchain image rather than the game's texture, as that's already been cropped, resolved and flipped
+	{
+		std::lock_guard<std::mutex> lock(mirror->mutex);
+		if (mirror->IsActive()) {
+			CheckCreateMirror();
+			if (mirror->texture)
+				context->CopySubresourceRegion(mirror->texture, 0, 0, 0, 0, imagesHandles[currentIndex].texture, 0, nullptr);
+		}
+	}
+
 	// Release the swapchain - OpenXR will use the last-released image in a swapchain
 	XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
 	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(chain, &releaseInfo));
 }
 
+void DX11Compositor::CheckCreateMirror()
+{
+	// Nothing has been submitted yet, so we don't know what size to make it
+	if (!chain)
+		return;
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = createInfo.width;
+	desc.Height = createInfo.height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = (DXGI_FORMAT)createInfo.format;
+	desc.SampleDesc.Count = 1;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED;
+
+	if (mirror->texture) {
+		D3D11_TEXTURE2D_DESC current;
+		mirror->texture->GetDesc(&current);
+		if (current.Width == desc.Width && current.Height == desc.Height && current.Format == desc.Format)
+			return;
+
+		// Any views the consumer already has will keep showing the old image
+		OOVR_LOG_ONCE("Swapchain changed while mirrored, recreating mirror texture");
+		mirror->texture->Release();
+		mirror->texture = nullptr;
+	}
+
+	if (FAILED(device->CreateTexture2D(&desc, nullptr, &mirror->texture))) {
+		OOVR_LOG_ONCE("WARNING: Failed to create mirror texture");
+		mirror->texture = nullptr;
+	}
+}
+
+HRESULT DX11Compositor::CreateMirrorView(ID3D11Device* consumer, ID3D11ShaderResourceView** view, std::shared_ptr<CompositorMirror>& reference)
+{
+	mirror->AddReference();
+
+	HRESULT hr;
+	{
+		std::lock_guard<std::mutex> lock(mirror->mutex);
+		hr = OpenMirrorView(consumer, view);
+	}
+
+	if (FAILED(hr)) {
+		mirror->ReleaseReference();
+		return hr;
+	}
+
+	reference = mirror;
+	return S_OK;
+}
+
+HRESULT DX11Compositor::OpenMirrorView(ID3D11Device* consumer, ID3D11ShaderResourceView** view)
+{
+	CheckCreateMirror();
+	if (!mirror->texture)
+		return E_FAIL;
+
+	if (consumer == device)
+		return device->CreateShaderResourceView(mirror->texture, nullptr, view);
+
+	ComPtr<IDXGIResource> resource;
+	HRESULT hr = mirror->texture->QueryInterface(IID_PPV_ARGS(&resource));
+	if (FAILED(hr))
+		return hr;
+
+	HANDLE handle;
+	hr = resource->GetSharedHandle(&handle);
+	if (FAILED(hr))
+		return hr;
+
+	ComPtr<ID3D11Texture2D> shared;
+	hr = consumer->OpenSharedResource(handle, IID_PPV_ARGS(&shared));
+	if (FAILED(hr))
+		return hr;
+
+	return consumer->CreateShaderResourceView(shared.Get(), nullptr, view);
+}
+
+void DX11Compositor::Mirror::FreeImage()
+{
+	if (texture) {
+		texture->Release();
+		texture = nullptr;
+	}
+}
+
+bool DX11Compositor::WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage)
+{
+	if (!pixelChain && !IsSwapchainFormatSupported(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB))
+		return false;
+
+	if (CheckCreatePixelSwapchain(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, width, height)) {
+		uint32_t imageCount;
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain, 0, &imageCount, nullptr));
+		pixelImages = std::vector<XrSwapchainImageD3D11KHR>(imageCount, { XR_TYPE_SWAPCHAIN_IMAGE_D3D11_KHR });
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain,
+		    pixelImages.size(), &imageCount, (XrSwapchainImageBaseHeader*)pixelImages.data()));
+	}
+
+	uint32_t index = AcquirePixelImage();
+	context->UpdateSubresource(pixelImages.at(index).texture, 0, nullptr, pixels, width * 4, 0);
+	ReleasePixelImage(subImage);
+
+	return true;
+}
+
 void DX11Compositor::InvokeCubemap(const vr::Texture_t* textures)
 {
 	CheckCreateSwapChain(&textures[0], nullptr, true);
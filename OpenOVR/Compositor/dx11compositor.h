@@ -16,9 +16,25 @@ public:
 
 	ID3D11Device* GetDevice() { return device; }
 
+	/**
+	 * Take a reference to this eye's mirror image, and create a shader resource view of it for the given device. This
+	 * may be the game's device, or a different one in which case the mirror is opened through its shared handle.
+	 *
+	 * On success reference is set to the mirror, which should be released when the view is.
+	 */
+	HRESULT CreateMirrorView(ID3D11Device* consumer, ID3D11ShaderResourceView** view, std::shared_ptr<CompositorMirror>& reference);
+
+	bool WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage) override;
+
 protected:
 	void CheckCreateSwapChain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, bool cube);
 
+	// (Re)create the mirror texture to match the swapchain, if required. This must be called with mirror->mutex held.
+	void CheckCreateMirror();
+
+	// Create a view of the mirror texture for CreateMirrorView. This must be called with mirror->mutex held.
+	HRESULT OpenMirrorView(ID3D11Device* consumer, ID3D11ShaderResourceView** view);
+
 	void ThrowIfFailed(HRESULT test);
 
 	bool CheckChainCompatible(D3D11_TEXTURE2D_DESC& inputDesc, vr::EColorSpace colourSpace);
@@ -35,6 +51,21 @@ protected:
 	std::vector<ID3D11RenderTargetView*> swapchain_rtvs;
 	std::vector<ID3D11Texture2D*> resolvedMSAATextures;
 
+	class Mirror : public CompositorMirror {
+	public:
+		// A copy of the last image submitted to the swapchain, only kept up to date while the mirror is active
+		ID3D11Texture2D* texture = nullptr;
+
+	protected:
+		void FreeImage() override;
+	};
+
+	// This is created up front, so it never changes while another thread might be submitting
+	std::shared_ptr<Mirror> mirror = std::make_shared<Mirror>();
+
+	// The images of pixelChain, for WritePixels
+	std::vector<XrSwapchainImageD3D11KHR> pixelImages;
+
 	struct DxgiFormatInfo {
 		/// The different versions of this format, set to DXGI_FORMAT_UNKNOWN if absent.
 		/// Both the SRGB and linear formats should be UNORM.
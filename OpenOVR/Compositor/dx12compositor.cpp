@@ -4,6 +4,7 @@
 
 #include "dx12compositor.h"
 
+#include <cstring>
 #include <string>
 
 #include <atlbase.h>
@@ -45,6 +46,11 @@ DX12Compositor::~DX12Compositor()
 		CloseHandle(event);
 	}
 
+	if (pixelFence) {
+		WaitForFence(pixelFence.Get(), pixelFenceValue, pixelFenceEvent);
+		CloseHandle(pixelFenceEvent);
+	}
+
 	device->Release();
 }
 
@@ -245,6 +251,99 @@ void DX12Compositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::VRT
 	++currentFenceValue;
 }
 
+bool DX12Compositor::WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage)
+{
+	if (!pixelChain && !IsSwapchainFormatSupported(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB))
+		return false;
+
+	if (!pixelFence) {
+		pixelFenceEvent = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		OOVR_FAILED_DX_ABORT(device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&pixelFence)));
+		OOVR_FAILED_DX_ABORT(device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&pixelCommandAllocator)));
+		OOVR_FAILED_DX_ABORT(device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+		    pixelCommandAllocator.Get(), nullptr, IID_PPV_ARGS(&pixelCommandList)));
+		pixelCommandList->Close();
+	}
+
+	// The upload buffer and command list are reused, so the last upload must be finished before touching them
+	WaitForFence(pixelFence.Get(), pixelFenceValue, pixelFenceEvent);
+
+	if (CheckCreatePixelSwapchain(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, width, height)) {
+		uint32_t imageCount;
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain, 0, &imageCount, nullptr));
+		pixelImages = std::vector<XrSwapchainImageD3D12KHR>(imageCount, { XR_TYPE_SWAPCHAIN_IMAGE_D3D12_KHR });
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain,
+		    pixelImages.size(), &imageCount, (XrSwapchainImageBaseHeader*)pixelImages.data()));
+
+		// Rows in the upload buffer have to be aligned, so let D3D12 lay it out to match the images
+		D3D12_RESOURCE_DESC imageDesc = pixelImages.at(0).texture->GetDesc();
+		UINT64 uploadSize;
+		device->GetCopyableFootprints(&imageDesc, 0, 1, 0, &pixelFootprint, nullptr, nullptr, &uploadSize);
+
+		D3D12_HEAP_PROPERTIES heap = {};
+		heap.Type = D3D12_HEAP_TYPE_UPLOAD;
+
+		D3D12_RESOURCE_DESC bufferDesc = {};
+		bufferDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+		bufferDesc.Width = uploadSize;
+		bufferDesc.Height = 1;
+		bufferDesc.DepthOrArraySize = 1;
+		bufferDesc.MipLevels = 1;
+		bufferDesc.SampleDesc.Count = 1;
+		bufferDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+
+		pixelUploadBuffer.Reset();
+		OOVR_FAILED_DX_ABORT(device->CreateCommittedResource(&heap, D3D12_HEAP_FLAG_NONE, &bufferDesc,
+		    D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, IID_PPV_ARGS(&pixelUploadBuffer)));
+		OOVR_FAILED_DX_ABORT(pixelUploadBuffer->Map(0, nullptr, &pixelUploadData));
+	}
+
+	size_t rowSize = (size_t)width * 4;
+	for (int32_t y = 0; y < height; y++) {
+		uint8_t* row = (uint8_t*)pixelUploadData + pixelFootprint.Offset + (size_t)pixelFootprint.Footprint.RowPitch * y;
+		memcpy(row, (const uint8_t*)pixels + rowSize * y, rowSize);
+	}
+
+	uint32_t index = AcquirePixelImage();
+	ID3D12Resource* image = pixelImages.at(index).texture;
+
+	pixelCommandAllocator->Reset();
+	pixelCommandList->Reset(pixelCommandAllocator.Get(), nullptr);
+
+	// The runtime hands out colour images in the render target state, and expects them back in it
+	D3D12_RESOURCE_BARRIER barrier = {};
+	barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	barrier.Transition.pResource = image;
+	barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+	pixelCommandList->ResourceBarrier(1, &barrier);
+
+	D3D12_TEXTURE_COPY_LOCATION dst = {};
+	dst.pResource = image;
+	dst.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	dst.SubresourceIndex = 0;
+
+	D3D12_TEXTURE_COPY_LOCATION src = {};
+	src.pResource = pixelUploadBuffer.Get();
+	src.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	src.PlacedFootprint = pixelFootprint;
+
+	pixelCommandList->CopyTextureRegion(&dst, 0, 0, 0, &src, nullptr);
+
+	barrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+	barrier.Transition.StateAfter = D3D12_RESOURCE_STATE_RENDER_TARGET;
+	pixelCommandList->ResourceBarrier(1, &barrier);
+
+	pixelCommandList->Close();
+	ID3D12CommandList* set[] = { pixelCommandList.Get() };
+	queue->ExecuteCommandLists(1, set);
+	queue->Signal(pixelFence.Get(), ++pixelFenceValue);
+
+	ReleasePixelImage(subImage);
+	return true;
+}
+
 void DX12Compositor::InvokeCubemap(const vr::Texture_t* textures)
 {
 	CheckCreateSwapChain(&textures[0], nullptr, true);
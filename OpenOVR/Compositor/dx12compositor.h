@@ -17,6 +17,8 @@ public:
 
 	ComPtr<ID3D12Device> GetDevice() { return device; }
 
+	bool WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage) override;
+
 private:
 	void CheckCreateSwapChain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, bool cube);
 
@@ -37,6 +39,20 @@ private:
 
 	std::vector<XrSwapchainImageD3D12KHR> imagesHandles;
 
+	// The images of pixelChain, for WritePixels
+	std::vector<XrSwapchainImageD3D12KHR> pixelImages;
+
+	// The upload buffer WritePixels copies from, laid out to match the pixelChain images, which stays mapped. The
+	// keyboard only redraws when it changes, so there's just the one, guarded by pixelFence.
+	ComPtr<ID3D12Resource> pixelUploadBuffer;
+	void* pixelUploadData = nullptr;
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT pixelFootprint{};
+	ComPtr<ID3D12CommandAllocator> pixelCommandAllocator;
+	ComPtr<ID3D12GraphicsCommandList> pixelCommandList;
+	ComPtr<ID3D12Fence> pixelFence;
+	HANDLE pixelFenceEvent = nullptr;
+	UINT64 pixelFenceValue = 0;
+
 	struct DxgiFormatInfo {
 		/// The different versions of this format, set to DXGI_FORMAT_UNKNOWN if absent.
 		/// Both the SRGB and linear formats should be UNORM.
@@ -29,9 +29,12 @@ typedef void(APIENTRY* PFNGLGENFRAMEBUFFERSPROC)(GLsizei n, GLuint* framebuffers
 typedef void(APIENTRY* PFNGLBINDFRAMEBUFFERPROC)(GLenum target, GLuint framebuffer);
 typedef void(APIENTRY* PFNGLBLITFRAMEBUFFERPROC)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
 typedef void(APIENTRY* PFNGLFRAMEBUFFERTEXTURE2DEXTPROC)(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+typedef void(APIENTRY* PFNGLBINDBUFFERPROC)(GLenum target, GLuint buffer);
 #define GL_FRAMEBUFFER 0x8D40
 #define GL_READ_FRAMEBUFFER 0x8CA8
 #define GL_COLOR_ATTACHMENT0 0x8CE0
+#define GL_PIXEL_UNPACK_BUFFER 0x88EC
+#define GL_PIXEL_UNPACK_BUFFER_BINDING 0x88EF
 #endif
 
 static PFNGLGETTEXTURELEVELPARAMETERIVPROC glGetTextureLevelParameteriv = nullptr;
@@ -40,6 +43,7 @@ static PFNGLBINDFRAMEBUFFERPROC glBindFramebuffer = nullptr;
 static PFNGLGENFRAMEBUFFERSPROC glGenFramebuffers = nullptr;
 static PFNGLBLITFRAMEBUFFERPROC glBlitFramebuffer = nullptr;
 static PFNGLFRAMEBUFFERTEXTURE2DEXTPROC glFramebufferTexture2D = nullptr;
+static PFNGLBINDBUFFERPROC glBindBuffer = nullptr;
 
 static void* getGlProcAddr(const char* name)
 {
@@ -61,22 +65,23 @@ GLCompositor::GLCompositor(GLuint initialTexture)
 		LOAD_FUNC(glGenFramebuffers);
 		LOAD_FUNC(glBlitFramebuffer);
 		LOAD_FUNC(glFramebufferTexture2D);
+		LOAD_FUNC(glBindBuffer);
 	}
 #undef LOAD_FUNC
 	glGenFramebuffers(2, fboId);
 }
 
-void GLCompositor::ReadSwapchainImages()
+void GLCompositor::ReadSwapchainImages(XrSwapchain swapchain, std::vector<GLuint>& out)
 {
 	// Enumerate all the swapchain images
 	uint32_t imageCount;
-	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(chain, 0, &imageCount, nullptr));
+	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(swapchain, 0, &imageCount, nullptr));
 	auto handles = std::vector<XrSwapchainImageOpenGLKHR>(imageCount, { XR_TYPE_SWAPCHAIN_IMAGE_OPENGL_KHR });
-	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(chain, imageCount, &imageCount, (XrSwapchainImageBaseHeader*)handles.data()));
+	OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(swapchain, imageCount, &imageCount, (XrSwapchainImageBaseHeader*)handles.data()));
 
-	images.clear();
+	out.clear();
 	for (const XrSwapchainImageOpenGLKHR& img : handles) {
-		images.push_back(img.image);
+		out.push_back(img.image);
 	}
 }
 
@@ -86,6 +91,13 @@ void GLCompositor::ReadSwapchainImages()
 
 #if defined(SUPPORT_GL) || defined(SUPPORT_GLES)
 
+GLBaseCompositor::~GLBaseCompositor()
+{
+	// Free the mirror texture now rather than when the game releases it, since it'll never be updated again. The
+	// compositors are destroyed from the game's thread, so its context is still current.
+	mirror->Detach();
+}
+
 void GLBaseCompositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, std::optional<XruEye>, vr::EVRSubmitFlags)
 {
 	// TODO: support array textures
@@ -159,6 +171,12 @@ void GLBaseCompositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::V
 		OOVR_LOG_ONCE("WARNING: OpenGL texture copy failed!");
 	}
 
+	{
+		std::lock_guard<std::mutex> lock(mirror->mutex);
+		if (mirror->IsActive())
+			CopyToMirror(dst);
+	}
+
 #if defined(SUPPORT_GL) && !defined(_WIN32)
 	const auto binding = (XrGraphicsBindingOpenGLXlibKHR*)((XrBackend*)BackendManager::Instance().GetBackendInstance())->GetCurrentGraphicsBinding();
 	if (binding->type == XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR && binding->glxContext != glXGetCurrentContext())
@@ -170,6 +188,106 @@ void GLBaseCompositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::V
 	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(chain, &releaseInfo));
 }
 
+std::shared_ptr<CompositorMirror> GLBaseCompositor::AcquireMirror(GLuint* texture)
+{
+	mirror->AddReference();
+
+	std::lock_guard<std::mutex> lock(mirror->mutex);
+	if (!mirror->texture)
+		glGenTextures(1, &mirror->texture);
+	*texture = mirror->texture;
+	return mirror;
+}
+
+void GLBaseCompositor::CopyToMirror(GLuint image)
+{
+	const XrSwapchainCreateInfo& current = mirror->createInfo;
+	if (current.width != createInfo.width || current.height != createInfo.height || current.format != createInfo.format) {
+		mirror->createInfo = createInfo;
+
+		GLint previous;
+		glGetIntegerv(GL_TEXTURE_BINDING_2D, &previous);
+		glBindTexture(GL_TEXTURE_2D, mirror->texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, (GLint)createInfo.format, (GLsizei)createInfo.width, (GLsizei)createInfo.height, 0,
+		    GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+		// There's only one mip level, so the default mipmapped filter would leave the texture incomplete
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glBindTexture(GL_TEXTURE_2D, previous);
+	}
+
+	// The swapchain image has already been cropped and flipped, so this is always a straight copy
+	glCopyImageSubData(
+	    image, GL_TEXTURE_2D, 0, 0, 0, 0,
+	    mirror->texture, GL_TEXTURE_2D, 0, 0, 0, 0,
+	    (int)createInfo.width, (int)createInfo.height, 1);
+}
+
+void GLBaseCompositor::Mirror::FreeImage()
+{
+	// This is called from ReleaseSharedGLTexture or the compositor's destructor, both with the game's context current
+	if (texture) {
+		glDeleteTextures(1, &texture);
+		texture = 0;
+	}
+	createInfo = {};
+}
+
+bool GLBaseCompositor::WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage)
+{
+	const int64_t format = 35907; // GL_SRGB8_ALPHA8 (0x8C43)
+	if (!pixelChain && !IsSwapchainFormatSupported(format))
+		return false;
+
+	if (CheckCreatePixelSwapchain(format, width, height))
+		ReadSwapchainImages(pixelChain, pixelImages);
+
+	size_t rowSize = (size_t)width * 4;
+	flippedPixels.resize(rowSize * height);
+	for (int32_t y = 0; y < height; y++) {
+		memcpy(flippedPixels.data() + rowSize * (height - 1 - y), (const uint8_t*)pixels + rowSize * y, rowSize);
+	}
+
+	uint32_t index = AcquirePixelImage();
+
+	// This runs in the middle of the game's rendering, so put back everything that affects the upload afterwards.
+	// Without this, a pixel unpack buffer bound by the game would have our pointer treated as an offset into it.
+	GLint previousTexture, previousUnpackBuffer, previousAlignment, previousRowLength, previousSkipRows, previousSkipPixels;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &previousTexture);
+	glGetIntegerv(GL_PIXEL_UNPACK_BUFFER_BINDING, &previousUnpackBuffer);
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &previousAlignment);
+	glGetIntegerv(GL_UNPACK_ROW_LENGTH, &previousRowLength);
+	glGetIntegerv(GL_UNPACK_SKIP_ROWS, &previousSkipRows);
+	glGetIntegerv(GL_UNPACK_SKIP_PIXELS, &previousSkipPixels);
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+
+	glBindTexture(GL_TEXTURE_2D, pixelImages.at(index));
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, flippedPixels.data());
+
+	glBindTexture(GL_TEXTURE_2D, previousTexture);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, previousUnpackBuffer);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, previousAlignment);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, previousRowLength);
+	glPixelStorei(GL_UNPACK_SKIP_ROWS, previousSkipRows);
+	glPixelStorei(GL_UNPACK_SKIP_PIXELS, previousSkipPixels);
+
+#if defined(SUPPORT_GL) && !defined(_WIN32)
+	// Same as for the colour image, the runtime's context might not see our upload otherwise
+	const auto binding = (XrGraphicsBindingOpenGLXlibKHR*)((XrBackend*)BackendManager::Instance().GetBackendInstance())->GetCurrentGraphicsBinding();
+	if (binding->type == XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR && binding->glxContext != glXGetCurrentContext())
+		glFinish();
+#endif
+
+	ReleasePixelImage(subImage);
+	return true;
+}
+
 void GLBaseCompositor::InvokeCubemap(const vr::Texture_t* textures)
 {
 	OOVR_ABORT("GLCompositor::InvokeCubemap: Not yet supported!");
@@ -234,7 +352,86 @@ void GLBaseCompositor::CheckCreateSwapChain(int width, int height, vr::EColorSpa
 	OOVR_FAILED_XR_ABORT(xrCreateSwapchain(xr_session.get(), &desc, &chain));
 
 	// Enumerate all the swapchain images
-	ReadSwapchainImages();
+	ReadSwapchainImages(chain, images);
+}
+
+bool GLBaseCompositor::CopyDepthToSwapchain(const vr::VRTextureDepthInfo_t& depth)
+{
+	while (glGetError() != GL_NO_ERROR) {
+	}
+
+	auto src = (GLuint)(intptr_t)depth.handle;
+
+	GLsizei width, height, format;
+	glBindTexture(GL_TEXTURE_2D, src);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	bool usable = depthChain != XR_NULL_HANDLE && depthCreateInfo.width == (uint32_t)width && depthCreateInfo.height == (uint32_t)height
+	    && depthCreateInfo.format == format;
+
+	if (!usable) {
+		// glCopyImageSubData requires the formats to be compatible, so there's no fallback format we can use here
+		if (!IsSwapchainFormatSupported(format)) {
+			OOVR_LOGF("Not submitting depth, the runtime doesn't support OpenGL depth format %d", format);
+			return false;
+		}
+
+		OOVR_LOGF("Creating new OpenGL depth swapchain: %dx%d with format %d", width, height, format);
+
+		if (depthChain) {
+			OOVR_FAILED_XR_ABORT(xrDestroySwapchain(depthChain));
+			depthChain = XR_NULL_HANDLE;
+		}
+
+		depthCreateInfo = { XR_TYPE_SWAPCHAIN_CREATE_INFO };
+		depthCreateInfo.faceCount = 1;
+		depthCreateInfo.width = width;
+		depthCreateInfo.height = height;
+		depthCreateInfo.format = format;
+		depthCreateInfo.mipCount = 1;
+		depthCreateInfo.sampleCount = 1;
+		depthCreateInfo.arraySize = 1;
+		depthCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+
+		OOVR_FAILED_XR_ABORT(xrCreateSwapchain(xr_session.get(), &depthCreateInfo, &depthChain));
+
+		ReadSwapchainImages(depthChain, depthImages);
+	}
+
+	XrSwapchainImageAcquireInfo acquireInfo{ XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+	uint32_t currentIndex = 0;
+	OOVR_FAILED_XR_ABORT(xrAcquireSwapchainImage(depthChain, &acquireInfo, &currentIndex));
+
+	XrSwapchainImageWaitInfo waitInfo{ XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+	XrResult res;
+	do {
+		OOVR_FAILED_XR_ABORT(res = xrWaitSwapchainImage(depthChain, &waitInfo));
+	} while (res == XR_TIMEOUT_EXPIRED);
+
+	glCopyImageSubData(
+	    src, GL_TEXTURE_2D, 0, 0, 0, 0,
+	    depthImages.at(currentIndex), GL_TEXTURE_2D, 0, 0, 0, 0,
+	    width, height, 1);
+
+	GLenum err = glGetError();
+	if (err != GL_NO_ERROR) {
+		OOVR_LOG_ONCE("WARNING: OpenGL depth texture copy failed!");
+	}
+
+#if defined(SUPPORT_GL) && !defined(_WIN32)
+	// Same as for the colour image, the runtime's context might not see our copy otherwise
+	const auto binding = (XrGraphicsBindingOpenGLXlibKHR*)((XrBackend*)BackendManager::Instance().GetBackendInstance())->GetCurrentGraphicsBinding();
+	if (binding->type == XR_TYPE_GRAPHICS_BINDING_OPENGL_XLIB_KHR && binding->glxContext != glXGetCurrentContext())
+		glFinish();
+#endif
+
+	XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(depthChain, &releaseInfo));
+
+	return true;
 }
 
 GLuint GLBaseCompositor::NormaliseFormat(vr::EColorSpace c_space, GLsizei rawFormat)
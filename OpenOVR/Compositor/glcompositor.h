@@ -5,17 +5,34 @@
 class GLBaseCompositor : public Compositor {
 public:
 	explicit GLBaseCompositor() = default;
+	~GLBaseCompositor() override;
 
 	// Override
 	void CopyToSwapchain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, std::optional<XruEye> eye, vr::EVRSubmitFlags submitFlags) override;
 
 	void InvokeCubemap(const vr::Texture_t* textures) override;
 
+	/**
+	 * Take a reference to this eye's mirror, and get the name of its texture. This must be called with the game's
+	 * context current, and the texture is only filled in on the next submit.
+	 *
+	 * The returned mirror should be released when the game releases the texture.
+	 */
+	std::shared_ptr<CompositorMirror> AcquireMirror(GLuint* texture);
+
+	bool WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage) override;
+
 protected:
+	bool CopyDepthToSwapchain(const vr::VRTextureDepthInfo_t& depth) override;
+
+	// Copy the given swapchain image into the mirror texture, resizing it to match the swapchain if required. This
+	// must be called with mirror->mutex held.
+	void CopyToMirror(GLuint image);
+
 	/**
-	 * Read the runtime-created swapchain names to [images] using the GL or GLES OpenXR structs.
+	 * Read the runtime-created swapchain names from the given swapchain to [out] using the GL or GLES OpenXR structs.
 	 */
-	virtual void ReadSwapchainImages() = 0;
+	virtual void ReadSwapchainImages(XrSwapchain swapchain, std::vector<GLuint>& out) = 0;
 
 	void CheckCreateSwapChain(int width, int height, vr::EColorSpace c_space, GLsizei format);
 
@@ -29,6 +46,26 @@ protected:
 	GLuint fboId[2] = { 0 };
 
 	std::vector<GLuint> images;
+	std::vector<GLuint> depthImages;
+
+	class Mirror : public CompositorMirror {
+	public:
+		// The texture name is handed out to the game, so it stays the same if the storage has to be reallocated
+		GLuint texture = 0;
+		XrSwapchainCreateInfo createInfo{};
+
+	protected:
+		void FreeImage() override;
+	};
+
+	// This is created up front, so it never changes while another thread might be submitting
+	std::shared_ptr<Mirror> mirror = std::make_shared<Mirror>();
+
+	// The images of pixelChain, for WritePixels
+	std::vector<GLuint> pixelImages;
+
+	// The last image passed to WritePixels, turned upside down to match OpenGL's bottom-up texture layout
+	std::vector<uint8_t> flippedPixels;
 };
 
 #ifdef SUPPORT_GL
@@ -37,6 +74,6 @@ public:
 	explicit GLCompositor(GLuint initialTexture);
 
 protected:
-	void ReadSwapchainImages() override;
+	void ReadSwapchainImages(XrSwapchain swapchain, std::vector<GLuint>& out) override;
 };
 #endif
@@ -8,5 +8,5 @@ public:
 	explicit GLESCompositor();
 
 protected:
-	void ReadSwapchainImages() override;
+	void ReadSwapchainImages(XrSwapchain swapchain, std::vector<GLuint>& out) override;
 };
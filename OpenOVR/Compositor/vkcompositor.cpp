@@ -5,6 +5,7 @@
 #include "generated/interfaces/vrtypes.h"
 #include "stdafx.h"
 
+#include <cstring>
 #include <vulkan/vulkan.h>
 // Required for the close(2) call for the texture shared memory on Linux
 #ifndef _WIN32
@@ -86,6 +87,7 @@ VkCompositor::VkCompositor(const vr::Texture_t* initialTexture)
 {
 	auto* tex = (vr::VRVulkanTextureData_t*)initialTexture->handle;
 
+	appPhysicalDevice = tex->m_pPhysicalDevice;
 	appDevice = tex->m_pDevice;
 	appQueue = tex->m_pQueue;
 
@@ -96,6 +98,12 @@ VkCompositor::VkCompositor(const vr::Texture_t* initialTexture)
 
 VkCompositor::~VkCompositor()
 {
+	if (pixelFence) {
+		vkWaitForFences(appDevice, 1, &pixelFence, VK_TRUE, UINT64_MAX);
+		vkDestroyFence(appDevice, pixelFence, nullptr);
+	}
+	DestroyPixelBuffer();
+
 	// destroying command pool also frees command buffers
 	vkDestroyCommandPool(appDevice, appCommandPool, nullptr);
 }
@@ -314,6 +322,313 @@ void VkCompositor::CopyToSwapchain(const vr::Texture_t* texture, const vr::VRTex
 	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(chain, &releaseInfo));
 }
 
+bool VkCompositor::CopyDepthToSwapchain(const vr::VRTextureDepthInfo_t& depth)
+{
+	const vr::VRVulkanTextureData_t* tex = (vr::VRVulkanTextureData_t*)depth.handle;
+
+	// Unlike colour, we can't resolve multisampled depth images with vkCmdResolveImage
+	if (tex->m_nSampleCount != 1) {
+		OOVR_LOG_ONCE("Not submitting depth, as multisampled Vulkan depth textures are not supported");
+		return false;
+	}
+
+	OOVR_FALSE_ABORT(appQueue == tex->m_pQueue);
+
+	VkImageAspectFlags aspects;
+	switch ((VkFormat)tex->m_nFormat) {
+	case VK_FORMAT_D16_UNORM:
+	case VK_FORMAT_D32_SFLOAT:
+		aspects = VK_IMAGE_ASPECT_DEPTH_BIT;
+		break;
+	case VK_FORMAT_D16_UNORM_S8_UINT:
+	case VK_FORMAT_D24_UNORM_S8_UINT:
+	case VK_FORMAT_D32_SFLOAT_S8_UINT:
+		// Layout transitions have to cover both aspects, but we only copy the depth
+		aspects = VK_IMAGE_ASPECT_DEPTH_BIT | VK_IMAGE_ASPECT_STENCIL_BIT;
+		break;
+	default:
+		OOVR_LOGF("Not submitting depth, unsupported Vulkan depth format %d", tex->m_nFormat);
+		return false;
+	}
+
+	bool usable = depthChain != XR_NULL_HANDLE && depthCreateInfo.width == tex->m_nWidth && depthCreateInfo.height == tex->m_nHeight
+	    && depthCreateInfo.format == tex->m_nFormat;
+
+	if (!usable) {
+		if (!IsSwapchainFormatSupported(tex->m_nFormat)) {
+			OOVR_LOGF("Not submitting depth, the runtime doesn't support Vulkan depth format %d", tex->m_nFormat);
+			return false;
+		}
+
+		OOVR_LOG("Generating new depth swap chain");
+
+		if (depthChain)
+			xrDestroySwapchain(depthChain);
+
+		if (!depthCommandBuffers.empty()) {
+			vkFreeCommandBuffers(appDevice, appCommandPool, depthCommandBuffers.size(), depthCommandBuffers.data());
+		}
+
+		depthCreateInfo = { XR_TYPE_SWAPCHAIN_CREATE_INFO };
+		depthCreateInfo.createFlags = 0;
+		depthCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_TRANSFER_DST_BIT | XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		depthCreateInfo.format = tex->m_nFormat;
+		depthCreateInfo.faceCount = 1;
+		depthCreateInfo.width = tex->m_nWidth;
+		depthCreateInfo.height = tex->m_nHeight;
+		depthCreateInfo.mipCount = 1;
+		depthCreateInfo.sampleCount = 1;
+		depthCreateInfo.arraySize = 1;
+
+		OOVR_FAILED_XR_ABORT(xrCreateSwapchain(xr_session.get(), &depthCreateInfo, &depthChain));
+
+		uint32_t chainLength = 0;
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(depthChain, 0, &chainLength, nullptr));
+		depthSwapchainImages.resize(chainLength);
+		for (XrSwapchainImageVulkanKHR& swapchainImage : depthSwapchainImages)
+			swapchainImage.type = XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR;
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(depthChain, depthSwapchainImages.size(), &chainLength, (XrSwapchainImageBaseHeader*)depthSwapchainImages.data()));
+
+		depthCommandBuffers.resize(chainLength);
+		VkCommandBufferAllocateInfo bufInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+		bufInfo.commandPool = appCommandPool;
+		bufInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		bufInfo.commandBufferCount = chainLength;
+		OOVR_FAILED_VK_ABORT(vkAllocateCommandBuffers(appDevice, &bufInfo, depthCommandBuffers.data()));
+	}
+
+	XrSwapchainImageAcquireInfo acquireInfo{ XR_TYPE_SWAPCHAIN_IMAGE_ACQUIRE_INFO };
+	uint32_t currentIndex;
+	OOVR_FAILED_XR_ABORT(xrAcquireSwapchainImage(depthChain, &acquireInfo, &currentIndex));
+
+	XrSwapchainImageWaitInfo waitInfo{ XR_TYPE_SWAPCHAIN_IMAGE_WAIT_INFO };
+	OOVR_FAILED_XR_ABORT(xrWaitSwapchainImage(depthChain, &waitInfo));
+
+	const VkCommandBuffer currentCommandBuffer = depthCommandBuffers.at(currentIndex);
+	VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	OOVR_FAILED_VK_ABORT(vkBeginCommandBuffer(currentCommandBuffer, &beginInfo));
+
+	// As with the colour image, the game's image is in TRANSFER_SRC_OPTIMAL
+	VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = depthSwapchainImages.at(currentIndex).image;
+	barrier.subresourceRange.aspectMask = aspects;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	vkCmdPipelineBarrier(
+	    currentCommandBuffer,
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	    0,
+	    0, nullptr,
+	    0, nullptr,
+	    1, &barrier);
+
+	VkImageCopy region = {};
+	region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+	region.srcSubresource.mipLevel = 0;
+	region.srcSubresource.baseArrayLayer = 0;
+	region.srcSubresource.layerCount = 1;
+	region.srcOffset = { 0, 0, 0 };
+	region.dstSubresource = region.srcSubresource;
+	region.dstOffset = { 0, 0, 0 };
+	region.extent = { tex->m_nWidth, tex->m_nHeight, 1 };
+
+	vkCmdCopyImage( //
+	    currentCommandBuffer, // commandbuffer
+	    (VkImage)tex->m_nImage, // srcImage
+	    VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, // srcImageLayout
+	    depthSwapchainImages.at(currentIndex).image, // dstImage
+	    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, // dstImageLayout
+	    1, // regionCount
+	    &region // pRegions
+	);
+
+	// transition swapchain image to DEPTH_STENCIL_ATTACHMENT_OPTIMAL for runtime
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	vkCmdPipelineBarrier(
+	    currentCommandBuffer, //
+	    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+	    0,
+	    0, nullptr,
+	    0, nullptr,
+	    1, &barrier);
+
+	OOVR_FAILED_VK_ABORT(vkEndCommandBuffer(currentCommandBuffer));
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &currentCommandBuffer;
+
+	OOVR_FAILED_VK_ABORT(vkQueueSubmit(tex->m_pQueue, 1, &submitInfo, VK_NULL_HANDLE));
+
+	XrSwapchainImageReleaseInfo releaseInfo{ XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
+	OOVR_FAILED_XR_ABORT(xrReleaseSwapchainImage(depthChain, &releaseInfo));
+
+	return true;
+}
+
+bool VkCompositor::WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage)
+{
+	if (!pixelChain && !IsSwapchainFormatSupported(VK_FORMAT_R8G8B8A8_SRGB))
+		return false;
+
+	if (!pixelFence) {
+		// Start signalled, so the first upload doesn't wait for anything
+		VkFenceCreateInfo fenceInfo = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+		OOVR_FAILED_VK_ABORT(vkCreateFence(appDevice, &fenceInfo, nullptr, &pixelFence));
+
+		VkCommandBufferAllocateInfo bufInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+		bufInfo.commandPool = appCommandPool;
+		bufInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		bufInfo.commandBufferCount = 1;
+		OOVR_FAILED_VK_ABORT(vkAllocateCommandBuffers(appDevice, &bufInfo, &pixelCommandBuffer));
+	}
+
+	// The staging buffer and command buffer are reused, so the last upload must be finished before touching them
+	OOVR_FAILED_VK_ABORT(vkWaitForFences(appDevice, 1, &pixelFence, VK_TRUE, UINT64_MAX));
+
+	if (CheckCreatePixelSwapchain(VK_FORMAT_R8G8B8A8_SRGB, width, height)) {
+		uint32_t imageCount = 0;
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain, 0, &imageCount, nullptr));
+		pixelImages = std::vector<XrSwapchainImageVulkanKHR>(imageCount, { XR_TYPE_SWAPCHAIN_IMAGE_VULKAN_KHR });
+		OOVR_FAILED_XR_ABORT(xrEnumerateSwapchainImages(pixelChain,
+		    pixelImages.size(), &imageCount, (XrSwapchainImageBaseHeader*)pixelImages.data()));
+	}
+
+	// Vulkan images are top row first, same as the pixels we're given, so they can be copied straight in
+	VkDeviceSize size = (VkDeviceSize)width * height * 4;
+	CheckCreatePixelBuffer(size);
+	memcpy(pixelData, pixels, size);
+
+	uint32_t index = AcquirePixelImage();
+
+	VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	OOVR_FAILED_VK_ABORT(vkBeginCommandBuffer(pixelCommandBuffer, &beginInfo));
+
+	VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = pixelImages.at(index).image;
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = 0;
+	barrier.subresourceRange.levelCount = 1;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	vkCmdPipelineBarrier(
+	    pixelCommandBuffer,
+	    VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	    0,
+	    0, nullptr,
+	    0, nullptr,
+	    1, &barrier);
+
+	VkBufferImageCopy region = {};
+	region.bufferOffset = 0;
+	region.bufferRowLength = 0; // Tightly packed
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = 0;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { (uint32_t)width, (uint32_t)height, 1 };
+
+	vkCmdCopyBufferToImage(pixelCommandBuffer, pixelBuffer, pixelImages.at(index).image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	// Same as the eye images, the runtime expects the image back in COLOR_ATTACHMENT_OPTIMAL
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+	vkCmdPipelineBarrier(
+	    pixelCommandBuffer,
+	    VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+	    0,
+	    0, nullptr,
+	    0, nullptr,
+	    1, &barrier);
+
+	OOVR_FAILED_VK_ABORT(vkEndCommandBuffer(pixelCommandBuffer));
+
+	VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &pixelCommandBuffer;
+
+	OOVR_FAILED_VK_ABORT(vkResetFences(appDevice, 1, &pixelFence));
+	OOVR_FAILED_VK_ABORT(vkQueueSubmit(appQueue, 1, &submitInfo, pixelFence));
+
+	ReleasePixelImage(subImage);
+	return true;
+}
+
+void VkCompositor::CheckCreatePixelBuffer(VkDeviceSize size)
+{
+	if (pixelBuffer && pixelBufferSize >= size)
+		return;
+
+	DestroyPixelBuffer();
+
+	VkBufferCreateInfo bufferInfo = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+	bufferInfo.size = size;
+	bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	OOVR_FAILED_VK_ABORT(vkCreateBuffer(appDevice, &bufferInfo, nullptr, &pixelBuffer));
+
+	VkMemoryRequirements requirements;
+	vkGetBufferMemoryRequirements(appDevice, pixelBuffer, &requirements);
+
+	// Any host-visible coherent memory will do, we only write to it once per upload
+	VkPhysicalDeviceMemoryProperties properties;
+	vkGetPhysicalDeviceMemoryProperties(appPhysicalDevice, &properties);
+
+	const VkMemoryPropertyFlags wanted = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	uint32_t memoryType = UINT32_MAX;
+	for (uint32_t i = 0; i < properties.memoryTypeCount; i++) {
+		if ((requirements.memoryTypeBits & (1u << i)) && (properties.memoryTypes[i].propertyFlags & wanted) == wanted) {
+			memoryType = i;
+			break;
+		}
+	}
+	if (memoryType == UINT32_MAX)
+		OOVR_ABORT("No host-visible Vulkan memory type available for uploading images");
+
+	VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+	allocInfo.allocationSize = requirements.size;
+	allocInfo.memoryTypeIndex = memoryType;
+	OOVR_FAILED_VK_ABORT(vkAllocateMemory(appDevice, &allocInfo, nullptr, &pixelMemory));
+	OOVR_FAILED_VK_ABORT(vkBindBufferMemory(appDevice, pixelBuffer, pixelMemory, 0));
+	OOVR_FAILED_VK_ABORT(vkMapMemory(appDevice, pixelMemory, 0, VK_WHOLE_SIZE, 0, &pixelData));
+
+	pixelBufferSize = size;
+}
+
+void VkCompositor::DestroyPixelBuffer()
+{
+	// Freeing the memory also unmaps it
+	if (pixelBuffer)
+		vkDestroyBuffer(appDevice, pixelBuffer, nullptr);
+	if (pixelMemory)
+		vkFreeMemory(appDevice, pixelMemory, nullptr);
+
+	pixelBuffer = VK_NULL_HANDLE;
+	pixelMemory = VK_NULL_HANDLE;
+	pixelBufferSize = 0;
+	pixelData = nullptr;
+}
+
 void VkCompositor::InvokeCubemap(const vr::Texture_t* textures)
 {
 	OOVR_ABORT("VkCompositor::InvokeCubemap: Not yet supported!");
@@ -10,17 +10,40 @@ public:
 
 	void CopyToSwapchain(const vr::Texture_t* texture, const vr::VRTextureBounds_t* bounds, std::optional<XruEye> eye, vr::EVRSubmitFlags submitFlags) override;
 
+	bool CopyDepthToSwapchain(const vr::VRTextureDepthInfo_t& depth) override;
+
 	void InvokeCubemap(const vr::Texture_t* textures) override;
 
+	bool WritePixels(const void* pixels, int32_t width, int32_t height, XrSwapchainSubImage& subImage) override;
+
 private:
 	static bool CheckChainCompatible(const vr::VRVulkanTextureData_t& tex, const XrSwapchainCreateInfo& chainDesc, vr::EColorSpace colourSpace);
 
+	// Make sure pixelBuffer can hold at least size bytes
+	void CheckCreatePixelBuffer(VkDeviceSize size);
+	void DestroyPixelBuffer();
+
 	// These resources live in the runtime's VkDevice
 	std::vector<XrSwapchainImageVulkanKHR> swapchainImages;
+	std::vector<XrSwapchainImageVulkanKHR> depthSwapchainImages;
+
+	// The images of pixelChain, for WritePixels
+	std::vector<XrSwapchainImageVulkanKHR> pixelImages;
 
 	// These resources live in the app's VkDevice
+	VkPhysicalDevice appPhysicalDevice = VK_NULL_HANDLE;
 	VkDevice appDevice = VK_NULL_HANDLE;
 	VkQueue appQueue = VK_NULL_HANDLE;
 	VkCommandPool appCommandPool = VK_NULL_HANDLE;
 	std::vector<VkCommandBuffer> appCommandBuffers{};
+	std::vector<VkCommandBuffer> depthCommandBuffers{};
+
+	// The staging buffer WritePixels copies from, which stays mapped. The keyboard only redraws when it changes,
+	// so there's just the one, guarded by pixelFence.
+	VkBuffer pixelBuffer = VK_NULL_HANDLE;
+	VkDeviceMemory pixelMemory = VK_NULL_HANDLE;
+	VkDeviceSize pixelBufferSize = 0;
+	void* pixelData = nullptr;
+	VkCommandBuffer pixelCommandBuffer = VK_NULL_HANDLE;
+	VkFence pixelFence = VK_NULL_HANDLE;
 };
@@ -4,6 +4,8 @@
 
 #include "Misc/Config.h"
 
+#include <chrono>
+
 // virtual destructor
 ITrackedDevice::~ITrackedDevice() {}
 IBackend::~IBackend() {}
@@ -40,10 +42,12 @@ vr::TrackedDevicePose_t BackendManager::InvalidPose()
 	return pose;
 }
 
-float BackendManager::GetTimeInSeconds()
+double BackendManager::GetTimeInSeconds()
 {
 #ifdef OC_XR_PORT
-	XR_STUBBED();
+	// steady_clock uses CLOCK_MONOTONIC on Linux and QueryPerformanceCounter on Windows, which are the clocks
+	// OpenXR can convert to XrTime (see XrSessionGlobals::GetTimeNow)
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
 #else
 	return ovr_GetTimeInSeconds();
 #endif
@@ -57,12 +61,12 @@ BackendManager::~BackendManager()
 {
 }
 
-std::shared_ptr<ITrackedDevice> BackendManager::GetDevice(vr::TrackedDeviceIndex_t index)
+ITrackedDevice* BackendManager::GetDevice(vr::TrackedDeviceIndex_t index)
 {
 	return backend->GetDevice(index);
 }
 
-std::shared_ptr<ITrackedDevice> BackendManager::GetDeviceByHand(ITrackedDevice::TrackedDeviceType hand)
+ITrackedDevice* BackendManager::GetDeviceByHand(ITrackedDevice::TrackedDeviceType hand)
 {
 	return backend->GetDeviceByHand(hand);
 }
@@ -79,7 +83,7 @@ void BackendManager::GetSinglePose(
     ETrackingStateType trackingState)
 {
 
-	std::shared_ptr<ITrackedDevice> dev = backend->GetDevice(index);
+	ITrackedDevice* dev = backend->GetDevice(index);
 
 	if (dev) {
 		dev->GetPose(origin, pose, trackingState);
@@ -147,6 +151,16 @@ void BackendManager::ReleaseMirrorTextureD3D11(void* pD3D11ShaderResourceView)
 }
 #endif
 
+IBackend::openvr_enum_t BackendManager::GetMirrorTextureGL(vr::EVREye eEye, vr::glUInt_t* pglTextureId, vr::glSharedTextureHandle_t* pglSharedTextureHandle)
+{
+	return backend->GetMirrorTextureGL(eEye, pglTextureId, pglSharedTextureHandle);
+}
+
+bool BackendManager::ReleaseMirrorTextureGL(vr::glUInt_t glTextureId, vr::glSharedTextureHandle_t glSharedTextureHandle)
+{
+	return backend->ReleaseMirrorTextureGL(glTextureId, glSharedTextureHandle);
+}
+
 bool BackendManager::GetPlayAreaPoints(vr::HmdVector3_t* points, int* count)
 {
 	return backend->GetPlayAreaPoints(points, count);
@@ -257,6 +271,11 @@ bool ITrackedDevice::IsHandTrackingValid()
 
 void ITrackedDevice::SetHandTrackingValid(bool valid) {}
 
+TrackedPropertyTable& ITrackedDevice::GetPropertyTable()
+{
+	return propertyTable;
+}
+
 vr::ETrackedDeviceClass IHMD::GetTrackedDeviceClass()
 {
 	return vr::TrackedDeviceClass_HMD;
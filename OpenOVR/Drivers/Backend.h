@@ -1,5 +1,6 @@
 #pragma once
 #include "../OpenOVR/custom_types.h" // TODO move this into the OpenVR tree
+#include "TrackedPropertyTable.h"
 #include "generated/interfaces/vrtypes.h"
 #include <memory>
 
@@ -113,8 +114,16 @@ public:
 
 	virtual void SetHandTrackingValid(bool valid);
 
+	/**
+	 * Get the table used to serve this device's properties to the application. This should be used in preference to
+	 * calling the Get*TrackedDeviceProperty methods directly, as it avoids re-evaluating properties on each request.
+	 */
+	TrackedPropertyTable& GetPropertyTable();
+
 private:
 	vr::TrackedDeviceIndex_t deviceIndex = vr::k_unTrackedDeviceIndexInvalid;
+
+	TrackedPropertyTable propertyTable{ *this };
 };
 
 /**
@@ -170,11 +179,12 @@ public:
 #define DECLARE_BACKEND_FUNCS(PREPEND, APPEND)                                                                                                     \
 	PREPEND std::shared_ptr<IHMD> GetPrimaryHMD() APPEND;                                                                                          \
                                                                                                                                                    \
-	PREPEND std::shared_ptr<ITrackedDevice> GetDevice(                                                                                             \
+	/* Device pointers are only guaranteed to remain valid until the end of the current frame, don't store them */                                 \
+	PREPEND ITrackedDevice* GetDevice(                                                                                                             \
 	    vr::TrackedDeviceIndex_t index) APPEND;                                                                                                    \
                                                                                                                                                    \
 	/* Get the first (and hopefully only) device of a given hand type, or nullptr */                                                               \
-	PREPEND std::shared_ptr<ITrackedDevice> GetDeviceByHand(                                                                                       \
+	PREPEND ITrackedDevice* GetDeviceByHand(                                                                                                       \
 	    ITrackedDevice::TrackedDeviceType hand) APPEND;                                                                                            \
                                                                                                                                                    \
 	PREPEND void GetDeviceToAbsoluteTrackingPose(                                                                                                  \
@@ -213,6 +223,10 @@ public:
 	PREPEND IBackend::openvr_enum_t GetMirrorTextureD3D11(vr::EVREye eEye, void* pD3D11DeviceOrResource, void** ppD3D11ShaderResourceView) APPEND; \
 	PREPEND void ReleaseMirrorTextureD3D11(void* pD3D11ShaderResourceView) APPEND;                                                                 \
 	/* #endif */                                                                                                                                   \
+	/* GL Mirror textures */                                                                                                                       \
+	PREPEND IBackend::openvr_enum_t GetMirrorTextureGL(                                                                                            \
+	    vr::EVREye eEye, vr::glUInt_t* pglTextureId, vr::glSharedTextureHandle_t* pglSharedTextureHandle) APPEND;                                  \
+	PREPEND bool ReleaseMirrorTextureGL(vr::glUInt_t glTextureId, vr::glSharedTextureHandle_t glSharedTextureHandle) APPEND;                       \
 	/** Returns the points of the Play Area. */                                                                                                    \
 	PREPEND bool GetPlayAreaPoints(vr::HmdVector3_t* points, int* count) APPEND;                                                                   \
 	/** Determine whether the bounds are showing right now **/                                                                                     \
@@ -268,8 +282,8 @@ public:
 
 	static vr::TrackedDevicePose_t InvalidPose();
 
-	// Returns global, absolute high-resolution time in seconds.
-	float GetTimeInSeconds();
+	// Returns global, absolute high-resolution time in seconds. This is monotonic, and cheap to call.
+	static double GetTimeInSeconds();
 
 	// Get the current backend instance
 	inline IBackend* GetBackendInstance() { return backend.get(); }
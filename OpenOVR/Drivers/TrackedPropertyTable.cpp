@@ -0,0 +1,223 @@
+#include "stdafx.h"
+
+#include "TrackedPropertyTable.h"
+
+#include "Backend.h"
+
+#include <algorithm>
+#include <cstring>
+
+TrackedPropertyTable::TrackedPropertyTable(ITrackedDevice& device)
+    : device(device), slots(std::make_unique<std::atomic<const Entry*>[]>(MAX_TABLE_PROPERTY))
+{
+	for (uint32_t i = 0; i < MAX_TABLE_PROPERTY; i++)
+		slots[i].store(nullptr, std::memory_order_relaxed);
+}
+
+TrackedPropertyTable::~TrackedPropertyTable() = default;
+
+bool TrackedPropertyTable::IsVolatile(vr::ETrackedDeviceProperty prop)
+{
+	switch (prop) {
+	case vr::Prop_UserIpdMeters_Float:
+	case vr::Prop_DisplayFrequency_Float:
+	case vr::Prop_SecondsFromVsyncToPhotons_Float:
+	case vr::Prop_DeviceBatteryPercentage_Float:
+	case vr::Prop_DeviceIsCharging_Bool:
+		return true;
+	default:
+		return false;
+	}
+}
+
+void TrackedPropertyTable::Invalidate()
+{
+	// Stop any in-progress lookups from storing values built from the old properties
+	std::lock_guard lock(entriesMutex);
+	generation++;
+
+	for (uint32_t i = 0; i < MAX_TABLE_PROPERTY; i++)
+		slots[i].store(nullptr, std::memory_order_release);
+
+	// The entries themselves are kept alive for now, see the comment on the entries field
+	for (std::unique_ptr<Entry>& entry : entries)
+		Retire(std::move(entry));
+	entries.clear();
+}
+
+void TrackedPropertyTable::AdvanceEpoch()
+{
+	std::lock_guard lock(entriesMutex);
+	epoch++;
+
+	// As with the device table, an entry retired during epoch N may still be read until the end of that
+	// frame, and once the following frame boundary has passed nothing can be reading it.
+	std::erase_if(retiredEntries, [this](const RetiredEntry& retired) {
+		return retired.retiredAtEpoch + 2 <= epoch;
+	});
+}
+
+void TrackedPropertyTable::Retire(std::unique_ptr<Entry> entry)
+{
+	retiredEntries.push_back(RetiredEntry{
+	    .entry = std::move(entry),
+	    .retiredAtEpoch = epoch,
+	});
+}
+
+const TrackedPropertyTable::Entry* TrackedPropertyTable::Lookup(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t type)
+{
+	if ((uint32_t)prop >= MAX_TABLE_PROPERTY || IsVolatile(prop))
+		return nullptr;
+
+	std::atomic<const Entry*>& slot = slots[prop];
+	const Entry* entry = slot.load(std::memory_order_acquire);
+
+	// If this property was previously requested with a different type and didn't exist, it might
+	// exist as the type we're now asking for. If it did exist, then the caller has the type wrong.
+	if (entry && (entry->type == type || entry->error == vr::TrackedProp_Success || (entry->missingTypes & (1u << type))))
+		return entry;
+
+	uint32_t startGeneration = generation.load();
+	auto newEntry = std::make_unique<Entry>(BuildEntry(prop, type));
+
+	// Remember the types this property has already been found not to exist as
+	if (newEntry->error != vr::TrackedProp_Success) {
+		newEntry->missingTypes = 1u << type;
+		if (entry)
+			newEntry->missingTypes |= entry->missingTypes;
+	}
+	entry = newEntry.get();
+
+	std::lock_guard lock(entriesMutex);
+
+	// If the table was invalidated while we were building this, it may be stale. It's still returned to this
+	// caller, who asked before the invalidation, but isn't stored.
+	if (generation.load() != startGeneration) {
+		Retire(std::move(newEntry));
+		return entry;
+	}
+
+	// Replace the entry this one supersedes, if any (which isn't necessarily the one we loaded above, if another
+	// thread was looking the same property up)
+	const Entry* old = slot.exchange(entry, std::memory_order_acq_rel);
+	if (old) {
+		auto iter = std::find_if(entries.begin(), entries.end(), [old](const std::unique_ptr<Entry>& e) {
+			return e.get() == old;
+		});
+		Retire(std::move(*iter));
+		entries.erase(iter);
+	}
+
+	entries.push_back(std::move(newEntry));
+	return entry;
+}
+
+TrackedPropertyTable::Entry TrackedPropertyTable::BuildEntry(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t type)
+{
+	Entry entry;
+	entry.type = type;
+
+	switch (type) {
+	case vr::k_unBoolPropertyTag:
+		entry.value.b = device.GetBoolTrackedDeviceProperty(prop, &entry.error);
+		break;
+	case vr::k_unFloatPropertyTag:
+		entry.value.f = device.GetFloatTrackedDeviceProperty(prop, &entry.error);
+		break;
+	case vr::k_unInt32PropertyTag:
+		entry.value.i32 = device.GetInt32TrackedDeviceProperty(prop, &entry.error);
+		break;
+	case vr::k_unUint64PropertyTag:
+		entry.value.u64 = device.GetUint64TrackedDeviceProperty(prop, &entry.error);
+		break;
+	case vr::k_unHmdMatrix34PropertyTag:
+		entry.value.m34 = device.GetMatrix34TrackedDeviceProperty(prop, &entry.error);
+		break;
+	case vr::k_unStringPropertyTag: {
+		// Find the length first, so we don't have to put a k_unMaxPropertyStringSize buffer on the stack
+		uint32_t size = device.GetStringTrackedDeviceProperty(prop, nullptr, 0, &entry.error);
+		if (entry.error != vr::TrackedProp_Success && entry.error != vr::TrackedProp_BufferTooSmall)
+			break;
+
+		if (size > 1) {
+			entry.str.resize(size);
+			device.GetStringTrackedDeviceProperty(prop, entry.str.data(), size, &entry.error);
+			entry.str.resize(strlen(entry.str.c_str()));
+		}
+		if (entry.error == vr::TrackedProp_BufferTooSmall)
+			entry.error = vr::TrackedProp_Success;
+		break;
+	}
+	default:
+		OOVR_ABORTF("Cannot build property table entry for type %d", type);
+	}
+
+	return entry;
+}
+
+#define DEFINE_TABLE_GETTER(ret_type, name, tag, field, device_getter)                                      \
+	ret_type TrackedPropertyTable::name(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError) \
+	{                                                                                                       \
+		const Entry* entry = Lookup(prop, tag);                                                             \
+		if (!entry)                                                                                         \
+			return device.device_getter(prop, pError);                                                      \
+		if (entry->type != tag) {                                                                           \
+			if (pError)                                                                                     \
+				*pError = entry->error ? entry->error : vr::TrackedProp_WrongDataType;                      \
+			return {};                                                                                      \
+		}                                                                                                   \
+		if (pError)                                                                                         \
+			*pError = entry->error;                                                                         \
+		return entry->value.field;                                                                          \
+	}
+
+DEFINE_TABLE_GETTER(bool, GetBool, vr::k_unBoolPropertyTag, b, GetBoolTrackedDeviceProperty)
+DEFINE_TABLE_GETTER(float, GetFloat, vr::k_unFloatPropertyTag, f, GetFloatTrackedDeviceProperty)
+DEFINE_TABLE_GETTER(int32_t, GetInt32, vr::k_unInt32PropertyTag, i32, GetInt32TrackedDeviceProperty)
+DEFINE_TABLE_GETTER(uint64_t, GetUint64, vr::k_unUint64PropertyTag, u64, GetUint64TrackedDeviceProperty)
+DEFINE_TABLE_GETTER(vr::HmdMatrix34_t, GetMatrix34, vr::k_unHmdMatrix34PropertyTag, m34, GetMatrix34TrackedDeviceProperty)
+
+#undef DEFINE_TABLE_GETTER
+
+uint32_t TrackedPropertyTable::GetString(vr::ETrackedDeviceProperty prop, char* pchValue, uint32_t unBufferSize,
+    vr::ETrackedPropertyError* pError, const char** pCachedValue)
+{
+	if (pCachedValue)
+		*pCachedValue = "";
+
+	const Entry* entry = Lookup(prop, vr::k_unStringPropertyTag);
+	if (!entry) {
+		uint32_t size = device.GetStringTrackedDeviceProperty(prop, pchValue, unBufferSize, pError);
+		if (pCachedValue && pchValue && unBufferSize > 0)
+			*pCachedValue = pchValue;
+		return size;
+	}
+
+	if (entry->type != vr::k_unStringPropertyTag) {
+		if (pError)
+			*pError = entry->error ? entry->error : vr::TrackedProp_WrongDataType;
+		return 0;
+	}
+
+	if (entry->error != vr::TrackedProp_Success) {
+		if (pError)
+			*pError = entry->error;
+		return 0;
+	}
+
+	if (pCachedValue)
+		*pCachedValue = entry->str.c_str();
+
+	uint32_t size = (uint32_t)entry->str.size() + 1;
+	if (pchValue == nullptr || unBufferSize < size) {
+		if (pError)
+			*pError = vr::TrackedProp_BufferTooSmall;
+		return size;
+	}
+
+	memcpy(pchValue, entry->str.c_str(), size);
+	if (pError)
+		*pError = vr::TrackedProp_Success;
+	return size;
+}
@@ -0,0 +1,118 @@
+#pragma once
+#include "generated/interfaces/vrtypes.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class ITrackedDevice;
+
+/**
+ * A flat per-device table of tracked property values, indexed by ETrackedDeviceProperty.
+ *
+ * Games can request thousands of properties at startup and hundreds per frame, and answering each of those
+ * from the device's switch statements and the interaction profile's property maps is comparatively slow. Instead,
+ * each property is resolved through the device's Get*TrackedDeviceProperty methods the first time it's requested,
+ * and from then on is served from this table with a single atomic load. String properties are stored pre-encoded.
+ *
+ * The table must be invalidated whenever the device's properties may change (namely when the interaction
+ * profile changes). Properties which change at runtime (such as the IPD) are never cached.
+ */
+class TrackedPropertyTable {
+public:
+	struct Entry {
+		vr::PropertyTypeTag_t type = vr::k_unInvalidPropertyTag;
+		vr::ETrackedPropertyError error = vr::TrackedProp_Success;
+
+		// If the property doesn't exist, the set of types (as 1 << tag) it's known not to exist as. Without
+		// this, a game polling a missing property as two different types would build a new entry on every call.
+		uint32_t missingTypes = 0;
+
+		union {
+			bool b;
+			float f;
+			int32_t i32;
+			uint64_t u64;
+			vr::HmdMatrix34_t m34;
+		} value = {};
+
+		std::string str;
+	};
+
+	explicit TrackedPropertyTable(ITrackedDevice& device);
+	~TrackedPropertyTable();
+
+	TrackedPropertyTable(const TrackedPropertyTable&) = delete;
+	TrackedPropertyTable& operator=(const TrackedPropertyTable&) = delete;
+
+	bool GetBool(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError);
+	float GetFloat(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError);
+	int32_t GetInt32(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError);
+	uint64_t GetUint64(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError);
+	vr::HmdMatrix34_t GetMatrix34(vr::ETrackedDeviceProperty prop, vr::ETrackedPropertyError* pError);
+
+	/**
+	 * Copies a string property into the supplied buffer, returning the size (including the null terminator) required
+	 * to hold it. If the buffer is too small, nothing is written and TrackedProp_BufferTooSmall is returned.
+	 *
+	 * If pCachedValue is non-null, it is set to the property's value (or an empty string) for logging.
+	 */
+	uint32_t GetString(vr::ETrackedDeviceProperty prop, char* pchValue, uint32_t unBufferSize,
+	    vr::ETrackedPropertyError* pError, const char** pCachedValue = nullptr);
+
+	/**
+	 * Discard all the cached values, so they'll be fetched from the device the next time they're requested.
+	 */
+	void Invalidate();
+
+	/**
+	 * Marks a frame boundary, freeing the entries discarded by Invalidate (or replaced by a lookup) that no reader
+	 * can still be using. This is called alongside the backend's device table epoch.
+	 */
+	void AdvanceEpoch();
+
+private:
+	// Only the standard properties (everything below the vendor-specific range) are stored in the table, which
+	// keeps it small enough to allocate up-front. Other properties are passed straight through to the device.
+	static constexpr uint32_t MAX_TABLE_PROPERTY = vr::Prop_VendorSpecific_Reserved_Start;
+
+	/**
+	 * Returns true if this property changes while the device exists, and thus must always be fetched from the device.
+	 */
+	static bool IsVolatile(vr::ETrackedDeviceProperty prop);
+
+	/**
+	 * Find the entry for the given property, building it if it doesn't exist yet. Returns nullptr if the
+	 * property can't be stored in the table.
+	 */
+	const Entry* Lookup(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t type);
+
+	Entry BuildEntry(vr::ETrackedDeviceProperty prop, vr::PropertyTypeTag_t type);
+
+	/**
+	 * Keep an entry that's no longer in the table alive until the next two epochs have passed. Must be called
+	 * with entriesMutex held.
+	 */
+	void Retire(std::unique_ptr<Entry> entry);
+
+	struct RetiredEntry {
+		std::unique_ptr<Entry> entry;
+		uint64_t retiredAtEpoch;
+	};
+
+	ITrackedDevice& device;
+
+	std::unique_ptr<std::atomic<const Entry*>[]> slots;
+
+	// Owns the entries referenced by slots. When an entry is taken out of the table it moves to retiredEntries,
+	// since a reader could still be copying out of it, and is freed by AdvanceEpoch once that reader must be done.
+	std::mutex entriesMutex;
+	std::vector<std::unique_ptr<Entry>> entries;
+	std::vector<RetiredEntry> retiredEntries;
+	uint64_t epoch = 0;
+
+	// Incremented on each invalidation
+	std::atomic<uint32_t> generation = 0;
+};
@@ -0,0 +1,214 @@
+#include "stdafx.h"
+
+#include "CallCapture.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+// Record types in the capture file
+static constexpr uint8_t RECORD_METHOD = 1;
+static constexpr uint8_t RECORD_CALL = 2;
+
+static const char CAPTURE_MAGIC[8] = { 'O', 'C', 'C', 'A', 'P', 'T', 0, 1 };
+
+// Don't copy anything unreasonably large, most likely from a bad array count
+static constexpr size_t MAX_ITEM_SIZE = 1024 * 1024;
+
+namespace {
+/**
+ * Collects call records from any thread, and writes them out in the background.
+ */
+class CaptureWriter {
+public:
+	~CaptureWriter()
+	{
+		// In case the game exits without shutting OpenVR down
+		Stop();
+	}
+
+	void Submit(const char* name, std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end,
+	    const std::vector<uint8_t>& payload)
+	{
+		using namespace std::chrono;
+
+		std::unique_lock lock(mutex);
+		if (!running && !Start())
+			return;
+
+		// Calls which started before the capture did are counted as starting with it
+		uint64_t startNs = (uint64_t)std::max<int64_t>(0, duration_cast<nanoseconds>(start - epoch).count());
+		uint32_t durationNs = (uint32_t)std::min<int64_t>(UINT32_MAX, duration_cast<nanoseconds>(end - start).count());
+
+		// Give each method a number the first time it's used, so the name only appears once in the file
+		auto iter = methodIds.find(name);
+		if (iter == methodIds.end()) {
+			uint16_t id = (uint16_t)methodIds.size();
+			iter = methodIds.emplace(name, id).first;
+
+			uint16_t length = (uint16_t)strlen(name);
+			Append(RECORD_METHOD);
+			Append(id);
+			Append(length);
+			buffer.insert(buffer.end(), name, name + length);
+		}
+
+		Append(RECORD_CALL);
+		Append(iter->second);
+		Append(startNs);
+		Append(durationNs);
+		Append((uint32_t)payload.size());
+		buffer.insert(buffer.end(), payload.begin(), payload.end());
+
+		if (buffer.size() >= FLUSH_SIZE)
+			wake.notify_one();
+	}
+
+	void Stop()
+	{
+		std::thread stopping;
+		{
+			std::lock_guard lock(mutex);
+			if (!running)
+				return;
+			running = false;
+			generation++;
+			stopping = std::move(thread);
+		}
+
+		// The writer thread writes out anything left in the buffer and closes the file before exiting
+		wake.notify_all();
+		stopping.join();
+	}
+
+private:
+	static constexpr size_t FLUSH_SIZE = 256 * 1024;
+
+	// Must be called with the mutex held
+	bool Start()
+	{
+		// Only try once, rather than trying to open the file on every call
+		if (startFailed)
+			return false;
+
+		std::string path = oovr_log_path("opencomposite_capture.occap");
+		FILE* file = fopen(path.c_str(), "wb");
+		if (!file) {
+			OOVR_LOGF("Could not open capture file '%s'", path.c_str());
+			startFailed = true;
+			return false;
+		}
+
+		OOVR_LOGF("Capturing OpenVR calls to '%s'", path.c_str());
+		fwrite(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC), 1, file);
+
+		// Capturing may restart after a shutdown, in which case the method IDs start again with the new file
+		methodIds.clear();
+		epoch = std::chrono::steady_clock::now();
+		running = true;
+		thread = std::thread(&CaptureWriter::Run, this, file, generation);
+		return true;
+	}
+
+	void Run(FILE* output, uint32_t runGeneration)
+	{
+		std::vector<uint8_t> writing;
+		std::unique_lock lock(mutex);
+
+		while (true) {
+			wake.wait_for(lock, std::chrono::milliseconds(100), [&]() { return generation != runGeneration || buffer.size() >= FLUSH_SIZE; });
+
+			writing.swap(buffer);
+			bool stop = generation != runGeneration;
+
+			lock.unlock();
+			if (!writing.empty())
+				fwrite(writing.data(), 1, writing.size(), output);
+			writing.clear();
+			if (stop) {
+				fclose(output);
+				return;
+			}
+			lock.lock();
+		}
+	}
+
+	template <typename T>
+	void Append(T value)
+	{
+		const uint8_t* bytes = (const uint8_t*)&value;
+		buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+	}
+
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::thread thread;
+	bool running = false;
+	bool startFailed = false;
+	uint32_t generation = 0;
+
+	std::vector<uint8_t> buffer;
+	std::unordered_map<const char*, uint16_t> methodIds;
+	std::chrono::steady_clock::time_point epoch;
+};
+} // namespace
+
+static CaptureWriter writer;
+
+CallCapture::CallCapture(const char* name)
+    : name(name), start(std::chrono::steady_clock::now())
+{
+}
+
+CallCapture::~CallCapture()
+{
+	writer.Submit(name, start, std::chrono::steady_clock::now(), payload);
+}
+
+void CallCapture::Shutdown()
+{
+	writer.Stop();
+}
+
+void CallCapture::Write(Tag tag, const void* data, size_t size)
+{
+	if (size > MAX_ITEM_SIZE) {
+		tag = Tag::Opaque;
+		size = 0;
+	}
+
+	uint32_t size32 = (uint32_t)size;
+	payload.push_back((uint8_t)tag);
+	payload.insert(payload.end(), (const uint8_t*)&size32, (const uint8_t*)&size32 + sizeof(size32));
+	if (size)
+		payload.insert(payload.end(), (const uint8_t*)data, (const uint8_t*)data + size);
+}
+
+void CallCapture::WriteString(Tag tag, const char* str)
+{
+	if (!str) {
+		Write(Tag::Null, nullptr, 0);
+		return;
+	}
+
+	Write(tag, str, strlen(str));
+}
+
+void CallCapture::WriteTextures(const vr::Texture_t* textures, uint32_t count)
+{
+	if (count > MAX_ITEM_SIZE / sizeof(vr::Texture_t)) {
+		Write(Tag::Opaque, nullptr, 0);
+		return;
+	}
+
+	// Replace the handles with 1 if they're set, so captures from different runs can be compared
+	std::vector<vr::Texture_t> copies(textures, textures + count);
+	for (vr::Texture_t& texture : copies)
+		texture.handle = texture.handle ? (void*)1 : nullptr;
+
+	Write(Tag::Value, copies.data(), copies.size() * sizeof(vr::Texture_t));
+}
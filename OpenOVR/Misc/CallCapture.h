@@ -0,0 +1,150 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Records the OpenVR calls a game makes into a compact binary log, so a game's call stream can be inspected,
+ * timed and compared against another capture without needing the game or a headset (see scripts/capture_tool.py).
+ *
+ * This is enabled with the captureOpenVRCalls config option. The generated stubs then create a CallCapture for
+ * each call, add the arguments to it before passing the call on to the Base* implementation, and the output
+ * parameters and return value after. The record is passed to a background thread to be written out when the
+ * CallCapture is destroyed, so the game never waits on the disk.
+ *
+ * The following are recorded byte-for-byte:
+ * - Values passed by value or const reference, so long as they're trivially copyable (numbers, enums, handles, structs)
+ * - Strings passed as const char*
+ * - The contents of const pointers to trivially-copyable types, using the count from VR_ARRAY_COUNT if there is one
+ * - After the call, the contents of non-const pointers to trivially-copyable types, in the same way
+ * - The return value
+ *
+ * Anything else - void pointers, output strings and (since they may point to something shorter than our version of
+ * the struct) any pointers passed to a function with a struct size parameter - is only recorded as being null or
+ * not. The handles in Texture_t are replaced by a placeholder, since they're meaningless outside the game's process.
+ */
+class CallCapture {
+public:
+	// The type of each item in a call record. The format is documented in scripts/capture_tool.py.
+	enum class Tag : uint8_t {
+		Null = 0,
+		Opaque = 1,
+		Value = 2,
+		String = 3,
+		Output = 4,
+		Return = 5,
+		ReturnString = 6,
+	};
+
+	explicit CallCapture(const char* name);
+	~CallCapture();
+
+	CallCapture(const CallCapture&) = delete;
+	CallCapture& operator=(const CallCapture&) = delete;
+
+	/**
+	 * Record an argument, before the call is made. For pointers, count is the number of elements it points to.
+	 */
+	template <typename T>
+	void In(const T& value, uint32_t count = 1)
+	{
+		if constexpr (std::is_pointer_v<T>) {
+			using Pointee = std::remove_pointer_t<T>;
+
+			if (!value) {
+				Write(Tag::Null, nullptr, 0);
+			} else if constexpr (std::is_same_v<std::remove_cv_t<Pointee>, char>) {
+				if constexpr (std::is_const_v<Pointee>)
+					WriteString(Tag::String, value);
+				else
+					Write(Tag::Opaque, nullptr, 0); // Output string, which may not be null-terminated yet
+			} else if constexpr (std::is_same_v<std::remove_cv_t<Pointee>, vr::Texture_t>) {
+				WriteTextures(value, count);
+			} else if constexpr (std::is_const_v<Pointee> && IsPlain<Pointee>()) {
+				WriteArray(Tag::Value, value, count);
+			} else {
+				Write(Tag::Opaque, nullptr, 0);
+			}
+		} else if constexpr (std::is_trivially_copyable_v<T>) {
+			Write(Tag::Value, &value, sizeof(T));
+		} else {
+			Write(Tag::Opaque, nullptr, 0);
+		}
+	}
+
+	/**
+	 * Record a pointer argument without its contents, for pointers whose size we can't know.
+	 */
+	void InOpaque(const void* value) { Write(value ? Tag::Opaque : Tag::Null, nullptr, 0); }
+
+	/**
+	 * Record what the call wrote into an output parameter. Does nothing if the argument isn't an output.
+	 */
+	template <typename T>
+	void Out(const T& value, uint32_t count = 1)
+	{
+		if constexpr (std::is_pointer_v<T>) {
+			using Pointee = std::remove_pointer_t<T>;
+			if constexpr (!std::is_const_v<Pointee> && !std::is_same_v<Pointee, char> && IsPlain<Pointee>()) {
+				if (value)
+					WriteArray(Tag::Output, value, count);
+			}
+		}
+	}
+
+	template <typename T>
+	T Return(T value)
+	{
+		if constexpr (std::is_same_v<T, const char*>) {
+			WriteString(Tag::ReturnString, value);
+		} else if constexpr (std::is_pointer_v<T>) {
+			bool present = value != nullptr;
+			Write(Tag::Return, &present, sizeof(present));
+		} else if constexpr (std::is_trivially_copyable_v<T>) {
+			Write(Tag::Return, &value, sizeof(T));
+		}
+		return value;
+	}
+
+	/**
+	 * Write out everything that's been captured and stop the writer thread. Capturing starts again (appending
+	 * to the same file) if any more calls are made.
+	 */
+	static void Shutdown();
+
+private:
+	// Whether the contents of a pointer to this type can be copied into the log
+	template <typename T>
+	static constexpr bool IsPlain()
+	{
+		if constexpr (std::is_void_v<T> || std::is_pointer_v<T>) {
+			return false;
+		} else if constexpr (!IsComplete<T>(0)) {
+			// Opaque handles such as VkInstance_T
+			return false;
+		} else {
+			return std::is_trivially_copyable_v<T>;
+		}
+	}
+
+	template <typename T, size_t = sizeof(T)>
+	static constexpr bool IsComplete(int) { return true; }
+	template <typename T>
+	static constexpr bool IsComplete(...) { return false; }
+
+	template <typename T>
+	void WriteArray(Tag tag, const T* values, uint32_t count)
+	{
+		Write(tag, values, (size_t)count * sizeof(T));
+	}
+
+	void Write(Tag tag, const void* data, size_t size);
+	void WriteString(Tag tag, const char* str);
+	void WriteTextures(const vr::Texture_t* textures, uint32_t count);
+
+	const char* name;
+	std::chrono::steady_clock::time_point start;
+	std::vector<uint8_t> payload;
+};
@@ -4,9 +4,16 @@
 #include "ini.h"
 
 #include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
 #include <codecvt>
+#include <cstring>
+#include <fstream>
 #include <locale>
+#include <stdexcept>
 #include <string>
+#include <sys/stat.h>
 
 #ifdef WIN32
 #include <direct.h>
@@ -16,24 +23,35 @@
 #define GetCurrentDir getcwd
 #endif
 
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
 using vr::HmdColor_t;
 
 Config oovr_global_configuration;
 
+// Set while re-reading the config files after they've been edited. A mistake in them shouldn't kill the game
+// then, so the error is thrown back to ini_handler instead and the current options are kept.
+static thread_local bool reloading = false;
+
 // OOVR_ABORT doesn't work here for some reason
 // TODO Turtle1331 use OOVR_ABORT from logging.h
+[[noreturn]] static void config_error(const string& msg)
+{
+	if (reloading)
+		throw std::runtime_error(msg);
+
 #ifdef WIN32
-#define ABORT(msg)                                                                        \
-	{                                                                                     \
-		MessageBoxA(NULL, string(msg).c_str(), "OpenComposite Config File Error", MB_OK); \
-		exit(1);                                                                          \
-	}
+	MessageBoxA(NULL, msg.c_str(), "OpenComposite Config File Error", MB_OK);
+	exit(1);
 #else
-#define ABORT(msg) \
-	{              \
-		exit(42);  \
-	}
+	exit(42);
 #endif
+}
+
+#define ABORT(msg) config_error(msg)
 
 static string str_tolower(std::string val)
 {
@@ -118,6 +136,69 @@ static float parse_float(string orig, string name, int line)
 	return result;
 }
 
+// Every option, as (type, name, live). The type selects the parse_ and format_ functions used for it. Live options
+// can be changed while the game is running, while the others are only used during startup and need a restart.
+#define CONFIG_OPTIONS(X)                   \
+	X(bool, renderCustomHands, true)        \
+	X(HmdColor_t, handColour, true)         \
+	X(float, supersampleRatio, true)        \
+	X(bool, haptics, true)                  \
+	X(bool, admitUnknownProps, true)        \
+	X(bool, logGetTrackedProperty, true)    \
+	X(bool, stopOnSoftAbort, true)          \
+	X(bool, dx10Mode, false)                \
+	X(bool, enableHiddenMeshFix, true)      \
+	X(bool, invertUsingShaders, true)       \
+	X(bool, initUsingVulkan, false)         \
+	X(float, hiddenMeshVerticalScale, true) \
+	X(float, refreshRate, true)             \
+	X(bool, logAllOpenVRCalls, true)        \
+	X(bool, captureOpenVRCalls, true)
+
+static string format_bool(bool value)
+{
+	return value ? "true" : "false";
+}
+
+static string format_float(float value)
+{
+	return to_string(value);
+}
+
+static string format_HmdColor_t(const HmdColor_t& value)
+{
+	char buff[8];
+	snprintf(buff, sizeof(buff), "#%02x%02x%02x", (int)std::lround(value.r * 255), (int)std::lround(value.g * 255),
+	    (int)std::lround(value.b * 255));
+	return buff;
+}
+
+static bool is_known_option(const string& name)
+{
+#define CFGOPT(type, vname, live) \
+	if (name == #vname)           \
+		return true;
+
+	CONFIG_OPTIONS(CFGOPT)
+
+#undef CFGOPT
+	return false;
+}
+
+bool Config::SetOption(Options& options, const string& name, const string& value, int lineno)
+{
+#define CFGOPT(type, vname, live)                          \
+	if (name == #vname) {                                  \
+		options.vname = parse_##type(value, name, lineno); \
+		return true;                                       \
+	}
+
+	CONFIG_OPTIONS(CFGOPT)
+
+#undef CFGOPT
+	return false;
+}
+
 int Config::ini_handler(void* user, const char* pSection,
     const char* pName, const char* pValue,
     int lineno)
@@ -127,34 +208,29 @@ int Config::ini_handler(void* user, const char* pSection,
 	string name = pName;
 	string value = pValue;
 
-	Config* cfg = (Config*)user;
-
-#define CFGOPT(type, vname)                             \
-	if (name == #vname) {                               \
-		cfg->vname = parse_##type(value, name, lineno); \
-		return true;                                    \
-	}
+	ParseState* state = (ParseState*)user;
+
+	try {
+		if (section == "" || section == "default") {
+			if (SetOption(*state->options, name, value, lineno))
+				return true;
+		} else if (section.rfind("app:", 0) == 0) {
+			// Check the name even if the section is for another game, so typos are caught straight away. The
+			// matching sections are applied after every file has been read, so they always override the defaults.
+			if (is_known_option(name)) {
+				if (state->config->MatchesApplication(section.substr(4)))
+					state->appOverrides.push_back(AppOverride{ name, value, lineno });
+				return true;
+			}
+		}
 
-	if (section == "" || section == "default") {
-		CFGOPT(bool, renderCustomHands);
-		CFGOPT(HmdColor_t, handColour);
-		CFGOPT(float, supersampleRatio);
-		CFGOPT(bool, haptics);
-		CFGOPT(bool, admitUnknownProps);
-		CFGOPT(bool, logGetTrackedProperty);
-		CFGOPT(bool, stopOnSoftAbort);
-		CFGOPT(bool, dx10Mode);
-		CFGOPT(bool, enableHiddenMeshFix);
-		CFGOPT(bool, invertUsingShaders);
-		CFGOPT(bool, initUsingVulkan);
-		CFGOPT(float, hiddenMeshVerticalScale);
-		CFGOPT(bool, logAllOpenVRCalls);
+		string err = "Unknown config option " + name + " on line " + to_string(lineno);
+		ABORT(err);
+	} catch (const std::runtime_error& e) {
+		// Only thrown while reloading, inih then stops and returns this line number
+		OOVR_LOGF("Config error: %s", e.what());
+		return false;
 	}
-
-#undef CFGOPT
-
-	string err = "Unknown config option " + name + " on line " + to_string(lineno);
-	ABORT(err);
 }
 
 static int wini_parse(const wchar_t* filename, ini_handler handler, void* user)
@@ -175,6 +251,76 @@ static int wini_parse(const wchar_t* filename, ini_handler handler, void* user)
 	return error;
 }
 
+int Config::ReadFiles(Options& options) const
+{
+	ParseState state{ this, &options, {} };
+
+	bool found = false;
+	for (const wstring& file : configFiles) {
+		int err = wini_parse(file.c_str(), ini_handler, &state);
+
+		// -1 means we couldn't open file. That's no problem since the config file is optional and
+		//  the defaults are set up as the default values for the variables
+		if (err == -1)
+			continue;
+
+		// Otherwise err is the line number
+		if (err != 0)
+			return err;
+
+		found = true;
+	}
+
+	// Everything else should have been set up by ini_handler
+	for (const AppOverride& option : state.appOverrides) {
+		OOVR_LOGF("Applying per-application option %s from line %d", option.name.c_str(), option.line);
+		SetOption(options, option.name, option.value, option.line);
+	}
+
+	return found ? 0 : -1;
+}
+
+void Config::DetectApplication()
+{
+#ifdef _WIN32
+	wchar_t buffer[MAX_PATH];
+	DWORD len = GetModuleFileNameW(NULL, buffer, MAX_PATH);
+
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> CHAR_CONV;
+	string path = len ? CHAR_CONV.to_bytes(wstring(buffer, len)) : "";
+#else
+	char buffer[FILENAME_MAX];
+	ssize_t len = readlink("/proc/self/exe", buffer, sizeof(buffer));
+	string path = len > 0 ? string(buffer, len) : "";
+#endif
+
+	size_t slash_index = path.find_last_of("/\\");
+	appExecutable = str_tolower(slash_index == string::npos ? path : path.substr(slash_index + 1));
+
+	// Steam sets this when it launches a game. Otherwise, games run outside of Steam usually have a steam_appid.txt.
+	appSteamId = GetEnv("SteamAppId");
+	if (appSteamId.empty()) {
+		std::ifstream in("steam_appid.txt");
+		if (in)
+			in >> appSteamId;
+	}
+}
+
+bool Config::MatchesApplication(const string& key) const
+{
+	string lower = str_tolower(key);
+
+	if (!appSteamId.empty() && lower == appSteamId)
+		return true;
+	if (!appExecutable.empty() && lower == appExecutable)
+		return true;
+
+	// Allow leaving off the .exe
+	const string ext = ".exe";
+	return appExecutable.size() > ext.size() && appExecutable.compare(appExecutable.size() - ext.size(), ext.size(), ext) == 0
+	    && lower == appExecutable.substr(0, appExecutable.size() - ext.size());
+}
+
 // The ctor is run before DLLMain, so use this hack for now
 #ifdef _WIN32
 EXTERN_C IMAGE_DOS_HEADER __ImageBase;
@@ -183,10 +329,8 @@ EXTERN_C IMAGE_DOS_HEADER __ImageBase;
 
 Config::Config()
 {
-	// Initialise using Vulkan if D3D11 is unavailable
-#if !defined(SUPPORT_DX11)
-	initUsingVulkan = true;
-#endif
+	// Find out which game this is, to pick which [app:...] sections apply
+	DetectApplication();
 
 	// If we're on Windows, look for a config file next to the DLL
 	// If we're on Linux, skip that and just check the working directory.
@@ -204,42 +348,216 @@ Config::Config()
 		}
 	}
 
-	OOVR_LOG("Checking for global config file...");
-	wstring file = dir + L"opencomposite.ini";
-	int err = wini_parse(file.c_str(), ini_handler, this);
-#else
-	int err = -1;
-	wstring file;
+	configFiles.push_back(dir + L"opencomposite.ini");
 #endif
 
-	if (err == -1 || err == 0) {
-		// No such file or it was parsed successfully, check the working directory
-		// for a file that overrides some properties
-		char buff[FILENAME_MAX];
-		GetCurrentDir(buff, FILENAME_MAX);
-		file = wstring(&buff[0], &buff[strlen(buff)]);
+	// Then check the working directory for a file that overrides some properties
+	char buff[FILENAME_MAX];
+	GetCurrentDir(buff, FILENAME_MAX);
+	wstring file = wstring(&buff[0], &buff[strlen(buff)]);
 #ifdef _WIN32
-		file += L"\\opencomposite.ini";
+	file += L"\\opencomposite.ini";
 #else
-		file += L"/opencomposite.ini";
+	file += L"/opencomposite.ini";
 #endif
-		OOVR_LOG("Checking for app specific config file...");
-		err = wini_parse(file.c_str(), ini_handler, this);
-	}
+	configFiles.push_back(file);
 
-	if (err == -1) {
-		// Couldn't open file, no problen since the config file is optional and
-		//  the defaults are set up as the default values for the variables
-		return;
-	} else if (err) {
-		// err is the line number
+	Options* options = new Options();
+	snapshots.emplace_back(options);
+
+	int err = ReadFiles(*options);
+	if (err != -1 && err != 0) {
 		string str = "Config error on line " + to_string(err);
 		ABORT(str);
 	}
 
-	// Everything should have been set up by ini_handler
+	current.store(options, std::memory_order_release);
+
+	OOVR_LOGF("Effective configuration for '%s' (Steam app ID '%s'):", appExecutable.c_str(), appSteamId.c_str());
+#define CFGOPT(type, vname, live) OOVR_LOGF("  %s = %s", #vname, format_##type(options->vname).c_str());
+	CONFIG_OPTIONS(CFGOPT)
+#undef CFGOPT
 }
 
 Config::~Config()
 {
+#ifdef _WIN32
+	// The game should have called VR_Shutdown by now, which stops the watcher. If it didn't, the process is exiting
+	// and the thread has already been killed, and joining it under the loader lock would deadlock.
+	if (watcher.joinable())
+		watcher.detach();
+#else
+	StopWatching();
+#endif
+}
+
+bool Config::ApplyPendingReload()
+{
+	if (!watching.load(std::memory_order_relaxed)) {
+		std::lock_guard lock(watcherMutex);
+		if (!watching) {
+			stopWatching = false;
+			watcher = std::thread(&Config::WatchFiles, this);
+			watching = true;
+		}
+	}
+
+	if (!reloadPending.load(std::memory_order_acquire))
+		return false;
+
+	std::lock_guard lock(reloadMutex);
+	reloadPending = false;
+	if (!pendingOptions)
+		return false;
+
+	const Options* options = pendingOptions.get();
+	snapshots.push_back(std::move(pendingOptions));
+	current.store(options, std::memory_order_release);
+
+	OOVR_LOG("Applied the new config options");
+	return true;
+}
+
+void Config::StopWatching()
+{
+	std::lock_guard lock(watcherMutex);
+	if (!watching)
+		return;
+
+	stopWatching = true;
+	watcher.join();
+	watching = false;
+}
+
+void Config::Reload()
+{
+	auto options = std::make_unique<Options>();
+
+	reloading = true;
+	bool valid = false;
+	try {
+		int err = ReadFiles(*options);
+		valid = err == 0 || err == -1;
+		if (!valid)
+			OOVR_LOGF("Config error on line %d, keeping the current options", err);
+	} catch (const std::runtime_error& e) {
+		// From a bad value in a per-game section, which are only parsed after reading all the files
+		OOVR_LOGF("Config error: %s, keeping the current options", e.what());
+	}
+	reloading = false;
+
+	if (!valid)
+		return;
+
+	std::lock_guard lock(reloadMutex);
+
+	// Compare against the newest options, even if they haven't been published yet
+	const Options& old = pendingOptions ? *pendingOptions : Current();
+
+	bool changed = false;
+#define CFGOPT(type, vname, live)                                                                                      \
+	if (format_##type(options->vname) != format_##type(old.vname)) {                                                   \
+		if (live) {                                                                                                    \
+			OOVR_LOGF("Config option %s changed from %s to %s", #vname, format_##type(old.vname).c_str(),              \
+			    format_##type(options->vname).c_str());                                                                \
+			changed = true;                                                                                            \
+		} else {                                                                                                       \
+			OOVR_LOGF("Config option %s changed to %s, but this only takes effect after restarting the game", #vname, \
+			    format_##type(options->vname).c_str());                                                                \
+			options->vname = old.vname;                                                                                \
+		}                                                                                                              \
+	}
+
+	CONFIG_OPTIONS(CFGOPT)
+
+#undef CFGOPT
+
+	if (!changed)
+		return;
+
+	pendingOptions = std::move(options);
+	reloadPending.store(true, std::memory_order_release);
+}
+
+void Config::WatchFiles()
+{
+	std::wstring_convert<std::codecvt_utf8<wchar_t>> CHAR_CONV;
+
+#ifdef __linux__
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd == -1) {
+		OOVR_LOGF("Could not watch the config files for changes: %s", strerror(errno));
+		return;
+	}
+
+	// Watch the directories rather than the files, since the files may not exist yet and many editors
+	// save by writing a new file and renaming it over the old one.
+	for (const wstring& file : configFiles) {
+		string path = CHAR_CONV.to_bytes(file);
+		string dir = path.substr(0, path.rfind('/') + 1);
+		if (inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) == -1)
+			OOVR_LOGF("Could not watch '%s' for config changes: %s", dir.c_str(), strerror(errno));
+	}
+
+	pollfd pfd = { fd, POLLIN, 0 };
+	while (!stopWatching) {
+		// Wake up regularly to check if we should stop
+		if (poll(&pfd, 1, 250) <= 0)
+			continue;
+
+		// Saving a file often shows up as several events, so wait for them to stop before reading it
+		bool changed = false;
+		do {
+			alignas(inotify_event) char buffer[4096];
+			ssize_t len;
+			while ((len = read(fd, buffer, sizeof(buffer))) > 0) {
+				for (char* ptr = buffer; ptr < buffer + len;) {
+					const inotify_event* event = (const inotify_event*)ptr;
+					if (event->len && strcmp(event->name, "opencomposite.ini") == 0)
+						changed = true;
+					ptr += sizeof(inotify_event) + event->len;
+				}
+			}
+		} while (poll(&pfd, 1, 100) > 0);
+
+		if (changed)
+			Reload();
+	}
+
+	close(fd);
+#else
+	// Without inotify, poll the modification times of the files instead
+	auto modifiedTime = [&](const wstring& file) -> int64_t {
+#ifdef _WIN32
+		struct _stat64 info;
+		if (_wstat64(file.c_str(), &info) != 0)
+			return -1;
+#else
+		struct stat info;
+		if (stat(CHAR_CONV.to_bytes(file).c_str(), &info) != 0)
+			return -1;
+#endif
+		return (int64_t)info.st_mtime;
+	};
+
+	std::vector<int64_t> times;
+	for (const wstring& file : configFiles)
+		times.push_back(modifiedTime(file));
+
+	while (!stopWatching) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+		bool changed = false;
+		for (size_t i = 0; i < configFiles.size(); i++) {
+			int64_t time = modifiedTime(configFiles.at(i));
+			if (time != times.at(i)) {
+				times.at(i) = time;
+				changed = true;
+			}
+		}
+
+		if (changed)
+			Reload();
+	}
+#endif
 }
@@ -1,43 +1,148 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * The options from opencomposite.ini.
+ *
+ * The config files are watched while the game is running, and edits to them are re-read on a background thread. Most
+ * options take effect at the start of the next frame (see ApplyPendingReload), so things like the supersample ratio
+ * or hand colour can be tuned without restarting the game. Options which are only used while starting up, such as
+ * dx10Mode, keep their old value and a message is logged saying the game needs restarting.
+ *
+ * The values are kept in an immutable snapshot, which is swapped out as a whole when the file changes. The getters
+ * are a single atomic load, so they're fine to call on hot paths.
+ */
 class Config {
 public:
 	Config();
 	~Config();
 
-	bool RenderCustomHands() const { return renderCustomHands; }
-	vr::HmdColor_t HandColour() const { return handColour; }
-	float SupersampleRatio() const { return supersampleRatio; }
-	bool Haptics() const { return haptics; }
-	bool AdmitUnknownProps() const { return admitUnknownProps; }
-	inline bool LogGetTrackedProperty() const { return logGetTrackedProperty; }
-	inline bool StopOnSoftAbort() const { return stopOnSoftAbort; }
-	inline bool DX10Mode() const { return dx10Mode; }
-	inline bool EnableHiddenMeshFix() const { return enableHiddenMeshFix; }
-	inline bool InvertUsingShaders() const { return invertUsingShaders; }
-	inline bool InitUsingVulkan() const { return initUsingVulkan; }
-	float HiddenMeshVerticalScale() const { return hiddenMeshVerticalScale; }
-	inline bool LogAllOpenVRCalls() const { return logAllOpenVRCalls; }
+	bool RenderCustomHands() const { return Current().renderCustomHands; }
+	vr::HmdColor_t HandColour() const { return Current().handColour; }
+	float SupersampleRatio() const { return Current().supersampleRatio; }
+	bool Haptics() const { return Current().haptics; }
+	bool AdmitUnknownProps() const { return Current().admitUnknownProps; }
+	inline bool LogGetTrackedProperty() const { return Current().logGetTrackedProperty; }
+	inline bool StopOnSoftAbort() const { return Current().stopOnSoftAbort; }
+	inline bool DX10Mode() const { return Current().dx10Mode; }
+	inline bool EnableHiddenMeshFix() const { return Current().enableHiddenMeshFix; }
+	inline bool InvertUsingShaders() const { return Current().invertUsingShaders; }
+	inline bool InitUsingVulkan() const { return Current().initUsingVulkan; }
+	float HiddenMeshVerticalScale() const { return Current().hiddenMeshVerticalScale; }
+	inline float RefreshRate() const { return Current().refreshRate; }
+	inline bool LogAllOpenVRCalls() const { return Current().logAllOpenVRCalls; }
+	inline bool CaptureOpenVRCalls() const { return Current().captureOpenVRCalls; }
+
+	/**
+	 * Publish the options from the last time a config file was edited, if that's happened since this was last
+	 * called. This is called once per frame from WaitGetPoses, so options only ever change between frames.
+	 *
+	 * The first call also starts watching the config files.
+	 *
+	 * Returns true if the options have changed.
+	 */
+	bool ApplyPendingReload();
+
+	/**
+	 * Stop watching the config files, for when the game shuts down OpenVR. Watching starts again if
+	 * ApplyPendingReload is called.
+	 */
+	void StopWatching();
 
 private:
+	struct Options {
+		bool renderCustomHands = true;
+		vr::HmdColor_t handColour = vr::HmdColor_t{ 0.3f, 0.3f, 0.3f, 1 };
+		float supersampleRatio = 1.0f;
+		bool haptics = true;
+		bool admitUnknownProps = false;
+		bool logGetTrackedProperty = false;
+		bool stopOnSoftAbort = false;
+		bool dx10Mode = false;
+		bool enableHiddenMeshFix = true;
+		bool invertUsingShaders = false;
+#if defined(SUPPORT_DX11)
+		bool initUsingVulkan = false;
+#else
+		// Initialise using Vulkan if D3D11 is unavailable
+		bool initUsingVulkan = true;
+#endif
+		float hiddenMeshVerticalScale = 1.0f;
+		float refreshRate = 0.0f;
+		bool logAllOpenVRCalls = false;
+		bool captureOpenVRCalls = false;
+	};
+
+	struct AppOverride {
+		std::string name;
+		std::string value;
+		int line;
+	};
+
+	// The state used by ini_handler while reading the config files
+	struct ParseState {
+		const Config* config;
+		Options* options;
+		std::vector<AppOverride> appOverrides;
+	};
+
+	const Options& Current() const { return *current.load(std::memory_order_acquire); }
+
 	static int ini_handler(
 	    void* user, const char* section,
 	    const char* name, const char* value,
 	    int lineno);
 
-	bool renderCustomHands = true;
-	vr::HmdColor_t handColour = vr::HmdColor_t{ 0.3f, 0.3f, 0.3f, 1 };
-	float supersampleRatio = 1.0f;
-	bool haptics = true;
-	bool admitUnknownProps = false;
-	bool logGetTrackedProperty = false;
-	bool stopOnSoftAbort = false;
-	bool dx10Mode = false;
-	bool enableHiddenMeshFix = true;
-	bool invertUsingShaders = false;
-	bool initUsingVulkan = false;
-	float hiddenMeshVerticalScale = 1.0f;
-	bool logAllOpenVRCalls = false;
+	// Set an option from its string value, returning false if there's no such option
+	static bool SetOption(Options& options, const std::string& name, const std::string& value, int lineno);
+
+	// Read every config file into options, which should already hold the defaults. This returns the line
+	// number of the first error, -1 if there are no config files, or 0 if they were all read successfully.
+	int ReadFiles(Options& options) const;
+
+	// Find the executable name and Steam app ID of the game we're running in
+	void DetectApplication();
+
+	// Check if an [app:key] section applies to this game. The key may be the executable name (with or
+	// without .exe) or the Steam app ID, and is case-insensitive.
+	bool MatchesApplication(const std::string& key) const;
+
+	// Run on the watcher thread until StopWatching is called, calling Reload when a config file is changed
+	void WatchFiles();
+
+	// Re-read the config files and store the result in pendingOptions. Mistakes in the files are logged rather
+	// than aborting, and the old options are kept.
+	void Reload();
+
+	std::string appExecutable;
+	std::string appSteamId;
+
+	// The config files we read, in the order they're read. They may not all exist.
+	std::vector<std::wstring> configFiles;
+
+	std::atomic<const Options*> current;
+
+	// Every set of options that has been published. These are never freed (until shutdown) as another thread
+	// could still be reading from an old one, which is cheap as they're small and only made when the user
+	// edits a config file.
+	std::vector<std::unique_ptr<const Options>> snapshots;
+
+	// Guards pendingOptions and snapshots
+	std::mutex reloadMutex;
+	std::unique_ptr<Options> pendingOptions;
+	std::atomic<bool> reloadPending = false;
+
+	// Guards starting and stopping the watcher thread
+	std::mutex watcherMutex;
+	std::thread watcher;
+	std::atomic<bool> watching = false;
+	std::atomic<bool> stopWatching = false;
 };
 
 extern Config oovr_global_configuration;
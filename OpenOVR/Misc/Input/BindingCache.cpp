@@ -0,0 +1,153 @@
+#include "stdafx.h"
+
+#include "BindingCache.h"
+
+#include "InteractionProfile.h"
+#include "generated/version.h"
+#include "json/json.h"
+
+#include <codecvt>
+#include <fstream>
+#include <locale>
+
+static constexpr uint64_t FNV_OFFSET_BASIS = 0xcbf29ce484222325;
+static constexpr uint64_t FNV_PRIME = 0x100000001b3;
+
+static uint64_t HashBytes(uint64_t hash, const std::string& data)
+{
+	for (char c : data) {
+		hash ^= (uint8_t)c;
+		hash *= FNV_PRIME;
+	}
+
+	// Include the length, so moving bytes from one source to the next changes the hash
+	uint64_t size = data.size();
+	for (int i = 0; i < 8; i++) {
+		hash ^= (uint8_t)(size >> (i * 8));
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+static std::string HashToString(uint64_t hash)
+{
+	char str[17];
+	snprintf(str, sizeof(str), "%016llx", (unsigned long long)hash);
+	return str;
+}
+
+#ifdef _WIN32
+// The paths are UTF-8, which the narrow fstream constructors wouldn't understand
+static std::wstring NativePath(const std::string& path)
+{
+	std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
+	return converter.from_bytes(path);
+}
+#else
+static const std::string& NativePath(const std::string& path)
+{
+	return path;
+}
+#endif
+
+BindingCache::BindingCache(const std::string& manifestPath)
+{
+	// One file per game, which is overwritten whenever its bindings change
+	std::string name = "bindingcache-" + HashToString(HashBytes(FNV_OFFSET_BASIS, manifestPath)) + ".json";
+	filePath = oovr_config_path(name);
+
+	key = HashBytes(FNV_OFFSET_BASIS, OC_VERSION);
+	for (const std::unique_ptr<InteractionProfile>& profile : InteractionProfile::GetProfileList())
+		key = HashBytes(key, profile->GetPath());
+}
+
+void BindingCache::AddSource(const std::string& contents)
+{
+	key = HashBytes(key, contents);
+}
+
+bool BindingCache::Load()
+{
+	if (filePath.empty())
+		return false;
+
+	std::ifstream in(NativePath(filePath), std::ios::binary);
+	if (!in)
+		return false;
+
+	Json::Value root;
+	Json::CharReaderBuilder builder;
+	std::string errors;
+	if (!Json::parseFromStream(builder, in, &root, &errors)) {
+		OOVR_LOGF("Ignoring broken binding cache '%s': %s", filePath.c_str(), errors.c_str());
+		return false;
+	}
+
+	if (root["key"].asString() != HashToString(key))
+		return false;
+
+	const Json::Value& profilesJson = root["profiles"];
+	if (!profilesJson.isObject())
+		return false;
+
+	for (const std::string& profilePath : profilesJson.getMemberNames()) {
+		const InteractionProfile* profile = InteractionProfile::GetProfileByPath(profilePath);
+		if (!profile)
+			continue;
+
+		const Json::Value& translations = profilesJson[profilePath];
+		for (const std::string& inputPath : translations.getMemberNames()) {
+			std::string translated = translations[inputPath].asString();
+			profile->AddTranslatedPath(inputPath, translated);
+
+			if (profile->IsInputPathValid(translated))
+				GetPath(translated);
+		}
+	}
+
+	OOVR_LOGF("Loaded binding cache '%s', %d paths interned", filePath.c_str(), (int)paths.size());
+	loaded = true;
+	return true;
+}
+
+XrPath BindingCache::GetPath(const std::string& path)
+{
+	auto iter = paths.find(path);
+	if (iter != paths.end())
+		return iter->second;
+
+	XrPath xrPath;
+	OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, path.c_str(), &xrPath));
+	paths[path] = xrPath;
+	return xrPath;
+}
+
+void BindingCache::Save() const
+{
+	if (loaded || filePath.empty())
+		return;
+
+	Json::Value root(Json::objectValue);
+	root["key"] = HashToString(key);
+
+	Json::Value& profilesJson = root["profiles"] = Json::Value(Json::objectValue);
+	for (const std::unique_ptr<InteractionProfile>& profile : InteractionProfile::GetProfileList()) {
+		const auto& translated = profile->GetTranslatedPaths();
+		if (translated.empty())
+			continue;
+
+		Json::Value& translations = profilesJson[profile->GetPath()] = Json::Value(Json::objectValue);
+		for (const auto& [inputPath, outputPath] : translated)
+			translations[inputPath] = outputPath;
+	}
+
+	std::ofstream out(NativePath(filePath), std::ios::binary);
+	if (!out) {
+		OOVR_LOGF("Could not write the binding cache '%s'", filePath.c_str());
+		return;
+	}
+
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = "";
+	out << Json::writeString(builder, root);
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Stores the input paths the interaction profiles resolved while loading a game's bindings in the OpenComposite
+ * config directory, so the next time the same game starts they can be reused rather than translated again.
+ *
+ * There's one cache file per action manifest. It's only used if its key matches a hash of everything the paths were
+ * resolved from: the action manifest and bindings file contents, the interaction profiles, and the OpenComposite
+ * version. Otherwise it's rewritten once the bindings have been loaded.
+ *
+ * Only the path strings are stored, since XrPaths are only valid for the instance that created them. They're
+ * interned again when the cache is loaded.
+ */
+class BindingCache {
+public:
+	BindingCache() = default;
+	explicit BindingCache(const std::string& manifestPath);
+
+	/**
+	 * Add the contents of a file the bindings are loaded from to the cache key. All the sources must be added
+	 * before calling Load.
+	 */
+	void AddSource(const std::string& contents);
+
+	/**
+	 * Try to load the cached paths, giving each interaction profile its translations back and interning the
+	 * valid paths. Returns false if there's no cache file, or it was built from different sources.
+	 */
+	bool Load();
+
+	/**
+	 * Get the XrPath for a resolved input path, interning it if it wasn't in the cache.
+	 */
+	XrPath GetPath(const std::string& path);
+
+	/**
+	 * Write out the paths the interaction profiles have resolved, if they weren't loaded from the cache.
+	 */
+	void Save() const;
+
+private:
+	std::string filePath;
+
+	// FNV-1a over the sources, seeded with the OpenComposite version and the interaction profiles
+	uint64_t key = 0;
+
+	bool loaded = false;
+
+	std::unordered_map<std::string, XrPath> paths;
+};
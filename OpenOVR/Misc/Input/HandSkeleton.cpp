@@ -0,0 +1,130 @@
+#include "HandSkeleton.h"
+
+#include <cmath>
+#include <limits>
+
+static constexpr int fingerFirstBone[VRFinger_Count] = { eBone_Thumb0, eBone_IndexFinger0, eBone_MiddleFinger0, eBone_RingFinger0, eBone_PinkyFinger0 };
+static constexpr int fingerBoneCount[VRFinger_Count] = { 4, 5, 5, 5, 5 };
+
+// Find which finger a bone belongs to, or -1 for the root and wrist
+static int GetBoneFinger(int bone)
+{
+	if (bone >= eBone_Aux_Thumb)
+		return bone - eBone_Aux_Thumb;
+
+	for (int finger = VRFinger_Count - 1; finger >= 0; finger--) {
+		if (bone >= fingerFirstBone[finger])
+			return finger;
+	}
+
+	return -1;
+}
+
+void GetEstimatedBoneWeights(float thumbTouch, float triggerTouch, float trigger, float grip, float (&weights)[eBone_Count])
+{
+	// Applying several blends to a bone one after the other is the same as a single blend of 1 - (1-a)(1-b), so
+	// these are combined up-front to blend each bone once.
+	float fingerWeights[VRFinger_Count] = {};
+
+	// Put the thumb down on touch
+	fingerWeights[VRFinger_Thumb] = thumbTouch;
+
+	// Curl fingers on trigger touch
+	// SteamVR does something similar, curling adjacent fingers to make them look more natural
+	fingerWeights[VRFinger_Index] = 0.4f * triggerTouch;
+	fingerWeights[VRFinger_Middle] = 0.2f * triggerTouch;
+	fingerWeights[VRFinger_Ring] = 0.1f * triggerTouch;
+
+	auto combine = [](float current, float pct) { return 1.0f - (1.0f - current) * (1.0f - pct); };
+
+	// Bend the index finger on trigger
+	fingerWeights[VRFinger_Index] = combine(fingerWeights[VRFinger_Index], trigger);
+
+	// Bend the 3 remaining fingers on grip
+	for (int finger = VRFinger_Middle; finger <= VRFinger_Pinky; finger++)
+		fingerWeights[finger] = combine(fingerWeights[finger], grip);
+
+	for (int bone = 0; bone < eBone_Count; bone++) {
+		int finger = GetBoneFinger(bone);
+		weights[bone] = finger == -1 ? 0.0f : fingerWeights[finger];
+	}
+}
+
+void BlendBones(BoneSoA& out, const BoneSoA& from, const BoneSoA& to, const float (&weights)[eBone_Count])
+{
+	for (int i = 0; i < eBone_Count; i++) {
+		float t = weights[i];
+		out.px[i] = from.px[i] + (to.px[i] - from.px[i]) * t;
+		out.py[i] = from.py[i] + (to.py[i] - from.py[i]) * t;
+		out.pz[i] = from.pz[i] + (to.pz[i] - from.pz[i]) * t;
+		out.pw[i] = t == 0.0f ? from.pw[i] : 1.0f;
+	}
+
+	// Find the slerp coefficients first, so the trigonometry doesn't stop the rest from being vectorised
+	float fromScale[eBone_Count];
+	float toScale[eBone_Count];
+	for (int i = 0; i < eBone_Count; i++) {
+		float t = weights[i];
+		float cosTheta = from.qw[i] * to.qw[i] + from.qx[i] * to.qx[i] + from.qy[i] * to.qy[i] + from.qz[i] * to.qz[i];
+
+		if (t == 0.0f) {
+			fromScale[i] = 1.0f;
+			toScale[i] = 0.0f;
+		} else if (cosTheta > 1.0f - std::numeric_limits<float>::epsilon()) {
+			// The rotations are nearly the same, so interpolate linearly to avoid dividing by sin(0)
+			fromScale[i] = 1.0f - t;
+			toScale[i] = t;
+		} else {
+			float angle = acosf(cosTheta);
+			float sinAngle = sinf(angle);
+			fromScale[i] = sinf((1.0f - t) * angle) / sinAngle;
+			toScale[i] = sinf(t * angle) / sinAngle;
+		}
+	}
+
+	for (int i = 0; i < eBone_Count; i++) {
+		out.qw[i] = from.qw[i] * fromScale[i] + to.qw[i] * toScale[i];
+		out.qx[i] = from.qx[i] * fromScale[i] + to.qx[i] * toScale[i];
+		out.qy[i] = from.qy[i] * fromScale[i] + to.qy[i] * toScale[i];
+		out.qz[i] = from.qz[i] * fromScale[i] + to.qz[i] * toScale[i];
+	}
+}
+
+// Set bone to parent * bone, where the position is rotated by the parent's orientation and then offset by its position.
+static inline void ConcatenateBone(BoneSoA& b, int parent, int bone)
+{
+	float pw = b.qw[parent], pqx = b.qx[parent], pqy = b.qy[parent], pqz = b.qz[parent];
+	float vx = b.px[bone], vy = b.py[bone], vz = b.pz[bone];
+
+	// Rotate the position by the parent's orientation: v + w*t + cross(q, t) where t = 2*cross(q, v)
+	float tx = 2.0f * (pqy * vz - pqz * vy);
+	float ty = 2.0f * (pqz * vx - pqx * vz);
+	float tz = 2.0f * (pqx * vy - pqy * vx);
+
+	b.px[bone] = b.px[parent] + vx + pw * tx + (pqy * tz - pqz * ty);
+	b.py[bone] = b.py[parent] + vy + pw * ty + (pqz * tx - pqx * tz);
+	b.pz[bone] = b.pz[parent] + vz + pw * tz + (pqx * ty - pqy * tx);
+
+	// SteamVR seems to accumulate this? Might not be needed
+	b.pw[bone] = b.pw[parent] + 1.0f;
+
+	float cw = b.qw[bone], cx = b.qx[bone], cy = b.qy[bone], cz = b.qz[bone];
+	b.qw[bone] = pw * cw - pqx * cx - pqy * cy - pqz * cz;
+	b.qx[bone] = pw * cx + pqx * cw + pqy * cz - pqz * cy;
+	b.qy[bone] = pw * cy - pqx * cz + pqy * cw + pqz * cx;
+	b.qz[bone] = pw * cz + pqx * cy - pqy * cx + pqz * cw;
+}
+
+void BonesToModelSpace(BoneSoA& bones)
+{
+	// Each bone depends on the one before it, so the fingers are walked in step with each other rather than one at a time
+	for (int depth = 0; depth < 5; depth++) {
+		for (int finger = 0; finger < VRFinger_Count; finger++) {
+			if (depth >= fingerBoneCount[finger])
+				continue;
+
+			int bone = fingerFirstBone[finger] + depth;
+			ConcatenateBone(bones, depth == 0 ? eBone_Wrist : bone - 1, bone);
+		}
+	}
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "generated/interfaces/public_vrtypes.h"
+
+// From https://github.com/ValveSoftware/openvr/wiki/Hand-Skeleton
+// Used as indexes into the skeleton output data
+enum HandSkeletonBone {
+	eBone_Root = 0,
+	eBone_Wrist,
+	eBone_Thumb0,
+	eBone_Thumb1,
+	eBone_Thumb2,
+	eBone_Thumb3,
+	eBone_IndexFinger0,
+	eBone_IndexFinger1,
+	eBone_IndexFinger2,
+	eBone_IndexFinger3,
+	eBone_IndexFinger4,
+	eBone_MiddleFinger0,
+	eBone_MiddleFinger1,
+	eBone_MiddleFinger2,
+	eBone_MiddleFinger3,
+	eBone_MiddleFinger4,
+	eBone_RingFinger0,
+	eBone_RingFinger1,
+	eBone_RingFinger2,
+	eBone_RingFinger3,
+	eBone_RingFinger4,
+	eBone_PinkyFinger0,
+	eBone_PinkyFinger1,
+	eBone_PinkyFinger2,
+	eBone_PinkyFinger3,
+	eBone_PinkyFinger4,
+	eBone_Aux_Thumb,
+	eBone_Aux_IndexFinger,
+	eBone_Aux_MiddleFinger,
+	eBone_Aux_RingFinger,
+	eBone_Aux_PinkyFinger,
+	eBone_Count
+};
+
+enum OOVR_EVRFinger {
+	VRFinger_Thumb = 0,
+	VRFinger_Index,
+	VRFinger_Middle,
+	VRFinger_Ring,
+	VRFinger_Pinky,
+	VRFinger_Count
+};
+
+// SKELETON MATH
+// Blending and space conversion is done on the whole skeleton at once, with each component of the bones stored in
+// its own array. Unlike VRBoneTransform_t's interleaved layout, this lets the compiler vectorise the loops in
+// HandSkeleton.cpp. This has no dependencies on the rest of OpenComposite, so it can be tested on its own.
+struct BoneSoA {
+	alignas(32) float px[eBone_Count];
+	alignas(32) float py[eBone_Count];
+	alignas(32) float pz[eBone_Count];
+	alignas(32) float pw[eBone_Count];
+
+	alignas(32) float qw[eBone_Count];
+	alignas(32) float qx[eBone_Count];
+	alignas(32) float qy[eBone_Count];
+	alignas(32) float qz[eBone_Count];
+
+	void Load(const vr::VRBoneTransform_t* bones)
+	{
+		for (int i = 0; i < eBone_Count; i++) {
+			px[i] = bones[i].position.v[0];
+			py[i] = bones[i].position.v[1];
+			pz[i] = bones[i].position.v[2];
+			pw[i] = bones[i].position.v[3];
+
+			qw[i] = bones[i].orientation.w;
+			qx[i] = bones[i].orientation.x;
+			qy[i] = bones[i].orientation.y;
+			qz[i] = bones[i].orientation.z;
+		}
+	}
+
+	void Store(vr::VRBoneTransform_t* bones) const
+	{
+		for (int i = 0; i < eBone_Count; i++) {
+			bones[i].position = { px[i], py[i], pz[i], pw[i] };
+			bones[i].orientation = { qw[i], qx[i], qy[i], qz[i] };
+		}
+	}
+};
+
+/**
+ * Find how far each bone of an estimated skeleton is bent from the open pose towards the closed one, from the
+ * controller state: how far the thumb and trigger are towards being touched, and the trigger and grip values.
+ */
+void GetEstimatedBoneWeights(float thumbTouch, float triggerTouch, float trigger, float grip, float (&weights)[eBone_Count]);
+
+/**
+ * Move each bone from its pose in `from` towards its pose in `to` by that bone's weight, interpolating the
+ * rotation the same way glm::mix does. Bones with a weight of zero are copied from `from` unchanged.
+ */
+void BlendBones(BoneSoA& out, const BoneSoA& from, const BoneSoA& to, const float (&weights)[eBone_Count]);
+
+/**
+ * Convert a skeleton from parent space to model space, by concatenating each finger bone with its parent starting
+ * from the wrist.
+ */
+void BonesToModelSpace(BoneSoA& bones);
@@ -0,0 +1,88 @@
+#include "stdafx.h"
+
+#include "HapticScheduler.h"
+
+#include <algorithm>
+
+void HapticScheduler::Schedule(XrAction action, XrPath subactionPath, double startTime, double duration, float frequency, float amplitude)
+{
+	if (action == XR_NULL_HANDLE || duration <= 0 || amplitude <= 0)
+		return;
+
+	std::lock_guard lock(mutex);
+
+	// There's only ever a handful of outputs (one per hand for legacy input, plus the game's haptic actions)
+	auto iter = std::find_if(outputs.begin(), outputs.end(), [&](const Output& output) {
+		return output.action == action && output.subactionPath == subactionPath;
+	});
+	if (iter == outputs.end()) {
+		iter = outputs.insert(outputs.end(), Output{});
+		iter->action = action;
+		iter->subactionPath = subactionPath;
+	}
+
+	iter->pending.push_back(Pulse{
+	    .startTime = startTime,
+	    .duration = duration,
+	    .frequency = frequency,
+	    .amplitude = std::min(amplitude, 1.0f),
+	});
+}
+
+void HapticScheduler::Flush(XrSession session, double now)
+{
+	std::lock_guard lock(mutex);
+
+	for (Output& output : outputs) {
+		if (output.pending.empty())
+			continue;
+
+		// Merge all the pulses that have come due into a single vibration. Each of them is played for its full
+		// duration from now, since a pulse which is shorter than a frame would otherwise always be missed.
+		bool due = false;
+		double mergedEndTime = now;
+		float mergedFrequency = 0;
+		float mergedAmplitude = 0;
+		for (const Pulse& pulse : output.pending) {
+			if (pulse.startTime > now)
+				continue;
+
+			due = true;
+			mergedEndTime = std::max(mergedEndTime, now + pulse.duration);
+			if (pulse.amplitude > mergedAmplitude) {
+				mergedAmplitude = pulse.amplitude;
+				mergedFrequency = pulse.frequency;
+			}
+		}
+
+		// Drop everything that's been merged, and keep the future pulses
+		std::erase_if(output.pending, [now](const Pulse& pulse) { return pulse.startTime <= now; });
+
+		if (!due)
+			continue;
+
+		// If the runtime is still playing something at least this strong for at least this long, there's nothing to do
+		if (output.activeEndTime >= mergedEndTime && output.activeAmplitude >= mergedAmplitude)
+			continue;
+
+		XrHapticActionInfo info = { XR_TYPE_HAPTIC_ACTION_INFO };
+		info.action = output.action;
+		info.subactionPath = output.subactionPath;
+
+		XrHapticVibration vibration = { XR_TYPE_HAPTIC_VIBRATION };
+		vibration.frequency = mergedFrequency == 0.0f ? XR_FREQUENCY_UNSPECIFIED : mergedFrequency;
+		vibration.duration = (XrDuration)((mergedEndTime - now) * 1000000000.0);
+		vibration.amplitude = mergedAmplitude;
+
+		OOVR_FAILED_XR_SOFT_ABORT(xrApplyHapticFeedback(session, &info, (XrHapticBaseHeader*)&vibration));
+
+		output.activeEndTime = mergedEndTime;
+		output.activeAmplitude = mergedAmplitude;
+	}
+}
+
+void HapticScheduler::Clear()
+{
+	std::lock_guard lock(mutex);
+	outputs.clear();
+}
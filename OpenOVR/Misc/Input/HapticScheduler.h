@@ -0,0 +1,57 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <mutex>
+#include <vector>
+
+/**
+ * Collects the haptic pulses requested for each haptic output (an OpenXR haptic action, and the subaction path it's
+ * restricted to) and sends them to the runtime when they're due, at most once per output each time it's flushed.
+ *
+ * OpenVR lets games schedule pulses some time in the future, which OpenXR can't do. Legacy games also commonly call
+ * TriggerHapticPulse every frame (or several times a frame), and passing each of those to the runtime is wasteful.
+ * Instead pulses are queued here, and any that have come due are merged when the scheduler is flushed each frame: the
+ * merged vibration lasts as long as the longest of them, at the strongest amplitude any of them asked for.
+ *
+ * All times are in seconds, from BackendManager::GetTimeInSeconds.
+ */
+class HapticScheduler {
+public:
+	/**
+	 * Queue a vibration to start at startTime and last for duration seconds. A frequency of zero means the
+	 * runtime should pick the frequency.
+	 */
+	void Schedule(XrAction action, XrPath subactionPath, double startTime, double duration, float frequency, float amplitude);
+
+	/**
+	 * Send any pulses that are due at the given time to the runtime.
+	 */
+	void Flush(XrSession session, double now);
+
+	/**
+	 * Drop all the queued pulses, for example because the actions they're for have been destroyed.
+	 */
+	void Clear();
+
+private:
+	struct Pulse {
+		double startTime;
+		double duration;
+		float frequency;
+		float amplitude;
+	};
+
+	struct Output {
+		XrAction action = XR_NULL_HANDLE;
+		XrPath subactionPath = XR_NULL_PATH;
+		std::vector<Pulse> pending;
+
+		// The vibration most recently sent to the runtime, so pulses which wouldn't change it can be skipped
+		double activeEndTime = 0;
+		float activeAmplitude = 0;
+	};
+
+	std::mutex mutex;
+	std::vector<Output> outputs;
+};
@@ -4,6 +4,7 @@
 
 #include "stdafx.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "HolographicInteractionProfile.h"
@@ -20,10 +21,14 @@
 #include "Reimpl/BaseInput.h"
 #include "generated/static_bases.gen.h"
 
-std::string InteractionProfile::TranslateAction(const std::string& inputPath) const
+const std::string& InteractionProfile::TranslateAction(const std::string& inputPath) const
 {
+	auto cached = translatedPathCache.find(inputPath);
+	if (cached != translatedPathCache.end())
+		return cached->second;
+
+	std::string ret = inputPath;
 	if (!pathTranslationMap.empty() && !IsInputPathValid(inputPath)) {
-		std::string ret = inputPath;
 		for (auto& [key, val] : pathTranslationMap) {
 			size_t loc = ret.find(key);
 			if (loc != std::string::npos) {
@@ -32,10 +37,20 @@ std::string InteractionProfile::TranslateAction(const std::string& inputPath) co
 			}
 		}
 		OOVR_LOGF("Translated path %s to %s for profile %s", inputPath.c_str(), ret.c_str(), GetPath().c_str());
-		return ret;
 	}
-	// either this path is already valid or it's invalid and not translatable
-	return inputPath;
+	// otherwise either this path is already valid or it's invalid and not translatable
+
+	return translatedPathCache.emplace(inputPath, std::move(ret)).first->second;
+}
+
+const std::unordered_map<std::string, std::string>& InteractionProfile::GetTranslatedPaths() const
+{
+	return translatedPathCache;
+}
+
+void InteractionProfile::AddTranslatedPath(const std::string& inputPath, const std::string& translatedPath) const
+{
+	translatedPathCache[inputPath] = translatedPath;
 }
 
 const std::unordered_set<std::string>& InteractionProfile::GetValidInputPaths() const
@@ -138,39 +153,92 @@ glm::mat4 InteractionProfile::GetGripToSteamVRTransform(ITrackedDevice::TrackedD
 	return glm::identity<glm::mat4>();
 }
 
-std::optional<glm::mat4> InteractionProfile::GetComponentTransform(ITrackedDevice::TrackedDeviceType hand, const std::string& name) const
+ControllerComponentId InteractionProfile::LookupComponentId(std::string_view name)
 {
-	std::unordered_map<std::string, glm::mat4> transforms = hand == ITrackedDevice::HAND_RIGHT ? rightComponentTransforms : leftComponentTransforms;
-	const auto iter = transforms.find(name);
-	if (iter == transforms.end())
-		return {};
-	else
-		return iter->second;
+	static const std::pair<std::string_view, ControllerComponentId> names[] = {
+		{ "base", ControllerComponentId::BASE },
+		{ "tip", ControllerComponentId::TIP },
+		{ "body", ControllerComponentId::BODY },
+		{ "gdc2015", ControllerComponentId::GDC2015 },
+		{ "grip", ControllerComponentId::GRIP },
+		{ "handgrip", ControllerComponentId::HANDGRIP },
+	};
+
+	for (const auto& [componentName, id] : names) {
+		if (componentName == name)
+			return id;
+	}
+	return ControllerComponentId::UNKNOWN;
+}
+
+const glm::mat4* InteractionProfile::GetComponentTransform(ITrackedDevice::TrackedDeviceType hand, ControllerComponentId component) const
+{
+	const ComponentTransforms& transforms = hand == ITrackedDevice::HAND_RIGHT ? rightComponentTransforms : leftComponentTransforms;
+	return transforms.Get(component);
 }
 
-std::optional<std::array<vr::VRBoneTransform_t, 31>> InteractionProfile::GetSkeletalReferencePose(ITrackedDevice::TrackedDeviceType hand, int pose) const
+const InteractionProfile::BoneArray* InteractionProfile::GetSkeletalReferencePose(ITrackedDevice::TrackedDeviceType hand, int pose) const
 {
-	auto poses = hand == ITrackedDevice::HAND_LEFT ? leftHandPoses : rightHandPoses;
+	const ReferencePoses& poses = hand == ITrackedDevice::HAND_LEFT ? leftHandPoses : rightHandPoses;
 
 	// Fall back to oculus poses, which should be close enough for most controllers
 	if (poses.empty()) {
 		OOVR_LOG_ONCE("WARNING: No reference poses defined for interaction profile, using fallback.");
-		if (hand == ITrackedDevice::HAND_LEFT) {
+
+		static const ReferencePoses fallbackLeft = [] {
+			ReferencePoses poses;
 			poses[VRSkeletalReferencePose_BindPose] = oculus::leftBindPose;
 			poses[VRSkeletalReferencePose_OpenHand] = oculus::leftOpenHandPose;
 			poses[VRSkeletalReferencePose_Fist] = oculus::leftFistPose;
 			poses[VRSkeletalReferencePose_GripLimit] = oculus::leftGripLimitPose;
-		} else {
+			return poses;
+		}();
+		static const ReferencePoses fallbackRight = [] {
+			ReferencePoses poses;
 			poses[VRSkeletalReferencePose_BindPose] = oculus::rightBindPose;
 			poses[VRSkeletalReferencePose_OpenHand] = oculus::rightOpenHandPose;
 			poses[VRSkeletalReferencePose_Fist] = oculus::rightFistPose;
 			poses[VRSkeletalReferencePose_GripLimit] = oculus::rightGripLimitPose;
-		}
+			return poses;
+		}();
+
+		return (hand == ITrackedDevice::HAND_LEFT ? fallbackLeft : fallbackRight).Get(pose);
 	}
 
-	const auto iter = poses.find(pose);
-	if (iter == poses.end())
-		return {};
-	else
-		return iter->second;
+	return poses.Get(pose);
+}
+
+glm::mat4& InteractionProfile::ComponentTransforms::operator[](std::string_view name)
+{
+	ControllerComponentId id = LookupComponentId(name);
+	if (id == ControllerComponentId::UNKNOWN)
+		OOVR_ABORTF("Cannot set transform for unknown component '%s'", std::string(name).c_str());
+
+	present.at((size_t)id) = true;
+	return transforms.at((size_t)id);
+}
+
+const glm::mat4* InteractionProfile::ComponentTransforms::Get(ControllerComponentId component) const
+{
+	if (component >= ControllerComponentId::COUNT || !present[(size_t)component])
+		return nullptr;
+	return &transforms[(size_t)component];
+}
+
+InteractionProfile::BoneArray& InteractionProfile::ReferencePoses::operator[](int pose)
+{
+	present.at(pose) = true;
+	return poses.at(pose);
+}
+
+const InteractionProfile::BoneArray* InteractionProfile::ReferencePoses::Get(int pose) const
+{
+	if (pose < 0 || (size_t)pose >= poses.size() || !present[pose])
+		return nullptr;
+	return &poses[pose];
+}
+
+bool InteractionProfile::ReferencePoses::empty() const
+{
+	return std::ranges::none_of(present, [](bool p) { return p; });
 }
@@ -11,6 +11,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <unordered_set>
 #include <variant>
 #include <vector>
@@ -20,6 +21,25 @@
 #include "LegacyControllerActions.h"
 #include "convert.h"
 
+/**
+ * The controller components (as used by IVRRenderModels::GetComponentState and pose bindings) that an
+ * interaction profile can define transforms for.
+ *
+ * Component names are resolved to one of these once, when the binding or render model is looked up, so
+ * that per-frame lookups are simple array accesses.
+ */
+enum class ControllerComponentId : int {
+	BASE,
+	TIP,
+	BODY,
+	GDC2015,
+	GRIP,
+	HANDGRIP,
+
+	COUNT,
+	UNKNOWN = COUNT,
+};
+
 /**
  * Defines an interaction profile, as specified by 6.4 in the OpenXR spec.
  * Implementing an interaction profile is fairly straightforward, view the other interaction profiles for examples.
@@ -56,6 +76,8 @@ private:
 	};
 
 public:
+	using BoneArray = std::array<vr::VRBoneTransform_t, 31>;
+
 	virtual ~InteractionProfile() = default;
 
 	using ProfileList = std::vector<std::unique_ptr<InteractionProfile>>;
@@ -110,8 +132,17 @@ public:
 	/**
 	 * Translate an unsupported path to a supported one using the pathTranslationMap.
 	 * For example, for the simple controller, this will translate any trigger paths to select paths.
+	 *
+	 * The results are cached, since the same paths come up for each action bound to a given input.
 	 */
-	std::string TranslateAction(const std::string& inputPath) const;
+	const std::string& TranslateAction(const std::string& inputPath) const;
+
+	/**
+	 * The results of TranslateAction so far, keyed by input path. BindingCache saves these between runs, and
+	 * adds them back with AddTranslatedPath.
+	 */
+	const std::unordered_map<std::string, std::string>& GetTranslatedPaths() const;
+	void AddTranslatedPath(const std::string& inputPath, const std::string& translatedPath) const;
 
 	/**
 	 * Returns the name for the profile as recognized by OpenVR, if it is recognized by it.
@@ -154,15 +185,22 @@ public:
 	 *
 	 * For the 'tip' pose in particular, the OpenXR aim space should be used if this function
 	 * does not provide anything.
+	 *
+	 * Returns nullptr if the component isn't specified.
 	 */
-	std::optional<glm::mat4> GetComponentTransform(ITrackedDevice::TrackedDeviceType hand, const std::string& name) const;
+	const glm::mat4* GetComponentTransform(ITrackedDevice::TrackedDeviceType hand, ControllerComponentId component) const;
 
 	/**
-	 * Get the specified reference pose of a controller (in parent space).
+	 * Find the ID of a component from it's name (eg, 'tip'), or ControllerComponentId::UNKNOWN if it's not one we know about.
+	 */
+	static ControllerComponentId LookupComponentId(std::string_view name);
+
+	/**
+	 * Get the specified reference pose of a controller (in parent space), or nullptr if the pose doesn't exist.
 	 *
 	 * These will unfortunately need to be specified for each controller, but the Quest poses are used as a good-enough fallback.
 	 */
-	std::optional<std::array<vr::VRBoneTransform_t, 31>> GetSkeletalReferencePose(ITrackedDevice::TrackedDeviceType hand, int) const;
+	const BoneArray* GetSkeletalReferencePose(ITrackedDevice::TrackedDeviceType hand, int pose) const;
 
 	/**
 	 * Build a list of suggested bindings for attaching the legacy actions to this profile.
@@ -179,11 +217,16 @@ public:
 	    const
 	{
 		using enum ITrackedDevice::TrackedDeviceType;
-		if (hand != HAND_NONE && propertiesMap.contains(property)) {
-			hand_values_type ret = propertiesMap.at(property);
-			return std::get<T>((hand == HAND_RIGHT && ret.right.has_value()) ? ret.right.value() : ret.left);
-		} else if (hmdPropertiesMap.contains(property)) {
-			return std::get<T>(hmdPropertiesMap.at(property));
+		if (hand != HAND_NONE) {
+			auto iter = propertiesMap.find(property);
+			if (iter != propertiesMap.end()) {
+				const hand_values_type<property_types>& ret = iter->second;
+				return std::get<T>((hand == HAND_RIGHT && ret.right.has_value()) ? *ret.right : ret.left);
+			}
+		}
+		auto iter = hmdPropertiesMap.find(property);
+		if (iter != hmdPropertiesMap.end()) {
+			return std::get<T>(iter->second);
 		}
 		return std::nullopt;
 	}
@@ -220,6 +263,9 @@ protected:
 	// For example, one common key, value pair might be "application_menu", "menu"
 	std::map<std::string, std::string, translation_compare> pathTranslationMap;
 
+	// Results of TranslateAction, keyed by the input path.
+	mutable std::unordered_map<std::string, std::string> translatedPathCache;
+
 	// A map for HMD properties.
 	// Note that for a SteamVR supported device can be extracted from the SteamVR System Report,
 	// in the properties.json section
@@ -240,17 +286,40 @@ protected:
 	// - Prop_ControllerType_String
 	std::unordered_map<vr::ETrackedDeviceProperty, hand_values_type<property_types>> propertiesMap;
 
+	// A set of component transforms for one hand, indexed by ControllerComponentId
+	struct ComponentTransforms {
+		std::array<glm::mat4, (size_t)ControllerComponentId::COUNT> transforms;
+		std::array<bool, (size_t)ControllerComponentId::COUNT> present = {};
+
+		// Set a component's transform, by name
+		glm::mat4& operator[](std::string_view name);
+
+		const glm::mat4* Get(ControllerComponentId component) const;
+	};
+
+	// A set of skeletal reference poses for one hand, indexed by EVRSkeletalReferencePose
+	struct ReferencePoses {
+		std::array<BoneArray, vr::VRSkeletalReferencePose_GripLimit + 1> poses;
+		std::array<bool, vr::VRSkeletalReferencePose_GripLimit + 1> present = {};
+
+		// Set a reference pose
+		BoneArray& operator[](int pose);
+
+		const BoneArray* Get(int pose) const;
+		bool empty() const;
+	};
+
 	/**
 	 * The transforms of the 'components' of the controller, as exposed via BaseRenderModels::GetComponentState.
 	 *
 	 * Don't manually set 'handgrip' - instead, use GetComponentTransform.
 	 */
-	std::unordered_map<std::string, glm::mat4> leftComponentTransforms, rightComponentTransforms;
+	ComponentTransforms leftComponentTransforms, rightComponentTransforms;
 
 	// Grip transforms for left and right hand
 	glm::mat4 leftHandGripTransform = glm::identity<glm::mat4>();
 	glm::mat4 rightHandGripTransform = glm::identity<glm::mat4>();
 
 	// Reference poses for each hand
-	std::unordered_map<int, std::array<vr::VRBoneTransform_t, 31>> leftHandPoses, rightHandPoses;
+	ReferencePoses leftHandPoses, rightHandPoses;
 };
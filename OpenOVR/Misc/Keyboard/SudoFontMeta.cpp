@@ -84,6 +84,7 @@ SudoFontMeta::SudoFontMeta(std::vector<char> data, std::vector<char> image)
 	}
 
 	// Load the image itself
+	std::vector<uint8_t> pixel_data;
 	lodepng::decode(
 	    pixel_data,
 	    imgWidth, imgHeight,
@@ -92,45 +93,65 @@ SudoFontMeta::SudoFontMeta(std::vector<char> data, std::vector<char> image)
 
 	assert(origTexW == imgWidth);
 	assert(origTexH == imgHeight);
+
+	alpha.resize((size_t)imgWidth * imgHeight);
+	for (size_t i = 0; i < alpha.size(); i++)
+		alpha[i] = pixel_data[i * 4 + 3];
 }
 
 SudoFontMeta::~SudoFontMeta()
 {
 }
 
-void SudoFontMeta::Blit(wchar_t ch, int x, int y, int img_width, pix_t targetColour, pix_t* rawPixels, bool hpad)
+const SudoFontMeta::CharInfo* SudoFontMeta::Find(wchar_t ch)
 {
-	pix_t* pixels = (pix_t*)rawPixels;
-	const pix_t* font = (const pix_t*)pixel_data.data();
+	auto iter = chars.find(ch);
+	if (iter == chars.end())
+		iter = chars.find('?');
+	if (iter == chars.end())
+		return nullptr;
+	return &iter->second;
+}
 
-	const CharInfo& info = chars.at(ch);
+void SudoFontMeta::Blit(wchar_t ch, int x, int y, int img_width, int img_height, pix_t targetColour, pix_t* rawPixels, bool hpad)
+{
+	const CharInfo* info = Find(ch);
+	if (!info)
+		return;
 
-	for (int ix = 0; ix < info.PackedWidth; ix++) {
-		for (int iy = 0; iy < info.PackedHeight; iy++) {
-			int px = ix + info.PackedX;
-			int py = iy + info.PackedY;
-			pix_t p = font[px + py * imgHeight];
+	int baseX = x + (hpad ? info->XOffset : 0);
+	int baseY = y + info->YOffset;
 
-			if (p.a == 0)
-				continue;
+	for (int iy = 0; iy < info->PackedHeight; iy++) {
+		int ty = baseY + iy;
+		if (ty < 0 || ty >= img_height)
+			continue;
 
-			int tx = ix + x + (hpad ? info.XOffset : 0);
-			int ty = iy + y + info.YOffset;
+		const uint8_t* src = &alpha[info->PackedX + (size_t)(info->PackedY + iy) * imgWidth];
+		pix_t* dst = &rawPixels[(size_t)ty * img_width];
 
-			assert(tx > 0);
-			assert(ty > 0);
+		for (int ix = 0; ix < info->PackedWidth; ix++) {
+			int tx = baseX + ix;
+			if (tx < 0 || tx >= img_width)
+				continue;
+
+			int a = src[ix] * targetColour.a / 255;
+			if (a == 0)
+				continue;
 
-			size_t idx = tx + ty * img_width;
-			pix_t& out = pixels[idx];
-			out = targetColour;
+			pix_t& out = dst[tx];
+			out.r = (uint8_t)((targetColour.r * a + out.r * (255 - a)) / 255);
+			out.g = (uint8_t)((targetColour.g * a + out.g * (255 - a)) / 255);
+			out.b = (uint8_t)((targetColour.b * a + out.b * (255 - a)) / 255);
+			out.a = (uint8_t)(a + out.a * (255 - a) / 255);
 		}
 	}
 }
 
 int SudoFontMeta::Width(wchar_t ch)
 {
-	const CharInfo& info = chars.at(ch);
-	return info.XAdvance;
+	const CharInfo* info = Find(ch);
+	return info ? info->XAdvance : 0;
 }
 
 int SudoFontMeta::Width(wstring str)
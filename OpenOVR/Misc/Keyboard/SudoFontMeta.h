@@ -32,11 +32,12 @@ public:
 	};
 
 	/**
-	 * Copy a character onto pixel data.
+	 * Draw a character onto pixel data, blending it over what's already there using the font's
+	 * anti-aliasing. Anything outside the image is clipped off.
 	 *
-	 * Does not copy transparent regions, so this respects the background.
+	 * Characters not in the font are drawn as a question mark.
 	 */
-	void Blit(wchar_t ch, int x, int y, int img_width, pix_t targetColour, pix_t* rawPixels, bool hpad = true);
+	void Blit(wchar_t ch, int x, int y, int img_width, int img_height, pix_t targetColour, pix_t* rawPixels, bool hpad = true);
 
 	int Width(wchar_t ch);
 	int Width(std::wstring str);
@@ -44,8 +45,13 @@ public:
 	unsigned int GetLineHeight() { return lineHeight; }
 
 private:
+	const CharInfo* Find(wchar_t ch);
+
 	std::map<wchar_t, CharInfo> chars;
-	std::vector<uint8_t> pixel_data;
+
+	// The coverage of each pixel in the font's image. The colour channels are all white, so only
+	// the alpha channel is kept after the image is decoded.
+	std::vector<uint8_t> alpha;
 
 	unsigned int imgWidth;
 	unsigned int imgHeight;
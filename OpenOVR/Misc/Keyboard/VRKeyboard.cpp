@@ -2,40 +2,100 @@
 
 #include "VRKeyboard.h"
 
-#ifndef OC_XR_PORT
-#include <d3d11.h>
-#endif
-
-#include "Reimpl/BaseCompositor.h"
-#include "Reimpl/BaseSystem.h"
+#include "Compositor/compositor.h"
+#include "Reimpl/BaseInput.h"
 #include "generated/static_bases.gen.h"
 
-#include "Misc/ScopeGuard.h"
 #include "convert.h"
 
 #include "resources.h"
 
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <vector>
 
-#ifdef _WIN32
-#pragma warning(disable : 4722) // ignore destructor never returning
-#pragma comment(lib, "d3d11.lib")
+using namespace vr;
+
+std::wstring_convert<std::codecvt_utf8<wchar_t>> VRKeyboard::CHAR_CONV;
+
+// The width of the keyboard image in pixels, and of the quad it's drawn on in metres
+static constexpr int KEYBOARD_WIDTH_PX = 1024;
+static constexpr float KEYBOARD_WIDTH_M = 1.0f;
 
-// for debugging only for now
-#include <comdef.h>
+static std::vector<char> loadResource(int rid, int type)
+{
+#ifndef _WIN32
+	const char *start = nullptr, *end = nullptr;
+	FindResourceLinux(rid, &start, &end);
+	return { start, end };
+#else
+	HRSRC ref = FindResource(openovr_module_id, MAKEINTRESOURCE(rid), MAKEINTRESOURCE(type));
+	if (!ref)
+		OOVR_ABORTF("FindResource error: %d", (int)GetLastError());
+
+	char* cstr = (char*)LoadResource(openovr_module_id, ref);
+	if (!cstr)
+		OOVR_ABORTF("LoadResource error: %d", (int)GetLastError());
+
+	DWORD len = SizeofResource(openovr_module_id, ref);
+	if (!len)
+		OOVR_ABORTF("SizeofResource error: %d", (int)GetLastError());
+
+	return { cstr, cstr + len };
 #endif
+}
 
-std::wstring_convert<std::codecvt_utf8<wchar_t>> VRKeyboard::CHAR_CONV;
+VRKeyboard::VRKeyboard(uint64_t userValue, uint32_t maxLength, bool minimal, bool multiLine, eventDispatch_t dispatch,
+    EGamepadTextInputMode inputMode, XrReferenceSpaceType space)
+    : userValue(userValue), maxLength(maxLength), minimal(minimal), multiLine(multiLine), eventDispatch(dispatch),
+      inputMode(inputMode), space(space)
+{
+	font = std::make_unique<SudoFontMeta>(loadResource(RES_O_FNT_UBUNTU, RES_T_FNTMETA),
+	    loadResource(RES_O_FNT_UBUNTU_TEXTURE, RES_T_PNG));
+	layout = std::make_unique<KeyboardLayout>(loadResource(RES_O_KB_EN_GB, RES_T_KBLAYOUT));
+
+	// Work out where everything goes once, since the layout never changes
+	width = KEYBOARD_WIDTH_PX;
+	keySize = ((width - padding) / layout->GetWidth()) - padding;
+
+	int rows = 0;
+	for (const KeyboardLayout::Key& key : layout->GetKeymap())
+		rows = std::max(rows, (int)std::ceil(key.y + key.h));
+
+	int keyAreaBaseY = minimal ? padding : padding + keySize + padding;
+	height = keyAreaBaseY + rows * (keySize + padding);
+	textRect = { padding, padding, width - padding * 2, keySize };
+
+	for (const KeyboardLayout::Key& key : layout->GetKeymap()) {
+		KeyRect rect;
+		rect.x = padding + (int)((keySize + padding) * key.x);
+		rect.y = keyAreaBaseY + (int)((keySize + padding) * key.y);
+		rect.w = (int)((keySize + padding) * key.w) - padding;
+		rect.h = (int)((keySize + padding) * key.h) - padding;
+
+		if (key.spansToRight)
+			rect.w = width - padding - rect.x;
+
+		keyRects.push_back(rect);
+	}
+
+	layer.layerFlags = XR_COMPOSITION_LAYER_BLEND_TEXTURE_SOURCE_ALPHA_BIT;
+	layer.eyeVisibility = XR_EYE_VISIBILITY_BOTH;
+	layer.size = { KEYBOARD_WIDTH_M, KEYBOARD_WIDTH_M * height / width };
+}
 
 VRKeyboard::~VRKeyboard()
 {
-	XR_STUBBED();
 }
+
 wstring VRKeyboard::contents()
 {
 	return text;
 }
-#ifndef OC_XR_PORT
 
 void VRKeyboard::contents(wstring str)
 {
@@ -43,279 +103,296 @@ void VRKeyboard::contents(wstring str)
 	dirty = true;
 }
 
-ovrLayerHeader* VRKeyboard::Update()
+void VRKeyboard::SetDescription(wstring str)
 {
-	if (dirty) {
-		dirty = false;
+	description = str;
+	dirty = true;
+}
+
+XrCompositionLayerBaseHeader* VRKeyboard::Update(Compositor* compositor)
+{
+	// The compositor is only created once the game submits a frame
+	if (closed || !compositor)
+		return nullptr;
+
+	// Unless the game has put it somewhere, open the keyboard in front of the user
+	if (!positioned)
+		PlaceInFrontOfHead();
+	if (!positioned)
+		return nullptr;
+
+	layer.space = xr_space_from_ref_space_type(space);
+
+	HandleInput();
+	if (closed)
+		return nullptr;
+
+	// If the compositor was recreated since we last drew, our image went with it
+	if (dirty || compositor->GetPixelSwapchain() != layer.subImage.swapchain) {
 		Refresh();
+
+		if (!compositor->WritePixels(pixels.data(), width, height, layer.subImage)) {
+			// Let the game carry on with whatever text it already had, rather than waiting forever
+			OOVR_LOG("The virtual keyboard is not yet supported with this graphics API, closing it");
+			closed = true;
+			SubmitEvent(VREvent_KeyboardDone, 0);
+			return nullptr;
+		}
+
+		dirty = false;
 	}
 
-	return &layer.Header;
+	return (XrCompositionLayerBaseHeader*)&layer;
 }
 
-void VRKeyboard::HandleOverlayInput(vr::EVREye side, vr::VRControllerState_t state, float time)
+void VRKeyboard::SetTransform(XrReferenceSpaceType newSpace, HmdMatrix34_t transform)
 {
-	using namespace vr;
+	space = newSpace;
+	layer.pose = S2O_om34_pose(transform);
+	positioned = true;
+}
+
+void VRKeyboard::PlaceInFrontOfHead()
+{
+	XrSpaceLocation location = { XR_TYPE_SPACE_LOCATION };
+	OOVR_FAILED_XR_SOFT_ABORT(xrLocateSpace(xr_gbl->viewSpace, xr_space_from_ref_space_type(space), xr_gbl->GetBestTime(), &location));
 
-	// In case this is somehow called after the keyboard is closed, ignore it
-	if (IsClosed())
+	XrSpaceLocationFlags required = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+	if ((location.locationFlags & required) != required)
 		return;
 
-	uint64_t lastButtons = lastButtonState[side];
-	lastButtonState[side] = state.ulButtonPressed;
-
-#define GET_BTTN(var, key) bool var = state.ulButtonPressed & ButtonMaskFromId(key)
-#define GET_BTTN_LAST(var, key) \
-	GET_BTTN(var, key);         \
-	bool var##_last = lastButtons & ButtonMaskFromId(key)
-	GET_BTTN(left, k_EButton_DPad_Left);
-	GET_BTTN(right, k_EButton_DPad_Right);
-	GET_BTTN(up, k_EButton_DPad_Up);
-	GET_BTTN(down, k_EButton_DPad_Down);
-	GET_BTTN_LAST(trigger, k_EButton_SteamVR_Trigger);
-	GET_BTTN_LAST(grip, k_EButton_Grip);
-#undef GET_BTTN
-#undef GET_BTTN_LAST
-
-	if (grip && !grip_last) {
-		closed = true;
-		SubmitEvent(VREvent_KeyboardClosed, 0);
+	// Only follow the direction the user is facing, so the keyboard is upright regardless of how their head is
+	// tilted. Put it a bit below eye level, and tilt it back a bit to face them.
+	glm::vec3 forward = X2G_quat(location.pose.orientation) * glm::vec3(0, 0, -1);
+	float yaw = atan2f(-forward.x, -forward.z);
+	glm::vec3 flatForward = glm::vec3(-sinf(yaw), 0, -cosf(yaw));
+
+	glm::quat rotation = glm::angleAxis(yaw, glm::vec3(0, 1, 0)) * glm::angleAxis(-0.35f, glm::vec3(1, 0, 0));
+	glm::vec3 position = X2G_v3f(location.pose.position) + flatForward * 0.6f + glm::vec3(0, -0.35f, 0);
+
+	layer.pose = { G2X_quat(rotation), G2X_v3f(position) };
+	positioned = true;
+}
+
+void VRKeyboard::HandleInput()
+{
+	BaseInput* input = GetUnsafeBaseInput();
+	if (!input)
 		return;
-	}
 
-	const KeyboardLayout::Key& key = layout->GetKeymap()[selected[side]];
+	XrSpace xrSpace = xr_space_from_ref_space_type(space);
+	glm::mat4 toQuad = glm::inverse(X2G_om34_pose(layer.pose));
 
-	if (trigger && !trigger_last) {
-		wchar_t ch = caseMode == ECaseMode::LOWER ? key.ch : key.shift;
+	for (int side = 0; side < 2; side++) {
+		ITrackedDevice::TrackedDeviceType hand = side == Eye_Left ? ITrackedDevice::HAND_LEFT : ITrackedDevice::HAND_RIGHT;
 
-		bool submitKeyEvent = false;
+		BaseInput::PointerState pointer;
+		if (!input->GetPointerState(hand, xrSpace, pointer)) {
+			// Treat the trigger as held, so it doesn't press anything if it's still held when tracking comes back
+			lastTrigger[side] = true;
+			if (selected[side] != -1) {
+				selected[side] = -1;
+				dirty = true;
+			}
+			continue;
+		}
 
-		if (ch == '\x01' || ch == '\x02') {
-			// Shift
-			ECaseMode target = ch == '\x02' ? ECaseMode::LOCK : ECaseMode::SHIFT;
-			caseMode = caseMode == target ? ECaseMode::LOWER : target;
-		} else if (ch == '\b') {
-			// Backspace
-			if (!text.empty()) {
-				text.erase(text.end() - 1);
+		// Find where the controller's aim ray hits the quad, which faces along +Z in its own space
+		glm::vec3 origin = toQuad * glm::vec4(X2G_v3f(pointer.pose.position), 1);
+		glm::vec3 direction = toQuad * glm::vec4(X2G_quat(pointer.pose.orientation) * glm::vec3(0, 0, -1), 0);
+
+		bool onKeyboard = false;
+		int hovered = -1;
+		if (origin.z > 0 && direction.z < 0) {
+			glm::vec3 hit = origin + direction * (-origin.z / direction.z);
+			float u = hit.x / layer.size.width + 0.5f;
+			float v = 0.5f - hit.y / layer.size.height;
+			onKeyboard = u >= 0 && u <= 1 && v >= 0 && v <= 1;
+
+			int px = (int)(u * width);
+			int py = (int)(v * height);
+			for (size_t i = 0; onKeyboard && i < keyRects.size(); i++) {
+				const KeyRect& r = keyRects[i];
+				if (px >= r.x && px < r.x + r.w && py >= r.y && py < r.y + r.h) {
+					hovered = (int)i;
+					break;
+				}
 			}
+		}
 
-			submitKeyEvent = true;
-		} else if (ch == '\x03') {
-			// done
+		if (hovered != selected[side]) {
+			selected[side] = hovered;
+			dirty = true;
+		}
 
-			// Submit mode is for stuff like chat, where the keyboard stays open
-			if (inputMode != EGamepadTextInputMode::k_EGamepadTextInputModeSubmit)
-				closed = true;
+		bool pressed = pointer.trigger && !lastTrigger[side];
+		lastTrigger[side] = pointer.trigger;
+		if (!pressed)
+			continue;
 
-			if (!minimal)
-				SubmitEvent(VREvent_KeyboardCharInput, 0);
+		if (!onKeyboard) {
+			closed = true;
+			SubmitEvent(VREvent_KeyboardClosed, 0);
+			return;
+		}
 
-			SubmitEvent(VREvent_KeyboardDone, 0);
-		} else if (!minimal && ch == '\t') {
-			// Silently soak up tabs for now
-		} else if (!minimal && ch == '\n') {
-			// Silently soak up newlines for now
-		} else {
-			text += ch;
+		if (hovered != -1)
+			PressKey(layout->GetKeymap()[hovered]);
 
-			submitKeyEvent = true;
+		if (closed)
+			return;
+	}
+}
 
-			if (caseMode == ECaseMode::SHIFT)
-				caseMode = ECaseMode::LOWER;
+void VRKeyboard::PressKey(const KeyboardLayout::Key& key)
+{
+	wchar_t ch = caseMode == ECaseMode::LOWER ? key.ch : key.shift;
+
+	bool submitKeyEvent = false;
+
+	if (ch == '\x01' || ch == '\x02') {
+		// Shift
+		ECaseMode target = ch == '\x02' ? ECaseMode::LOCK : ECaseMode::SHIFT;
+		caseMode = caseMode == target ? ECaseMode::LOWER : target;
+	} else if (ch == '\b') {
+		// Backspace
+		if (!text.empty()) {
+			text.erase(text.end() - 1);
 		}
 
-		if (submitKeyEvent) {
-			SubmitEvent(VREvent_KeyboardCharInput, minimal ? ch : 0);
-		}
+		submitKeyEvent = true;
+	} else if (ch == '\x03' || (!minimal && !multiLine && ch == '\n')) {
+		// done
 
-		dirty = true;
-	}
+		// Submit mode is for stuff like chat, where the keyboard stays open
+		if (inputMode != EGamepadTextInputMode::k_EGamepadTextInputModeSubmit)
+			closed = true;
 
-	// Movement:
-	bool any = left || right || up || down;
-	if (!any) {
-	cancel:
-		repeatCount[side] = 0;
-		lastInputTime[side] = 0;
-		return;
-	}
+		if (!minimal)
+			SubmitEvent(VREvent_KeyboardCharInput, 0);
 
-	if (time - lastInputTime[side] < (repeatCount[side] <= 1 ? 0.3 : 0.1))
-		return;
+		SubmitEvent(VREvent_KeyboardDone, 0);
+	} else if (!minimal && ch == '\t') {
+		// Silently soak up tabs for now
+	} else if (maxLength != 0 && text.length() >= maxLength) {
+		// Full, ignore any more characters
+	} else {
+		text += ch;
 
-	lastInputTime[side] = time;
-	repeatCount[side]++;
-
-	int target = -1;
-	if (left)
-		target = key.toLeft;
-	else if (right)
-		target = key.toRight;
-	else if (up)
-		target = key.toUp;
-	else if (down)
-		target = key.toDown;
-
-	if (target == -1) {
-		goto cancel;
+		submitKeyEvent = true;
+
+		if (caseMode == ECaseMode::SHIFT)
+			caseMode = ECaseMode::LOWER;
+	}
+
+	if (submitKeyEvent) {
+		SubmitEvent(VREvent_KeyboardCharInput, minimal ? ch : 0);
 	}
 
-	selected[side] = target;
 	dirty = true;
 }
 
-void VRKeyboard::SetTransform(HmdMatrix34_t transform)
+void VRKeyboard::FillArea(int x, int y, int w, int h, pix_t colour)
 {
-	ovrPosef pose = S2O_om34_pose(transform);
-
-	layer.QuadPoseCenter = pose;
+	for (int iy = 0; iy < h; iy++) {
+		pix_t* row = &pixels[x + (size_t)(y + iy) * width];
+		std::fill(row, row + w, colour);
+	}
 }
 
-struct pix_t {
-	uint8_t r, g, b, a;
-};
-
-static_assert(sizeof(pix_t) == 4, "padded pix_t");
-
-void VRKeyboard::Refresh()
+void VRKeyboard::Print(int x, int y, pix_t colour, const wstring& str, bool hpad)
 {
-	D3D11_TEXTURE2D_DESC desc;
-	desc.Width = chainDesc.Width;
-	desc.Height = chainDesc.Height;
-	desc.MipLevels = 1;
-	desc.ArraySize = 1;
-	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
-	desc.SampleDesc = { 1, 0 };
-	desc.Usage = D3D11_USAGE_DEFAULT; // D3D11_USAGE_IMMUTABLE;
-	desc.BindFlags = 0;
-	desc.CPUAccessFlags = 0;
-	desc.MiscFlags = 0;
-
-	pix_t* pixels = new pix_t[desc.Width * desc.Height];
-
-	for (UINT y = 0; y < desc.Height; y++) {
-		for (UINT x = 0; x < desc.Width; x++) {
-			int col = 125;
-
-			pix_t& pix = pixels[x + y * desc.Width];
-			pix.a = 255;
-			pix.r = col;
-			pix.g = col;
-			pix.b = col;
-		}
+	for (wchar_t ch : str) {
+		font->Blit(ch, x, y, width, height, colour, pixels.data(), hpad);
+		x += font->Width(ch);
 	}
+}
 
-	int padding = 8;
+void VRKeyboard::DrawKey(const KeyboardLayout::Key& key, bool hoverLeft, bool hoverRight)
+{
+	const KeyRect& r = keyRects.at(key.id);
 
-	auto fillArea = [pixels, &desc](int x, int y, int w, int h, int r, int g, int b) {
-		for (int ix = 0; ix < w; ix++) {
-			for (int iy = 0; iy < h; iy++) {
-				size_t idx = (x + ix) + (y + iy) * desc.Width;
-				pix_t& p = pixels[idx];
+	bool highlighted = (key.ch == '\x01' && caseMode == ECaseMode::SHIFT)
+	    || (key.ch == '\x02' && caseMode == ECaseMode::LOCK);
+	uint8_t bkg_c = highlighted ? 255 : 80;
 
-				p.r = r;
-				p.g = g;
-				p.b = b;
-				p.a = 255;
-			}
-		}
-	};
+	FillArea(r.x, r.y, r.w, r.h, { bkg_c, bkg_c, bkg_c, 255 });
 
-	auto print = [&](int x, int y, pix_t colour, wstring text, bool hpad = true) {
-		SudoFontMeta::pix_t c = { colour.r, colour.g, colour.b, colour.a };
-		for (size_t i = 0; i < text.length(); i++) {
-			font->Blit(text[i], x, y, desc.Width, c, (SudoFontMeta::pix_t*)pixels, hpad);
-			x += font->Width(text[i]);
-		}
-	};
+	if (hoverLeft)
+		FillArea(r.x, r.y, r.w / 2, r.h, { 0, 100, 255, 255 });
 
-	int kbWidth = layout->GetWidth();
-	int keySize = ((desc.Width - padding) / kbWidth) - padding;
-	auto drawKey = [&](int x, int y, const KeyboardLayout::Key& key) {
-		int width = (int)(keySize * key.w);
-		int height = (int)(keySize * key.h);
+	if (hoverRight)
+		FillArea(r.x + r.w / 2, r.y, r.w - r.w / 2, r.h, { 0, 255, 100, 255 });
 
-		if (key.spansToRight) {
-			width = desc.Width - padding - x;
-		}
+	pix_t targetColour = { 255, 255, 255, 255 };
 
-		bool highlighted = (key.ch == '\x01' && caseMode == ECaseMode::SHIFT)
-		    || (key.ch == '\x02' && caseMode == ECaseMode::LOCK);
-		int bkg_c = highlighted ? 255 : 80;
+	if (highlighted) {
+		targetColour = { 0, 0, 0, 255 };
+	}
 
-		fillArea(
-		    x, y,
-		    width, height,
-		    bkg_c, bkg_c, bkg_c);
+	wstring label = caseMode == ECaseMode::LOWER ? key.label : key.labelShift;
+	int textWidth = font->Width(label);
 
-		if (selected[vr::Eye_Left] == key.id) {
-			fillArea(
-			    x, y,
-			    width / 2, height,
-			    0, 100, 255);
-		}
+	Print(r.x + (r.w - textWidth) / 2, r.y + (keySize - (int)font->GetLineHeight()) / 2, targetColour, label, false);
+}
 
-		if (selected[vr::Eye_Right] == key.id) {
-			fillArea(
-			    x + width / 2, y,
-			    width / 2, height,
-			    0, 255, 100);
-		}
+const std::vector<VRKeyboard::pix_t>& VRKeyboard::GetBaseImage()
+{
+	std::vector<pix_t>& image = baseImages[caseMode];
 
-		pix_t targetColour = { 255, 255, 255, 255 };
+	if (image.empty()) {
+		pixels.assign((size_t)width * height, { 125, 125, 125, 255 });
 
-		if (highlighted) {
-			targetColour = { 0, 0, 0, 255 };
-		}
+		for (const KeyboardLayout::Key& key : layout->GetKeymap())
+			DrawKey(key, false, false);
 
-		wstring label = caseMode == ECaseMode::LOWER ? key.label : key.labelShift;
-		int textWidth = font->Width(label);
+		image = pixels;
+	}
 
-		print(x + (width - textWidth) / 2, y + padding, targetColour, label, false);
-	};
+	return image;
+}
 
-	int keyAreaBaseY = minimal ? padding : padding + keySize + padding;
+void VRKeyboard::Refresh()
+{
+	pixels = GetBaseImage();
+
+	// Only the keys being pointed at differ from the base image
 	for (const KeyboardLayout::Key& key : layout->GetKeymap()) {
-		int x = padding + (int)((keySize + padding) * key.x);
-		int y = keyAreaBaseY + (int)((keySize + padding) * key.y);
+		bool hoverLeft = selected[Eye_Left] == key.id;
+		bool hoverRight = selected[Eye_Right] == key.id;
 
-		drawKey(x, y, key);
+		if (hoverLeft || hoverRight)
+			DrawKey(key, hoverLeft, hoverRight);
 	}
 
-	if (!minimal) {
-		fillArea(
-		    padding, padding,
-		    desc.Width - padding * 2, keySize,
-		    255, 255, 255);
-
-		pix_t targetColour = { 0, 0, 0, 255 };
-
-		print(padding * 2, padding * 2, targetColour, text);
-	}
+	if (minimal)
+		return;
 
-	D3D11_SUBRESOURCE_DATA init[] = {
-		{ pixels, sizeof(pix_t) * desc.Width, sizeof(pix_t) * desc.Width * desc.Height }
-	};
+	FillArea(textRect.x, textRect.y, textRect.w, textRect.h, { 255, 255, 255, 255 });
 
-	CComPtr<ID3D11Texture2D> tex;
-	HRESULT rres = dev->CreateTexture2D(&desc, init, &tex);
-	// HRESULT hrr = dev->GetDeviceRemovedReason();
-	OOVR_FAILED_DX_ABORT(rres);
-	delete[] pixels;
+	int textY = textRect.y + (textRect.h - (int)font->GetLineHeight()) / 2;
+	int available = textRect.w - padding * 2;
 
-	////
+	if (text.empty()) {
+		// Show what the game wants typed in, until the user starts typing
+		wstring shown = description;
+		while (!shown.empty() && font->Width(shown) > available)
+			shown.pop_back();
 
-	int index;
-	OOVR_FAILED_OVR_ABORT(ovr_GetTextureSwapChainCurrentIndex(*ovr::session, chain, &index));
+		Print(textRect.x + padding, textY, { 150, 150, 150, 255 }, shown);
+		return;
+	}
 
-	CComPtr<ID3D11Texture2D> dst;
-	OOVR_FAILED_OVR_ABORT(ovr_GetTextureSwapChainBufferDX(*ovr::session, chain, index, IID_PPV_ARGS(&dst)));
+	wstring shown = inputMode == k_EGamepadTextInputModePassword ? wstring(text.length(), L'*') : text;
+	std::replace(shown.begin(), shown.end(), L'\n', L' ');
 
-	ctx->CopyResource(dst, tex);
+	// Show the end of the text if it doesn't all fit, since that's where the user is typing
+	int shownWidth = font->Width(shown);
+	size_t start = 0;
+	while (start < shown.length() && shownWidth > available)
+		shownWidth -= font->Width(shown[start++]);
 
-	// Commit the texture to LibOVR
-	OOVR_FAILED_OVR_ABORT(ovr_CommitTextureSwapChain(*ovr::session, chain));
+	Print(textRect.x + padding, textY, { 0, 0, 0, 255 }, shown.substr(start));
 }
 
 void VRKeyboard::SubmitEvent(vr::EVREventType ev, wchar_t ch)
@@ -355,5 +432,3 @@ void VRKeyboard::SubmitEvent(vr::EVREventType ev, wchar_t ch)
 
 	eventDispatch(evt);
 }
-
-#endif
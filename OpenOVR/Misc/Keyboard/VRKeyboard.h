@@ -1,9 +1,5 @@
 #pragma once
 
-#ifndef OC_XR_PORT
-#include <d3d11.h>
-#endif
-
 #include <codecvt>
 #include <functional>
 #include <locale>
@@ -14,6 +10,15 @@
 #include "KeyboardLayout.h"
 #include "SudoFontMeta.h"
 
+class Compositor;
+
+/**
+ * The virtual keyboard shown by IVROverlay::ShowKeyboard. It's drawn on the CPU into an RGBA image, which is
+ * submitted as a quad layer through the game's compositor. The image is only redrawn when something on it
+ * changes, such as a key being pressed or a different key being pointed at.
+ *
+ * The user types by pointing a controller at a key and pulling the trigger.
+ */
 class VRKeyboard {
 public:
 	typedef std::function<void(vr::VREvent_t)> eventDispatch_t;
@@ -26,19 +31,23 @@ public:
 		k_EGamepadTextInputModeSubmit = 2,
 	};
 
-#ifndef OC_XR_PORT
-	VRKeyboard(ID3D11Device* dev, uint64_t userValue, uint32_t maxLength, bool minimal, eventDispatch_t dispatch, EGamepadTextInputMode inputMode);
-#endif
+	VRKeyboard(uint64_t userValue, uint32_t maxLength, bool minimal, bool multiLine, eventDispatch_t dispatch,
+	    EGamepadTextInputMode inputMode, XrReferenceSpaceType space);
 	~VRKeyboard();
 
 	std::wstring contents();
 	void contents(std::wstring);
 
-#ifndef OC_XR_PORT
-	ovrLayerHeader* Update();
-#endif
+	// The text shown in the text box while it's empty
+	void SetDescription(std::wstring description);
 
-	void HandleOverlayInput(vr::EVREye controllerDeviceIndex, vr::VRControllerState_t state, float time);
+	/**
+	 * Handle this frame's controller input, redraw the keyboard if needed, and get the layer to show it with.
+	 *
+	 * This must be called from the thread the game submits frames on, as it draws using compositor. Returns
+	 * nullptr if there's nothing to show yet, or if the keyboard was closed.
+	 */
+	XrCompositionLayerBaseHeader* Update(Compositor* compositor);
 
 	enum ECaseMode {
 		LOWER,
@@ -50,41 +59,61 @@ public:
 
 	bool IsClosed() { return closed; }
 
-	void SetTransform(vr::HmdMatrix34_t transform);
+	void SetTransform(XrReferenceSpaceType space, vr::HmdMatrix34_t transform);
 
 private:
-#ifndef OC_XR_PORT
-	ID3D11Device* const dev;
-	ID3D11DeviceContext* ctx;
-#endif
+	using pix_t = SudoFontMeta::pix_t;
+
+	struct KeyRect {
+		int x, y, w, h;
+	};
 
 	bool dirty = true;
 	bool closed = false;
 
 	std::wstring text;
+	std::wstring description;
 	ECaseMode caseMode = LOWER;
 
 	uint64_t userValue; // Arbitary user data, to be passed into the SteamVR events
 	uint32_t maxLength;
 	bool minimal;
+	bool multiLine;
 	eventDispatch_t eventDispatch;
 	EGamepadTextInputMode inputMode;
 
-#ifndef OC_XR_PORT
-	ovrTextureSwapChain chain;
-	ovrTextureSwapChainDesc chainDesc;
-	ovrLayerQuad layer;
-#endif
-
 	std::unique_ptr<SudoFontMeta> font;
 	std::unique_ptr<KeyboardLayout> layout;
 
-	// These use the OpenVR eye constants
-	float lastInputTime[2];
-	int repeatCount[2];
-	int selected[2];
-	uint64_t lastButtonState[2];
-
+	// The image's layout, in pixels
+	int width, height;
+	int padding = 8;
+	int keySize;
+	std::vector<KeyRect> keyRects;
+	KeyRect textRect;
+
+	// The image with all the keys drawn and nothing hovered or typed, for each case mode. Each
+	// redraw starts with a copy of one of these, rather than drawing every key again.
+	std::vector<pix_t> baseImages[3];
+	std::vector<pix_t> pixels;
+
+	XrCompositionLayerQuad layer = { XR_TYPE_COMPOSITION_LAYER_QUAD };
+	XrReferenceSpaceType space;
+	bool positioned = false;
+
+	// These use the OpenVR eye constants. The trigger is assumed to be held when the keyboard opens, so
+	// if the user opened it with the trigger that doesn't immediately press a key.
+	int selected[2] = { -1, -1 };
+	bool lastTrigger[2] = { true, true };
+
+	void HandleInput();
+	void PressKey(const KeyboardLayout::Key& key);
+	void PlaceInFrontOfHead();
+
+	void FillArea(int x, int y, int w, int h, pix_t colour);
+	void Print(int x, int y, pix_t colour, const std::wstring& str, bool hpad = true);
+	void DrawKey(const KeyboardLayout::Key& key, bool hoverLeft, bool hoverRight);
+	const std::vector<pix_t>& GetBaseImage();
 	void Refresh();
 
 	void SubmitEvent(vr::EVREventType ev, wchar_t ch);
@@ -35,6 +35,10 @@
 #include <jni.h>
 #endif
 
+#ifdef XR_USE_TIMESPEC
+#include <time.h>
+#endif
+
 #include "../logging.h"
 
 #include "../RuntimeExtensions/XR_MNDX_xdev_space.h"
@@ -66,6 +70,7 @@ public:
 	XrExt(XrGraphicsApiSupportedFlags apis, const std::vector<const char*>& extensions);
 
 	bool G2Controller_Available() { return supportsG2Controller; }
+	bool CompositionLayerDepth_Available() { return supportsCompositionLayerDepth; }
 	bool xrGetVisibilityMaskKHR_Available() { return pfnXrGetVisibilityMaskKHR != nullptr; }
 	bool xrMndxXdevSpace_Available() { return pfnxrCreateXDevSpaceMNDX != nullptr; }
 
@@ -97,6 +102,40 @@ public:
 		return pfnXrLocateHandJointsExt(handTracker, locateInfo, locations);
 	}
 
+#ifdef XR_USE_TIMESPEC
+	bool xrConvertTimespecTimeToTimeKHR_Available() { return pfnXrConvertTimespecTimeToTimeKHR != nullptr; }
+	XrResult xrConvertTimespecTimeToTimeKHR(XrInstance instance, const struct timespec* timespecTime, XrTime* time)
+	{
+		OOVR_FALSE_ABORT(pfnXrConvertTimespecTimeToTimeKHR);
+		return pfnXrConvertTimespecTimeToTimeKHR(instance, timespecTime, time);
+	}
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+	bool xrConvertWin32PerformanceCounterToTimeKHR_Available() { return pfnXrConvertWin32PerformanceCounterToTimeKHR != nullptr; }
+	XrResult xrConvertWin32PerformanceCounterToTimeKHR(XrInstance instance, const LARGE_INTEGER* performanceCounter, XrTime* time)
+	{
+		OOVR_FALSE_ABORT(pfnXrConvertWin32PerformanceCounterToTimeKHR);
+		return pfnXrConvertWin32PerformanceCounterToTimeKHR(instance, performanceCounter, time);
+	}
+#endif
+
+	bool displayRefreshRateExtensionAvailable() { return pfnXrGetDisplayRefreshRateFB != nullptr; }
+	XrResult xrEnumerateDisplayRefreshRatesFB(XrSession session, uint32_t displayRefreshRateCapacityInput, uint32_t* displayRefreshRateCountOutput, float* displayRefreshRates)
+	{
+		OOVR_FALSE_ABORT(pfnXrEnumerateDisplayRefreshRatesFB);
+		return pfnXrEnumerateDisplayRefreshRatesFB(session, displayRefreshRateCapacityInput, displayRefreshRateCountOutput, displayRefreshRates);
+	}
+	XrResult xrGetDisplayRefreshRateFB(XrSession session, float* displayRefreshRate)
+	{
+		OOVR_FALSE_ABORT(pfnXrGetDisplayRefreshRateFB);
+		return pfnXrGetDisplayRefreshRateFB(session, displayRefreshRate);
+	}
+	XrResult xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate)
+	{
+		OOVR_FALSE_ABORT(pfnXrRequestDisplayRefreshRateFB);
+		return pfnXrRequestDisplayRefreshRateFB(session, displayRefreshRate);
+	}
+
 	XrResult xrCreateXDevListMNDX(XrSession session, const XrCreateXDevListInfoMNDX* createInfo, XrXDevListMNDX* xdevList)
 	{
 		OOVR_FALSE_ABORT(pfnxrCreateXDevListMNDX);
@@ -213,6 +252,17 @@ private:
 	PFN_xrDestroyHandTrackerEXT pfnXrDestroyHandTrackerExt = nullptr;
 	PFN_xrLocateHandJointsEXT pfnXrLocateHandJointsExt = nullptr;
 
+#ifdef XR_USE_TIMESPEC
+	PFN_xrConvertTimespecTimeToTimeKHR pfnXrConvertTimespecTimeToTimeKHR = nullptr;
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+	PFN_xrConvertWin32PerformanceCounterToTimeKHR pfnXrConvertWin32PerformanceCounterToTimeKHR = nullptr;
+#endif
+
+	PFN_xrEnumerateDisplayRefreshRatesFB pfnXrEnumerateDisplayRefreshRatesFB = nullptr;
+	PFN_xrGetDisplayRefreshRateFB pfnXrGetDisplayRefreshRateFB = nullptr;
+	PFN_xrRequestDisplayRefreshRateFB pfnXrRequestDisplayRefreshRateFB = nullptr;
+
 	PFN_xrCreateXDevListMNDX pfnxrCreateXDevListMNDX = nullptr;
 	PFN_xrGetXDevListGenerationNumberMNDX pfnxrGetXDevListGenerationNumberMNDX = nullptr;
 	PFN_xrEnumerateXDevsMNDX pfnxrEnumerateXDevsMNDX = nullptr;
@@ -221,6 +271,7 @@ private:
 	PFN_xrCreateXDevSpaceMNDX pfnxrCreateXDevSpaceMNDX = nullptr;
 
 	bool supportsG2Controller = false;
+	bool supportsCompositionLayerDepth = false;
 
 #if defined(SUPPORT_DX) && defined(SUPPORT_DX11)
 	PFN_xrGetD3D11GraphicsRequirementsKHR pfnXrGetD3D11GraphicsRequirementsKHR = nullptr;
@@ -30,6 +30,8 @@ XrExt::XrExt(XrGraphicsApiSupportedFlags apis, const std::vector<const char*>& e
 	bool hasVisMask = false;
 	bool hasHandTracking = false;
 	bool xdevSpace = false;
+	bool hasRefreshRate = false;
+	bool hasTimeConversion = false;
 	for (const char* ext : extensions) {
 		if (strcmp(ext, XR_KHR_VISIBILITY_MASK_EXTENSION_NAME) == 0)
 			hasVisMask = true;
@@ -37,8 +39,20 @@ XrExt::XrExt(XrGraphicsApiSupportedFlags apis, const std::vector<const char*>& e
 			hasHandTracking = true;
 		if (strcmp(ext, XR_EXT_HP_MIXED_REALITY_CONTROLLER_EXTENSION_NAME) == 0)
 			supportsG2Controller = true;
+		if (strcmp(ext, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME) == 0)
+			supportsCompositionLayerDepth = true;
 		if (strcmp(ext, XR_MNDX_XDEV_SPACE_EXTENSION_NAME) == 0)
 			xdevSpace = true;
+		if (strcmp(ext, XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME) == 0)
+			hasRefreshRate = true;
+#ifdef XR_USE_TIMESPEC
+		if (strcmp(ext, XR_KHR_CONVERT_TIMESPEC_TIME_EXTENSION_NAME) == 0)
+			hasTimeConversion = true;
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+		if (strcmp(ext, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME) == 0)
+			hasTimeConversion = true;
+#endif
 	}
 
 #define XR_BIND(name, function) OOVR_FAILED_XR_ABORT(xrGetInstanceProcAddr(xr_instance, #name, (PFN_xrVoidFunction*)&this->function))
@@ -53,6 +67,21 @@ XrExt::XrExt(XrGraphicsApiSupportedFlags apis, const std::vector<const char*>& e
 		XR_BIND(xrLocateHandJointsEXT, pfnXrLocateHandJointsExt);
 	}
 
+	if (hasTimeConversion) {
+#ifdef XR_USE_TIMESPEC
+		XR_BIND(xrConvertTimespecTimeToTimeKHR, pfnXrConvertTimespecTimeToTimeKHR);
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+		XR_BIND(xrConvertWin32PerformanceCounterToTimeKHR, pfnXrConvertWin32PerformanceCounterToTimeKHR);
+#endif
+	}
+
+	if (hasRefreshRate) {
+		XR_BIND(xrEnumerateDisplayRefreshRatesFB, pfnXrEnumerateDisplayRefreshRatesFB);
+		XR_BIND(xrGetDisplayRefreshRateFB, pfnXrGetDisplayRefreshRateFB);
+		XR_BIND(xrRequestDisplayRefreshRateFB, pfnXrRequestDisplayRefreshRateFB);
+	}
+
 	if (xdevSpace) {
 		XR_BIND(xrCreateXDevListMNDX, pfnxrCreateXDevListMNDX);
 		XR_BIND(xrGetXDevListGenerationNumberMNDX, pfnxrGetXDevListGenerationNumberMNDX);
@@ -128,6 +157,67 @@ XrTime XrSessionGlobals::GetBestTime()
 	return nextPredictedFrameTime > 1 ? nextPredictedFrameTime : latestTime;
 }
 
+float XrSessionGlobals::GetDisplayRefreshRate()
+{
+	if (displayRefreshRate > 0)
+		return displayRefreshRate;
+
+	if (predictedDisplayPeriod > 0)
+		return (float)(1e9 / (double)predictedDisplayPeriod);
+
+	// Nothing better to go on until the first frame
+	return 90.0f;
+}
+
+XrTime XrSessionGlobals::GetTimeNow()
+{
+	XrTime time = 0;
+
+#ifdef XR_USE_TIMESPEC
+	if (xr_ext->xrConvertTimespecTimeToTimeKHR_Available()) {
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		OOVR_FAILED_XR_SOFT_ABORT(xr_ext->xrConvertTimespecTimeToTimeKHR(xr_instance, &now, &time));
+	}
+#endif
+#ifdef XR_USE_PLATFORM_WIN32
+	if (xr_ext->xrConvertWin32PerformanceCounterToTimeKHR_Available()) {
+		LARGE_INTEGER now;
+		QueryPerformanceCounter(&now);
+		OOVR_FAILED_XR_SOFT_ABORT(xr_ext->xrConvertWin32PerformanceCounterToTimeKHR(xr_instance, &now, &time));
+	}
+#endif
+
+	return time;
+}
+
+bool XrSessionGlobals::GetTimeSinceLastVsync(double& seconds, uint64_t& vsyncCounter)
+{
+	XrDuration period = predictedDisplayPeriod;
+	if (period <= 0)
+		return false;
+
+	int64_t sinceVsync;
+	int64_t vsyncTime;
+
+	XrTime now = GetTimeNow();
+	if (now > 0 && nextPredictedFrameTime > 1) {
+		// Use the positive remainder, since the predicted time is (usually) in the future
+		int64_t delta = now - nextPredictedFrameTime;
+		sinceVsync = ((delta % period) + period) % period;
+		vsyncTime = now - sinceVsync;
+	} else {
+		auto elapsed = std::chrono::steady_clock::now() - lastFrameWaitTime;
+		int64_t elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+		sinceVsync = elapsedNs % period;
+		vsyncTime = std::chrono::duration_cast<std::chrono::nanoseconds>(lastFrameWaitTime.time_since_epoch()).count() + elapsedNs - sinceVsync;
+	}
+
+	seconds = (double)sinceVsync / 1e9;
+	vsyncCounter = (uint64_t)(vsyncTime / period);
+	return true;
+}
+
 XruCachedViews XrSessionGlobals::GetCachedViews(XrSpace space)
 {
 	std::lock_guard lock(cachedViewsMtx);
@@ -2,6 +2,7 @@
 
 #include "generated/interfaces/vrtypes.h"
 #include <array>
+#include <chrono>
 #include <mutex>
 #include <openxr/openxr.h>
 #include <shared_mutex>
@@ -60,6 +61,15 @@ public:
 	// Set by XrBackend
 	XrTime nextPredictedFrameTime = 1;
 
+	// The predictedDisplayPeriod from the last xrWaitFrame call, or zero before the first frame. Set by XrBackend.
+	XrDuration predictedDisplayPeriod = 0;
+
+	// The refresh rate reported by XR_FB_display_refresh_rate, or zero if it's unavailable. Set by XrBackend.
+	float displayRefreshRate = 0;
+
+	// When the last xrWaitFrame call returned. Set by XrBackend.
+	std::chrono::steady_clock::time_point lastFrameWaitTime{};
+
 	/**
 	 * The latest time we've observed from the runtime. This will be set before a frame is submitted, so for
 	 * stuff that needs a time (but it probably doesn't matter much) this can be used.
@@ -77,6 +87,28 @@ public:
 	 */
 	XrTime GetBestTime();
 
+	/**
+	 * Returns the display's refresh rate in Hz. This comes from XR_FB_display_refresh_rate if it's available, otherwise
+	 * it's derived from the predicted display period.
+	 */
+	float GetDisplayRefreshRate();
+
+	/**
+	 * Returns the current time as an XrTime, converted from the clock BackendManager::GetTimeInSeconds uses. Returns
+	 * zero if the runtime doesn't support converting times.
+	 */
+	XrTime GetTimeNow();
+
+	/**
+	 * Find how long it's been since the display last refreshed, and a counter that increments on every refresh.
+	 *
+	 * Refreshes are assumed to happen once every predicted display period, lined up with the predicted display
+	 * time. If the current XrTime isn't available, the last xrWaitFrame call is assumed to have returned on a refresh.
+	 *
+	 * Returns false if no frames have been waited on yet.
+	 */
+	bool GetTimeSinceLastVsync(double& seconds, uint64_t& vsyncCounter);
+
 	/**
 	 * Returns a XruCachedViews containing the cached result of a xrLocateViews call with the specified space.
 	 */
@@ -1,144 +1,701 @@
 #include "stdafx.h"
 #define BASE_IMPL
 #include "BaseApplications.h"
+#include "BaseClientCore.h"
+#include "BaseSystem.h"
+#include "generated/static_bases.gen.h"
+#include "json/json.h"
+
+#include <algorithm>
+#include <codecvt>
+#include <fstream>
+#include <locale>
+#include <mutex>
 #include <string>
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 using namespace vr;
 
 /** The maximum length of an application key */
 static const uint32_t k_unMaxApplicationKeyLength = 128;
 
+// The file in the OpenComposite config directory listing the permanently-added manifests
+static const char* PERMANENT_MANIFESTS_FILE = "appmanifests.json";
+
 // So I can easily use it for return types
 typedef OOVR_EVRApplicationError EVRApplicationError;
 
+static uint32_t GetCurrentPid()
+{
+#ifdef _WIN32
+	return GetCurrentProcessId();
+#else
+	return (uint32_t)getpid();
+#endif
+}
+
+static bool ReadJsonFile(const std::string& path, Json::Value& result, std::string& errors)
+{
+#ifdef _WIN32
+	// The path is UTF-8, which the narrow ifstream constructor wouldn't understand
+	std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
+	std::ifstream in(converter.from_bytes(path), std::ios::binary);
+#else
+	std::ifstream in(path, std::ios::binary);
+#endif
+	if (!in) {
+		errors = "could not open file";
+		return false;
+	}
+
+	Json::CharReaderBuilder builder;
+	return Json::parseFromStream(builder, in, &result, &errors);
+}
+
+// Paths in a manifest are relative to the directory it's in
+static std::string ResolveManifestPath(const std::string& manifestPath, const std::string& path)
+{
+	bool absolute = path.empty() || path[0] == '/' || path[0] == '\\' || (path.size() >= 2 && path[1] == ':');
+	if (absolute)
+		return path;
+
+	size_t slash = manifestPath.find_last_of("/\\");
+	if (slash == std::string::npos)
+		return path;
+	return manifestPath.substr(0, slash + 1) + path;
+}
+
+// Copy a key into the caller's buffer, failing if it doesn't fit
+static EVRApplicationError CopyKey(const std::string& key, char* pchBuffer, uint32_t unBufferLen)
+{
+	if (!pchBuffer || key.size() + 1 > unBufferLen)
+		return VRApplicationError_BufferTooSmall;
+
+	memcpy(pchBuffer, key.c_str(), key.size() + 1);
+	return VRApplicationError_None;
+}
+
+// Copy a comma-separated list into the caller's buffer, returning the size needed to fit it
+static uint32_t CopyList(const std::vector<std::string>& items, char* pchBuffer, uint32_t unBufferLen)
+{
+	std::string list;
+	for (const std::string& item : items) {
+		if (!list.empty())
+			list += ",";
+		list += item;
+	}
+
+	uint32_t required = (uint32_t)list.size() + 1;
+	if (pchBuffer && unBufferLen >= required)
+		memcpy(pchBuffer, list.c_str(), required);
+	return required;
+}
+
+BaseApplications::BaseApplications()
+{
+	std::string path = oovr_config_path(PERMANENT_MANIFESTS_FILE);
+	if (path.empty())
+		return;
+
+	Json::Value root;
+	std::string errors;
+	if (!ReadJsonFile(path, root, errors)) {
+		// Not having added any manifests yet is the usual case, so only log if the file is broken
+		if (errors != "could not open file")
+			OOVR_LOGF("Failed to read the application manifest list '%s': %s", path.c_str(), errors.c_str());
+		return;
+	}
+
+	std::unique_lock lock(registryMutex);
+	for (const Json::Value& manifest : root["manifest_paths"]) {
+		std::string manifestPath = manifest.asString();
+		permanentManifests.push_back(manifestPath);
+
+		// Keep manifests which fail to load in the list, they may belong to a game which is being reinstalled
+		LoadManifest(manifestPath);
+	}
+}
+
+EVRApplicationError BaseApplications::LoadManifest(const std::string& path)
+{
+	Json::Value root;
+	std::string errors;
+	if (!ReadJsonFile(path, root, errors)) {
+		OOVR_LOGF("Failed to load application manifest '%s': %s", path.c_str(), errors.c_str());
+		return VRApplicationError_InvalidManifest;
+	}
+
+	if (!root.isObject() || !root["applications"].isArray()) {
+		OOVR_LOGF("Application manifest '%s' has no applications array", path.c_str());
+		return VRApplicationError_InvalidManifest;
+	}
+
+	// Adding a manifest again picks up any changes to it
+	UnloadManifest(path);
+
+#if defined(_WIN32)
+	const char* binaryPathKey = "binary_path_windows";
+#elif defined(__APPLE__)
+	const char* binaryPathKey = "binary_path_osx";
+#else
+	const char* binaryPathKey = "binary_path_linux";
+#endif
+
+	EVRApplicationError result = VRApplicationError_None;
+	for (const Json::Value& entry : root["applications"]) {
+		Application app;
+		app.key = entry["app_key"].asString();
+		app.manifestPath = path;
+
+		if (app.key.empty() || app.key.size() >= k_unMaxApplicationKeyLength) {
+			OOVR_LOGF("Skipping application with invalid key '%s' in manifest '%s'", app.key.c_str(), path.c_str());
+			result = VRApplicationError_InvalidManifest;
+			continue;
+		}
+
+		if (applicationIndices.count(app.key)) {
+			const Application& existing = applications.at(applicationIndices.at(app.key));
+			OOVR_LOGF("Skipping application '%s' in manifest '%s', it's already defined by '%s'", app.key.c_str(),
+			    path.c_str(), existing.manifestPath.c_str());
+			result = VRApplicationError_AppKeyAlreadyExists;
+			continue;
+		}
+
+		auto setString = [&](EVRApplicationProperty prop, const Json::Value& value, bool isPath = false) {
+			if (!value.isString())
+				return;
+			app.strings[prop] = isPath ? ResolveManifestPath(path, value.asString()) : value.asString();
+		};
+
+		setString(VRApplicationProperty_LaunchType_String, entry["launch_type"]);
+		setString(VRApplicationProperty_WorkingDirectory_String, entry["working_directory"], true);
+		setString(VRApplicationProperty_BinaryPath_String, entry[binaryPathKey], true);
+		setString(VRApplicationProperty_Arguments_String, entry["arguments"]);
+		setString(VRApplicationProperty_URL_String, entry["url"]);
+		setString(VRApplicationProperty_ImagePath_String, entry["image_path"], true);
+		setString(VRApplicationProperty_Source_String, root["source"]);
+		setString(VRApplicationProperty_ActionManifestURL_String, entry["action_manifest_path"], true);
+
+		// SteamVR picks a launch type from whichever of these is set if the manifest doesn't specify one
+		if (!app.strings.count(VRApplicationProperty_LaunchType_String)) {
+			if (app.strings.count(VRApplicationProperty_URL_String))
+				app.strings[VRApplicationProperty_LaunchType_String] = "url";
+			else if (app.strings.count(VRApplicationProperty_BinaryPath_String))
+				app.strings[VRApplicationProperty_LaunchType_String] = "binary";
+		}
+
+		// Prefer English, since that's what we'd show if we had a UI
+		const Json::Value& strings = entry["strings"];
+		if (strings.isObject() && !strings.empty()) {
+			const Json::Value& localised = strings.isMember("en_us") ? strings["en_us"] : *strings.begin();
+			setString(VRApplicationProperty_Name_String, localised["name"]);
+			setString(VRApplicationProperty_Description_String, localised["description"]);
+		}
+
+		app.bools[VRApplicationProperty_IsDashboardOverlay_Bool] = entry["is_dashboard_overlay"].asBool();
+		app.bools[VRApplicationProperty_IsTemplate_Bool] = entry["is_template"].asBool();
+		app.bools[VRApplicationProperty_IsInstanced_Bool] = entry["is_instanced"].asBool();
+		app.bools[VRApplicationProperty_IsInternal_Bool] = false;
+		app.bools[VRApplicationProperty_WantsCompositorPauseInStandby_Bool] = false;
+
+		for (const Json::Value& mimeType : entry["mime_types"]) {
+			if (mimeType.isString())
+				app.mimeTypes.push_back(mimeType.asString());
+		}
+
+		applicationIndices[app.key] = applications.size();
+		applications.push_back(std::move(app));
+	}
+
+	OOVR_LOGF("Loaded application manifest '%s', %d applications now registered", path.c_str(), (int)applications.size());
+	return result;
+}
+
+void BaseApplications::UnloadManifest(const std::string& path)
+{
+	auto removed = std::remove_if(applications.begin(), applications.end(),
+	    [&](const Application& app) { return app.manifestPath == path; });
+	if (removed == applications.end())
+		return;
+	applications.erase(removed, applications.end());
+
+	// Removing manifests is rare, so just rebuild the indices rather than trying to patch them up
+	applicationIndices.clear();
+	for (size_t i = 0; i < applications.size(); i++)
+		applicationIndices[applications.at(i).key] = i;
+
+	// Leave processApplications alone: the processes are still running, and the manifest may be added back
+}
+
+const BaseApplications::Application* BaseApplications::FindApplication(const char* pchAppKey)
+{
+	if (!pchAppKey)
+		return nullptr;
+
+	auto iter = applicationIndices.find(pchAppKey);
+	if (iter == applicationIndices.end())
+		return nullptr;
+	return &applications.at(iter->second);
+}
+
+void BaseApplications::SavePermanentManifests()
+{
+	std::string path = oovr_config_path(PERMANENT_MANIFESTS_FILE);
+	if (path.empty()) {
+		OOVR_LOG_ONCE("Could not find the OpenComposite config directory, permanent manifests will not be saved");
+		return;
+	}
+
+	Json::Value root(Json::objectValue);
+	Json::Value& paths = root["manifest_paths"] = Json::Value(Json::arrayValue);
+	for (const std::string& manifest : permanentManifests)
+		paths.append(manifest);
+
+	std::ofstream out(path, std::ios::binary);
+	if (!out) {
+		OOVR_LOGF("Could not write the application manifest list '%s'", path.c_str());
+		return;
+	}
+
+	Json::StreamWriterBuilder builder;
+	out << Json::writeString(builder, root);
+}
+
+void BaseApplications::_SetSceneApplicationState(EVRSceneApplicationState state)
+{
+	if (sceneApplicationState.exchange(state) == state)
+		return;
+
+	BaseSystem* system = GetUnsafeBaseSystem();
+	if (system) {
+		VREvent_t ev = { VREvent_SceneApplicationStateChanged };
+		system->_EnqueueEvent(ev);
+	}
+}
+
 // Used by Viveport
 EVRApplicationError BaseApplications::AddApplicationManifest(const char* pchApplicationManifestFullPath, bool bTemporary)
 {
-	OOVR_LOGF("NOOP: Attempting to add manifest %s, temporary=%d", pchApplicationManifestFullPath, bTemporary);
-	return VRApplicationError_None;
+	if (!pchApplicationManifestFullPath || !*pchApplicationManifestFullPath)
+		return VRApplicationError_InvalidParameter;
+
+	std::string path = pchApplicationManifestFullPath;
+	OOVR_LOGF("Adding application manifest %s, temporary=%d", path.c_str(), bTemporary);
+
+	std::unique_lock lock(registryMutex);
+	EVRApplicationError err = LoadManifest(path);
+
+	// Don't save manifests which couldn't be read, or we'd try loading them in every game from now on
+	bool loaded = std::any_of(applications.begin(), applications.end(),
+	    [&](const Application& app) { return app.manifestPath == path; });
+
+	if (loaded && !bTemporary && std::find(permanentManifests.begin(), permanentManifests.end(), path) == permanentManifests.end()) {
+		permanentManifests.push_back(path);
+		SavePermanentManifests();
+	}
+
+	return err;
 }
 EVRApplicationError BaseApplications::RemoveApplicationManifest(const char* pchApplicationManifestFullPath)
 {
-	OOVR_LOGF("NOOP: Attempting to remove manifest %s", pchApplicationManifestFullPath);
+	if (!pchApplicationManifestFullPath)
+		return VRApplicationError_InvalidParameter;
+
+	std::string path = pchApplicationManifestFullPath;
+	OOVR_LOGF("Removing application manifest %s", path.c_str());
+
+	std::unique_lock lock(registryMutex);
+	UnloadManifest(path);
+
+	auto iter = std::find(permanentManifests.begin(), permanentManifests.end(), path);
+	if (iter != permanentManifests.end()) {
+		permanentManifests.erase(iter);
+		SavePermanentManifests();
+	}
+
 	return VRApplicationError_None;
 }
 
 bool BaseApplications::IsApplicationInstalled(const char* pchAppKey)
 {
-	return false;
+	std::shared_lock lock(registryMutex);
+	return FindApplication(pchAppKey) != nullptr;
 }
 uint32_t BaseApplications::GetApplicationCount()
 {
-	return 0;
+	std::shared_lock lock(registryMutex);
+	return (uint32_t)applications.size();
 }
 EVRApplicationError BaseApplications::GetApplicationKeyByIndex(uint32_t unApplicationIndex, VR_OUT_STRING() char* pchAppKeyBuffer, uint32_t unAppKeyBufferLen)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	if (unApplicationIndex >= applications.size())
+		return VRApplicationError_InvalidIndex;
+
+	return CopyKey(applications.at(unApplicationIndex).key, pchAppKeyBuffer, unAppKeyBufferLen);
 }
 EVRApplicationError BaseApplications::GetApplicationKeyByProcessId(uint32_t unProcessId, VR_OUT_STRING() char* pchAppKeyBuffer, uint32_t unAppKeyBufferLen)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	auto iter = processApplications.find(unProcessId);
+	if (iter == processApplications.end())
+		return VRApplicationError_UnknownApplication;
+
+	return CopyKey(iter->second, pchAppKeyBuffer, unAppKeyBufferLen);
 }
 EVRApplicationError BaseApplications::LaunchApplication(const char* pchAppKey)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	if (!app)
+		return VRApplicationError_UnknownApplication;
+	if (app->bools.at(VRApplicationProperty_IsTemplate_Bool))
+		return VRApplicationError_IsTemplate;
+
+	// We run inside the game's process, so there's no way to hand the headset over to another application
+	OOVR_LOGF("Cannot launch application '%s', launching applications is not supported", pchAppKey);
+	return VRApplicationError_LaunchFailed;
 }
 EVRApplicationError BaseApplications::LaunchTemplateApplication(const char* pchTemplateAppKey, const char* pchNewAppKey, VR_ARRAY_COUNT(unKeys) const AppOverrideKeys_t* pKeys, uint32_t unKeys)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchTemplateAppKey);
+	if (!app)
+		return VRApplicationError_UnknownApplication;
+	if (!app->bools.at(VRApplicationProperty_IsTemplate_Bool))
+		return VRApplicationError_InvalidApplication;
+	if (FindApplication(pchNewAppKey))
+		return VRApplicationError_AppKeyAlreadyExists;
+
+	OOVR_LOGF("Cannot launch template application '%s', launching applications is not supported", pchTemplateAppKey);
+	return VRApplicationError_LaunchFailed;
 }
 EVRApplicationError BaseApplications::LaunchApplicationFromMimeType(const char* pchMimeType, const char* pchArgs)
 {
-	STUBBED();
+	OOVR_LOGF("Cannot launch application for mime type '%s', launching applications is not supported", pchMimeType);
+	return VRApplicationError_LaunchFailed;
 }
 EVRApplicationError BaseApplications::LaunchDashboardOverlay(const char* pchAppKey)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	if (!app)
+		return VRApplicationError_UnknownApplication;
+	if (!app->bools.at(VRApplicationProperty_IsDashboardOverlay_Bool))
+		return VRApplicationError_InvalidApplication;
+
+	OOVR_LOGF("Cannot launch dashboard overlay '%s', launching applications is not supported", pchAppKey);
+	return VRApplicationError_LaunchFailed;
 }
 bool BaseApplications::CancelApplicationLaunch(const char* pchAppKey)
 {
-	STUBBED();
+	// Nothing is ever launching
+	return false;
 }
 EVRApplicationError BaseApplications::IdentifyApplication(uint32_t unProcessId, const char* pchAppKey)
 {
-	OOVR_LOGF("NOOP: Attempting to identify application %s, pid=%d", pchAppKey, unProcessId);
+	if (unProcessId == 0)
+		unProcessId = GetCurrentPid();
+
+	std::unique_lock lock(registryMutex);
+
+	// Each application key belongs to at most one process
+	for (auto iter = processApplications.begin(); iter != processApplications.end();) {
+		if (pchAppKey && iter->second == pchAppKey)
+			iter = processApplications.erase(iter);
+		else
+			++iter;
+	}
+
+	if (!pchAppKey || !*pchAppKey) {
+		processApplications.erase(unProcessId);
+		return VRApplicationError_None;
+	}
+
+	// Games usually identify themselves with a key that was never in any manifest we've loaded, which SteamVR
+	// accepts, so record those too.
+	processApplications[unProcessId] = pchAppKey;
+
+	if (FindApplication(pchAppKey))
+		OOVR_LOGF("Identified pid=%d as application %s", unProcessId, pchAppKey);
+	else
+		OOVR_LOGF("Identified pid=%d as application %s, which isn't in any loaded manifest", unProcessId, pchAppKey);
 	return VRApplicationError_None;
 }
 uint32_t BaseApplications::GetApplicationProcessId(const char* pchAppKey)
 {
-	STUBBED();
+	if (!pchAppKey)
+		return 0;
+
+	std::shared_lock lock(registryMutex);
+	for (const auto& [pid, key] : processApplications) {
+		if (key == pchAppKey)
+			return pid;
+	}
+	return 0;
 }
 const char* BaseApplications::GetApplicationsErrorNameFromEnum(EVRApplicationError error)
 {
-	STUBBED();
+#define ERR_CASE(name)              \
+	case VRApplicationError_##name: \
+		return "VRApplicationError_" #name;
+
+	switch (error) {
+		ERR_CASE(None)
+		ERR_CASE(AppKeyAlreadyExists)
+		ERR_CASE(NoManifest)
+		ERR_CASE(NoApplication)
+		ERR_CASE(InvalidIndex)
+		ERR_CASE(UnknownApplication)
+		ERR_CASE(IPCFailed)
+		ERR_CASE(ApplicationAlreadyRunning)
+		ERR_CASE(InvalidManifest)
+		ERR_CASE(InvalidApplication)
+		ERR_CASE(LaunchFailed)
+		ERR_CASE(ApplicationAlreadyStarting)
+		ERR_CASE(LaunchInProgress)
+		ERR_CASE(OldApplicationQuitting)
+		ERR_CASE(TransitionAborted)
+		ERR_CASE(IsTemplate)
+		ERR_CASE(SteamVRIsExiting)
+		ERR_CASE(BufferTooSmall)
+		ERR_CASE(PropertyNotSet)
+		ERR_CASE(UnknownProperty)
+		ERR_CASE(InvalidParameter)
+	}
+#undef ERR_CASE
+
+	return "Unknown error";
 }
 uint32_t BaseApplications::GetApplicationPropertyString(const char* pchAppKey, EVRApplicationProperty eProperty, VR_OUT_STRING() char* pchPropertyValueBuffer, uint32_t unPropertyValueBufferLen, EVRApplicationError* peError)
 {
-	STUBBED();
+	EVRApplicationError dummy;
+	if (!peError)
+		peError = &dummy;
+
+	if (pchPropertyValueBuffer && unPropertyValueBufferLen)
+		pchPropertyValueBuffer[0] = 0;
+
+	switch (eProperty) {
+	case VRApplicationProperty_Name_String:
+	case VRApplicationProperty_LaunchType_String:
+	case VRApplicationProperty_WorkingDirectory_String:
+	case VRApplicationProperty_BinaryPath_String:
+	case VRApplicationProperty_Arguments_String:
+	case VRApplicationProperty_URL_String:
+	case VRApplicationProperty_Description_String:
+	case VRApplicationProperty_NewsURL_String:
+	case VRApplicationProperty_ImagePath_String:
+	case VRApplicationProperty_Source_String:
+	case VRApplicationProperty_ActionManifestURL_String:
+		break;
+	default:
+		*peError = VRApplicationError_UnknownProperty;
+		return 0;
+	}
+
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	if (!app) {
+		*peError = VRApplicationError_UnknownApplication;
+		return 0;
+	}
+
+	auto iter = app->strings.find(eProperty);
+	if (iter == app->strings.end()) {
+		*peError = VRApplicationError_PropertyNotSet;
+		return 0;
+	}
+
+	const std::string& value = iter->second;
+	uint32_t required = (uint32_t)value.size() + 1;
+	if (!pchPropertyValueBuffer || unPropertyValueBufferLen < required) {
+		*peError = VRApplicationError_BufferTooSmall;
+		return required;
+	}
+
+	memcpy(pchPropertyValueBuffer, value.c_str(), required);
+	*peError = VRApplicationError_None;
+	return required;
 }
 bool BaseApplications::GetApplicationPropertyBool(const char* pchAppKey, EVRApplicationProperty eProperty, EVRApplicationError* peError)
 {
-	STUBBED();
+	EVRApplicationError dummy;
+	if (!peError)
+		peError = &dummy;
+
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	if (!app) {
+		*peError = VRApplicationError_UnknownApplication;
+		return false;
+	}
+
+	auto iter = app->bools.find(eProperty);
+	if (iter == app->bools.end()) {
+		*peError = VRApplicationError_UnknownProperty;
+		return false;
+	}
+
+	*peError = VRApplicationError_None;
+	return iter->second;
 }
 uint64_t BaseApplications::GetApplicationPropertyUint64(const char* pchAppKey, EVRApplicationProperty eProperty, EVRApplicationError* peError)
 {
-	STUBBED();
+	EVRApplicationError dummy;
+	if (!peError)
+		peError = &dummy;
+
+	std::shared_lock lock(registryMutex);
+	if (!FindApplication(pchAppKey)) {
+		*peError = VRApplicationError_UnknownApplication;
+		return 0;
+	}
+
+	if (eProperty != VRApplicationProperty_LastLaunchTime_Uint64) {
+		*peError = VRApplicationError_UnknownProperty;
+		return 0;
+	}
+
+	// We never launch anything, so there's no launch time to report
+	*peError = VRApplicationError_PropertyNotSet;
+	return 0;
 }
 EVRApplicationError BaseApplications::SetApplicationAutoLaunch(const char* pchAppKey, bool bAutoLaunch)
 {
-	STUBBED();
+	std::unique_lock lock(registryMutex);
+	auto iter = pchAppKey ? applicationIndices.find(pchAppKey) : applicationIndices.end();
+	if (iter == applicationIndices.end())
+		return VRApplicationError_UnknownApplication;
+
+	Application& app = applications.at(iter->second);
+	if (!app.bools.at(VRApplicationProperty_IsDashboardOverlay_Bool))
+		return VRApplicationError_InvalidApplication;
+
+	app.autoLaunch = bAutoLaunch;
+	return VRApplicationError_None;
 }
 bool BaseApplications::GetApplicationAutoLaunch(const char* pchAppKey)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	return app && app->autoLaunch;
 }
 EVRApplicationError BaseApplications::SetDefaultApplicationForMimeType(const char* pchAppKey, const char* pchMimeType)
 {
-	STUBBED();
+	if (!pchMimeType)
+		return VRApplicationError_InvalidParameter;
+
+	std::unique_lock lock(registryMutex);
+	if (!FindApplication(pchAppKey))
+		return VRApplicationError_UnknownApplication;
+
+	defaultMimeTypeApplications[pchMimeType] = pchAppKey;
+	return VRApplicationError_None;
 }
 bool BaseApplications::GetDefaultApplicationForMimeType(const char* pchMimeType, VR_OUT_STRING() char* pchAppKeyBuffer, uint32_t unAppKeyBufferLen)
 {
-	STUBBED();
+	if (!pchMimeType)
+		return false;
+
+	std::shared_lock lock(registryMutex);
+	auto iter = defaultMimeTypeApplications.find(pchMimeType);
+	if (iter != defaultMimeTypeApplications.end() && applicationIndices.count(iter->second))
+		return CopyKey(iter->second, pchAppKeyBuffer, unAppKeyBufferLen) == VRApplicationError_None;
+
+	// Otherwise use the first application that says it supports it
+	for (const Application& app : applications) {
+		if (std::find(app.mimeTypes.begin(), app.mimeTypes.end(), pchMimeType) != app.mimeTypes.end())
+			return CopyKey(app.key, pchAppKeyBuffer, unAppKeyBufferLen) == VRApplicationError_None;
+	}
+
+	return false;
 }
 bool BaseApplications::GetApplicationSupportedMimeTypes(const char* pchAppKey, VR_OUT_STRING() char* pchMimeTypesBuffer, uint32_t unMimeTypesBuffer)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	const Application* app = FindApplication(pchAppKey);
+	if (!app)
+		return false;
+
+	return CopyList(app->mimeTypes, pchMimeTypesBuffer, unMimeTypesBuffer) <= unMimeTypesBuffer;
 }
 uint32_t BaseApplications::GetApplicationsThatSupportMimeType(const char* pchMimeType, VR_OUT_STRING() char* pchAppKeysThatSupportBuffer, uint32_t unAppKeysThatSupportBuffer)
 {
-	STUBBED();
+	if (!pchMimeType)
+		return 0;
+
+	std::shared_lock lock(registryMutex);
+	std::vector<std::string> keys;
+	for (const Application& app : applications) {
+		if (std::find(app.mimeTypes.begin(), app.mimeTypes.end(), pchMimeType) != app.mimeTypes.end())
+			keys.push_back(app.key);
+	}
+
+	return CopyList(keys, pchAppKeysThatSupportBuffer, unAppKeysThatSupportBuffer);
 }
 uint32_t BaseApplications::GetApplicationLaunchArguments(uint32_t unHandle, VR_OUT_STRING() char* pchArgs, uint32_t unArgs)
 {
-	STUBBED();
+	// We never send VREvent_ApplicationMimeTypeLoad, so there aren't any arguments to fetch
+	if (pchArgs && unArgs)
+		pchArgs[0] = 0;
+	return 0;
 }
 EVRApplicationError BaseApplications::GetStartingApplication(VR_OUT_STRING() char* pchAppKeyBuffer, uint32_t unAppKeyBufferLen)
 {
-	STUBBED();
+	return VRApplicationError_NoApplication;
 }
 BaseApplications::EVRApplicationTransitionState BaseApplications::GetTransitionState()
 {
-	STUBBED();
+	return VRApplicationTransition_None;
 }
 BaseApplications::EVRSceneApplicationState BaseApplications::GetSceneApplicationState()
 {
-	STUBBED();
+	return sceneApplicationState;
 }
 EVRApplicationError BaseApplications::PerformApplicationPrelaunchCheck(const char* pchAppKey)
 {
-	STUBBED();
+	std::shared_lock lock(registryMutex);
+	if (!FindApplication(pchAppKey))
+		return VRApplicationError_UnknownApplication;
+	return VRApplicationError_None;
 }
 const char* BaseApplications::GetApplicationsTransitionStateNameFromEnum(EVRApplicationTransitionState state)
 {
-	STUBBED();
+	switch (state) {
+	case VRApplicationTransition_None:
+		return "None";
+	case VRApplicationTransition_OldAppQuitSent:
+		return "OldAppQuitSent";
+	case VRApplicationTransition_WaitingForExternalLaunch:
+		return "WaitingForExternalLaunch";
+	case VRApplicationTransition_NewAppLaunched:
+		return "NewAppLaunched";
+	}
+	return "Unknown";
 }
 const char* BaseApplications::GetSceneApplicationStateNameFromEnum(BaseApplications::EVRSceneApplicationState state)
 {
-	STUBBED();
+	switch (state) {
+	case EVRSceneApplicationState_None:
+		return "None";
+	case EVRSceneApplicationState_Starting:
+		return "Starting";
+	case EVRSceneApplicationState_Quitting:
+		return "Quitting";
+	case EVRSceneApplicationState_Running:
+		return "Running";
+	case EVRSceneApplicationState_Waiting:
+		return "Waiting";
+	}
+	return "Unknown";
 }
 bool BaseApplications::IsQuitUserPromptRequested()
 {
-	STUBBED();
+	return false;
 }
 EVRApplicationError BaseApplications::LaunchInternalProcess(const char* pchBinaryPath, const char* pchArguments, const char* pchWorkingDirectory)
 {
@@ -175,5 +732,8 @@ EVRApplicationError BaseApplications::LaunchInternalProcess(const char* pchBinar
 }
 uint32_t BaseApplications::GetCurrentSceneProcessId()
 {
-	STUBBED();
+	// Overlays run inside the game's process, so the scene application is us
+	if (sceneApplicationState == EVRSceneApplicationState_None)
+		return 0;
+	return GetCurrentPid();
 }
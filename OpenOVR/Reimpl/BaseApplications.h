@@ -1,6 +1,12 @@
 #pragma once
 #include "BaseCommon.h"
 
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
 /** Used for all errors reported by the IVRApplications interface */
 enum OOVR_EVRApplicationError {
 	// clang-format off
@@ -211,4 +217,46 @@ public:
 	 * focus once it starts rendering, but it will appear here once it calls VR_Init with the Scene application
 	 * type. */
 	uint32_t GetCurrentSceneProcessId();
+
+	// ---------------  OpenComposite internals  --------------- //
+
+	BaseApplications();
+
+	/** Called by the backend when the OpenXR session changes state, so overlays and launchers can see whether the
+	 * game is drawing anything. This is static as the session may start before anything asks for IVRApplications. */
+	static void _SetSceneApplicationState(EVRSceneApplicationState state);
+
+private:
+	struct Application {
+		std::string key;
+		std::string manifestPath;
+
+		// Properties which weren't set in the manifest are left out, so they can return PropertyNotSet
+		std::unordered_map<EVRApplicationProperty, std::string> strings;
+		std::unordered_map<EVRApplicationProperty, bool> bools;
+
+		std::vector<std::string> mimeTypes;
+		bool autoLaunch = false;
+	};
+
+	// These must be called with the registry lock held
+	EVRApplicationError LoadManifest(const std::string& path);
+	void UnloadManifest(const std::string& path);
+	const Application* FindApplication(const char* pchAppKey);
+	void SavePermanentManifests();
+
+	// Launchers may enumerate the applications every frame, so this is a reader-writer lock: only adding or
+	// removing manifests needs exclusive access.
+	std::shared_mutex registryMutex;
+	std::vector<Application> applications;
+	std::unordered_map<std::string, size_t> applicationIndices; // App key to index into applications
+	// Process ID to app key, from IdentifyApplication. This is kept separately from the manifests, as games may
+	// identify themselves with keys that aren't in any of them.
+	std::unordered_map<uint32_t, std::string> processApplications;
+	std::unordered_map<std::string, std::string> defaultMimeTypeApplications;
+
+	// The manifests added with bTemporary=false, which are loaded again each time the game starts
+	std::vector<std::string> permanentManifests;
+
+	static inline std::atomic<EVRSceneApplicationState> sceneApplicationState = EVRSceneApplicationState_None;
 };
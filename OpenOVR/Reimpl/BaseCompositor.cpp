@@ -497,22 +497,22 @@ void BaseCompositor::ReleaseMirrorTextureD3D11(void* pD3D11ShaderResourceView)
 
 ovr_enum_t BaseCompositor::GetMirrorTextureGL(EVREye eEye, glUInt_t* pglTextureId, glSharedTextureHandle_t* pglSharedTextureHandle)
 {
-	STUBBED();
+	return BackendManager::Instance().GetMirrorTextureGL(eEye, pglTextureId, pglSharedTextureHandle);
 }
 
 bool BaseCompositor::ReleaseSharedGLTexture(glUInt_t glTextureId, glSharedTextureHandle_t glSharedTextureHandle)
 {
-	STUBBED();
+	return BackendManager::Instance().ReleaseMirrorTextureGL(glTextureId, glSharedTextureHandle);
 }
 
 void BaseCompositor::LockGLSharedTextureForAccess(glSharedTextureHandle_t glSharedTextureHandle)
 {
-	STUBBED();
+	// The mirror texture lives in the game's own context and is only written to during Submit, so there's
+	// nothing to synchronise with.
 }
 
 void BaseCompositor::UnlockGLSharedTextureForAccess(glSharedTextureHandle_t glSharedTextureHandle)
 {
-	STUBBED();
 }
 
 uint32_t BaseCompositor::GetVulkanInstanceExtensionsRequired(char* pchValue, uint32_t unBufferSize)
@@ -2,44 +2,108 @@
 #define BASE_IMPL
 #include "../BaseCommon.h"
 
+#include "Drivers/Backend.h"
+
+#include <algorithm>
+
+// These are in openvr.h, but not the split headers
+static const uint32_t k_unHeadsetViewMaxWidth = 3840;
+static const uint32_t k_unHeadsetViewMaxHeight = 2160;
+
 void BaseHeadsetView::SetHeadsetViewSize(uint32_t nWidth, uint32_t nHeight)
 {
+	std::lock_guard<std::mutex> lock(mutex);
+	width = std::min(nWidth, k_unHeadsetViewMaxWidth);
+	height = std::min(nHeight, k_unHeadsetViewMaxHeight);
 }
 
 void BaseHeadsetView::GetHeadsetViewSize(uint32_t* pnWidth, uint32_t* pnHeight)
 {
-	*pnWidth = 0;
-	*pnHeight = 0;
+	uint32_t outWidth, outHeight;
+	OOVR_HeadsetViewMode_t currentMode;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		outWidth = width;
+		outHeight = height;
+		currentMode = mode;
+	}
+
+	// Until a size is set, default to the size of the game's eye images
+	if (outWidth == 0 || outHeight == 0) {
+		BackendManager::Instance().GetPrimaryHMD()->GetRecommendedRenderTargetSize(&outWidth, &outHeight);
+		if (currentMode == HeadsetViewMode_Both)
+			outWidth *= 2;
+
+		// Scale down to fit, keeping the aspect ratio
+		double scale = std::min({ 1.0, (double)k_unHeadsetViewMaxWidth / std::max(outWidth, 1u), (double)k_unHeadsetViewMaxHeight / std::max(outHeight, 1u) });
+		outWidth = (uint32_t)(outWidth * scale);
+		outHeight = (uint32_t)(outHeight * scale);
+	}
+
+	if (pnWidth)
+		*pnWidth = outWidth;
+	if (pnHeight)
+		*pnHeight = outHeight;
 }
 
 void BaseHeadsetView::SetHeadsetViewMode(OOVR_HeadsetViewMode_t eHeadsetViewMode)
 {
+	if (eHeadsetViewMode < HeadsetViewMode_Left || eHeadsetViewMode > HeadsetViewMode_Both) {
+		OOVR_LOGF("Ignoring invalid headset view mode %d", eHeadsetViewMode);
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	mode = eHeadsetViewMode;
 }
 
 OOVR_HeadsetViewMode_t BaseHeadsetView::GetHeadsetViewMode()
 {
-	return HeadsetViewMode_Both;
+	std::lock_guard<std::mutex> lock(mutex);
+	return mode;
 }
 
 void BaseHeadsetView::SetHeadsetViewCropped(bool bCropped)
 {
+	std::lock_guard<std::mutex> lock(mutex);
+	cropped = bCropped;
 }
 
 bool BaseHeadsetView::GetHeadsetViewCropped()
 {
-	return false;
+	std::lock_guard<std::mutex> lock(mutex);
+	return cropped;
 }
 
 float BaseHeadsetView::GetHeadsetViewAspectRatio()
 {
-	return 0.0;
+	uint32_t eyeWidth = 0, eyeHeight = 0;
+	BackendManager::Instance().GetPrimaryHMD()->GetRecommendedRenderTargetSize(&eyeWidth, &eyeHeight);
+	if (eyeWidth == 0 || eyeHeight == 0)
+		return 1.0f;
+
+	// In both-eyes mode the views are placed side-by-side
+	float ratio = (float)eyeWidth / (float)eyeHeight;
+	if (GetHeadsetViewMode() == HeadsetViewMode_Both)
+		ratio *= 2;
+	return ratio;
 }
 
 void BaseHeadsetView::SetHeadsetViewBlendRange(float flStartPct, float flEndPct)
 {
+	flStartPct = std::clamp(flStartPct, 0.0f, 1.0f);
+	flEndPct = std::clamp(flEndPct, 0.0f, 1.0f);
+
+	std::lock_guard<std::mutex> lock(mutex);
+	blendStart = std::min(flStartPct, flEndPct);
+	blendEnd = std::max(flStartPct, flEndPct);
 }
 
 void BaseHeadsetView::GetHeadsetViewBlendRange(float* pStartPct, float* pEndPct)
 {
-	STUBBED();
+	std::lock_guard<std::mutex> lock(mutex);
+	if (pStartPct)
+		*pStartPct = blendStart;
+	if (pEndPct)
+		*pEndPct = blendEnd;
 }
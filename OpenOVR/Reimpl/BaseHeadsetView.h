@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <mutex>
 
 enum OOVR_HeadsetViewMode_t {
 	HeadsetViewMode_Left = 0,
@@ -40,4 +41,18 @@ public:
 
 	/** Get the current range [0..1] that the headset view blends across the stereo overlapped area in cropped both mode. */
 	void GetHeadsetViewBlendRange(float* pStartPct, float* pEndPct);
+
+private:
+	// We don't draw a headset view window ourselves, but these are kept so that tools that show the
+	// mirror textures can read back the settings they (or the user) chose.
+	std::mutex mutex;
+
+	// Zero until set, in which case the size follows the headset's render resolution
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	OOVR_HeadsetViewMode_t mode = HeadsetViewMode_Both;
+	bool cropped = false;
+	float blendStart = 0.4f;
+	float blendEnd = 0.6f;
 };
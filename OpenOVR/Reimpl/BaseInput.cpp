@@ -11,6 +11,7 @@
 #include "Drivers/Backend.h"
 #include "generated/static_bases.gen.h"
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <codecvt>
 #include <cstdint>
@@ -29,6 +30,7 @@
 #include <set>
 #include <utility>
 
+#include "Misc/Config.h"
 #include "Misc/xrmoreutils.h"
 
 // Use RenderModels for the pose offsets, which are the same as component positions
@@ -66,8 +68,8 @@ using namespace vr;
 		}                                                            \
 	} while (0)
 
-// This is a duplicate from BaseClientCore.cpp
-static bool ReadJson(const std::wstring& path, Json::Value& result)
+// This is a duplicate from BaseClientCore.cpp, which can also return the file's contents (for BindingCache)
+static bool ReadJson(const std::wstring& path, Json::Value& result, std::string* rawContents = nullptr)
 {
 #ifndef _WIN32
 	typedef std::codecvt_utf8<wchar_t> convert_type;
@@ -82,6 +84,8 @@ static bool ReadJson(const std::wstring& path, Json::Value& result)
 	if (in) {
 		std::stringstream contents;
 		contents << in.rdbuf();
+		if (rawContents)
+			*rawContents = contents.str();
 		contents >> result;
 		return true;
 	} else {
@@ -90,6 +94,8 @@ static bool ReadJson(const std::wstring& path, Json::Value& result)
 	}
 #else
 	std::string contents = OpenComposite_Android_Load_Input_File(real_path.c_str());
+	if (rawContents)
+		*rawContents = contents;
 	Json::Reader reader;
 	reader.parse(contents, result, false);
 	return true;
@@ -207,42 +213,62 @@ BaseInput::InputValueHandle::~InputValueHandle() = default;
 
 // Registry implementation
 
+// Incremented for each registry that's created, so handles from one can't be used with another
+static std::atomic<uint16_t> nextRegistryGeneration = 1;
+
+template <typename T>
+BaseInput::Registry<T>::Registry(uint16_t _tag, uint32_t _maxNameSize)
+    : maxNameSize(_maxNameSize), handlePrefix(((RegHandle)_tag << 48) | ((RegHandle)nextRegistryGeneration++ << 32))
+{
+}
+
+template <typename T>
+uint32_t BaseInput::Registry<T>::InternName(const std::string& lowerName)
+{
+	auto iter = slotsByName.find(lowerName);
+	if (iter != slotsByName.end())
+		return iter->second;
+
+	uint32_t index = slots.size();
+	slots.push_back(Slot{ lowerName, nullptr });
+	slotsByName[lowerName] = index;
+	return index;
+}
+
 template <typename T>
-BaseInput::Registry<T>::Registry(uint32_t _maxNameSize)
-    : maxNameSize(_maxNameSize) {}
+BaseInput::RegHandle BaseInput::Registry<T>::MakeHandle(uint32_t index) const
+{
+	// Offset the index by one, so a handle is never zero (which is the invalid handle value)
+	return handlePrefix | ((RegHandle)index + 1);
+}
 
 template <typename T>
 T* BaseInput::Registry<T>::LookupItem(const std::string& name) const
 {
-	auto iter = itemsByName.find(lowerStr(name));
-	if (iter == itemsByName.end())
+	auto iter = slotsByName.find(lowerStr(name));
+	if (iter == slotsByName.end())
 		return nullptr;
-	return iter->second;
+	return slots[iter->second].item;
 }
 
 template <typename T>
 T* BaseInput::Registry<T>::LookupItem(RegHandle handle) const
 {
-	auto iter = itemsByHandle.find(handle);
-	if (iter == itemsByHandle.end())
+	// This rejects both handles from other registries and invalid (zero) handles
+	if ((handle & 0xffffffff00000000) != handlePrefix)
 		return nullptr;
-	return iter->second;
+
+	uint64_t index = (handle & 0xffffffff) - 1;
+	if (index >= slots.size())
+		return nullptr;
+	return slots[index].item;
 }
 
 template <typename T>
 BaseInput::RegHandle BaseInput::Registry<T>::LookupHandle(const std::string& name)
 {
-	std::string lowerName = ShortenOrLookupName(name);
-	auto iter = handlesByName.find(lowerName);
-	if (iter != handlesByName.end())
-		return iter->second;
-
-	// Create a new dummy handle. It's only in the handlesByName map, so looking up the item
-	// for it will return nullptr.
-	RegHandle handle = 0xabcd0001 + handlesByName.size();
-	handlesByName[lowerName] = handle;
-	namesByHandle[handle] = name;
-	return handle;
+	// If the name doesn't exist yet this creates a new dummy slot for it, with no item associated
+	return MakeHandle(InternName(ShortenOrLookupName(name)));
 }
 
 template <typename T>
@@ -260,11 +286,11 @@ std::string BaseInput::Registry<T>::ShortenOrLookupName(const std::string& longN
 			OOVR_LOGF("Shortened name %s to %s", fullName.c_str(), ret.c_str());
 		} else {
 			// name has already been shortened before - find the shortened version
-			auto iter2 = handlesByName.find(iter->second);
+			auto iter2 = slotsByName.find(iter->second);
 
-			// if it's in the longNames map, it has to be in the handlesByName map
+			// if it's in the longNames map, it has to be in the slotsByName map
 			// otherwise something probably went wrong
-			OOVR_FALSE_ABORT(iter2 != handlesByName.end());
+			OOVR_FALSE_ABORT(iter2 != slotsByName.end());
 
 			// return shortened name
 			return iter2->first;
@@ -274,34 +300,18 @@ std::string BaseInput::Registry<T>::ShortenOrLookupName(const std::string& longN
 }
 
 template <typename T>
-T* BaseInput::Registry<T>::Initialise(const std::string& name, std::unique_ptr<T> value)
+T* BaseInput::Registry<T>::Initialise(const std::string& name)
 {
-	std::string lowerName = lowerStr(name);
-	RegHandle handle = 0;
-
 	// apparently games CAN in fact grab handles before initialization - Kayak VR does this
-	// grab already created handle if it exists
-	if (handlesByName.count(lowerName) != 0) {
-		// since we only generate dummy handles before initialization, make sure we only have dummy handles
-		// dummy handles have no associated items
-		handle = handlesByName.find(lowerName)->second;
-		OOVR_FALSE_ABORT(itemsByHandle.find(handle) == itemsByHandle.end());
-	}
+	// in that case we reuse the slot the handle was created for
+	Slot& slot = slots.at(InternName(lowerStr(name)));
 
-	// Move the pointer into storage, so we'll own it
-	T* ptr = value.get();
-	storage.emplace_back(std::move(value));
+	// since we only generate dummy handles before initialization, make sure we only have dummy handles
+	// dummy handles have no associated items
+	OOVR_FALSE_ABORT(slot.item == nullptr);
 
-	// Use pointer as handle, for ease of debugging only
-	// Since our values live as long as the registry, it's guaranteed their addresses won't repeat
-	if (!handle) {
-		handle = (RegHandle)ptr;
-		handlesByName[lowerName] = handle;
-		namesByHandle[handle] = lowerName;
-	}
-
-	itemsByName[lowerName] = ptr;
-	itemsByHandle[handle] = ptr;
+	T* ptr = &storage.emplace_back();
+	slot.item = ptr;
 
 	// Convenience return
 	return ptr;
@@ -310,12 +320,12 @@ T* BaseInput::Registry<T>::Initialise(const std::string& name, std::unique_ptr<T
 template <typename T>
 void BaseInput::Registry<T>::Reset()
 {
-	// We want to preserve handlesByName and namesByHandle, because handles are supposed to always be accessible
+	// We want to preserve the slots, because handles are supposed to always be accessible
 	// from the same values regardless of if said handles are actually currently valid
 	// In the case of NomaiVR, it will set an action manifest, get all the action handles, and then set another (identical) manifest
 	// We can clear the actual item storage though, since these will no longer be valid
-	itemsByHandle.clear();
-	itemsByName.clear();
+	for (Slot& slot : slots)
+		slot.item = nullptr;
 	storage.clear();
 }
 
@@ -324,7 +334,8 @@ void BaseInput::Registry<T>::Reset()
 const BaseInput::ActionPerProfileData BaseInput::Action::defaultActionData;
 
 BaseInput::BaseInput()
-    : actionSets(XR_MAX_ACTION_SET_NAME_SIZE), actions(XR_MAX_ACTION_NAME_SIZE)
+    : actionSets(0xa5e7, XR_MAX_ACTION_SET_NAME_SIZE), actions(0xac71, XR_MAX_ACTION_NAME_SIZE),
+      inputHandleRegistry(0x1a7d, UINT32_MAX)
 {
 	// Initialise the subaction path constants
 	for (const std::string& str : allSubactionPathNames) {
@@ -340,6 +351,8 @@ BaseInput::BaseInput()
 }
 BaseInput::~BaseInput()
 {
+	invalidateHandJointSamples();
+
 	for (XrHandTrackerEXT& handTracker : handTrackers) {
 		if (handTracker != XR_NULL_HANDLE)
 			xr_ext->xrDestroyHandTrackerEXT(handTracker);
@@ -369,8 +382,8 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 			return vr::VRInputError_None;
 
 		OOVR_LOG("Received another manifest! Restarting session to reattach inputs...");
-		for (std::unique_ptr<ActionSet>& as : actionSets.GetItems()) {
-			OOVR_FAILED_XR_ABORT(xrDestroyActionSet(as->xr));
+		for (ActionSet& as : actionSets.GetItems()) {
+			OOVR_FAILED_XR_ABORT(xrDestroyActionSet(as.xr));
 		}
 		OOVR_FAILED_XR_ABORT(xrDestroyActionSet(legacyInputsSet));
 		legacyInputsSet = XR_NULL_HANDLE;
@@ -388,20 +401,26 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 	loadedActionsPath = pchActionManifestPath;
 
 	Json::Value root;
+	std::string manifestContents;
 	// It says 'open or parse', but really it ignores parse errors - TODO catch those
-	if (!ReadJson(utf8to16(pchActionManifestPath), root))
+	if (!ReadJson(utf8to16(pchActionManifestPath), root, &manifestContents))
 		OOVR_ABORTF("Failed to open or parse input manifest (%s)", pchActionManifestPath);
 
+	bindingCache = BindingCache(pchActionManifestPath);
+	bindingCache.AddSource(manifestContents);
+
 	// Random setting which is in the action manifest
 	allowSetDominantHand = root["supports_dominant_hand_setting"].asBool();
 
 	// Parse the actions
 	OOVR_LOG("Parsing actions...");
 	for (Json::Value item : root["actions"]) {
-		std::unique_ptr<Action> actionPtr = std::make_unique<Action>();
-		Action& action = *actionPtr;
+		std::string fullName = actions.ShortenOrLookupName(item["name"].asString());
+		if (actions.LookupItem(fullName) != nullptr)
+			OOVR_ABORTF("Duplicate action name '%s'", fullName.c_str());
 
-		action.fullName = actions.ShortenOrLookupName(item["name"].asString());
+		Action& action = *actions.Initialise(fullName);
+		action.fullName = fullName;
 
 		// Split the full name by stroke ('/') characters
 		// They have four parts: the first is always 'actions', the second is the action set name, the third is
@@ -457,9 +476,6 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 		else
 			OOVR_ABORTF("Invalid action type '%s' for action '%s'", type.c_str(), action.fullName.c_str());
 
-		if (actions.LookupItem(action.fullName) != nullptr)
-			OOVR_ABORTF("Duplicate action name '%s'", action.fullName.c_str());
-
 		// If this is a skeletal action, see what hand it's bound to. Uniquely, this is done in the actions manifest itself
 		if (action.type == ActionType::Skeleton) {
 			// Default to the left hand, so we can always safely use it as a 0 or 1 value for indexing arrays etc
@@ -477,17 +493,17 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 				    skelSide.c_str(), action.fullName.c_str());
 			}
 		}
-
-		std::string name = action.fullName; // Array index may be evaluated first iirc, so pull this out now
-		actions.Initialise(name, std::move(actionPtr));
 	}
 
 	// Parse the action sets
 	OOVR_LOG("Parsing action sets...");
 	for (Json::Value item : root["action_sets"]) {
-		ActionSet set = {};
+		std::string fullName = actionSets.ShortenOrLookupName(item["name"].asString());
+		if (actionSets.LookupItem(fullName) != nullptr)
+			OOVR_ABORTF("Duplicate action set name '%s'", fullName.c_str());
 
-		set.fullName = actionSets.ShortenOrLookupName(item["name"].asString());
+		ActionSet& set = *actionSets.Initialise(fullName);
+		set.fullName = fullName;
 
 		// Split the full name by stroke ('/') characters
 		// They have four parts: the first is always 'actions', the second is the action set name, the third is
@@ -513,50 +529,47 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 			set.usage = ActionSetUsage::Hidden;
 		else
 			OOVR_ABORTF("Invalid action set usage '%s' for action set '%s'", usage.c_str(), set.name.c_str());
-
-		// Register it
-		actionSets.Initialise(set.fullName, std::make_unique<ActionSet>(set));
 	}
 
 	// Make sure all the actions have a corresponding set
-	for (const std::unique_ptr<Action>& action : actions.GetItems()) {
+	for (Action& action : actions.GetItems()) {
 		// In the OpenVR samples, they don't declare their action set. Are they automatically created?!
 		// Also Vivecraft unfortunately does this, so we do have to support it.
-		std::string fullName = "/actions/" + action->setName;
+		std::string fullName = "/actions/" + action.setName;
 		ActionSet* set = actionSets.LookupItem(fullName);
 		if (set == nullptr) {
-			OOVR_LOGF("Invalid action set '%s' for action '%s', creating implicit set", action->setName.c_str(), action->fullName.c_str());
+			OOVR_LOGF("Invalid action set '%s' for action '%s', creating implicit set", action.setName.c_str(), action.fullName.c_str());
 
 			// Create this set
-			set = actionSets.Initialise(fullName, std::make_unique<ActionSet>());
-			set->name = action->setName;
+			set = actionSets.Initialise(fullName);
+			set->name = action.setName;
 			set->fullName = fullName;
 			set->usage = ActionSetUsage::LeftRight; // Just assume these default sets are in leftright mode, FIXME validate against steamvr
 		}
 
-		action->set = set;
+		action.set = set;
 	}
 
 	//////////////////////////
 	/// Now we've got everything done, load the actions into OpenXR
 	//////////////////////////
 
-	for (const std::unique_ptr<ActionSet>& as : actionSets.GetItems()) {
+	for (ActionSet& as : actionSets.GetItems()) {
 		XrActionSetCreateInfo createInfo = { XR_TYPE_ACTION_SET_CREATE_INFO };
-		std::string safeName = escapePathString(as->name);
+		std::string safeName = escapePathString(as.name);
 		strcpy_arr(createInfo.actionSetName, safeName.c_str());
-		strcpy_arr(createInfo.localizedActionSetName, as->name.c_str()); // TODO localisation
+		strcpy_arr(createInfo.localizedActionSetName, as.name.c_str()); // TODO localisation
 
-		OOVR_FAILED_XR_ABORT(xrCreateActionSet(xr_instance, &createInfo, &as->xr));
+		OOVR_FAILED_XR_ABORT(xrCreateActionSet(xr_instance, &createInfo, &as.xr));
 	}
 
-	for (const std::unique_ptr<Action>& act : actions.GetItems()) {
+	for (Action& act : actions.GetItems()) {
 		XrActionCreateInfo info = { XR_TYPE_ACTION_CREATE_INFO };
-		std::string safeName = escapePathString(act->shortName);
+		std::string safeName = escapePathString(act.shortName);
 		strcpy_arr(info.actionName, safeName.c_str());
-		strcpy_arr(info.localizedActionName, act->shortName.c_str()); // TODO localisation
+		strcpy_arr(info.localizedActionName, act.shortName.c_str()); // TODO localisation
 
-		switch (act->type) {
+		switch (act.type) {
 		case ActionType::Boolean:
 			info.actionType = XR_ACTION_TYPE_FLOAT_INPUT; // do the float->boolean conversion in here
 			break;
@@ -579,14 +592,14 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 			// Don't actually create an action for skeletons, since we'll get their data from the hand tracking extension.
 			continue;
 		default:
-			OOVR_SOFT_ABORTF("Bad action type while remapping action %s: %d", act->fullName.c_str(), static_cast<int>(act->type));
+			OOVR_SOFT_ABORTF("Bad action type while remapping action %s: %d", act.fullName.c_str(), static_cast<int>(act.type));
 		}
 
 		// Listen on all the subactions
 		info.subactionPaths = allSubactionPaths.data();
 		info.countSubactionPaths = allSubactionPaths.size();
 
-		OOVR_FAILED_XR_ABORT(xrCreateAction(act->set->xr, &info, &act->xr));
+		OOVR_FAILED_XR_ABORT(xrCreateAction(act.set->xr, &info, &act.xr));
 	}
 
 	CreateLegacyActions();
@@ -614,6 +627,17 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 		{ "generic", 1 }
 	};
 
+	// Work out which bindings file each profile uses first, since all their contents are needed to find the
+	// binding cache before any of them are loaded.
+	std::vector<std::pair<const InteractionProfile*, std::string>> profileBindings;
+	auto loadBindings = [&](const InteractionProfile& profile, const std::string& path) {
+		// Don't bother reading the file if it won't be used
+		if (!profile.CanHaveBindings())
+			return;
+
+		profileBindings.emplace_back(&profile, path);
+	};
+
 	for (Json::Value item : root["default_bindings"]) {
 		std::string controller_type = item["controller_type"].asString();
 		std::string path = dirnameOf(pchActionManifestPath) + "/" + item["binding_url"].asString();
@@ -630,7 +654,7 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 		// have to loop through every binding type because default_bindings is an array for some reason
 		auto iter = OpenVRNameToProfile.find(controller_type);
 		if (iter != OpenVRNameToProfile.end()) {
-			LoadBindingsSet(*(iter->second), path);
+			loadBindings(*(iter->second), path);
 			// profile has been bound: we don't need it in our map anymore
 			OpenVRNameToProfile.erase(iter);
 		}
@@ -650,9 +674,36 @@ EVRInputError BaseInput::SetActionManifestPath(const char* pchActionManifestPath
 
 	// remaining profiles: bind to our backup path
 	for (auto& [name, profile_ptr] : OpenVRNameToProfile) {
-		LoadBindingsSet(*profile_ptr, backupPath);
+		loadBindings(*profile_ptr, backupPath);
+	}
+
+	// Parse each bindings file only once - the backup file in particular is usually used by several profiles.
+	std::unordered_map<std::string, Json::Value> parsedBindings;
+	for (const auto& [profile, path] : profileBindings) {
+		bindingCache.AddSource(profile->GetPath());
+		bindingCache.AddSource(path);
+
+		if (parsedBindings.count(path))
+			continue;
+
+		Json::Value bindingsRoot;
+		std::string contents;
+		if (!ReadJson(utf8to16(path), bindingsRoot, &contents)) {
+			OOVR_ABORTF("Failed to read and parse JSON binding descriptor: %s", path.c_str());
+		}
+		bindingCache.AddSource(contents);
+		parsedBindings.emplace(path, std::move(bindingsRoot));
 	}
 
+	bool cached = bindingCache.Load();
+
+	for (const auto& [profile, path] : profileBindings) {
+		LoadBindingsSet(*profile, path, parsedBindings.at(path));
+	}
+
+	if (!cached)
+		bindingCache.Save();
+
 	// Attach everything to the current session
 	BindInputsForSession();
 	return vr::VRInputError_None;
@@ -716,8 +767,8 @@ void BaseInput::BindInputsForSession()
 		return;
 
 	// Since the session has changed, any actionspaces we previously created are now invalid
-	for (const std::unique_ptr<Action>& action : actions.GetItems()) {
-		action->actionSpaces.clear();
+	for (Action& action : actions.GetItems()) {
+		action.actionSpaces.clear();
 	}
 
 	// Same goes for the actionspaces of the legacy controller pose actions, this time create
@@ -740,8 +791,8 @@ void BaseInput::BindInputsForSession()
 
 	// Now attach the action sets to the OpenXR session, making them immutable (including attaching suggested bindings)
 	std::vector<XrActionSet> sets;
-	for (const std::unique_ptr<ActionSet>& as : actionSets.GetItems()) {
-		sets.push_back(as->xr);
+	for (ActionSet& as : actionSets.GetItems()) {
+		sets.push_back(as.xr);
 	}
 
 	sets.push_back(legacyInputsSet);
@@ -751,6 +802,12 @@ void BaseInput::BindInputsForSession()
 	attachInfo.countActionSets = sets.size();
 	OOVR_FAILED_XR_ABORT(xrAttachSessionActionSets(xr_session.get(), &attachInfo));
 
+	// Any joints located so far came from the old session's hand trackers
+	invalidateHandJointSamples();
+
+	// Likewise, don't play any pulses queued for the old actions
+	hapticScheduler.Clear();
+
 	// Setup hand tracking if supported
 	if (xr_gbl->handTrackingProperties.supportsHandTracking) {
 		XrHandTrackerCreateInfoEXT createInfo = { XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT };
@@ -762,18 +819,13 @@ void BaseInput::BindInputsForSession()
 	}
 }
 
-void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::string& bindingsPath)
+void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::string& bindingsPath, const Json::Value& bindingsRoot)
 {
 	OOVR_LOGF("Loading bindings for %s", profile.GetPath().c_str());
 
 	if (!profile.CanHaveBindings())
 		return;
 
-	Json::Value bindingsRoot;
-	if (!ReadJson(utf8to16(bindingsPath), bindingsRoot)) {
-		OOVR_ABORTF("Failed to read and parse JSON binding descriptor: %s", bindingsPath.c_str());
-	}
-
 	// TODO aliases, if anyone uses them
 	if (!bindingsRoot["alias_info"].empty())
 		OOVR_LOGF("WARNING: Ignoring alias_info from binding descriptor %s", bindingsPath.c_str());
@@ -888,9 +940,7 @@ void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::st
 						OOVR_LOGF("Trying to bind index extendo action to non-existent path %s? Ignoring...", pathStr.c_str());
 					} else {
 						OOVR_LOGF("Bound index extendo action to %s for original %s (%s)", pathStr.c_str(), importBasePath.c_str(), action->fullName.c_str());
-						XrPath path;
-						OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, pathStr.c_str(), &path));
-						bindings.push_back(XrActionSuggestedBinding{ forceAction, path });
+						bindings.push_back(XrActionSuggestedBinding{ forceAction, bindingCache.GetPath(pathStr) });
 					}
 
 					action->stackedValueExtension = forceAction;
@@ -936,9 +986,7 @@ void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::st
 					continue;
 				}
 
-				XrPath path;
-				OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, pathStr.c_str(), &path));
-				bindings.push_back(XrActionSuggestedBinding{ action->xr, path });
+				bindings.push_back(XrActionSuggestedBinding{ action->xr, bindingCache.GetPath(pathStr) });
 			}
 		}
 
@@ -968,12 +1016,16 @@ void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::st
 				info.point = PoseBindingPoint::RAW;
 			} else if (withoutPrefix == "pose/grip") {
 				info.point = PoseBindingPoint::GRIP;
+				info.component = ControllerComponentId::GRIP;
 			} else if (withoutPrefix == "pose/handgrip") {
 				info.point = PoseBindingPoint::HANDGRIP;
+				info.component = ControllerComponentId::HANDGRIP;
 			} else if (withoutPrefix == "pose/base") {
 				info.point = PoseBindingPoint::BASE;
+				info.component = ControllerComponentId::BASE;
 			} else if (withoutPrefix == "pose/tip") {
 				info.point = PoseBindingPoint::TIP;
+				info.component = ControllerComponentId::TIP;
 			} else if (withoutPrefix == "pose/body") {
 				info.point = PoseBindingPoint::BODY;
 			} else if (withoutPrefix == "pose/gdc2015") {
@@ -1004,9 +1056,7 @@ void BaseInput::LoadBindingsSet(const InteractionProfile& profile, const std::st
 				OOVR_ABORTF("Built invalid input path %s from pose action %s", pathStr.c_str(), actionName.c_str());
 			}
 
-			XrPath path;
-			OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, pathStr.c_str(), &path));
-			bindings.push_back(XrActionSuggestedBinding{ action->xr, path });
+			bindings.push_back(XrActionSuggestedBinding{ action->xr, bindingCache.GetPath(pathStr) });
 		}
 	}
 
@@ -1086,8 +1136,7 @@ void BaseInput::LoadDpadAction(const InteractionProfile& profile, const std::str
 		OOVR_FAILED_XR_ABORT(xrCreateAction(action->set->xr, &info, &parent_iter->second.vectorAction));
 
 		// add parent to bindings
-		XrPath suggested_path;
-		OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, profile.TranslateAction(importBasePath).c_str(), &suggested_path));
+		XrPath suggested_path = bindingCache.GetPath(parentPath);
 		bindings.push_back(XrActionSuggestedBinding{ parent_iter->second.vectorAction, suggested_path });
 	}
 
@@ -1111,8 +1160,7 @@ void BaseInput::LoadDpadAction(const InteractionProfile& profile, const std::str
 				action->perProfileData[&profile].click_deactivate_threshold = 0.2f;
 			}
 
-			XrPath suggested_path;
-			OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, profile.TranslateAction(importBasePath + (manualThreshold ? "/force" : "/click")).c_str(), &suggested_path));
+			XrPath suggested_path = bindingCache.GetPath(profile.TranslateAction(importBasePath + (manualThreshold ? "/force" : "/click")));
 			bindings.push_back(XrActionSuggestedBinding{ parent_iter->second.clickAction, suggested_path });
 		}
 	} else {
@@ -1128,8 +1176,7 @@ void BaseInput::LoadDpadAction(const InteractionProfile& profile, const std::str
 			strcpy_arr(info.localizedActionName, touch_name.c_str());
 			OOVR_FAILED_XR_ABORT(xrCreateAction(action->set->xr, &info, &parent_iter->second.touchAction));
 
-			XrPath suggested_path;
-			OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, touchPath.c_str(), &suggested_path));
+			XrPath suggested_path = bindingCache.GetPath(touchPath);
 			bindings.push_back(XrActionSuggestedBinding{ parent_iter->second.touchAction, suggested_path });
 		}
 	}
@@ -1170,8 +1217,7 @@ void BaseInput::LoadDClickAction(const InteractionProfile& profile, const std::s
 	strcpy_arr(info.localizedActionName, clickName.c_str()); // TODO: localization
 	OOVR_FAILED_XR_ABORT(xrCreateAction(action->set->xr, &info, &dclickInfo.click_action)); // FIXME: share click actions
 
-	XrPath suggested_path;
-	OOVR_FAILED_XR_ABORT(xrStringToPath(xr_instance, clickPath.c_str(), &suggested_path));
+	XrPath suggested_path = bindingCache.GetPath(clickPath);
 	bindings.push_back(XrActionSuggestedBinding{ dclickInfo.click_action, suggested_path });
 
 	action->perProfileData[&profile].dclickBindings.push_back(dclickInfo);
@@ -1259,15 +1305,12 @@ EVRInputError BaseInput::GetInputSourceHandle(const char* pchInputSourcePath, VR
 	// Get the existing InputValueHandle if it already exists, or make a new one otherwise. Applications can
 	// get whatever handles they want, regardless of whether the runtime associates any special meaning with it.
 
-	const auto iter = inputHandleRegistry.find(pchInputSourcePath);
-	if (iter != inputHandleRegistry.end()) {
-		InputValueHandle* handle = iter->second.get();
-		*pHandle = (uint64_t)handle;
+	RegHandle regHandle = inputHandleRegistry.LookupHandle(pchInputSourcePath);
+	*pHandle = regHandle;
+	if (inputHandleRegistry.LookupItem(regHandle))
 		return VRInputError_None;
-	}
 
-	std::unique_ptr<InputValueHandle> handle = std::make_unique<InputValueHandle>();
-	InputValueHandle* ptr = handle.get();
+	InputValueHandle* handle = inputHandleRegistry.Initialise(pchInputSourcePath);
 	handle->path = pchInputSourcePath;
 
 	// Yes, this will let through something like/user/hand/leftblah but it's probably not an issue
@@ -1289,8 +1332,6 @@ EVRInputError BaseInput::GetInputSourceHandle(const char* pchInputSourcePath, VR
 		OOVR_FALSE_ABORT(std::count(allSubactionPaths.begin(), allSubactionPaths.end(), handle->devicePath));
 	}
 
-	inputHandleRegistry[pchInputSourcePath] = std::move(handle);
-	*(uint64_t*)pHandle = (uint64_t)ptr;
 	return VRInputError_None;
 }
 
@@ -1323,7 +1364,7 @@ EVRInputError BaseInput::UpdateActionState(VR_ARRAY_COUNT(unSetCount) VRActiveAc
 		aas[i].actionSet = as->xr;
 
 		if (set.ulRestrictedToDevice != vr::k_ulInvalidInputValueHandle) {
-			std::shared_ptr<ITrackedDevice> dev = ivhToDev(set.ulRestrictedToDevice);
+			ITrackedDevice* dev = ivhToDev(set.ulRestrictedToDevice);
 			if (dev && dev->GetHand() != ITrackedDevice::HAND_NONE) {
 				LegacyControllerActions& ctrl = legacyControllers[dev->GetHand()];
 				aas[i].subactionPath = ctrl.handPathXr;
@@ -1357,6 +1398,12 @@ void BaseInput::InternalUpdate()
 	// Always increment this once per frame, and only once per frame
 	syncSerialDigital++;
 
+	// Send any haptic pulses that have come due since the last frame
+	if (oovr_global_configuration.Haptics())
+		hapticScheduler.Flush(xr_session.get(), BackendManager::GetTimeInSeconds());
+	else
+		hapticScheduler.Clear();
+
 	if (!usingLegacyInput)
 		return;
 
@@ -1565,11 +1612,11 @@ XrResult BaseInput::getBooleanOrDpadData(const InteractionProfile* profile, Acti
 				dpad_info.lastState = currentState;
 
 				if (currentState && dpad_info.triggerHapticOnClick) {
-					for (auto& otherAction : actions.GetItems()) {
-						if (!otherAction->haptic || otherAction->xr == XR_NULL_HANDLE)
+					for (Action& otherAction : actions.GetItems()) {
+						if (!otherAction.haptic || otherAction.xr == XR_NULL_HANDLE)
 							continue;
 						XrHapticActionInfo hapticInfo = { XR_TYPE_HAPTIC_ACTION_INFO };
-						hapticInfo.action = otherAction->xr;
+						hapticInfo.action = otherAction.xr;
 						hapticInfo.subactionPath = getInfo->subactionPath;
 						XrHapticVibration vibration = { XR_TYPE_HAPTIC_VIBRATION };
 						vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
@@ -1788,7 +1835,7 @@ EVRInputError BaseInput::GetPoseActionData(VRActionHandle_t action, ETrackingUni
 	OOVR_FALSE_ABORT(unActionDataSize == sizeof(*pActionData));
 
 	if (act->type == ActionType::Skeleton) {
-		std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
+		ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
 		if (!dev)
 			return vr::VRInputError_InvalidDevice;
 
@@ -1816,7 +1863,7 @@ EVRInputError BaseInput::GetPoseActionData(VRActionHandle_t action, ETrackingUni
 		}
 
 		// Find the device for this hand, and look up it's interaction profile
-		std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(handType);
+		ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(handType);
 		if (!dev)
 			continue;
 
@@ -1844,33 +1891,12 @@ EVRInputError BaseInput::GetPoseActionData(VRActionHandle_t action, ETrackingUni
 		if (rawPose.bPoseIsValid) {
 			glm::mat4 handMat = S2G_m34(rawPose.mDeviceToAbsoluteTracking);
 
-			const char* componentName = nullptr;
-			switch (binding.point) {
-			case PoseBindingPoint::RAW:
-			case PoseBindingPoint::BODY:
-			case PoseBindingPoint::GDC2015:
-				// No component name
-				break;
-			case PoseBindingPoint::GRIP:
-				componentName = "grip";
-				break;
-			case PoseBindingPoint::BASE:
-				componentName = "base";
-				break;
-			case PoseBindingPoint::HANDGRIP:
-				componentName = "handgrip";
-				break;
-			case PoseBindingPoint::TIP:
-				componentName = "tip";
-				break;
-			}
-
 			// Add the component transform, if required
 			OOVR_RenderModel_ComponentState_t state = {};
 			bool hasTransform = false;
 			glm::mat4 transform = glm::identity<glm::mat4>();
-			if (componentName) {
-				hasTransform = GetBaseRenderModels()->TryGetComponentState(handType, componentName, &state);
+			if (binding.component != ControllerComponentId::UNKNOWN) {
+				hasTransform = GetBaseRenderModels()->TryGetComponentState(handType, binding.component, &state);
 			}
 			if (hasTransform) {
 				transform = S2G_m34(state.mTrackingToComponentLocal);
@@ -1986,7 +2012,7 @@ EVRInputError BaseInput::GetSkeletalReferenceTransforms(VRActionHandle_t actionH
 	std::span<VRBoneTransform_t> out(pTransformArray, unTransformArrayCount);
 
 	// Find the interaction profile to retrieve hand pose
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
 	if (!dev)
 		return vr::VRInputError_InvalidDevice;
 
@@ -1994,13 +2020,13 @@ EVRInputError BaseInput::GetSkeletalReferenceTransforms(VRActionHandle_t actionH
 	if (!profile)
 		return vr::VRInputError_InvalidDevice;
 
-	const std::optional<BoneArray> pose = profile->GetSkeletalReferencePose(act->skeletalHand, eReferencePose);
-	if (!pose.has_value()) {
+	const BoneArray* pose = profile->GetSkeletalReferencePose(act->skeletalHand, eReferencePose);
+	if (!pose) {
 		OOVR_LOGF("WARNING: Couldn't find reference pose: %d, %d", act->skeletalHand, eReferencePose);
 		return vr::VRInputError_InvalidParam;
 	}
 
-	std::copy(std::begin(pose.value()), std::end(pose.value()), out.begin());
+	std::copy(pose->begin(), pose->end(), out.begin());
 
 	if (eTransformSpace == EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model)
 		ParentSpaceSkeletonToModelSpace(pTransformArray);
@@ -2014,7 +2040,7 @@ EVRInputError BaseInput::GetSkeletalTrackingLevel(VRActionHandle_t action, EVRSk
 	if (act->skeletalHand == ITrackedDevice::HAND_NONE)
 		return vr::VRInputError_InvalidHandle;
 
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(act->skeletalHand);
 	if (!dev)
 		return vr::VRInputError_InvalidDevice;
 
@@ -2026,7 +2052,14 @@ EVRInputError BaseInput::GetSkeletalTrackingLevel(VRActionHandle_t action, EVRSk
 		return vr::VRInputError_None;
 	}
 
-	if (dev->IsHandTrackingValid()) {
+	bool handTracked;
+	{
+		std::lock_guard lock(handJointSamplesMutex);
+		HandJointSample* sample = getHandJointSample(act->skeletalHand);
+		handTracked = sample && sample->isActive;
+	}
+
+	if (handTracked) {
 		*pSkeletalTrackingLevel = vr::VRSkeletalTracking_Full;
 		return vr::VRInputError_None;
 	}
@@ -2074,62 +2107,76 @@ EVRInputError BaseInput::GetSkeletalBoneData(VRActionHandle_t actionHandle, EVRS
 	const auto hand = action->skeletalHand;
 	OOVR_FALSE_ABORT(static_cast<int>(hand) < 2);
 
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(hand);
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(hand);
 	if (!dev)
 		return vr::VRInputError_InvalidDevice;
 
-	if (!xr_gbl->handTrackingProperties.supportsHandTracking) {
-		dev->SetHandTrackingValid(false);
-		return getEstimatedBoneData(hand, eTransformSpace, eMotionRange, std::span<VRBoneTransform_t, eBone_Count>(pTransformArray, eBone_Count));
-	}
-
-	bool usingFakePose = dev->IsPoseFromHandTracking();
+	std::lock_guard lock(handJointSamplesMutex);
+	HandJointSample* sample = getHandJointSample(hand);
 
-	XrHandJointsLocateInfoEXT locateInfo = { XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT };
-	// If the pose is fake that means we don't have controllers the hand must be located relative to floor
-	locateInfo.baseSpace = usingFakePose ? xr_gbl->floorSpace : legacyControllers[static_cast<int>(hand)].gripPoseSpace;
-	locateInfo.time = xr_gbl->GetBestTime();
-
-	XrHandJointLocationsEXT locations = { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
-	locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
-	std::vector<XrHandJointLocationEXT> jointLocations(locations.jointCount);
-	locations.jointLocations = jointLocations.data();
-
-	OOVR_FAILED_XR_ABORT(xr_ext->xrLocateHandJointsEXT(handTrackers[(int)action->skeletalHand], &locateInfo, &locations));
-
-	if (!locations.isActive) {
+	if (!sample || !sample->isActive) {
 		// Fallback to estimated bone data (e.g. for controllers)
 		dev->SetHandTrackingValid(false);
 		return getEstimatedBoneData(hand, eTransformSpace, eMotionRange, std::span<VRBoneTransform_t, eBone_Count>(pTransformArray, eBone_Count));
 	}
 
-	bool isRight = (action->skeletalHand == ITrackedDevice::HAND_RIGHT);
+	// If the pose is fake that means we don't have controllers, so there's no grip pose to position the hand relative to
+	const XrSpaceLocationFlags gripValidFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+	bool usingFakePose = dev->IsPoseFromHandTracking() || (sample->gripLocation.locationFlags & gripValidFlags) != gripValidFlags;
+
 	const InteractionProfile* profile = dev->GetInteractionProfile();
 
-	// Retrieve the appropriate hand transform to account for the SteamVR pose being different from OpenXR grip
-	glm::mat4 transform = profile->GetGripToSteamVRTransform(hand);
+	// The skeleton doesn't depend on the motion range or transform space, so it's only built once per sample
+	if (!sample->skeletonBuilt || sample->skeletonFakeWrist != usingFakePose || sample->skeletonProfile != profile) {
+		sample->skeletonBuilt = true;
+		sample->skeletonFakeWrist = usingFakePose;
+		sample->skeletonProfile = profile;
+
+		// The joints were located in floor space, move them to be relative to the grip pose. Every joint has to be
+		// moved since the bones are built from each joint's pose relative to its parent, including the wrist's.
+		HandJointArray joints = sample->locations;
+		if (!usingFakePose) {
+			glm::quat gripOrientationInverse = glm::inverse(X2G_quat(sample->gripLocation.pose.orientation));
+			glm::vec3 gripPosition = X2G_v3f(sample->gripLocation.pose.position);
+
+			for (XrHandJointLocationEXT& joint : joints) {
+				joint.pose.position = G2X_v3f(gripOrientationInverse * (X2G_v3f(joint.pose.position) - gripPosition));
+				joint.pose.orientation = G2X_quat(gripOrientationInverse * X2G_quat(joint.pose.orientation));
+			}
+		}
 
-	if (!XrHandJointsToSkeleton(jointLocations, isRight, pTransformArray, transform))
-		return getEstimatedBoneData(hand, eTransformSpace, eMotionRange, std::span<VRBoneTransform_t, eBone_Count>(pTransformArray, eBone_Count));
+		bool isRight = (hand == ITrackedDevice::HAND_RIGHT);
 
-	// Without a controller we get a hand positioned relative to floor space, change that to be relative to the fake controller pose
-	if (usingFakePose) {
-		vr::VRBoneTransform_t& wrist = pTransformArray[eBone_Wrist];
-		if (isRight) {
-			wrist.position = { 0.034038f, 0.036503f, 0.164722f, 1.000000f };
-			wrist.orientation = { -0.055147f, -0.078608f, 0.920279f, -0.379296f };
-		} else {
-			wrist.position = { -0.034038f, 0.036503f, 0.164722f, 1.000000f };
-			wrist.orientation = { -0.055147f, -0.078608f, -0.920279f, 0.379296f };
+		// Retrieve the appropriate hand transform to account for the SteamVR pose being different from OpenXR grip
+		glm::mat4 transform = profile->GetGripToSteamVRTransform(hand);
+
+		BoneArray& bones = sample->parentSpaceSkeleton;
+		sample->skeletonValid = XrHandJointsToSkeleton(joints, isRight, bones.data(), transform);
+
+		// Without a controller we get a hand positioned relative to floor space, change that to be relative to the fake controller pose
+		if (sample->skeletonValid && usingFakePose) {
+			vr::VRBoneTransform_t& wrist = bones[eBone_Wrist];
+			if (isRight) {
+				wrist.position = { 0.034038f, 0.036503f, 0.164722f, 1.000000f };
+				wrist.orientation = { -0.055147f, -0.078608f, 0.920279f, -0.379296f };
+			} else {
+				wrist.position = { -0.034038f, 0.036503f, 0.164722f, 1.000000f };
+				wrist.orientation = { -0.055147f, -0.078608f, -0.920279f, 0.379296f };
+			}
 		}
+
+		sample->modelSpaceSkeleton = bones;
+		ParentSpaceSkeletonToModelSpace(sample->modelSpaceSkeleton.data());
 	}
 
-	if (eTransformSpace == EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model)
-		ParentSpaceSkeletonToModelSpace(pTransformArray);
+	if (!sample->skeletonValid)
+		return getEstimatedBoneData(hand, eTransformSpace, eMotionRange, std::span<VRBoneTransform_t, eBone_Count>(pTransformArray, eBone_Count));
+
+	const BoneArray& bones = eTransformSpace == EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model ? sample->modelSpaceSkeleton : sample->parentSpaceSkeleton;
+	std::copy(bones.begin(), bones.end(), pTransformArray);
 
 	dev->SetHandTrackingValid(true);
 
-	// For now, just return with non-active data
 	return vr::VRInputError_None;
 }
 EVRInputError BaseInput::GetSkeletalSummaryData(VRActionHandle_t actionHandle, EVRSummaryType eSummaryType, VRSkeletalSummaryData_t* pSkeletalSummaryData)
@@ -2145,52 +2192,37 @@ EVRInputError BaseInput::GetSkeletalSummaryData(VRActionHandle_t actionHandle, E
 	return getEstimatedSkeletalSummary(action->skeletalHand, pSkeletalSummaryData);
 }
 
-EVRInputError BaseInput::getRealSkeletalSummary(ITrackedDevice::TrackedDeviceType hand, VRSkeletalSummaryData_t* pSkeletalSummaryData)
+// Find how far each finger is curled, from the angle between its metacarpal, proximal and tip joints
+static void buildFingerCurls(const HandJointArray& joints, float curls[VRFinger_Count])
 {
-	XrHandJointsLocateInfoEXT locateInfo = { XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT };
-	locateInfo.baseSpace = xr_gbl->floorSpace;
-	locateInfo.time = xr_gbl->GetBestTime();
-
-	XrHandJointLocationsEXT locations = { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
-	locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
-	std::vector<XrHandJointLocationEXT> jointLocations(locations.jointCount);
-	locations.jointLocations = jointLocations.data();
-
-	OOVR_FAILED_XR_ABORT(xr_ext->xrLocateHandJointsEXT(handTrackers[hand], &locateInfo, &locations));
-
-	if (!locations.isActive) {
-		// Fallback to estimated skeletal summary data (e.g. for controllers)
-		return getEstimatedSkeletalSummary(hand, pSkeletalSummaryData);
-	}
-
-	for (int i = 0; i < 5; ++i) {
+	for (int i = 0; i < VRFinger_Count; ++i) {
 		XrHandJointLocationEXT metacarpal, proximal, tip;
 
 		switch (i) {
 		case 0: // thumb
-			metacarpal = jointLocations[XR_HAND_JOINT_THUMB_METACARPAL_EXT];
-			proximal = jointLocations[XR_HAND_JOINT_THUMB_PROXIMAL_EXT];
-			tip = jointLocations[XR_HAND_JOINT_THUMB_TIP_EXT];
+			metacarpal = joints[XR_HAND_JOINT_THUMB_METACARPAL_EXT];
+			proximal = joints[XR_HAND_JOINT_THUMB_PROXIMAL_EXT];
+			tip = joints[XR_HAND_JOINT_THUMB_TIP_EXT];
 			break;
 		case 1: // index
-			metacarpal = jointLocations[XR_HAND_JOINT_INDEX_METACARPAL_EXT];
-			proximal = jointLocations[XR_HAND_JOINT_INDEX_PROXIMAL_EXT];
-			tip = jointLocations[XR_HAND_JOINT_INDEX_TIP_EXT];
+			metacarpal = joints[XR_HAND_JOINT_INDEX_METACARPAL_EXT];
+			proximal = joints[XR_HAND_JOINT_INDEX_PROXIMAL_EXT];
+			tip = joints[XR_HAND_JOINT_INDEX_TIP_EXT];
 			break;
 		case 2: // middle
-			metacarpal = jointLocations[XR_HAND_JOINT_MIDDLE_METACARPAL_EXT];
-			proximal = jointLocations[XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT];
-			tip = jointLocations[XR_HAND_JOINT_MIDDLE_TIP_EXT];
+			metacarpal = joints[XR_HAND_JOINT_MIDDLE_METACARPAL_EXT];
+			proximal = joints[XR_HAND_JOINT_MIDDLE_PROXIMAL_EXT];
+			tip = joints[XR_HAND_JOINT_MIDDLE_TIP_EXT];
 			break;
 		case 3: // ring
-			metacarpal = jointLocations[XR_HAND_JOINT_RING_METACARPAL_EXT];
-			proximal = jointLocations[XR_HAND_JOINT_RING_PROXIMAL_EXT];
-			tip = jointLocations[XR_HAND_JOINT_RING_TIP_EXT];
+			metacarpal = joints[XR_HAND_JOINT_RING_METACARPAL_EXT];
+			proximal = joints[XR_HAND_JOINT_RING_PROXIMAL_EXT];
+			tip = joints[XR_HAND_JOINT_RING_TIP_EXT];
 			break;
 		case 4: // little
-			metacarpal = jointLocations[XR_HAND_JOINT_LITTLE_METACARPAL_EXT];
-			proximal = jointLocations[XR_HAND_JOINT_LITTLE_PROXIMAL_EXT];
-			tip = jointLocations[XR_HAND_JOINT_LITTLE_TIP_EXT];
+			metacarpal = joints[XR_HAND_JOINT_LITTLE_METACARPAL_EXT];
+			proximal = joints[XR_HAND_JOINT_LITTLE_PROXIMAL_EXT];
+			tip = joints[XR_HAND_JOINT_LITTLE_TIP_EXT];
 			break;
 		default:
 			break;
@@ -2220,9 +2252,28 @@ EVRInputError BaseInput::getRealSkeletalSummary(ITrackedDevice::TrackedDeviceTyp
 			curl = 1.0f - (ang / std::numbers::pi_v<float>);
 		}
 
-		pSkeletalSummaryData->flFingerCurl[i] = curl;
+		curls[i] = curl;
+	}
+}
+
+EVRInputError BaseInput::getRealSkeletalSummary(ITrackedDevice::TrackedDeviceType hand, VRSkeletalSummaryData_t* pSkeletalSummaryData)
+{
+	std::lock_guard lock(handJointSamplesMutex);
+	HandJointSample* sample = getHandJointSample(hand);
+
+	if (!sample || !sample->isActive) {
+		// Fallback to estimated skeletal summary data (e.g. for controllers)
+		return getEstimatedSkeletalSummary(hand, pSkeletalSummaryData);
 	}
 
+	if (!sample->curlsBuilt) {
+		sample->curlsBuilt = true;
+		buildFingerCurls(sample->locations, sample->fingerCurls);
+	}
+
+	for (int i = 0; i < VRFinger_Count; ++i)
+		pSkeletalSummaryData->flFingerCurl[i] = sample->fingerCurls[i];
+
 	for (int i = 0; i < 4; ++i) {
 		OOVR_LOG_ONCE("Finger splay hardcoded at 0.2");
 		pSkeletalSummaryData->flFingerSplay[i] = 0.2f; // TODO
@@ -2231,6 +2282,78 @@ EVRInputError BaseInput::getRealSkeletalSummary(ITrackedDevice::TrackedDeviceTyp
 	return vr::VRInputError_None;
 }
 
+BaseInput::HandJointSample* BaseInput::getHandJointSample(ITrackedDevice::TrackedDeviceType hand)
+{
+	if (!xr_gbl || !xr_gbl->handTrackingProperties.supportsHandTracking)
+		return nullptr;
+
+	if (hand != ITrackedDevice::HAND_LEFT && hand != ITrackedDevice::HAND_RIGHT)
+		return nullptr;
+
+	XrHandTrackerEXT tracker = handTrackers[hand];
+	if (tracker == XR_NULL_HANDLE)
+		return nullptr;
+
+	HandJointSample& sample = handJointSamples[hand];
+	XrTime time = xr_gbl->GetBestTime();
+	if (sample.time == time)
+		return &sample;
+
+	sample = HandJointSample{};
+
+	XrHandJointsLocateInfoEXT locateInfo = { XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT };
+	locateInfo.baseSpace = xr_gbl->floorSpace;
+	locateInfo.time = time;
+
+	XrHandJointVelocitiesEXT velocities = { XR_TYPE_HAND_JOINT_VELOCITIES_EXT };
+	velocities.jointCount = XR_HAND_JOINT_COUNT_EXT;
+	velocities.jointVelocities = sample.velocities.data();
+
+	XrHandJointLocationsEXT locations = { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
+	locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
+	locations.jointLocations = sample.locations.data();
+	locations.next = &velocities;
+
+	OOVR_FAILED_XR_ABORT(xr_ext->xrLocateHandJointsEXT(tracker, &locateInfo, &locations));
+
+	sample.time = time;
+	sample.isActive = locations.isActive;
+
+	// Find the grip pose at the same time, so the skeleton can be made relative to it without locating the joints again
+	XrSpace gripSpace = legacyControllers[hand].gripPoseSpace;
+	if (sample.isActive && gripSpace != XR_NULL_HANDLE)
+		OOVR_FAILED_XR_SOFT_ABORT(xrLocateSpace(gripSpace, xr_gbl->floorSpace, time, &sample.gripLocation));
+
+	return &sample;
+}
+
+void BaseInput::invalidateHandJointSamples()
+{
+	std::lock_guard lock(handJointSamplesMutex);
+	for (HandJointSample& sample : handJointSamples)
+		sample = HandJointSample{};
+}
+
+bool BaseInput::GetHandTrackingPose(ITrackedDevice::TrackedDeviceType hand, vr::TrackedDevicePose_t* pose)
+{
+	std::lock_guard lock(handJointSamplesMutex);
+	HandJointSample* sample = getHandJointSample(hand);
+	if (!sample || !sample->isActive)
+		return false;
+
+	XrHandJointVelocitiesEXT velocities = { XR_TYPE_HAND_JOINT_VELOCITIES_EXT };
+	velocities.jointCount = XR_HAND_JOINT_COUNT_EXT;
+	velocities.jointVelocities = sample->velocities.data();
+
+	XrHandJointLocationsEXT locations = { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
+	locations.isActive = sample->isActive;
+	locations.jointCount = XR_HAND_JOINT_COUNT_EXT;
+	locations.jointLocations = sample->locations.data();
+
+	xr_utils::PoseFromHandTracking(pose, locations, velocities, hand == ITrackedDevice::HAND_RIGHT);
+	return true;
+}
+
 EVRInputError BaseInput::GetSkeletalSummaryData(VRActionHandle_t action, VRSkeletalSummaryData_t* pSkeletalSummaryData)
 {
 	return GetSkeletalSummaryData(action, VRSummaryType_FromDevice, pSkeletalSummaryData);
@@ -2271,25 +2394,16 @@ EVRInputError BaseInput::TriggerHapticVibrationAction(VRActionHandle_t action, f
 	// TODO check the subaction stuff works properly
 	XrPath subactionPath = XR_NULL_PATH;
 	if (ulRestrictToDevice != vr::k_ulInvalidInputValueHandle) {
-		std::shared_ptr<ITrackedDevice> dev = ivhToDev(ulRestrictToDevice);
+		ITrackedDevice* dev = ivhToDev(ulRestrictToDevice);
 		if (dev && dev->GetHand() != ITrackedDevice::HAND_NONE) {
 			LegacyControllerActions& ctrl = legacyControllers[dev->GetHand()];
 			subactionPath = ctrl.handPathXr;
 		}
 	}
 
-	XrHapticActionInfo info = { XR_TYPE_HAPTIC_ACTION_INFO };
-	info.action = act->xr;
-	info.subactionPath = subactionPath;
-
-	// TODO implement fStartSecondsFromNow - just assume most games leave it at or very close to zero
-
-	XrHapticVibration vibration = { XR_TYPE_HAPTIC_VIBRATION };
-	vibration.frequency = fFrequency == 0.0f ? XR_FREQUENCY_UNSPECIFIED : fFrequency;
-	vibration.duration = (int)(fDurationSeconds * 1000000000.0f);
-	vibration.amplitude = fAmplitude;
-
-	OOVR_FAILED_XR_ABORT(xrApplyHapticFeedback(xr_session.get(), &info, (XrHapticBaseHeader*)&vibration));
+	// The pulse is sent to the runtime once it's due, when the scheduler is next flushed in InternalUpdate
+	double startTime = BackendManager::GetTimeInSeconds() + std::max(fStartSecondsFromNow, 0.0f);
+	hapticScheduler.Schedule(act->xr, subactionPath, startTime, fDurationSeconds, fFrequency, fAmplitude);
 
 	return VRInputError_None;
 }
@@ -2357,7 +2471,7 @@ EVRInputError BaseInput::GetOriginLocalizedName(VRInputValueHandle_t origin, VR_
 	if (origin == vr::k_ulInvalidInputValueHandle)
 		return vr::VRInputError_InvalidHandle;
 
-	std::shared_ptr<ITrackedDevice> dev = ivhToDev(origin);
+	ITrackedDevice* dev = ivhToDev(origin);
 
 	if (!dev)
 		return VRInputError_InvalidHandle;
@@ -2414,7 +2528,7 @@ EVRInputError BaseInput::GetOriginTrackedDeviceInfo(VRInputValueHandle_t origin,
 	if (origin == vr::k_ulInvalidInputValueHandle)
 		return vr::VRInputError_InvalidHandle;
 
-	std::shared_ptr<ITrackedDevice> dev = ivhToDev(origin);
+	ITrackedDevice* dev = ivhToDev(origin);
 
 	if (!dev)
 		return vr::VRInputError_InvalidHandle;
@@ -2558,10 +2672,13 @@ BaseInput::InputValueHandle* BaseInput::cast_IVH(VRInputValueHandle_t handle)
 	if (handle == vr::k_ulInvalidInputValueHandle)
 		OOVR_ABORT("Called ivhToDev for invalid input value handle");
 
-	return (InputValueHandle*)handle;
+	InputValueHandle* ivh = inputHandleRegistry.LookupItem((RegHandle)handle);
+	if (!ivh)
+		OOVR_ABORTF("Unknown input value handle %llx", (unsigned long long)handle);
+	return ivh;
 }
 
-std::shared_ptr<ITrackedDevice> BaseInput::ivhToDev(VRInputValueHandle_t handle)
+ITrackedDevice* BaseInput::ivhToDev(VRInputValueHandle_t handle)
 {
 	const InputValueHandle* ivh = cast_IVH(handle);
 
@@ -2638,36 +2755,37 @@ VRInputValueHandle_t BaseInput::activeOriginFromSubaction(Action* action, const
 	return handle;
 }
 
-bool BaseInput::GetLegacyControllerState(vr::TrackedDeviceIndex_t controllerDeviceIndex, vr::VRControllerState_t* state)
+BaseInput::LegacyActionStates BaseInput::GetLegacyActionStates(int hand)
 {
-	*state = {};
+	std::lock_guard lock(legacyActionStatesMutex);
+	LegacyActionStates& states = legacyActionStates[hand];
+	if (states.populated && states.syncSerial == syncSerial)
+		return states;
 
-	// FIXME implement packetNum
-	static int i = 0;
-	state->unPacketNum = i++; // Not exactly thread safe
+	states = {};
+	states.populated = true;
+	states.syncSerial = syncSerial;
 
-	// TODO for performance reasons, is it worth grabbing the results once and reusing them until xrSyncActions is called?
+	const LegacyControllerActions& ctrl = legacyControllers[hand];
 
-	int hand = DeviceIndexToHandId(controllerDeviceIndex);
-	if (hand == -1)
-		return false;
-	LegacyControllerActions& ctrl = legacyControllers[hand];
+	auto readBool = [&states](XrAction action) -> bool {
+		if (!action)
+			return false;
 
-	auto bindButton = [state](XrAction action, XrAction touch, int shift) {
 		XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
-		XrActionStateBoolean xs = { XR_TYPE_ACTION_STATE_BOOLEAN };
+		getInfo.action = action;
 
-		if (action) {
-			getInfo.action = action;
-			OOVR_FAILED_XR_ABORT(xrGetActionStateBoolean(xr_session.get(), &getInfo, &xs));
-			state->ulButtonPressed |= (uint64_t)(xs.currentState != 0) << shift;
+		XrActionStateBoolean xs = { XR_TYPE_ACTION_STATE_BOOLEAN };
+		if (XR_FAILED(xrGetActionStateBoolean(xr_session.get(), &getInfo, &xs))) {
+			states.allRead = false;
+			return false;
 		}
+		return xs.currentState;
+	};
 
-		if (touch != XR_NULL_HANDLE) {
-			getInfo.action = touch;
-			OOVR_FAILED_XR_ABORT(xrGetActionStateBoolean(xr_session.get(), &getInfo, &xs));
-			state->ulButtonTouched |= (uint64_t)(xs.currentState != 0) << shift;
-		}
+	auto bindButton = [&](XrAction action, XrAction touch, int shift) {
+		states.buttonsPressed |= (uint64_t)readBool(action) << shift;
+		states.buttonsTouched |= (uint64_t)readBool(touch) << shift;
 	};
 
 	// Read the buttons
@@ -2682,7 +2800,7 @@ bool BaseInput::GetLegacyControllerState(vr::TrackedDeviceIndex_t controllerDevi
 	bindButton(XR_NULL_HANDLE, XR_NULL_HANDLE, vr::k_EButton_Axis2); // FIXME clean up? Is this the grip?
 
 	// Read the analogue values
-	auto readFloat = [](XrAction action) -> float {
+	auto readFloat = [&states](XrAction action) -> float {
 		if (!action)
 			return 0;
 
@@ -2690,24 +2808,50 @@ bool BaseInput::GetLegacyControllerState(vr::TrackedDeviceIndex_t controllerDevi
 		getInfo.action = action;
 
 		XrActionStateFloat as = { XR_TYPE_ACTION_STATE_FLOAT };
-		OOVR_FAILED_XR_ABORT(xrGetActionStateFloat(xr_session.get(), &getInfo, &as));
-		if (as.isActive) {
-			return as.currentState;
-		} else {
+		if (XR_FAILED(xrGetActionStateFloat(xr_session.get(), &getInfo, &as))) {
+			states.allRead = false;
 			return 0;
 		}
+		return as.isActive ? as.currentState : 0;
 	};
 
+	states.stickX = readFloat(ctrl.stickX);
+	states.stickY = readFloat(ctrl.stickY);
+	states.trigger = readFloat(ctrl.trigger);
+	states.grip = readFloat(ctrl.grip);
+
+	if (!states.allRead)
+		OOVR_LOG_ONCE("WARNING: couldn't read some of the legacy input actions");
+
+	return states;
+}
+
+bool BaseInput::GetLegacyControllerState(vr::TrackedDeviceIndex_t controllerDeviceIndex, vr::VRControllerState_t* state)
+{
+	*state = {};
+
+	// FIXME implement packetNum
+	static int i = 0;
+	state->unPacketNum = i++; // Not exactly thread safe
+
+	int hand = DeviceIndexToHandId(controllerDeviceIndex);
+	if (hand == -1)
+		return false;
+
+	LegacyActionStates actions = GetLegacyActionStates(hand);
+	state->ulButtonPressed = actions.buttonsPressed;
+	state->ulButtonTouched = actions.buttonsTouched;
+
 	VRControllerAxis_t& thumbstick = state->rAxis[0];
-	thumbstick.x = readFloat(ctrl.stickX);
-	thumbstick.y = readFloat(ctrl.stickY);
+	thumbstick.x = actions.stickX;
+	thumbstick.y = actions.stickY;
 
 	VRControllerAxis_t& trigger = state->rAxis[1];
-	trigger.x = readFloat(ctrl.trigger);
+	trigger.x = actions.trigger;
 	trigger.y = 0;
 
 	VRControllerAxis_t& grip = state->rAxis[2];
-	grip.x = readFloat(ctrl.grip);
+	grip.x = actions.grip;
 	grip.y = 0;
 
 	// SteamVR seemingly writes to these two axis to represent finger curl on legacy input.
@@ -2741,20 +2885,13 @@ void BaseInput::TriggerLegacyHapticPulse(vr::TrackedDeviceIndex_t controllerDevi
 		return;
 	}
 
-	XrHapticActionInfo info = { XR_TYPE_HAPTIC_ACTION_INFO };
-	info.action = ctrl.haptic;
-
-	XrHapticVibration vibration = { XR_TYPE_HAPTIC_VIBRATION };
-	vibration.frequency = XR_FREQUENCY_UNSPECIFIED;
-	vibration.duration = durationNanos;
-	vibration.amplitude = 1;
-
-	OOVR_FAILED_XR_ABORT(xrApplyHapticFeedback(xr_session.get(), &info, (XrHapticBaseHeader*)&vibration));
+	// Games often call this every frame, so let the scheduler merge them into one vibration per frame
+	hapticScheduler.Schedule(ctrl.haptic, XR_NULL_PATH, BackendManager::GetTimeInSeconds(), durationNanos / 1000000000.0, 0.0f, 1.0f);
 }
 
 int BaseInput::DeviceIndexToHandId(vr::TrackedDeviceIndex_t idx)
 {
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(idx);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(idx);
 	if (!dev)
 		return -1;
 
@@ -2778,7 +2915,7 @@ void BaseInput::GetHandSpace(vr::TrackedDeviceIndex_t index, XrSpace& space, boo
 	if (!hasLoadedActions)
 		return;
 
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(index);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(index);
 	if (!dev)
 		return;
 
@@ -2793,6 +2930,62 @@ void BaseInput::GetHandSpace(ITrackedDevice::TrackedDeviceType hand, XrSpace& sp
 	space = aimPose ? ctrl.aimPoseSpace : ctrl.gripPoseSpace;
 }
 
+bool BaseInput::GetPointerState(ITrackedDevice::TrackedDeviceType hand, XrSpace space, PointerState& state)
+{
+	if (!hasLoadedActions || (hand != ITrackedDevice::HAND_LEFT && hand != ITrackedDevice::HAND_RIGHT))
+		return false;
+
+	LegacyControllerActions& ctrl = legacyControllers[hand];
+	if (!ctrl.aimPoseSpace)
+		return false;
+
+	XrSpaceLocation location = { XR_TYPE_SPACE_LOCATION };
+	OOVR_FAILED_XR_SOFT_ABORT(xrLocateSpace(ctrl.aimPoseSpace, space, xr_gbl->GetBestTime(), &location));
+
+	XrSpaceLocationFlags required = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+	if ((location.locationFlags & required) != required)
+		return false;
+
+	auto readBool = [](XrAction action) -> bool {
+		if (!action)
+			return false;
+
+		XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+		getInfo.action = action;
+
+		XrActionStateBoolean bs = { XR_TYPE_ACTION_STATE_BOOLEAN };
+		OOVR_FAILED_XR_ABORT(xrGetActionStateBoolean(xr_session.get(), &getInfo, &bs));
+		return bs.isActive && bs.currentState;
+	};
+
+	auto readFloat = [](XrAction action) -> float {
+		if (!action)
+			return 0;
+
+		XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+		getInfo.action = action;
+
+		XrActionStateFloat as = { XR_TYPE_ACTION_STATE_FLOAT };
+		OOVR_FAILED_XR_ABORT(xrGetActionStateFloat(xr_session.get(), &getInfo, &as));
+		return as.isActive ? as.currentState : 0;
+	};
+
+	state.pose = location.pose;
+	state.trigger = readBool(ctrl.triggerClick);
+
+	state.padX = readFloat(ctrl.stickX);
+	state.padY = readFloat(ctrl.stickY);
+	if (state.padX == 0 && state.padY == 0) {
+		state.padX = readFloat(ctrl.trackpadX);
+		state.padY = readFloat(ctrl.trackpadY);
+	}
+
+	state.padTouched = readBool(ctrl.stickBtnTouch) || readBool(ctrl.trackpadTouch);
+	state.padPressed = readBool(ctrl.stickBtn);
+
+	return true;
+}
+
 bool BaseInput::AreActionsLoaded()
 {
 	return hasLoadedActions;
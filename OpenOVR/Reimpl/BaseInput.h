@@ -4,18 +4,30 @@
 // FIXME don't do that, it's ugly and slows down the build when modifying headers
 
 #include "Drivers/Backend.h"
+#include <array>
+#include <chrono>
+#include <deque>
+#include <mutex>
 #include <numbers>
 #include <span>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "Misc/Input/BindingCache.h"
+#include "Misc/Input/HandSkeleton.h"
+#include "Misc/Input/HapticScheduler.h"
 #include "Misc/Input/InputData.h"
 #include "Misc/Input/InteractionProfile.h"
 #include "Misc/Input/LegacyControllerActions.h"
 #include "generated/interfaces/vrannotation.h"
 
+namespace Json {
+class Value;
+}
+
 typedef std::array<vr::VRBoneTransform_t, 31> BoneArray;
+typedef std::array<XrHandJointLocationEXT, XR_HAND_JOINT_COUNT_EXT> HandJointArray;
 typedef vr::EVRSkeletalTrackingLevel OOVR_EVRSkeletalTrackingLevel;
 
 enum OOVR_EVRSkeletalReferencePose {
@@ -25,15 +37,6 @@ enum OOVR_EVRSkeletalReferencePose {
 	VRSkeletalReferencePose_GripLimit
 };
 
-enum OOVR_EVRFinger {
-	VRFinger_Thumb = 0,
-	VRFinger_Index,
-	VRFinger_Middle,
-	VRFinger_Ring,
-	VRFinger_Pinky,
-	VRFinger_Count
-};
-
 enum OOVR_EVRFingerSplay {
 	VRFingerSplay_Thumb_Index = 0,
 	VRFingerSplay_Index_Middle,
@@ -69,43 +72,6 @@ enum OOVR_EVRInputFilterCancelType {
 	VRInputFilterCancel_Momentum = 1,
 };
 
-// From https://github.com/ValveSoftware/openvr/wiki/Hand-Skeleton
-// Used as indexes into the skeleton output data
-enum HandSkeletonBone {
-	eBone_Root = 0,
-	eBone_Wrist,
-	eBone_Thumb0,
-	eBone_Thumb1,
-	eBone_Thumb2,
-	eBone_Thumb3,
-	eBone_IndexFinger0,
-	eBone_IndexFinger1,
-	eBone_IndexFinger2,
-	eBone_IndexFinger3,
-	eBone_IndexFinger4,
-	eBone_MiddleFinger0,
-	eBone_MiddleFinger1,
-	eBone_MiddleFinger2,
-	eBone_MiddleFinger3,
-	eBone_MiddleFinger4,
-	eBone_RingFinger0,
-	eBone_RingFinger1,
-	eBone_RingFinger2,
-	eBone_RingFinger3,
-	eBone_RingFinger4,
-	eBone_PinkyFinger0,
-	eBone_PinkyFinger1,
-	eBone_PinkyFinger2,
-	eBone_PinkyFinger3,
-	eBone_PinkyFinger4,
-	eBone_Aux_Thumb,
-	eBone_Aux_IndexFinger,
-	eBone_Aux_MiddleFinger,
-	eBone_Aux_RingFinger,
-	eBone_Aux_PinkyFinger,
-	eBone_Count
-};
-
 struct OOVR_InputSkeletalActionData_t {
 	/** Whether or not this action is currently available to be bound in the active action set */
 	bool bActive;
@@ -207,6 +173,13 @@ public:
 
 	XrHandTrackerEXT handTrackers[2] = { XR_NULL_HANDLE, XR_NULL_HANDLE };
 
+	/**
+	 * Get the pose of a controller derived from hand tracking, for when the controller itself isn't being tracked.
+	 *
+	 * Returns false (and leaves the pose untouched) if the hand isn't currently being tracked.
+	 */
+	bool GetHandTrackingPose(ITrackedDevice::TrackedDeviceType hand, vr::TrackedDevicePose_t* pose);
+
 	// ---------------  Handle management   --------------- //
 
 	/** Sets the path to the action manifest JSON file that is used by this application. If this information
@@ -404,6 +377,25 @@ public: // INTERNAL FUNCTIONS
 
 	void GetHandSpace(ITrackedDevice::TrackedDeviceType hand, XrSpace& space, bool aimPose);
 
+	// The state of a controller used to point at OpenComposite's UI or the game's overlays, see GetPointerState
+	struct PointerState {
+		XrPosef pose; // The aim pose
+		bool trigger;
+
+		// The thumbstick, or the trackpad on controllers without one. These are -1 to 1, with +Y being up.
+		float padX, padY;
+		bool padTouched, padPressed;
+	};
+
+	/**
+	 * Get a hand's aim pose in the given space, along with the buttons used for pointing. This is for pointing at
+	 * OpenComposite's own UI, such as the keyboard, and the game's overlays. It reads the legacy input actions
+	 * since they're synced regardless of which input system the game uses.
+	 *
+	 * Returns false if the pose isn't available.
+	 */
+	bool GetPointerState(ITrackedDevice::TrackedDeviceType hand, XrSpace space, PointerState& state);
+
 	bool AreActionsLoaded();
 
 	/**
@@ -581,6 +573,10 @@ private:
 	struct PoseBindingInfo {
 		PoseBindingPoint point = PoseBindingPoint::RAW;
 		ITrackedDevice::TrackedDeviceType hand = ITrackedDevice::HAND_LEFT;
+
+		// The component whose transform is applied to the pose, resolved from point when the binding is loaded.
+		// The raw, body and gdc2015 points don't use a component.
+		ControllerComponentId component = ControllerComponentId::UNKNOWN;
 	};
 
 	struct ActionPerProfileData {
@@ -718,23 +714,24 @@ private:
 	//  handle and that handle must be both unique for that string, and constant across calls with the same
 	//  string supplied.
 	// Additionally, some magic strings that OpenComposite loads are associated with additional data.
-	// These provide an opaque handle for a given string. If that string has an object associated with it then
-	//  it's that pointer (to make debugging easier, since you just cast to inspect the contents) or a dummy
-	//  value of a constant plus some randomisation otherwise.
-	// Handle-to-object lookups are always done through an unsorted map (no pointer cases, just in case the
-	//  memory behind the dummy values are somehow allocated and the performance cost should be very
-	//  small), the handle being the pointer solely for debugging.
+	// Names are case-insensitive, and are interned into a list of slots the first time they're seen. A handle
+	//  is the index of it's name's slot, tagged with the kind of registry (so an action set handle can't be
+	//  used as an action handle) and a generation number unique to each registry instance (so handles left
+	//  over from a previous VR_Init aren't accepted). Thus handle-to-object lookups are just a range check and
+	//  an array access, with no hashing involved.
+	// Names keep their slot when the items are reset, since handles must stay valid across manifest loads.
 	template <typename T>
 	class Registry {
 	public:
-		Registry(uint32_t _maxNameSize);
+		Registry(uint16_t _tag, uint32_t _maxNameSize);
 		~Registry() = default;
 
 		T* LookupItem(const std::string& name) const;
 		T* LookupItem(RegHandle handle) const;
 		RegHandle LookupHandle(const std::string& name);
-		T* Initialise(const std::string& name, std::unique_ptr<T> value);
-		std::vector<std::unique_ptr<T>>& GetItems() { return storage; }
+		// Create the item for a name, which the caller then fills in
+		T* Initialise(const std::string& name);
+		std::deque<T>& GetItems() { return storage; }
 
 		// Function for shortening or looking up a shortened version of a name (if it exists)
 		// Necessary because OpenXR has defined limits on name lengths, while OpenVR appears to have no such limits
@@ -742,22 +739,29 @@ private:
 		void Reset();
 
 	private:
-		// A map of names to handles, used in the common case of not-the-first call
-		std::unordered_map<std::string, RegHandle> handlesByName;
+		struct Slot {
+			// The interned (lower-case) name
+			std::string name;
+
+			// The item associated with this name, or null if there isn't one
+			T* item = nullptr;
+		};
 
-		// Reverse-lookup for debugging
-		std::unordered_map<RegHandle, std::string> namesByHandle;
+		// Find or create the slot for an already-lower-case name, returning it's index
+		uint32_t InternName(const std::string& lowerName);
 
-		// Handles to their associated item, or nothing
-		std::unordered_map<RegHandle, T*> itemsByHandle;
+		RegHandle MakeHandle(uint32_t index) const;
 
-		// Also for bonus performance, name to handle directly. Access time is more
-		// important than memory usage here, as there won't be many actual items (maybe
-		// single-digit thousands at most).
-		std::unordered_map<std::string, T*> itemsByName;
+		// Interned names to the index of their slot, used in the common case of not-the-first call
+		std::unordered_map<std::string, uint32_t> slotsByName;
 
-		// The storage for all the actual items
-		std::vector<std::unique_ptr<T>> storage;
+		// All the names we've seen, indexed by handle
+		std::vector<Slot> slots;
+
+		// The storage for all the actual items. A deque keeps them in a few contiguous blocks rather than one
+		// allocation each, while still never moving them - actions are referenced by pointer all over the input
+		// code (dpad parents, action->set and so on), and the registry grows during manifest loading.
+		std::deque<T> storage;
 
 		// A map for names that are too long.
 		// For actions, these are names longer than XR_MAX_ACTION_NAME_SIZE
@@ -766,6 +770,9 @@ private:
 
 		// The maximum name size. Does not include the null terminator.
 		const uint32_t maxNameSize;
+
+		// The top 32 bits of all this registry's handles, made from it's tag and generation
+		const RegHandle handlePrefix;
 	};
 
 	// See GetSyncSerial
@@ -786,11 +793,13 @@ private:
 
 	vr::ETrackedControllerRole dominantHand = vr::TrackedControllerRole_RightHand;
 
-	// TODO convert to Registry
-	std::unordered_map<std::string, std::unique_ptr<InputValueHandle>> inputHandleRegistry;
+	Registry<InputValueHandle> inputHandleRegistry;
 
 	std::unordered_map<std::string, XrAction> indexGripExtensionActions;
 
+	// The resolved binding paths for the current action manifest, see SetActionManifestPath
+	BindingCache bindingCache;
+
 	XrActionSet legacyInputsSet = XR_NULL_HANDLE;
 
 	/**
@@ -809,7 +818,11 @@ private:
 
 	std::vector<const InteractionProfile*> handInteractionProfiles;
 
-	void LoadBindingsSet(const InteractionProfile& profile, const std::string& bindingsPath);
+	/**
+	 * Load the bindings from a parsed bindings file into the given profile. The file is parsed by the caller, since
+	 * the same file is often used for several profiles.
+	 */
+	void LoadBindingsSet(const InteractionProfile& profile, const std::string& bindingsPath, const Json::Value& bindingsRoot);
 
 	void LoadDpadAction(const InteractionProfile& profile, const std::string& importBasePath, const std::string& inputName, const std::string& subMode, Action* action, std::vector<XrActionSuggestedBinding>& bindings, bool isKnuckles);
 	void LoadDClickAction(const InteractionProfile& profile, const std::string& importBasePath, Action* action, std::vector<XrActionSuggestedBinding>& bindings);
@@ -823,15 +836,44 @@ private:
 
 	LegacyControllerActions legacyControllers[2] = {};
 
-	static bool XrHandJointsToSkeleton(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform);
+	/**
+	 * The states of one hand's legacy input actions, read once after each xrSyncActions (see syncSerial) and shared
+	 * by everything that reads them until the next one: GetControllerState and the estimated skeleton.
+	 */
+	struct LegacyActionStates {
+		bool populated = false;
+		uint64_t syncSerial = 0;
+
+		// False if any of the actions couldn't be read, in which case their values are left at zero
+		bool allRead = true;
+
+		// Indexed by EVRButtonId, as in VRControllerState_t
+		uint64_t buttonsPressed = 0;
+		uint64_t buttonsTouched = 0;
+
+		// Zero while the action isn't active
+		float stickX = 0;
+		float stickY = 0;
+		float trigger = 0;
+		float grip = 0;
+	};
+	LegacyActionStates legacyActionStates[2];
+	std::mutex legacyActionStatesMutex;
+
+	LegacyActionStates GetLegacyActionStates(int hand);
+
+	// All haptic pulses go through this, so they can be scheduled in the future and merged together
+	HapticScheduler hapticScheduler;
+
+	static bool XrHandJointsToSkeleton(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform);
 	static void ParentSpaceSkeletonToModelSpace(VRBoneTransform_t* joints);
 
 	// Utility functions
 	Action* cast_AH(VRActionHandle_t);
 	ActionSet* cast_ASH(VRActionSetHandle_t);
-	static InputValueHandle* cast_IVH(VRInputValueHandle_t);
-	static std::shared_ptr<ITrackedDevice> ivhToDev(VRInputValueHandle_t handle);
-	static bool checkRestrictToDevice(vr::VRInputValueHandle_t restrict, XrPath subactionPath);
+	InputValueHandle* cast_IVH(VRInputValueHandle_t);
+	ITrackedDevice* ivhToDev(VRInputValueHandle_t handle);
+	bool checkRestrictToDevice(vr::VRInputValueHandle_t restrict, XrPath subactionPath);
 	static ITrackedDevice::TrackedDeviceType ParseAndRemoveHandPrefix(std::string& toModify);
 
 	/**
@@ -860,6 +902,72 @@ private:
 	EVRInputError getEstimatedSkeletalSummary(ITrackedDevice::TrackedDeviceType hand, VRSkeletalSummaryData_t* pSkeletalSummaryData);
 	EVRInputError getEstimatedBoneData(ITrackedDevice::TrackedDeviceType hand, EVRSkeletalTransformSpace transformSpace, EVRSkeletalMotionRange eMotionRange, std::span<VRBoneTransform_t, eBone_Count> boneData);
 
+	/**
+	 * The controller inputs used to pose an estimated skeleton, with the touch inputs smoothed out over time.
+	 *
+	 * This is advanced once per frame (see syncSerialDigital) using the real time elapsed since the last frame, so
+	 * the fingers move at the same speed no matter how often the game asks for the skeleton, and every query in
+	 * the same frame gets the same result.
+	 */
+	struct EstimatedHandState {
+		float triggerPct = 0;
+		float gripPct = 0;
+		float thumbTouchPct = 0;
+		float triggerTouchPct = 0;
+
+		bool initialised = false;
+		uint64_t frameSerial = 0;
+		std::chrono::steady_clock::time_point lastUpdate;
+	};
+	EstimatedHandState estimatedHandStates[2];
+	std::mutex estimatedHandStatesMutex;
+
+	EstimatedHandState getEstimatedHandState(ITrackedDevice::TrackedDeviceType hand);
+
+	/**
+	 * The hand joints located for one hand, shared by everything that reads hand tracking data.
+	 *
+	 * The joints are located once per frame (in floor space, along with their velocities) and the controller pose,
+	 * skeleton, summary and tracking level are all derived from that, rather than each asking the runtime separately.
+	 * This matters for games which fetch the skeleton for several motion ranges and transform spaces each frame.
+	 *
+	 * The skeleton and finger curls are built lazily, the first time they're requested for a given sample.
+	 */
+	struct HandJointSample {
+		XrTime time = 0;
+		bool isActive = false;
+		HandJointArray locations = {};
+		std::array<XrHandJointVelocityEXT, XR_HAND_JOINT_COUNT_EXT> velocities = {};
+
+		// The OpenXR grip pose in floor space at the same time, used to make the skeleton relative to the controller
+		XrSpaceLocation gripLocation = { XR_TYPE_SPACE_LOCATION };
+
+		bool skeletonBuilt = false;
+		bool skeletonValid = false;
+		bool skeletonFakeWrist = false;
+		const InteractionProfile* skeletonProfile = nullptr;
+		BoneArray parentSpaceSkeleton = {};
+		BoneArray modelSpaceSkeleton = {};
+
+		bool curlsBuilt = false;
+		float fingerCurls[VRFinger_Count] = {};
+	};
+	HandJointSample handJointSamples[2];
+	std::mutex handJointSamplesMutex;
+
+	/**
+	 * Get the joint sample for the current frame, locating the hand's joints if they haven't yet been located this
+	 * frame. Returns nullptr if hand tracking isn't available for this hand.
+	 *
+	 * handJointSamplesMutex must be held while calling this and for as long as the result is used.
+	 */
+	HandJointSample* getHandJointSample(ITrackedDevice::TrackedDeviceType hand);
+
+	/**
+	 * Throw away any joint samples, so the joints are located again the next time they're used.
+	 */
+	void invalidateHandJointSamples();
+
 	/**
 	 * Some games (i.e. newer Unity games) won't explicitly call SetActionManifestPath, but instead will set the path through
 	 * the Steamworks web interface. If this is the case, we'll never be able to set the actions! So instead, we must discover if this is the case.
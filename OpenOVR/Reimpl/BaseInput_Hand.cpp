@@ -18,7 +18,6 @@
 
 #include <chrono>
 #include <optional>
-#include <ranges>
 
 // Think of this file as just a part of BaseInput.cpp.
 // It's split out in pursuit of lower compile times.
@@ -49,65 +48,11 @@ static glm::quat ApplyBoneHandTransform(glm::quat quat, bool isRight)
 	return quat;
 }
 
-// https://github.com/ValveSoftware/openvr/blob/master/samples/drivers/utils/vrmath/vrmath.h
-static HmdQuaternionf_t operator*(const vr::HmdQuaternionf_t& lhs, const vr::HmdQuaternionf_t& rhs)
-{
-	return {
-		lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
-		lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
-		lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
-		lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
-	};
-}
-
-static HmdVector4_t operator+(const HmdVector4_t& a, const HmdVector4_t& b)
-{
-	return {
-		a.v[0] + b.v[0],
-		a.v[1] + b.v[1],
-		a.v[2] + b.v[2],
-		a.v[3] + 1.f // SteamVR seems to accumulate this? Might not be needed
-	};
-}
-
-static HmdQuaternionf_t operator-( const HmdQuaternionf_t &q )
-{
-	return { q.w, -q.x, -q.y, -q.z };
-}
-
-static HmdVector4_t operator*( const HmdVector4_t &vec, const HmdQuaternionf_t &q )
-{
-	const HmdQuaternionf_t qvec = { 0.0, vec.v[ 0 ], vec.v[ 1 ], vec.v[ 2 ] };
-
-	const HmdQuaternionf_t qResult = (q * qvec) * (-q);
-
-	return { static_cast< float >( qResult.x ), static_cast< float >( qResult.y ), static_cast< float >( qResult.z ), static_cast< float >(vec.v[3]) };
-}
-
-static VRBoneTransform_t operator*(const VRBoneTransform_t& a, const VRBoneTransform_t& b)
-{
-	return {
-		a.position + (b.position * a.orientation),
-		a.orientation * b.orientation,
-	};
-}
-
 static bool isBoneMetacarpal(XrHandJointEXT handJoint)
 {
 	return handJoint == XR_HAND_JOINT_THUMB_METACARPAL_EXT || handJoint == XR_HAND_JOINT_INDEX_METACARPAL_EXT || handJoint == XR_HAND_JOINT_MIDDLE_METACARPAL_EXT || handJoint == XR_HAND_JOINT_RING_METACARPAL_EXT || handJoint == XR_HAND_JOINT_LITTLE_METACARPAL_EXT;
 }
 
-// converts a range of finger bones to model space.
-static void convertJointRange(HandSkeletonBone start, HandSkeletonBone end, VRBoneTransform_t* joints)
-{
-	HandSkeletonBone parentId = eBone_Wrist;
-
-	for (int i = start; i <= end; i++) {
-		joints[i] = joints[parentId] * joints[i];
-		parentId = (HandSkeletonBone)i;
-	}
-}
-
 static std::map<HandSkeletonBone, XrHandJointEXT> auxBoneMap = {
 	{ eBone_Aux_Thumb, XR_HAND_JOINT_THUMB_DISTAL_EXT },
 	{ eBone_Aux_IndexFinger, XR_HAND_JOINT_INDEX_DISTAL_EXT },
@@ -124,7 +69,7 @@ constexpr XrHandJointEXT metacarpalJoints[5] = {
 	XR_HAND_JOINT_LITTLE_METACARPAL_EXT
 };
 
-static bool ConvertWristPose(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform)
+static bool ConvertWristPose(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform)
 {
 	const XrHandJointLocationEXT& wrist = joints[XR_HAND_JOINT_WRIST_EXT];
 
@@ -193,7 +138,7 @@ static bool GetJointRelative(const XrHandJointLocationEXT& currentJoint, const X
 	return true;
 }
 
-static bool MetacarpalJointPass(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output)
+static bool MetacarpalJointPass(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output)
 {
 	for (int joint : metacarpalJoints) {
 
@@ -232,7 +177,7 @@ static bool MetacarpalJointPass(const std::vector<XrHandJointLocationEXT>& joint
 	return true;
 }
 
-static bool FlexionJointPass(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output)
+static bool FlexionJointPass(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output)
 {
 	int parentId = -1;
 
@@ -257,7 +202,7 @@ static bool FlexionJointPass(const std::vector<XrHandJointLocationEXT>& joints,
 	return true;
 }
 
-static bool AuxJointPass(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output)
+static bool AuxJointPass(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output)
 {
 	XrHandJointLocationEXT currentJoint;
 	for (int i = eBone_Aux_Thumb; i <= eBone_Aux_PinkyFinger; i++) {
@@ -273,120 +218,64 @@ static bool AuxJointPass(const std::vector<XrHandJointLocationEXT>& joints, bool
 	return true;
 }
 
-static void InterpolateBone(VRBoneTransform_t& bone, const VRBoneTransform_t& targetBone, float pct)
+BaseInput::EstimatedHandState BaseInput::getEstimatedHandState(ITrackedDevice::TrackedDeviceType hand)
 {
-	glm::vec3 startPos(bone.position.v[0], bone.position.v[1], bone.position.v[2]);
-	glm::quat startRot(bone.orientation.w, bone.orientation.x, bone.orientation.y, bone.orientation.z);
-
-	glm::vec3 targetPos(targetBone.position.v[0], targetBone.position.v[1], targetBone.position.v[2]);
-	glm::quat targetRot(targetBone.orientation.w, targetBone.orientation.x, targetBone.orientation.y, targetBone.orientation.z);
-
-	glm::vec3 resPos = glm::mix(startPos, targetPos, pct);
-	glm::quat resRot;
-	resRot = glm::mix(startRot, targetRot, pct);
+	std::lock_guard lock(estimatedHandStatesMutex);
+	EstimatedHandState& output = estimatedHandStates[hand];
 
-	bone.position = { resPos.x, resPos.y, resPos.z, 1.f };
-	bone.orientation = { resRot.w, resRot.x, resRot.y, resRot.z };
-}
-
-static auto GetInterpolatedControllerState(const ITrackedDevice::TrackedDeviceType hand, const LegacyControllerActions controller) {
-	struct ControllerState {
-		float triggerPct;
-		float gripPct;
-		float thumbTouchPct;
-		float triggerTouchPct;
-	} output;
-
-	XrActionStateGetInfo info{
-		.type = XR_TYPE_ACTION_STATE_GET_INFO,
-		.action = controller.trigger,
-		.subactionPath = XR_NULL_PATH,
-	};
+	// Only advance once per frame, so querying this several times in a frame gives the same result each time
+	if (output.initialised && output.frameSerial == syncSerialDigital)
+		return output;
 
-	XrActionStateFloat state{ XR_TYPE_ACTION_STATE_FLOAT };
-	XrActionStateBoolean stateBool{ XR_TYPE_ACTION_STATE_BOOLEAN };
+	// Share the action states GetControllerState already read this sync, rather than querying the runtime again
+	const LegacyActionStates actions = GetLegacyActionStates(hand);
 
 	constexpr float simulateCurlThreshold = 0.08f;
 
-	// Trigger State
-	XrResult actionRes = xrGetActionStateFloat(xr_session.get(), &info, &state);
-	output.triggerPct = 0.0f;
-	if (XR_SUCCEEDED(actionRes) && state.currentState >= simulateCurlThreshold) {
-		output.triggerPct = state.currentState;
-	} else if (XR_FAILED(actionRes)) {
-		OOVR_LOGF("WARNING: couldn't get trigger percentage (%d)", actionRes);
-	}
+	// Trigger and grip state
+	output.triggerPct = actions.trigger >= simulateCurlThreshold ? actions.trigger : 0.0f;
+	output.gripPct = actions.grip >= simulateCurlThreshold ? actions.grip : 0.0f;
 
-	// Grip State
-	info.action = controller.grip;
-	actionRes = xrGetActionStateFloat(xr_session.get(), &info, &state);
-	output.gripPct = 0.0f;
-	if (XR_SUCCEEDED(actionRes) && state.currentState >= simulateCurlThreshold) {
-		output.gripPct = state.currentState;
-	} else if (XR_FAILED(actionRes)) {
-		OOVR_LOGF("WARNING: couldn't get grip percentage (%d)", actionRes);
-	}
+	auto touched = [&actions](vr::EVRButtonId button) { return (actions.buttonsTouched & vr::ButtonMaskFromId(button)) != 0; };
 
 	// Trigger Touch State
-	info.action = controller.triggerTouch;
-	actionRes = xrGetActionStateBoolean(xr_session.get(), &info, &stateBool);
-	bool triggerTouch = XR_SUCCEEDED(actionRes) && stateBool.currentState;
+	bool triggerTouch = touched(vr::k_EButton_SteamVR_Trigger);
 
 	// Force touch to true when trigger is being pressed
 	if (output.triggerPct != 0.0f)
 		triggerTouch = true;
 
-
-	bool hasThumbInput = false;
-	bool thumbTouch = false;
-
 	// Put thumb down on any relevant touch inputs
-	const XrAction thumbActions[] = {controller.menuTouch, controller.btnATouch, controller.trackpadTouch, controller.stickBtnTouch};
-	for (const auto& action : thumbActions) {
-		info.action = action;
-		actionRes = xrGetActionStateBoolean(xr_session.get(), &info, &stateBool);
-		if (XR_SUCCEEDED(actionRes)) {
-			if (stateBool.currentState) {
-				thumbTouch = true;
-			}
-			hasThumbInput = true;
-		}
-	}
+	bool hasThumbInput = actions.allRead;
+	bool thumbTouch = touched(vr::k_EButton_ApplicationMenu) || touched(vr::k_EButton_A) || touched(vr::k_EButton_SteamVR_Touchpad);
 
 	// Allow for straightening the thumb on controllers with no touch inputs
 	if (!hasThumbInput) {
 		thumbTouch = output.gripPct != 1.0f || output.triggerPct == 1.0f;
 	}
 
-	static std::array<std::chrono::high_resolution_clock::time_point, 2> lastTime{
-		std::chrono::high_resolution_clock::now(),
-		std::chrono::high_resolution_clock::now()
-	};
-
-	// Calculate per-hand deltaTime for binary input interpolation
-	auto currentTime = std::chrono::high_resolution_clock::now();
-	std::chrono::duration<float> deltaTimeDuration = currentTime - lastTime[hand];
-	float deltaTime = deltaTimeDuration.count();
-	lastTime[hand] = currentTime;
+	// Calculate how long it's been since the last frame, so the fingers move at the same speed regardless of frame rate.
+	// The first time round there's nothing to interpolate from, so start from the open hand.
+	auto currentTime = std::chrono::steady_clock::now();
+	float deltaTime = 0.0f;
+	if (output.initialised)
+		deltaTime = std::chrono::duration<float>(currentTime - output.lastUpdate).count();
 
-	// Interpolated states
-	static std::array<float, 2> thumbTouchPcts = {0.0f, 0.0f};
-	static std::array<float, 2> triggerTouchPcts = {0.0f, 0.0f};
+	output.initialised = true;
+	output.frameSerial = syncSerialDigital;
+	output.lastUpdate = currentTime;
 
 	constexpr float touchTransitionSpeed = 8.0f;
 
 	// Update interpolated values
-	thumbTouchPcts[hand] = glm::clamp(thumbTouchPcts[hand] + (thumbTouch ? deltaTime * touchTransitionSpeed : -deltaTime * touchTransitionSpeed), 0.0f, 1.0f);
-	triggerTouchPcts[hand] = glm::clamp(triggerTouchPcts[hand] + (triggerTouch ? deltaTime * touchTransitionSpeed : -deltaTime * touchTransitionSpeed), 0.0f, 1.0f);
-
-	output.thumbTouchPct = thumbTouchPcts[hand];
-	output.triggerTouchPct = triggerTouchPcts[hand];
+	output.thumbTouchPct = glm::clamp(output.thumbTouchPct + (thumbTouch ? deltaTime * touchTransitionSpeed : -deltaTime * touchTransitionSpeed), 0.0f, 1.0f);
+	output.triggerTouchPct = glm::clamp(output.triggerTouchPct + (triggerTouch ? deltaTime * touchTransitionSpeed : -deltaTime * touchTransitionSpeed), 0.0f, 1.0f);
 
 	return output;
 }
 
 // OpenXR Hand Joints to OpenVR Hand Skeleton logic generously donated by danwillm from valve.
-bool BaseInput::XrHandJointsToSkeleton(const std::vector<XrHandJointLocationEXT>& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform)
+bool BaseInput::XrHandJointsToSkeleton(const HandJointArray& joints, bool isRight, VRBoneTransform_t* output, glm::mat4 transform)
 {
 	// The root bone should just be left at identity
 	output[eBone_Root].orientation = vr::HmdQuaternionf_t{ /* w */ 1, 0, 0, 0 };
@@ -416,11 +305,10 @@ void BaseInput::ParentSpaceSkeletonToModelSpace(VRBoneTransform_t* joints)
 	// for bone 0, we multiply it by the wrist.
 	// for bone 1, we multiply it by the result of 0, etc.
 
-	convertJointRange(eBone_Thumb0, eBone_Thumb3, joints);
-	convertJointRange(eBone_IndexFinger0, eBone_IndexFinger4, joints);
-	convertJointRange(eBone_MiddleFinger0, eBone_MiddleFinger4, joints);
-	convertJointRange(eBone_RingFinger0, eBone_RingFinger4, joints);
-	convertJointRange(eBone_PinkyFinger0, eBone_PinkyFinger4, joints);
+	BoneSoA bones;
+	bones.Load(joints);
+	BonesToModelSpace(bones);
+	bones.Store(joints);
 }
 
 EVRInputError BaseInput::getEstimatedBoneData(
@@ -429,49 +317,14 @@ EVRInputError BaseInput::getEstimatedBoneData(
     EVRSkeletalMotionRange eMotionRange,
     std::span<VRBoneTransform_t, eBone_Count> boneData)
 {
-	auto& controller = legacyControllers[hand];
-
-	auto state = GetInterpolatedControllerState(hand, controller);
-
-	auto boneDataGen = [state](const BoneArray& openPose, const BoneArray& closedPose) {
-		return std::ranges::iota_view(0, static_cast<int>(eBone_Count)) | std::views::transform([=](int bone_index) {
-			auto bone = openPose[bone_index];
-
-			// Put the thumb down on touch
-			if (state.thumbTouchPct != 0.0f) {
-				if ((bone_index >= eBone_Thumb0 && bone_index <= eBone_Thumb3) || bone_index == eBone_Aux_Thumb) 
-					InterpolateBone(bone, closedPose[bone_index], state.thumbTouchPct);
-			}
-
-			// Curl fingers on trigger touch
-			if (state.triggerTouchPct != 0.0f || state.triggerPct != 0.0f) {
-				// SteamVR does something similar, curling adjacent fingers to make them look more natural
-				if ((bone_index >= eBone_IndexFinger0 && bone_index <= eBone_IndexFinger4) || bone_index == eBone_Aux_IndexFinger)
-					InterpolateBone(bone, closedPose[bone_index], 0.4f * state.triggerTouchPct);
-				else if ((bone_index >= eBone_MiddleFinger0 && bone_index <= eBone_MiddleFinger4) || bone_index == eBone_Aux_MiddleFinger)
-					InterpolateBone(bone, closedPose[bone_index], 0.2f * state.triggerTouchPct);
-				else if ((bone_index >= eBone_RingFinger0 && bone_index <= eBone_RingFinger4) || bone_index == eBone_Aux_RingFinger)
-					InterpolateBone(bone, closedPose[bone_index], 0.1f * state.triggerTouchPct);
-			}
-
-			// Bend the index finger on trigger
-			if (state.triggerPct != 0.0f) {
-				if ((bone_index >= eBone_IndexFinger0 && bone_index <= eBone_IndexFinger4) || bone_index == eBone_Aux_IndexFinger)
-					InterpolateBone(bone, closedPose[bone_index], state.triggerPct);
-			}
-
-			// Bend the 3 remaining fingers on grip
-			if (state.gripPct != 0.0f) {
-				if ((bone_index >= eBone_MiddleFinger0 && bone_index <= eBone_PinkyFinger4) || (bone_index >= eBone_Aux_MiddleFinger && bone_index <= eBone_Aux_PinkyFinger))
-					InterpolateBone(bone, closedPose[bone_index], state.gripPct);
-			}
-
-			return bone;
-		});
-	};
+	EstimatedHandState state = getEstimatedHandState(hand);
+
+	// How far each bone is bent from the open pose towards the closed one
+	float boneWeights[eBone_Count];
+	GetEstimatedBoneWeights(state.thumbTouchPct, state.triggerTouchPct, state.triggerPct, state.gripPct, boneWeights);
 
 	// Find the interaction profile to retrieve hand poses
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(hand);
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(hand);
 	if (!dev)
 		return vr::VRInputError_InvalidDevice;
 
@@ -479,8 +332,8 @@ EVRInputError BaseInput::getEstimatedBoneData(
 	if (!profile)
 		return vr::VRInputError_InvalidDevice;
 
-	const std::optional<BoneArray> open = profile->GetSkeletalReferencePose(hand, VRSkeletalReferencePose_OpenHand);
-	if (!open.has_value()) {
+	const BoneArray* open = profile->GetSkeletalReferencePose(hand, VRSkeletalReferencePose_OpenHand);
+	if (!open) {
 		OOVR_LOGF("WARNING: Couldn't find reference pose: %d, %d", hand, VRSkeletalReferencePose_OpenHand);
 		return vr::VRInputError_InvalidSkeleton;
 	}
@@ -489,16 +342,21 @@ EVRInputError BaseInput::getEstimatedBoneData(
 	const EVRSkeletalReferencePose closedPose = eMotionRange == VRSkeletalMotionRange_WithController 
 		? VRSkeletalReferencePose_GripLimit : VRSkeletalReferencePose_Fist;
 
-	const std::optional<BoneArray> closed = profile->GetSkeletalReferencePose(hand, closedPose);
-	if (!closed.has_value()) {
+	const BoneArray* closed = profile->GetSkeletalReferencePose(hand, closedPose);
+	if (!closed) {
 		OOVR_LOGF("WARNING: Couldn't find reference pose: %d, %d", hand, closedPose);
 		return vr::VRInputError_InvalidSkeleton;
 	}
 
-	std::ranges::copy(boneDataGen(open.value(), closed.value()), boneData.begin());
+	BoneSoA openBones, closedBones, bones;
+	openBones.Load(open->data());
+	closedBones.Load(closed->data());
+	BlendBones(bones, openBones, closedBones, boneWeights);
 
 	if (transformSpace == EVRSkeletalTransformSpace::VRSkeletalTransformSpace_Model)
-		ParentSpaceSkeletonToModelSpace(boneData.data());
+		BonesToModelSpace(bones);
+
+	bones.Store(boneData.data());
 
 	return vr::VRInputError_None;
 }
@@ -509,9 +367,7 @@ EVRInputError BaseInput::getEstimatedSkeletalSummary(ITrackedDevice::TrackedDevi
 
 	std::fill(std::begin(pSkeletalSummaryData->flFingerSplay), std::end(pSkeletalSummaryData->flFingerSplay), 0.2f);
 
-	LegacyControllerActions& controller = legacyControllers[hand];
-
-	auto state = GetInterpolatedControllerState(hand, controller);
+	EstimatedHandState state = getEstimatedHandState(hand);
 
 	// Replicate what getEstimatedBoneData is doing
 
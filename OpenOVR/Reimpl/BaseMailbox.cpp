@@ -4,55 +4,148 @@
 
 #include "BaseMailbox.h"
 
+#include <cstring>
+
 typedef BaseMailbox::MboxErr MboxErr;
 
 MboxErr BaseMailbox::RegisterMailbox(const char* name, OOVR_mbox_handle* handle)
 {
-	*handle = 123;
+	if (!name)
+		name = "";
+
+	std::unique_lock lock(mailboxesMutex);
+
+	for (const auto& [existingHandle, mailbox] : mailboxes) {
+		if (mailbox->name == name) {
+			*handle = existingHandle;
+			return VR_MBox_None;
+		}
+	}
+
+	auto mailbox = std::make_shared<Mailbox>();
+	mailbox->name = name;
 
-	// Ignore it for now
-	OOVR_LOGF("Pretending to register mailbox '%s'", name);
+	// HL:A waits for this before it starts
+	mailbox->messages.push_back(R"({ "type": "ready", })");
 
+	*handle = nextHandle++;
+	mailboxes[*handle] = mailbox;
+
+	OOVR_LOGF("Registered mailbox '%s' as %d", name, (int)*handle);
 	return VR_MBox_None;
 }
 
 MboxErr BaseMailbox::UnregisterMailbox(OOVR_mbox_handle mbox)
 {
-	OOVR_LOGF("Pretending to unregister mailbox ID %d", (int)mbox);
+	std::unique_lock lock(mailboxesMutex);
+
+	auto iter = mailboxes.find(mbox);
+	if (iter == mailboxes.end()) {
+		OOVR_LOGF("Tried to unregister unknown mailbox %d", (int)mbox);
+		return VR_MBox_None;
+	}
+
+	OOVR_LOGF("Unregistered mailbox '%s'", iter->second->name.c_str());
+	mailboxes.erase(iter);
 	return VR_MBox_None;
 }
 
-MboxErr BaseMailbox::SendMessage(OOVR_mbox_handle mbox, const char* type, const char* message)
+std::shared_ptr<BaseMailbox::Mailbox> BaseMailbox::GetMailbox(OOVR_mbox_handle handle)
 {
-	OOVR_LOGF("Pretending to send mailbox message, type '%s' contents '%s'", type, message);
-	return VR_MBox_None;
+	std::shared_lock lock(mailboxesMutex);
+
+	auto iter = mailboxes.find(handle);
+	if (iter == mailboxes.end())
+		return nullptr;
+	return iter->second;
 }
 
-MboxErr BaseMailbox::ReadMessage(OOVR_mbox_handle mboxHandle, char* outBuf, uint32_t outBufLen, uint32_t* msgLen)
+std::shared_ptr<BaseMailbox::Mailbox> BaseMailbox::FindMailbox(const char* name)
 {
-	// Read message function
-	// If we have a message available (IDK what the mailbox is even supposed to do), try to read a message.
-	// If the message fits within the output buffer, copy it in and return 0.
-	// Otherwise if it doesn't fit, return 2.
-	// In both cases, set msgLen
-	// If we don't have a message, return an unknown error code other than 0 and 2 (HL:A doesn't care).
-
-	static bool recvdReadyMsg = false;
-	if (!recvdReadyMsg) {
-		recvdReadyMsg = true;
-
-		const std::string msg = R"({ "type": "ready", })";
-		*msgLen = msg.size();
+	std::shared_lock lock(mailboxesMutex);
 
-		if (outBufLen < msg.size() + 1) {
-			return VR_MBox_BufferTooShort;
+	for (const auto& [handle, mailbox] : mailboxes) {
+		if (mailbox->name == name)
+			return mailbox;
+	}
+	return nullptr;
+}
+
+MboxErr BaseMailbox::SendMessage(OOVR_mbox_handle mbox, const char* address, const char* message)
+{
+	if (!address)
+		address = "";
+	if (!message)
+		message = "";
+
+	std::shared_ptr<Mailbox> sender = GetMailbox(mbox);
+	if (!sender) {
+		OOVR_LOG_ONCEF("Sending message to '%s' from unknown mailbox %d", address, (int)mbox);
+		return VR_MBox_None;
+	}
+
+	// Messages are only ever delivered to another mailbox: HL:A reads its own mailbox every frame, and would see
+	// everything it sends if they were queued back up for it.
+	std::shared_ptr<Mailbox> target = FindMailbox(address);
+	if (!target || target == sender) {
+		std::lock_guard lock(sender->mutex);
+
+		auto now = std::chrono::steady_clock::now();
+		if (now - sender->lastLogTime < std::chrono::seconds(1)) {
+			sender->unloggedMessages++;
+			return VR_MBox_None;
 		}
-		strcpy(outBuf, msg.c_str());
 
-		OOVR_LOGF("Sending fake ready message '%s'", msg.c_str());
+		OOVR_LOGF("Mailbox '%s' sent message to '%s' which has no other mailbox to receive it, dropping: '%s' (plus %d unlogged)",
+		    sender->name.c_str(), address, message, sender->unloggedMessages);
+		sender->lastLogTime = now;
+		sender->unloggedMessages = 0;
 		return VR_MBox_None;
 	}
 
-	// For now, just say we don't have a message
-	return VR_MBox_NoMessage;
+	std::lock_guard lock(target->mutex);
+
+	if (target->messages.size() >= MAX_QUEUED_MESSAGES) {
+		target->messages.pop_front();
+		target->droppedMessages++;
+	}
+	target->messages.emplace_back(message);
+
+	auto now = std::chrono::steady_clock::now();
+	if (now - target->lastLogTime < std::chrono::seconds(1)) {
+		target->unloggedMessages++;
+		return VR_MBox_None;
+	}
+
+	OOVR_LOGF("Mailbox '%s' received message from '%s' contents '%s' (plus %d unlogged, %d dropped since last logged)",
+	    target->name.c_str(), sender->name.c_str(), message, target->unloggedMessages, target->droppedMessages);
+	target->lastLogTime = now;
+	target->unloggedMessages = 0;
+	target->droppedMessages = 0;
+
+	return VR_MBox_None;
+}
+
+MboxErr BaseMailbox::ReadMessage(OOVR_mbox_handle mboxHandle, char* outBuf, uint32_t outBufLen, uint32_t* msgLen)
+{
+	std::shared_ptr<Mailbox> mailbox = GetMailbox(mboxHandle);
+	if (!mailbox)
+		return VR_MBox_NoMessage;
+
+	std::lock_guard lock(mailbox->mutex);
+
+	if (mailbox->messages.empty())
+		return VR_MBox_NoMessage;
+
+	const std::string& msg = mailbox->messages.front();
+	if (msgLen)
+		*msgLen = msg.size();
+
+	// Leave the message in the queue, so the game can try again with a bigger buffer
+	if (!outBuf || outBufLen < msg.size() + 1)
+		return VR_MBox_BufferTooShort;
+
+	memcpy(outBuf, msg.c_str(), msg.size() + 1);
+	mailbox->messages.pop_front();
+	return VR_MBox_None;
 }
@@ -3,8 +3,24 @@
 #include "../BaseCommon.h"
 #include "custom_interfaces/IVRMailbox_001.h"
 
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
 typedef vr::IVRMailbox_001::mbox_handle OOVR_mbox_handle;
 
+/**
+ * The mailbox is SteamVR's undocumented message-passing interface, used by Half-Life: Alyx to talk to vrmonitor.
+ *
+ * Each mailbox is a named queue of messages. Messages are addressed to a mailbox by name, and are delivered to
+ * whichever mailbox in this process has that name. Since there's no vrmonitor (or any other process) to receive
+ * them, messages addressed to anything else are logged and dropped. The only message we generate ourselves is the
+ * 'ready' message each mailbox receives when it's registered, which is what HL:A waits for.
+ */
 class BaseMailbox {
 public:
 	enum MboxErr {
@@ -15,13 +31,50 @@ public:
 
 	// TODO build up names and comments for these and their types
 
+	/**
+	 * Create a mailbox, or find the existing one if a mailbox with this name has already been registered.
+	 */
 	MboxErr RegisterMailbox(const char* name, OOVR_mbox_handle* handle);
 
 	MboxErr UnregisterMailbox(OOVR_mbox_handle mbox);
 
-	MboxErr SendMessage(OOVR_mbox_handle mbox, const char* type, const char* message);
+	/**
+	 * Send a message from the mailbox mbox to the mailbox named address. If there's no such mailbox (or it's the
+	 * sender's own mailbox) the message is dropped.
+	 */
+	MboxErr SendMessage(OOVR_mbox_handle mbox, const char* address, const char* message);
 
+	/**
+	 * Read the oldest message from a mailbox. msgLen is always set to the length of the message, and if the buffer
+	 * can't fit it (with its null terminator) then VR_MBox_BufferTooShort is returned and the message is left in
+	 * the mailbox, so it can be read again with a bigger buffer.
+	 */
 	MboxErr ReadMessage(OOVR_mbox_handle mbox, char* outBuf, uint32_t outBufLen, uint32_t* msgLen);
+
+private:
+	// If a mailbox isn't being read, drop the oldest messages rather than letting it grow forever
+	static constexpr size_t MAX_QUEUED_MESSAGES = 256;
+
+	struct Mailbox {
+		std::string name;
+
+		std::mutex mutex;
+		std::deque<std::string> messages;
+
+		// Games may send messages every frame, so only log one line a second about them. These are used both for
+		// messages this mailbox receives and for those it sends that are dropped.
+		std::chrono::steady_clock::time_point lastLogTime;
+		uint32_t unloggedMessages = 0;
+		uint32_t droppedMessages = 0;
+	};
+
+	std::shared_ptr<Mailbox> GetMailbox(OOVR_mbox_handle handle);
+	std::shared_ptr<Mailbox> FindMailbox(const char* name);
+
+	// Guards the mailbox table only: each mailbox's queue has its own lock
+	std::shared_mutex mailboxesMutex;
+	std::unordered_map<OOVR_mbox_handle, std::shared_ptr<Mailbox>> mailboxes;
+	OOVR_mbox_handle nextHandle = 1;
 };
 
 typedef BaseMailbox::MboxErr OOVR_vrmb_typeb;
@@ -2,6 +2,7 @@
 #define BASE_IMPL
 #include "../../DrvOpenXR/XrBackend.h"
 #include "BaseCompositor.h"
+#include "BaseInput.h"
 #include "BaseOverlay.h"
 #include "BaseSystem.h"
 #include "Compositor/compositor.h"
@@ -10,6 +11,7 @@
 #include "Misc/ScopeGuard.h"
 #include "convert.h"
 #include "generated/static_bases.gen.h"
+#include <cmath>
 #include <string>
 
 using glm::mat4;
@@ -17,6 +19,13 @@ using glm::vec3;
 
 using namespace vr;
 
+// Drop the oldest events if an overlay isn't polling them, rather than letting the queue grow forever
+static constexpr size_t MAX_QUEUED_EVENTS = 256;
+
+// The rate the thumbstick scrolls at when fully deflected, in scroll steps per second
+static constexpr float SCROLL_SPEED = 10;
+static constexpr float SCROLL_DEADZONE = 0.15f;
+
 // Class to represent an overlay
 class BaseOverlay::OverlayData {
 public:
@@ -30,17 +39,23 @@ public:
 	EColorSpace colourSpace = ColorSpace_Auto;
 	bool visible = false; // TODO check against SteamVR
 	VRTextureBounds_t textureBounds = { 0, 0, 1, 1 };
-	VROverlayInputMethod inputMethod = VROverlayInputMethod_None; // TODO fire events
+	VROverlayInputMethod inputMethod = VROverlayInputMethod_None;
 	HmdVector2_t mouseScale = { 1.0f, 1.0f };
 	bool highQuality = false;
 	uint64_t flags = 0;
 	float texelAspect = 1;
 	std::queue<VREvent_t> eventQueue;
 
+	// Input
+	std::vector<OOVR_VROverlayIntersectionMaskPrimitive_t> intersectionMask; // Empty if the whole overlay can be pointed at
+	HmdVector2_t dualAnalogCenter[2] = {};
+	float dualAnalogRadius[2] = { 1, 1 };
+
 	// Rendering
 	Texture_t texture = {};
 	XrCompositionLayerQuad layerQuad = { XR_TYPE_COMPOSITION_LAYER_QUAD };
 	std::weak_ptr<Compositor> compositor;
+	bool submitted = false; // Set if the overlay was shown this frame, and thus can be pointed at
 
 	// Transform
 	VROverlayTransformType transformType = VROverlayTransform_Absolute;
@@ -62,8 +77,91 @@ public:
 	    : key(key), name(name)
 	{
 	}
+
+	// Add an event to the queue, returning it so the caller can fill in its data
+	VREvent_t& PostEvent(EVREventType type, TrackedDeviceIndex_t device)
+	{
+		while (eventQueue.size() >= MAX_QUEUED_EVENTS)
+			eventQueue.pop();
+
+		VREvent_t evt = {};
+		evt.eventType = type;
+		evt.trackedDeviceIndex = device;
+		eventQueue.push(evt);
+		return eventQueue.back();
+	}
+
+	/**
+	 * Find where a controller's aim ray hits this overlay, in mouse coordinates (scaled by mouseScale, with 0,0 at the
+	 * bottom-left). If bounded is false this finds where the ray hits the overlay's plane even if it misses the overlay
+	 * itself, which is used for dragging the mouse off the edge of an overlay.
+	 *
+	 * This only uses the quad from the last call to _BuildLayers, so it's cheap enough to run on every overlay each frame.
+	 */
+	bool Intersect(const XrPosef& aim, bool bounded, float& distance, HmdVector2_t& mouse) const
+	{
+		if (layerQuad.size.width <= 0 || layerQuad.size.height <= 0)
+			return false;
+
+		// Move the ray into the quad's space, where the quad faces along +Z
+		const XrPosef& pose = layerQuad.pose;
+		XrQuaternionf inverse = { -pose.orientation.x, -pose.orientation.y, -pose.orientation.z, pose.orientation.w };
+		XrVector3f offset = { aim.position.x - pose.position.x, aim.position.y - pose.position.y, aim.position.z - pose.position.z };
+
+		XrVector3f origin, forward, direction;
+		rotate_vector_by_quaternion(offset, inverse, origin);
+		rotate_vector_by_quaternion({ 0, 0, -1 }, aim.orientation, forward);
+		rotate_vector_by_quaternion(forward, inverse, direction);
+
+		if (direction.z == 0)
+			return false;
+
+		distance = -origin.z / direction.z;
+		if (distance <= 0)
+			return false;
+
+		// 0 to 1 across the quad, from the bottom-left
+		float u = (origin.x + direction.x * distance) / layerQuad.size.width + 0.5f;
+		float v = (origin.y + direction.y * distance) / layerQuad.size.height + 0.5f;
+		mouse = { u * mouseScale.v[0], v * mouseScale.v[1] };
+
+		if (!bounded)
+			return true;
+
+		if (u < 0 || u > 1 || v < 0 || v > 1)
+			return false;
+
+		if (intersectionMask.empty())
+			return true;
+
+		// The mask primitives are in mouse units, but measured from the top-left
+		float x = mouse.v[0];
+		float y = mouseScale.v[1] - mouse.v[1];
+		for (const OOVR_VROverlayIntersectionMaskPrimitive_t& primitive : intersectionMask) {
+			if (primitive.m_nPrimitiveType == OverlayIntersectionPrimitiveType_Rectangle) {
+				const OOVR_IntersectionMaskRectangle_t& rect = primitive.m_Primitive.m_Rectangle;
+				if (x >= rect.m_flTopLeftX && x <= rect.m_flTopLeftX + rect.m_flWidth
+				    && y >= rect.m_flTopLeftY && y <= rect.m_flTopLeftY + rect.m_flHeight)
+					return true;
+			} else if (primitive.m_nPrimitiveType == OverlayIntersectionPrimitiveType_Circle) {
+				const OOVR_IntersectionMaskCircle_t& circle = primitive.m_Primitive.m_Circle;
+				float dx = x - circle.m_flCenterX;
+				float dy = y - circle.m_flCenterY;
+				if (dx * dx + dy * dy <= circle.m_flRadius * circle.m_flRadius)
+					return true;
+			}
+		}
+
+		return false;
+	}
 };
 
+static TrackedDeviceIndex_t GetHandDeviceIndex(int hand)
+{
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand((ITrackedDevice::TrackedDeviceType)hand);
+	return dev ? dev->DeviceIndex() : k_unTrackedDeviceIndexInvalid;
+}
+
 // TODO don't pass around handles, as it will cause
 // crashes when we should merely return VROverlayError_InvalidHandle
 #define OVL (*((OverlayData**)pOverlayHandle))
@@ -96,24 +194,10 @@ int BaseOverlay::_BuildLayers(XrCompositionLayerBaseHeader* sceneLayer, XrCompos
 	if (sceneLayer)
 		layerHeaders.push_back(sceneLayer);
 
-	// For performance reasons, this indicates that something is using input
-	// Don't write it directly to usingInput, as that could cause race conditions between
-	//  when it's initially set to false, and when it's reset to true.
-	bool checkUsingInput = false;
-
-	if (keyboard) {
-#ifndef OC_XR_PORT
-		layerHeaders.push_back(keyboard->Update());
-#endif
-		checkUsingInput = true;
-
-		if (keyboard->IsClosed())
-			HideKeyboard();
-	}
-
 	for (const auto& kv : overlays) {
 		if (kv.second) {
 			OverlayData& overlay = *kv.second;
+			overlay.submitted = false;
 
 			// Skip hiddden overlays, and those without a valid texture (eg, after calling ClearOverlayTexture).
 			if (!overlay.visible || overlay.texture.handle == nullptr)
@@ -148,26 +232,258 @@ int BaseOverlay::_BuildLayers(XrCompositionLayerBaseHeader* sceneLayer, XrCompos
 				{ overlay.overlayTransform[0][3], overlay.overlayTransform[1][3], overlay.overlayTransform[2][3] } };
 
 			layerHeaders.push_back((XrCompositionLayerBaseHeader*)&overlay.layerQuad);
+			overlay.submitted = true;
 		}
 	}
 
-	usingInput = checkUsingInput;
+	// The keyboard uses the controllers itself while it's open
+	if (keyboard) {
+		for (PointerHand& hand : pointerHands)
+			hand = PointerHand();
+	} else {
+		UpdatePointer();
+	}
+
+	// Draw the keyboard last, so it's on top of the game's overlays
+	if (keyboard) {
+		auto* backend = (XrBackend*)BackendManager::Instance().GetBackendInstance();
+		XrCompositionLayerBaseHeader* keyboardLayer = keyboard->Update(backend->GetSceneCompositor());
+
+		if (keyboard->IsClosed())
+			HideKeyboard();
+		else if (keyboardLayer)
+			layerHeaders.push_back(keyboardLayer);
+	}
+
 	layers = layerHeaders.data();
 	return static_cast<int>(layerHeaders.size());
 }
 
-bool BaseOverlay::_HandleOverlayInput(EVREye side, TrackedDeviceIndex_t index, VRControllerState_t state)
+void BaseOverlay::UpdatePointer()
 {
-	if (!usingInput)
-		return true;
+	double now = BackendManager::GetTimeInSeconds();
+	// Don't scroll a long way at once after a long frame, such as during loading
+	float dt = lastPointerUpdate == 0 ? 0 : (float)std::min(now - lastPointerUpdate, 0.1);
+	lastPointerUpdate = now;
 
-	if (!keyboard)
+	TrackedDeviceIndex_t device = GetHandDeviceIndex(pointerHand);
+
+	auto releaseButton = [&]() {
+		if (!pointerCaptured)
+			return;
+
+		VREvent_t& evt = pointerTarget->PostEvent(VREvent_MouseButtonUp, device);
+		evt.data.mouse = { pointerPosition.v[0], pointerPosition.v[1], VRMouseButton_Left };
+		pointerCaptured = false;
+	};
+
+	auto setTarget = [&](OverlayData* target) {
+		if (target == pointerTarget)
+			return;
+
+		releaseButton();
+		if (pointerTarget)
+			pointerTarget->PostEvent(VREvent_FocusLeave, device).data.overlay.overlayHandle = (VROverlayHandle_t)pointerTarget;
+		if (target)
+			target->PostEvent(VREvent_FocusEnter, device).data.overlay.overlayHandle = (VROverlayHandle_t)target;
+
+		pointerTarget = target;
+		scrollRemainder[0] = scrollRemainder[1] = 0;
+	};
+
+	// Most games don't use overlay input at all, so don't read the controllers unless something wants it
+	bool wantsInput = false;
+	for (const auto& kv : overlays) {
+		if (kv.second && kv.second->submitted && kv.second->inputMethod != VROverlayInputMethod_None) {
+			wantsInput = true;
+			break;
+		}
+	}
+
+	BaseInput* input = GetUnsafeBaseInput();
+	if (!wantsInput || !input) {
+		setTarget(nullptr);
+		for (PointerHand& hand : pointerHands)
+			hand = PointerHand();
+		return;
+	}
+
+	XrSpace space = xr_space_from_ref_space_type(GetUnsafeBaseSystem()->currentSpace);
+	BaseInput::PointerState states[2] = {};
+	bool tracked[2];
+	PointerHand current[2];
+	for (int hand = 0; hand < 2; hand++) {
+		const BaseInput::PointerState& state = states[hand];
+		const PointerHand& last = pointerHands[hand];
+		tracked[hand] = input->GetPointerState((ITrackedDevice::TrackedDeviceType)hand, space, states[hand]);
+
+		PointerHand& cur = current[hand];
+		cur.trigger = state.trigger;
+		cur.padTouched = state.padTouched;
+		cur.padPressed = state.padPressed;
+		cur.padX = state.padX;
+		cur.padY = state.padY;
+
+		if (cur.padTouched && !last.padTouched) {
+			cur.padTouchTime = now;
+			cur.padFirstX = cur.padX;
+			cur.padFirstY = cur.padY;
+		} else {
+			cur.padTouchTime = last.padTouchTime;
+			cur.padFirstX = last.padFirstX;
+			cur.padFirstY = last.padFirstY;
+		}
+	}
+
+	// Pulling the other trigger moves the mouse over to that hand, without clicking on anything
+	bool switched = false;
+	int other = 1 - pointerHand;
+	if (!pointerCaptured && current[other].trigger && !pointerHands[other].trigger) {
+		setTarget(nullptr);
+		pointerHand = other;
+		device = GetHandDeviceIndex(pointerHand);
+		switched = true;
+	}
+
+	if (pointerCaptured && !pointerTarget->submitted)
+		releaseButton();
+
+	// Overlays are almost always in the same space as the pointer was found in, but one may have been made before the
+	// game switched between seated and standing mode.
+	const BaseInput::PointerState& pointer = states[pointerHand];
+	auto getAim = [&](const OverlayData& overlay, XrPosef& aim) {
+		if (overlay.layerQuad.space == space) {
+			aim = pointer.pose;
+			return true;
+		}
+
+		BaseInput::PointerState state;
+		if (!input->GetPointerState((ITrackedDevice::TrackedDeviceType)pointerHand, overlay.layerQuad.space, state))
+			return false;
+		aim = state.pose;
 		return true;
+	};
 
-#ifndef OC_XR_PORT
-	keyboard->HandleOverlayInput(side, state, (float)ovr_GetTimeInSeconds());
-#endif
-	return false;
+	OverlayData* target = nullptr;
+	HmdVector2_t position = pointerPosition;
+	XrPosef aim;
+	float distance;
+	if (pointerCaptured) {
+		// Keep the mouse on the overlay that was clicked until the trigger is released, even if it's dragged off the edge
+		target = pointerTarget;
+		if (tracked[pointerHand] && getAim(*target, aim))
+			target->Intersect(aim, false, distance, position);
+	} else if (tracked[pointerHand]) {
+		// Use the nearest overlay the pointer hits
+		float nearest = INFINITY;
+		for (const auto& kv : overlays) {
+			OverlayData* overlay = kv.second;
+			if (!overlay || !overlay->submitted || overlay->inputMethod != VROverlayInputMethod_Mouse)
+				continue;
+
+			HmdVector2_t hit;
+			if (!getAim(*overlay, aim) || !overlay->Intersect(aim, true, distance, hit) || distance >= nearest)
+				continue;
+
+			nearest = distance;
+			target = overlay;
+			position = hit;
+		}
+	}
+
+	bool moved = target && (target != pointerTarget || position.v[0] != pointerPosition.v[0] || position.v[1] != pointerPosition.v[1]);
+	setTarget(target);
+	pointerPosition = position;
+
+	if (moved) {
+		VREvent_t& evt = target->PostEvent(VREvent_MouseMove, device);
+		evt.data.mouse = { position.v[0], position.v[1], 0 };
+	}
+
+	const PointerHand& last = pointerHands[pointerHand];
+	const PointerHand& cur = current[pointerHand];
+	if (target && !switched && cur.trigger && !last.trigger) {
+		VREvent_t& evt = target->PostEvent(VREvent_MouseButtonDown, device);
+		evt.data.mouse = { position.v[0], position.v[1], VRMouseButton_Left };
+		pointerCaptured = true;
+	} else if (!cur.trigger) {
+		releaseButton();
+	}
+
+	if (target) {
+		float x = fabsf(cur.padX) > SCROLL_DEADZONE ? cur.padX : 0;
+		float y = fabsf(cur.padY) > SCROLL_DEADZONE ? cur.padY : 0;
+
+		if (target->flags & (1uLL << VROverlayFlags_SendVRSmoothScrollEvents)) {
+			if (x != 0 || y != 0) {
+				VREvent_t& evt = target->PostEvent(VREvent_ScrollSmooth, device);
+				evt.data.scroll = { x * dt * SCROLL_SPEED, y * dt * SCROLL_SPEED, 0, 1 };
+			}
+		} else if (target->flags & (1uLL << VROverlayFlags_SendVRScrollEvents)) {
+			// Discrete scrolling only sends whole steps, like a mouse wheel
+			scrollRemainder[0] += x * dt * SCROLL_SPEED;
+			scrollRemainder[1] += y * dt * SCROLL_SPEED;
+			float stepX = truncf(scrollRemainder[0]);
+			float stepY = truncf(scrollRemainder[1]);
+			if (stepX != 0 || stepY != 0) {
+				VREvent_t& evt = target->PostEvent(VREvent_ScrollDiscrete, device);
+				evt.data.scroll = { stepX, stepY, 0, 1 };
+				scrollRemainder[0] -= stepX;
+				scrollRemainder[1] -= stepY;
+			}
+		}
+
+		if ((target->flags & (1uLL << VROverlayFlags_SendVRTouchpadEvents)) && (cur.padTouched || last.padTouched)) {
+			// Send one last event when the finger is lifted, with where it was before that
+			const PointerHand& values = cur.padTouched ? cur : last;
+			VREvent_t& evt = target->PostEvent(VREvent_TouchPadMove, device);
+			evt.data.touchPadMove = { cur.padTouched, (float)(now - cur.padTouchTime), cur.padFirstX, cur.padFirstY, values.padX, values.padY };
+		}
+	}
+
+	for (int hand = 0; hand < 2; hand++) {
+		UpdateDualAnalog(hand, pointerHands[hand], current[hand]);
+		pointerHands[hand] = current[hand];
+	}
+}
+
+void BaseOverlay::UpdateDualAnalog(int hand, const PointerHand& last, const PointerHand& current)
+{
+	bool moved = current.padTouched && (current.padX != last.padX || current.padY != last.padY);
+	if (!moved && current.padTouched == last.padTouched && current.padPressed == last.padPressed)
+		return;
+
+	// There's no gamepad focus, so these go to every visible overlay that asks for them
+	TrackedDeviceIndex_t device = GetHandDeviceIndex(hand);
+	for (const auto& kv : overlays) {
+		OverlayData* overlay = kv.second;
+		if (!overlay || !overlay->submitted || overlay->inputMethod != VROverlayInputMethod_DualAnalog)
+			continue;
+
+		VREvent_DualAnalog_t data = {
+			current.padX,
+			current.padY,
+			overlay->dualAnalogCenter[hand].v[0] + current.padX * overlay->dualAnalogRadius[hand],
+			overlay->dualAnalogCenter[hand].v[1] + current.padY * overlay->dualAnalogRadius[hand],
+			(EDualAnalogWhich)hand,
+		};
+
+		auto post = [&](EDualAnalogEventType type) {
+			VREvent_t& evt = overlay->PostEvent((EVREventType)type, device);
+			memcpy(&evt.data, &data, sizeof(data));
+		};
+
+		if (current.padTouched && !last.padTouched)
+			post(VREvent_DualAnalog_Touch);
+		if (current.padPressed && !last.padPressed)
+			post(VREvent_DualAnalog_Press);
+		if (moved)
+			post(VREvent_DualAnalog_Move);
+		if (!current.padPressed && last.padPressed)
+			post(VREvent_DualAnalog_Unpress);
+		if (!current.padTouched && last.padTouched)
+			post(VREvent_DualAnalog_Untouch);
+	}
 }
 
 EVROverlayError BaseOverlay::FindOverlay(const char* pchOverlayKey, VROverlayHandle_t* pOverlayHandle)
@@ -213,6 +529,11 @@ EVROverlayError BaseOverlay::DestroyOverlay(VROverlayHandle_t ulOverlayHandle)
 		auto* backend = (XrBackend*)BackendManager::Instance().GetBackendInstance();
 		backend->UnregisterOverlayCompositor(comp);
 	}
+	if (pointerTarget == overlay) {
+		pointerTarget = nullptr;
+		pointerCaptured = false;
+	}
+
 	overlays.erase(overlay->key);
 	validOverlays.erase(overlay);
 	delete overlay;
@@ -676,7 +997,9 @@ bool BaseOverlay::HandleControllerOverlayInteractionAsMouse(VROverlayHandle_t ul
 }
 bool BaseOverlay::IsHoverTargetOverlay(VROverlayHandle_t ulOverlayHandle)
 {
-	STUBBED();
+	USEHB();
+
+	return overlay == pointerTarget;
 }
 VROverlayHandle_t BaseOverlay::GetGamepadFocusOverlay()
 {
@@ -696,15 +1019,33 @@ EVROverlayError BaseOverlay::MoveGamepadFocusToNeighbor(EOverlayDirection eDirec
 }
 EVROverlayError BaseOverlay::SetOverlayDualAnalogTransform(VROverlayHandle_t ulOverlay, EDualAnalogWhich eWhich, const HmdVector2_t& vCenter, float fRadius)
 {
-	STUBBED();
+	return SetOverlayDualAnalogTransform(ulOverlay, eWhich, &vCenter, fRadius);
 }
-EVROverlayError BaseOverlay::GetOverlayDualAnalogTransform(VROverlayHandle_t ulOverlay, EDualAnalogWhich eWhich, HmdVector2_t* pvCenter, float* pfRadius)
+EVROverlayError BaseOverlay::GetOverlayDualAnalogTransform(VROverlayHandle_t ulOverlayHandle, EDualAnalogWhich eWhich, HmdVector2_t* pvCenter, float* pfRadius)
 {
-	STUBBED();
+	USEH();
+
+	if (eWhich != k_EDualAnalog_Left && eWhich != k_EDualAnalog_Right)
+		return VROverlayError_InvalidParameter;
+
+	if (pvCenter)
+		*pvCenter = overlay->dualAnalogCenter[eWhich];
+	if (pfRadius)
+		*pfRadius = overlay->dualAnalogRadius[eWhich];
+
+	return VROverlayError_None;
 }
-EVROverlayError BaseOverlay::SetOverlayDualAnalogTransform(VROverlayHandle_t ulOverlay, EDualAnalogWhich eWhich, const HmdVector2_t* pvCenter, float fRadius)
+EVROverlayError BaseOverlay::SetOverlayDualAnalogTransform(VROverlayHandle_t ulOverlayHandle, EDualAnalogWhich eWhich, const HmdVector2_t* pvCenter, float fRadius)
 {
-	STUBBED();
+	USEH();
+
+	if (!pvCenter || (eWhich != k_EDualAnalog_Left && eWhich != k_EDualAnalog_Right))
+		return VROverlayError_InvalidParameter;
+
+	overlay->dualAnalogCenter[eWhich] = *pvCenter;
+	overlay->dualAnalogRadius[eWhich] = fRadius;
+
+	return VROverlayError_None;
 }
 EVROverlayError BaseOverlay::TriggerLaserMouseHapticVibration(VROverlayHandle_t ulOverlayHandle, float fDurationSeconds, float fFrequency, float fAmplitude)
 {
@@ -814,45 +1155,24 @@ EVROverlayError BaseOverlay::ShowKeyboardWithDispatch(EGamepadTextInputMode eInp
     const char* pchDescription, uint32_t unCharMax, const char* pchExistingText, bool bUseMinimalMode, uint64_t uUserValue,
     VRKeyboard::eventDispatch_t eventDispatch)
 {
-	// Submit a KeyboardDone event since the actual keyboard is not implemented yet.  This allows certain games to still proceed instead of crash.
-	SubmitPlaceholderKeyboardEvent(VREvent_KeyboardDone, eventDispatch, uUserValue);
-
-#ifndef OC_XR_PORT
-	if (!BaseCompositor::dxcomp)
-		OOVR_ABORT("Keyboard currently only available on DX11 and DX10 games");
+	if (keyboard)
+		return VROverlayError_KeyboardAlreadyInUse;
 
-	if (eLineInputMode != k_EGamepadTextInputLineModeSingleLine)
-		OOVR_ABORTF("Only single-line keyboard entry mode is currently supported (as opposed to ID=%d)", eLineInputMode);
+	bool multiLine = eLineInputMode == k_EGamepadTextInputLineModeMultipleLines;
+	keyboard = std::make_unique<VRKeyboard>(uUserValue, unCharMax, bUseMinimalMode, multiLine, eventDispatch,
+	    (VRKeyboard::EGamepadTextInputMode)eInputMode, GetUnsafeBaseSystem()->currentSpace);
 
-	// TODO use description
-	keyboard = make_unique<VRKeyboard>(BaseCompositor::dxcomp->GetDevice(), uUserValue, unCharMax, bUseMinimalMode, eventDispatch,
-	    (VRKeyboard::EGamepadTextInputMode)eInputMode);
-
-	keyboard->contents(VRKeyboard::CHAR_CONV.from_bytes(pchExistingText));
+	keyboard->contents(VRKeyboard::CHAR_CONV.from_bytes(pchExistingText ? pchExistingText : ""));
+	keyboard->SetDescription(VRKeyboard::CHAR_CONV.from_bytes(pchDescription ? pchDescription : ""));
 
 	BaseSystem* system = GetUnsafeBaseSystem();
 	if (system) {
 		system->_BlockInputsUntilReleased();
 	}
-#endif
 
 	return VROverlayError_None;
 }
 
-/** Placeholder method for submitting a KeyboardDone event when asked to show the keyboard since it is not implemented yet. **/
-void BaseOverlay::SubmitPlaceholderKeyboardEvent(vr::EVREventType ev, VRKeyboard::eventDispatch_t eventDispatch, uint64_t userValue)
-{
-	VREvent_Keyboard_t data{};
-	data.uUserValue = userValue;
-
-	VREvent_t evt = { 0 };
-	evt.eventType = ev;
-	evt.trackedDeviceIndex = 0;
-	evt.data.keyboard = data;
-
-	eventDispatch(evt);
-}
-
 EVROverlayError BaseOverlay::ShowKeyboard(EGamepadTextInputMode eInputMode, EGamepadTextInputLineMode eLineInputMode,
     const char* pchDescription, uint32_t unCharMax, const char* pchExistingText, bool bUseMinimalMode, uint64_t uUserValue)
 {
@@ -895,8 +1215,8 @@ uint32_t BaseOverlay::GetKeyboardText(char* pchText, uint32_t cchText)
 {
 	string str = keyboard ? VRKeyboard::CHAR_CONV.to_bytes(keyboard->contents()) : keyboardCache;
 
-	// Since keyboard is not functional yet, return this default text (Adventurer because this fix was made specifically for Skyrim VR)
-	str = "Adventurer";
+	if (!pchText || cchText == 0)
+		return (uint32_t)str.length();
 
 	// FFS, strncpy is secure.
 	strncpy_s(pchText, cchText, str.c_str(), cchText);
@@ -927,16 +1247,19 @@ void BaseOverlay::SetKeyboardTransformAbsolute(ETrackingUniverseOrigin eTracking
 	if (!keyboard)
 		OOVR_ABORT("Cannot set keyboard position when the keyboard is closed!");
 
-#ifdef OC_XR_PORT
-	XR_STUBBED();
-#else
-	BaseCompositor* compositor = GetUnsafeBaseCompositor();
-	if (compositor && eTrackingOrigin != compositor->GetTrackingSpace()) {
-		OOVR_ABORTF("Origin mismatch - current %d, requested %d", compositor->GetTrackingSpace(), eTrackingOrigin);
+	XrReferenceSpaceType space;
+	switch (eTrackingOrigin) {
+	case TrackingUniverseSeated:
+		space = XR_REFERENCE_SPACE_TYPE_LOCAL;
+		break;
+	case TrackingUniverseStanding:
+		space = XR_REFERENCE_SPACE_TYPE_STAGE;
+		break;
+	default:
+		OOVR_ABORTF("Unsupported keyboard tracking origin %d", eTrackingOrigin);
 	}
 
-	keyboard->SetTransform(*pmatTrackingOriginToKeyboardTransform);
-#endif
+	keyboard->SetTransform(space, *pmatTrackingOriginToKeyboardTransform);
 }
 void BaseOverlay::SetKeyboardPositionForOverlay(VROverlayHandle_t ulOverlayHandle, HmdRect2_t avoidRect)
 {
@@ -944,7 +1267,25 @@ void BaseOverlay::SetKeyboardPositionForOverlay(VROverlayHandle_t ulOverlayHandl
 }
 EVROverlayError BaseOverlay::SetOverlayIntersectionMask(VROverlayHandle_t ulOverlayHandle, OOVR_VROverlayIntersectionMaskPrimitive_t* pMaskPrimitives, uint32_t unNumMaskPrimitives, uint32_t unPrimitiveSize)
 {
-	STUBBED();
+	USEH();
+
+	// Passing no primitives makes the whole overlay pointable again
+	overlay->intersectionMask.clear();
+	if (!pMaskPrimitives || unNumMaskPrimitives == 0)
+		return VROverlayError_None;
+
+	if (unPrimitiveSize < sizeof(OOVR_VROverlayIntersectionMaskPrimitive_t))
+		return VROverlayError_InvalidParameter;
+
+	// Step through by the caller's size, in case it's from a newer version of OpenVR with a larger struct
+	const char* data = (const char*)pMaskPrimitives;
+	for (uint32_t i = 0; i < unNumMaskPrimitives; i++) {
+		OOVR_VROverlayIntersectionMaskPrimitive_t primitive;
+		memcpy(&primitive, data + (size_t)i * unPrimitiveSize, sizeof(primitive));
+		overlay->intersectionMask.push_back(primitive);
+	}
+
+	return VROverlayError_None;
 }
 EVROverlayError BaseOverlay::GetOverlayFlags(VROverlayHandle_t ulOverlayHandle, uint32_t* pFlags)
 {
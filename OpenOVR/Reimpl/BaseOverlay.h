@@ -63,6 +63,14 @@ enum OOVR_VROverlayFlags {
 
 	// If set, the overlay will be shown in the dashboard, otherwise it will be hidden.
 	VROverlayFlags_VisibleInDashboard = 15,
+
+	// If this is set and the overlay's input method is not none, the system-wide laser mouse
+	// mode will be activated whenever this overlay is visible.
+	VROverlayFlags_MakeOverlaysInteractiveIfVisible = 16,
+
+	// If this is set the overlay will receive smooth VREvent_ScrollSmooth that emulate trackpad scrolling.
+	// Requires mouse input mode.
+	VROverlayFlags_SendVRSmoothScrollEvents = 17,
 };
 
 enum OOVR_VRMessageOverlayResponse {
@@ -184,8 +192,31 @@ private:
 	// Cached copy of the keyboard contents, available after it is closed
 	std::string keyboardCache;
 
-	// True if we're modifying the input in any way
-	bool usingInput;
+	// The laser mouse, which sends mouse events to overlays using VROverlayInputMethod_Mouse. See UpdatePointer.
+	struct PointerHand {
+		// The trigger is assumed to be held to start with, so if it's still held from
+		// something else it doesn't click on whatever overlay it's pointing at.
+		bool trigger = true;
+
+		bool padTouched = false, padPressed = false;
+		float padX = 0, padY = 0;
+
+		// Where and when the finger first touched the pad, for VREvent_TouchPadMove
+		double padTouchTime = 0;
+		float padFirstX = 0, padFirstY = 0;
+	};
+	PointerHand pointerHands[2]; // These use the OpenVR eye constants, which match ITrackedDevice's hands
+	int pointerHand = vr::Eye_Right; // The hand the mouse follows, which switches when the other trigger is pulled
+
+	OverlayData* pointerTarget = nullptr; // The overlay the mouse is over, if any
+	bool pointerCaptured = false; // If set, pointerTarget keeps the mouse until the trigger is released
+	vr::HmdVector2_t pointerPosition = {}; // In pointerTarget's mouse coordinates
+	float scrollRemainder[2] = {}; // Scrolling not yet sent as a VREvent_ScrollDiscrete step
+	double lastPointerUpdate = 0;
+
+	// Hit test the overlays submitted this frame, and send input events to them
+	void UpdatePointer();
+	void UpdateDualAnalog(int hand, const PointerHand& last, const PointerHand& current);
 
 	vr::EVROverlayError ShowKeyboardWithDispatch(
 	    EGamepadTextInputMode eInputMode, EGamepadTextInputLineMode eLineInputMode,
@@ -200,9 +231,6 @@ public:
 	// Builds the collection of layers to be submitted to LibOVR
 	int _BuildLayers(XrCompositionLayerBaseHeader* sceneLayer, XrCompositionLayerBaseHeader const* const*& result);
 
-	// If an overlay needs input, this grabs the input and returns whether the input should preceed to the application
-	bool _HandleOverlayInput(vr::EVREye role, vr::TrackedDeviceIndex_t controllerDeviceIndex, vr::VRControllerState_t state);
-
 	// ---------------------------------------------
 	// Overlay management methods
 	// ---------------------------------------------
@@ -537,9 +565,6 @@ public:
 	/** Show the virtual keyboard to accept input **/
 	vr::EVROverlayError ShowKeyboard(EGamepadTextInputMode eInputMode, EGamepadTextInputLineMode eLineInputMode, const char* pchDescription, uint32_t unCharMax, const char* pchExistingText, bool bUseMinimalMode, uint64_t uUserValue);
 
-	/** Placeholder method for submitting a KeyboardDone event when asked to show the keyboard since it is not implemented yet. **/
-	void SubmitPlaceholderKeyboardEvent(vr::EVREventType ev, VRKeyboard::eventDispatch_t eventDispatch, uint64_t userValue);
-
 	/**
 	 * Show the virtual keyboard to accept input. In most cases, you should pass KeyboardFlag_Modal to enable modal overlay
 	 * behavior on the keyboard itself. See EKeyboardFlags for more.
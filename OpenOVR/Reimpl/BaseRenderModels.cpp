@@ -545,7 +545,7 @@ bool BaseRenderModels::GetComponentState(const char* pchRenderModelName, const c
 	}
 
 	// See if we can get it properly
-	bool success = TryGetComponentState(hand, componentName, pComponentState);
+	bool success = TryGetComponentState(hand, InteractionProfile::LookupComponentId(componentName), pComponentState);
 	if (success)
 		return true;
 
@@ -566,22 +566,22 @@ bool BaseRenderModels::GetComponentState(const char* pchRenderModelName, const c
 	return true;
 }
 
-bool BaseRenderModels::TryGetComponentState(ITrackedDevice::TrackedDeviceType hand, const std::string& componentName, OOVR_RenderModel_ComponentState_t* result)
+bool BaseRenderModels::TryGetComponentState(ITrackedDevice::TrackedDeviceType hand, ControllerComponentId component, OOVR_RenderModel_ComponentState_t* result)
 {
-	if (hand == ITrackedDevice::HAND_NONE)
+	if (hand == ITrackedDevice::HAND_NONE || component == ControllerComponentId::UNKNOWN)
 		return false;
 
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDeviceByHand(hand);
+	ITrackedDevice* dev = BackendManager::Instance().GetDeviceByHand(hand);
 	if (!dev)
 		return false;
 
 	// See if there's a manually-defined transform
 	const InteractionProfile* profile = dev->GetInteractionProfile();
 	if (profile) {
-		std::optional<glm::mat4> transform = profile->GetComponentTransform(hand, componentName);
+		const glm::mat4* transform = profile->GetComponentTransform(hand, component);
 		if (transform) {
-			result->mTrackingToComponentLocal = G2S_m34(transform.value());
-			result->mTrackingToComponentRenderModel = G2S_m34(transform.value());
+			result->mTrackingToComponentLocal = G2S_m34(*transform);
+			result->mTrackingToComponentRenderModel = G2S_m34(*transform);
 			result->uProperties = VRComponentProperty_IsVisible | VRComponentProperty_IsStatic;
 			return true;
 		}
@@ -594,7 +594,7 @@ bool BaseRenderModels::TryGetComponentState(ITrackedDevice::TrackedDeviceType ha
 	}
 
 	// The grip space is simple - it's just the hand-to-grip transform matrix
-	if (componentName == "handgrip") {
+	if (component == ControllerComponentId::HANDGRIP) {
 		result->mTrackingToComponentLocal = G2S_m34(handToGripSpace);
 		result->mTrackingToComponentRenderModel = G2S_m34(handToGripSpace);
 		result->uProperties = VRComponentProperty_IsVisible | VRComponentProperty_IsStatic;
@@ -602,7 +602,7 @@ bool BaseRenderModels::TryGetComponentState(ITrackedDevice::TrackedDeviceType ha
 	}
 
 	// If it's not manually specified, calculate the 'tip' position to match up with the OpenXR aim pose.
-	if (componentName != "tip") {
+	if (component != ControllerComponentId::TIP) {
 		return false;
 	}
 
@@ -12,6 +12,7 @@ typedef int32_t OOVR_TextureID_t;
 struct OOVR_RenderModel_TextureMap_t;
 struct OOVR_RenderModel_ControllerMode_State_t;
 typedef vr::RenderModel_ComponentState_t OOVR_RenderModel_ComponentState_t;
+enum class ControllerComponentId : int;
 
 class BaseRenderModels {
 private:
@@ -19,7 +20,7 @@ private:
 
 public: // INTERNAL FUNCTIONS
 	/** Try to find a component, if possible. This is the core of GetComponentState, which itself handles the case where this fails. */
-	bool TryGetComponentState(ITrackedDevice::TrackedDeviceType hand, const std::string& componentName, OOVR_RenderModel_ComponentState_t* result);
+	bool TryGetComponentState(ITrackedDevice::TrackedDeviceType hand, ControllerComponentId component, OOVR_RenderModel_ComponentState_t* result);
 
 public:
 	/** Loads and returns a render model for use in the application. pchRenderModelName should be a render model name
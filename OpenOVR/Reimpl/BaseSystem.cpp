@@ -57,7 +57,7 @@ public:
 	DEF_PRINT_RESULT(float, "%f", result)
 	DEF_PRINT_RESULT(int32_t, "%" PRIi32, result)
 	DEF_PRINT_RESULT(uint64_t, "%" PRIu64, result)
-	DEF_PRINT_RESULT(char*, "%s", result)
+	DEF_PRINT_RESULT(const char*, "%s", result)
 
 	void print_result(HmdMatrix34_t result)
 	{
@@ -300,7 +300,7 @@ vr::TrackedDeviceIndex_t BaseSystem::GetTrackedDeviceIndexForControllerRole(vr::
 		unDeviceIndex = rightHandIndex;
 	}
 
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 	if (!dev) {
 		return -1; // This is what SteamVR does for unknown devices
 	} else {
@@ -344,7 +344,7 @@ bool BaseSystem::IsTrackedDeviceConnected(vr::TrackedDeviceIndex_t deviceIndex)
 bool BaseSystem::GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "bool");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -352,7 +352,7 @@ bool BaseSystem::GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceI
 		return false;
 	}
 
-	bool ret = dev->GetBoolTrackedDeviceProperty(prop, pErrorL);
+	bool ret = dev->GetPropertyTable().GetBool(prop, pErrorL);
 	p.print_result(ret);
 	return ret;
 }
@@ -360,7 +360,7 @@ bool BaseSystem::GetBoolTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceI
 float BaseSystem::GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "float");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -368,7 +368,7 @@ float BaseSystem::GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDevic
 		return 0;
 	}
 
-	float ret = dev->GetFloatTrackedDeviceProperty(prop, pErrorL);
+	float ret = dev->GetPropertyTable().GetFloat(prop, pErrorL);
 	p.print_result(ret);
 	return ret;
 }
@@ -376,7 +376,7 @@ float BaseSystem::GetFloatTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDevic
 int32_t BaseSystem::GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "int32_t");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -384,7 +384,7 @@ int32_t BaseSystem::GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDev
 		return 0;
 	}
 
-	int32_t ret = dev->GetInt32TrackedDeviceProperty(prop, pErrorL);
+	int32_t ret = dev->GetPropertyTable().GetInt32(prop, pErrorL);
 	p.print_result(ret);
 	return ret;
 }
@@ -392,7 +392,7 @@ int32_t BaseSystem::GetInt32TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDev
 uint64_t BaseSystem::GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "uint64_t");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -400,7 +400,7 @@ uint64_t BaseSystem::GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unD
 		return 0;
 	}
 
-	uint64_t ret = dev->GetUint64TrackedDeviceProperty(prop, pErrorL);
+	uint64_t ret = dev->GetPropertyTable().GetUint64(prop, pErrorL);
 	p.print_result(ret);
 	return ret;
 }
@@ -408,7 +408,7 @@ uint64_t BaseSystem::GetUint64TrackedDeviceProperty(vr::TrackedDeviceIndex_t unD
 HmdMatrix34_t BaseSystem::GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "HmdMatrix34_t");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -416,7 +416,7 @@ HmdMatrix34_t BaseSystem::GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceInde
 		return {};
 	}
 
-	HmdMatrix34_t ret = dev->GetMatrix34TrackedDeviceProperty(prop, pErrorL);
+	HmdMatrix34_t ret = dev->GetPropertyTable().GetMatrix34(prop, pErrorL);
 	p.print_result(ret);
 	return ret;
 }
@@ -424,7 +424,7 @@ HmdMatrix34_t BaseSystem::GetMatrix34TrackedDeviceProperty(vr::TrackedDeviceInde
 uint32_t BaseSystem::GetArrayTrackedDeviceProperty(vr::TrackedDeviceIndex_t unDeviceIndex, ETrackedDeviceProperty prop, PropertyTypeTag_t propType, void* pBuffer, uint32_t unBufferSize, ETrackedPropertyError* pError)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "array");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pError)
@@ -457,7 +457,7 @@ uint32_t BaseSystem::GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t unD
     VR_OUT_STRING() char* value, uint32_t bufferSize, ETrackedPropertyError* pErrorL)
 {
 	PropertyPrinter p(prop, unDeviceIndex, "string");
-	std::shared_ptr<ITrackedDevice> dev = BackendManager::Instance().GetDevice(unDeviceIndex);
+	ITrackedDevice* dev = BackendManager::Instance().GetDevice(unDeviceIndex);
 
 	if (!dev) {
 		if (pErrorL)
@@ -465,8 +465,10 @@ uint32_t BaseSystem::GetStringTrackedDeviceProperty(vr::TrackedDeviceIndex_t unD
 		return 0;
 	}
 
-	uint32_t ret = dev->GetStringTrackedDeviceProperty(prop, value, bufferSize, pErrorL);
-	p.print_result(value);
+	// Log the value from the table, since the application's buffer may be null or too small
+	const char* cachedValue;
+	uint32_t ret = dev->GetPropertyTable().GetString(prop, value, bufferSize, pErrorL, &cachedValue);
+	p.print_result(cachedValue);
 	return ret;
 }
 
@@ -552,8 +554,9 @@ void BaseSystem::_OnPostFrame()
 
 void BaseSystem::_EnqueueEvent(const VREvent_t& e)
 {
+	double now = BackendManager::GetTimeInSeconds();
 	std::unique_lock lock(events_mutex);
-	events.push(e);
+	events.push(event_info_t(e, now));
 }
 
 void BaseSystem::_BlockInputsUntilReleased()
@@ -589,9 +592,10 @@ void BaseSystem::CheckControllerEvents(TrackedDeviceIndex_t hand, VRControllerSt
 
 	VREvent_t ev_base{};
 	ev_base.trackedDeviceIndex = hand;
-	ev_base.eventAgeSeconds = 0; // TODO
 	ev_base.data.controller = { 0 };
 
+	double now = BackendManager::GetTimeInSeconds();
+
 	TrackedDevicePose_t pose{};
 	BaseCompositor* compositor = GetUnsafeBaseCompositor();
 	if (compositor) {
@@ -612,7 +616,7 @@ void BaseSystem::CheckControllerEvents(TrackedDeviceIndex_t hand, VRControllerSt
 			VREvent_t e = ev_base;
 			e.eventType = newState ? VREvent_ButtonPress : VREvent_ButtonUnpress;
 			std::unique_lock lock(events_mutex);
-			events.push(event_info_t(e, pose));
+			events.push(event_info_t(e, pose, now));
 		}
 
 		// Did the user touch or break contact with the button?
@@ -623,7 +627,7 @@ void BaseSystem::CheckControllerEvents(TrackedDeviceIndex_t hand, VRControllerSt
 			VREvent_t e = ev_base;
 			e.eventType = newState ? VREvent_ButtonTouch : VREvent_ButtonUntouch;
 			std::unique_lock lock(events_mutex);
-			events.push(event_info_t(e, pose));
+			events.push(event_info_t(e, pose, now));
 		}
 	}
 
@@ -649,6 +653,8 @@ bool BaseSystem::PollNextEventWithPose(ETrackingUniverseOrigin eOrigin, VREvent_
 	VREvent_t e = info.ev;
 	events.pop();
 
+	e.eventAgeSeconds = (float)(BackendManager::GetTimeInSeconds() - info.time);
+
 	memcpy(pEvent, &e, std::min((size_t)uncbVREvent, sizeof(e)));
 
 	if (pTrackedDevicePose) {
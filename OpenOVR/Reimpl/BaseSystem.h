@@ -15,11 +15,14 @@ private:
 		vr::VREvent_t ev{};
 		vr::TrackedDevicePose_t pose{};
 
-		event_info_t(vr::VREvent_t ev)
-		    : ev(ev) {}
+		// When the event was queued, from BackendManager::GetTimeInSeconds
+		double time = 0;
 
-		event_info_t(vr::VREvent_t ev, vr::TrackedDevicePose_t pose)
-		    : ev(ev), pose(pose) {}
+		event_info_t(vr::VREvent_t ev, double time)
+		    : ev(ev), time(time) {}
+
+		event_info_t(vr::VREvent_t ev, vr::TrackedDevicePose_t pose, double time)
+		    : ev(ev), pose(pose), time(time) {}
 	};
 
 	std::queue<event_info_t> events;
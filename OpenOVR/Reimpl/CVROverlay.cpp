@@ -2,6 +2,8 @@
 #define GENFILE
 #include "BaseCommon.h"
 
+#include <bit>
+
 GEN_INTERFACE("Overlay", "007")
 GEN_INTERFACE("Overlay", "010")
 GEN_INTERFACE("Overlay", "011")
@@ -46,3 +48,70 @@ vr::EVROverlayError CVROverlay_013::GetOverlayTexture(vr::VROverlayHandle_t ulOv
 	// It should be fairly simple, but it's unlikely to be used so I can't be bothered implementing it now
 	STUBBED();
 }
+
+// From IVROverlay_021 onwards, the overlay flags are bitmasks rather than bit indices. Convert
+// them back to the indices that BaseOverlay (and the older interfaces) use.
+static OOVR_VROverlayFlags flag_index(uint32_t mask)
+{
+	return (OOVR_VROverlayFlags)std::countr_zero(mask);
+}
+
+vr::EVROverlayError CVROverlay_021::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_021::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_021::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_021::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
+
+vr::EVROverlayError CVROverlay_022::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_022::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_022::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_022::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
+
+vr::EVROverlayError CVROverlay_024::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_024::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_024::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_024::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
+
+vr::EVROverlayError CVROverlay_025::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_025::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_025::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_025::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
+
+vr::EVROverlayError CVROverlay_026::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_026::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_026::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_026::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
+
+vr::EVROverlayError CVROverlay_027::SetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_027::VROverlayFlags eOverlayFlag, bool bEnabled)
+{
+	return base->SetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), bEnabled);
+}
+
+vr::EVROverlayError CVROverlay_027::GetOverlayFlag(vr::VROverlayHandle_t ulOverlayHandle, vr::IVROverlay_027::VROverlayFlags eOverlayFlag, bool* pbEnabled)
+{
+	return base->GetOverlayFlag(ulOverlayHandle, flag_index(eOverlayFlag), pbEnabled);
+}
@@ -11,3 +11,18 @@ enum EDualAnalogWhich {
 	k_EDualAnalog_Left = 0,
 	k_EDualAnalog_Right = 1,
 };
+
+// Sent to overlays using VROverlayInputMethod_DualAnalog, up to OpenVR 1.9
+enum EDualAnalogEventType {
+	VREvent_DualAnalog_Press = 250, // data is dualAnalog
+	VREvent_DualAnalog_Unpress = 251, // data is dualAnalog
+	VREvent_DualAnalog_Touch = 252, // data is dualAnalog
+	VREvent_DualAnalog_Untouch = 253, // data is dualAnalog
+	VREvent_DualAnalog_Move = 254, // data is dualAnalog
+};
+
+struct VREvent_DualAnalog_t {
+	float x, y; // coordinates are -1..1 analog values
+	float transformedX, transformedY; // transformed by the center and radius numbers provided by the overlay
+	EDualAnalogWhich which;
+};
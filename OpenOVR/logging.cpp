@@ -162,32 +162,63 @@ static FILE* cfile(std::ofstream& ofs)
 
 #endif
 
-static void init_stream()
+std::string oovr_log_path(const std::string& filename)
 {
-	if (!stream.is_open()) {
-		string outputFilePath = "opencomposite.log";
-
-		// Try and write to standard location
-		// fall back to exe dir if can't create dir
+	// Try and write to standard location
+	// fall back to exe dir if can't create dir
 #ifdef _WIN32
-		string outputFolder = GetEnv("LOCALAPPDATA");
+	string outputFolder = GetEnv("LOCALAPPDATA");
+	if (!outputFolder.empty())
+		outputFolder = outputFolder + "\\OpenComposite\\logs";
+	if (!outputFolder.empty() && makePath(outputFolder))
+		return outputFolder + "\\" + filename;
+#else
+	string outputFolder = GetEnv("XDG_STATE_HOME");
+	if (outputFolder.empty()) {
+		outputFolder = GetEnv("HOME");
 		if (!outputFolder.empty())
-			outputFolder = outputFolder + "\\OpenComposite\\logs";
-		if (!outputFolder.empty() && makePath(outputFolder))
-			outputFilePath = outputFolder + "\\" + outputFilePath;
+			outputFolder = outputFolder + "/.local/state";
+	}
+	if (!outputFolder.empty())
+		outputFolder = outputFolder + "/OpenComposite/logs";
+	if (!outputFolder.empty() && makePath(outputFolder))
+		return outputFolder + "/" + filename;
+#endif
+
+	return filename;
+}
+
+std::string oovr_config_path(const std::string& filename)
+{
+	// Unlike the log, there's no sensible fallback: anything written to the working directory would be
+	// lost as soon as a different game is started.
+#ifdef _WIN32
+	string outputFolder = GetEnv("LOCALAPPDATA");
+	if (!outputFolder.empty())
+		outputFolder = outputFolder + "\\OpenComposite";
+	if (!outputFolder.empty() && makePath(outputFolder))
+		return outputFolder + "\\" + filename;
 #else
-		string outputFolder = GetEnv("XDG_STATE_HOME");
-		if (outputFolder.empty()) {
-			outputFolder = GetEnv("HOME");
-			if (!outputFolder.empty())
-				outputFolder = outputFolder + "/.local/state";
-		}
+	string outputFolder = GetEnv("XDG_CONFIG_HOME");
+	if (outputFolder.empty()) {
+		outputFolder = GetEnv("HOME");
 		if (!outputFolder.empty())
-			outputFolder = outputFolder + "/OpenComposite/logs";
-		if (!outputFolder.empty() && makePath(outputFolder))
-			outputFilePath = outputFolder + "/" + outputFilePath;
+			outputFolder = outputFolder + "/.config";
+	}
+	if (!outputFolder.empty())
+		outputFolder = outputFolder + "/OpenComposite";
+	if (!outputFolder.empty() && makePath(outputFolder))
+		return outputFolder + "/" + filename;
 #endif
 
+	return "";
+}
+
+static void init_stream()
+{
+	if (!stream.is_open()) {
+		string outputFilePath = oovr_log_path("opencomposite.log");
+
 		stream.open(outputFilePath.c_str());
 #ifdef __GLIBCXX__
 		stream_fd.store(fileno(cfile(stream)), std::memory_order::seq_cst);
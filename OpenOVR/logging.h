@@ -26,6 +26,12 @@ void oovr_soft_abort_raw(const char* file, long line, const char* func, int* hit
 
 std::string GetEnv(const std::string& var);
 
+// Get the path of a file in the directory the log is written to
+std::string oovr_log_path(const std::string& filename);
+
+// Get the path of a file in OpenComposite's per-user config directory, or an empty string if it can't be created
+std::string oovr_config_path(const std::string& filename);
+
 #define OOVR_ABORT(msg)                                        \
 	do {                                                       \
 		oovr_abort_raw(__FILE__, __LINE__, __FUNCTION__, msg); \
@@ -14,6 +14,7 @@
 
 // Fonts
 #define RES_O_FNT_UBUNTU 4
+#define RES_O_FNT_UBUNTU_TEXTURE 6
 
 // Keyboard layouts
 #define RES_O_KB_EN_GB 5
@@ -25,4 +26,5 @@
 	f(RES_O_HAND_RIGHT) \
 	f(RES_O_VIVE_TRACKER) \
 	f(RES_O_FNT_UBUNTU) \
+	f(RES_O_FNT_UBUNTU_TEXTURE) \
 	f(RES_O_KB_EN_GB) // clang-format on
@@ -0,0 +1,564 @@
+//
+// Benchmarks of the OpenVR calls games make every frame, run against the headless runtime so the results only
+// depend on OpenComposite. For each call this reports the time taken, the number of heap allocations made and the
+// number of OpenXR calls made, as JSON.
+//
+// Usage: OCBenchmark [--iterations N] [--filter TEXT] [--json FILE]
+//
+
+#include "HeadlessHarness.h"
+
+#include "generated/interfaces/IVRCompositor_028.h"
+#include "generated/interfaces/IVRInput_010.h"
+#include "generated/interfaces/IVROverlay_027.h"
+#include "generated/interfaces/IVRRenderModels_006.h"
+#include "generated/interfaces/IVRSystem_022.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string>
+#include <vector>
+
+using vr::IVRCompositor_028::IVRCompositor;
+using vr::IVRInput_010::IVRInput;
+using vr::IVROverlay_027::IVROverlay;
+using vr::IVRRenderModels_006::IVRRenderModels;
+using vr::IVRSystem_022::IVRSystem;
+
+// ---------------  Allocation counting   --------------- //
+
+static std::atomic<uint64_t> allocationCount;
+
+// These replace the standard library's operator new for vrclient as well as for us, since this executable's
+// symbols are exported (see ENABLE_EXPORTS in CMakeLists.txt) and vrclient uses the shared libstdc++. The other
+// forms of new (arrays, nothrow) are implemented in terms of these, and the standard operator delete frees memory
+// from both. Allocations made with malloc aren't counted.
+__attribute__((visibility("default"))) void* operator new(std::size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	void* result = malloc(size ? size : 1);
+	if (!result)
+		throw std::bad_alloc();
+	return result;
+}
+
+__attribute__((visibility("default"))) void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	// aligned_alloc requires the size to be a multiple of the alignment
+	size_t align = (size_t)alignment;
+	void* result = aligned_alloc(align, (size + align - 1) / align * align);
+	if (!result)
+		throw std::bad_alloc();
+	return result;
+}
+
+// ---------------  Benchmark runner   --------------- //
+
+class Benchmarks {
+public:
+	Benchmarks(HeadlessHarness& harness, uint64_t iterations, std::string filter)
+	    : harness(harness), iterations(iterations), filter(std::move(filter))
+	{
+	}
+
+	/**
+	 * Time a function, which makes callsPerIteration calls to whatever's being measured each time it's run. The
+	 * results are divided by the number of calls. The function is run iterations / divisor times, after a short
+	 * warm-up so OpenComposite has created anything it creates lazily.
+	 */
+	void Run(const std::string& name, uint64_t divisor, uint64_t callsPerIteration, const std::function<void()>& function)
+	{
+		if (!filter.empty() && name.find(filter) == std::string::npos)
+			return;
+
+		uint64_t count = std::max<uint64_t>(iterations / divisor, 1);
+		for (uint64_t i = 0; i < count / 10 + 1; i++)
+			function();
+
+		int64_t startRuntimeCalls = harness.RuntimeCallCount();
+		uint64_t startAllocations = allocationCount.load();
+		auto start = std::chrono::steady_clock::now();
+
+		for (uint64_t i = 0; i < count; i++)
+			function();
+
+		auto end = std::chrono::steady_clock::now();
+		uint64_t allocations = allocationCount.load() - startAllocations;
+		int64_t runtimeCalls = harness.RuntimeCallCount() - startRuntimeCalls;
+
+		Result result;
+		result.name = name;
+		result.calls = count * callsPerIteration;
+		result.nsPerCall = std::chrono::duration<double, std::nano>(end - start).count() / (double)result.calls;
+		result.allocationsPerCall = (double)allocations / (double)result.calls;
+		result.runtimeCallsPerCall = startRuntimeCalls < 0 ? -1 : (double)runtimeCalls / (double)result.calls;
+		results.push_back(result);
+
+		fprintf(stderr, "%-40s %12.1f ns %10.2f allocs %8.2f xr calls\n", name.c_str(), result.nsPerCall,
+		    result.allocationsPerCall, result.runtimeCallsPerCall);
+	}
+
+	void Run(const std::string& name, const std::function<void()>& function)
+	{
+		Run(name, 1, 1, function);
+	}
+
+	void WriteJson(FILE* file) const
+	{
+		fprintf(file, "{\n  \"benchmarks\": [\n");
+		for (size_t i = 0; i < results.size(); i++) {
+			const Result& result = results[i];
+			fprintf(file, "    { \"name\": \"%s\", \"calls\": %llu, \"ns_per_call\": %.2f, \"allocations_per_call\": %.3f, ",
+			    result.name.c_str(), (unsigned long long)result.calls, result.nsPerCall, result.allocationsPerCall);
+
+			// Null if we're not running against the headless runtime, so don't know
+			if (result.runtimeCallsPerCall < 0)
+				fprintf(file, "\"runtime_calls_per_call\": null }");
+			else
+				fprintf(file, "\"runtime_calls_per_call\": %.3f }", result.runtimeCallsPerCall);
+
+			fprintf(file, "%s\n", i + 1 < results.size() ? "," : "");
+		}
+		fprintf(file, "  ]\n}\n");
+	}
+
+private:
+	struct Result {
+		std::string name;
+		uint64_t calls = 0;
+		double nsPerCall = 0;
+		double allocationsPerCall = 0;
+		double runtimeCallsPerCall = 0;
+	};
+
+	HeadlessHarness& harness;
+	uint64_t iterations;
+	std::string filter;
+	std::vector<Result> results;
+};
+
+// ---------------  Test application   --------------- //
+
+// Both hands are held out in front of the headset, with the right trigger held down and the left hand half closed,
+// so every finger of the estimated left hand skeleton is blended
+static const char* script = "0 /user/head        0 1.6 0  0 0 0 1\n"
+                            "0 /user/hand/left   -0.2 1.2 -0.3  0 0 0 1\n"
+                            "0 /user/hand/right  0.2 1.2 -0.3  0 0 0 1\n"
+                            "0 /user/hand/right/input/trigger/value  1\n"
+                            "0 /user/hand/right/input/squeeze/value  0.5\n"
+                            "0 /user/hand/left/input/trigger/value  0.5\n"
+                            "0 /user/hand/left/input/squeeze/value  0.5\n"
+                            "0 /user/hand/left/input/x/touch  1\n";
+
+static const char* actionManifest = R"({
+	"default_bindings": [ { "controller_type": "oculus_touch", "binding_url": "bindings_touch.json" } ],
+	"action_sets": [ { "name": "/actions/main", "usage": "leftright" } ],
+	"actions": [
+		{ "name": "/actions/main/in/trigger", "type": "boolean" },
+		{ "name": "/actions/main/in/squeeze", "type": "vector1" },
+		{ "name": "/actions/main/in/hand_right", "type": "pose" },
+		{ "name": "/actions/main/in/tip_right", "type": "pose" },
+		{ "name": "/actions/main/in/skeleton_left", "type": "skeleton", "skeleton": "/skeleton/hand/left" }
+	]
+})";
+
+static const char* touchBindings = R"({
+	"controller_type": "oculus_touch",
+	"bindings": {
+		"/actions/main": {
+			"sources": [
+				{ "path": "/user/hand/right/input/trigger", "mode": "button", "inputs": { "click": { "output": "/actions/main/in/trigger" } } },
+				{ "path": "/user/hand/right/input/grip", "mode": "trigger", "inputs": { "pull": { "output": "/actions/main/in/squeeze" } } }
+			],
+			"poses": [
+				{ "path": "/user/hand/right/pose/raw", "output": "/actions/main/in/hand_right" },
+				{ "path": "/user/hand/right/pose/tip", "output": "/actions/main/in/tip_right" }
+			],
+			"skeleton": [ { "path": "/user/hand/left/input/skeleton/left", "output": "/actions/main/in/skeleton_left" } ]
+		}
+	}
+})";
+
+/**
+ * The action manifest and bindings, written out to a temporary directory for SetActionManifestPath.
+ */
+class ManifestFiles {
+public:
+	ManifestFiles()
+	{
+		char dirname[] = "/tmp/oc_benchmark_XXXXXX";
+		OC_TEST_CHECK(mkdtemp(dirname));
+		directory = dirname;
+
+		Write("actions.json", actionManifest);
+		Write("bindings_touch.json", touchBindings);
+	}
+
+	~ManifestFiles()
+	{
+		for (const std::string& file : files)
+			unlink(file.c_str());
+		rmdir(directory.c_str());
+	}
+
+	std::string ManifestPath() const { return directory + "/actions.json"; }
+
+private:
+	void Write(const char* name, const char* contents)
+	{
+		std::string path = directory + "/" + name;
+		FILE* file = fopen(path.c_str(), "w");
+		OC_TEST_CHECKF(file, "Could not create %s", path.c_str());
+		fputs(contents, file);
+		fclose(file);
+		files.push_back(path);
+	}
+
+	std::string directory;
+	std::vector<std::string> files;
+};
+
+struct Actions {
+	vr::VRActionSetHandle_t main = vr::k_ulInvalidActionSetHandle;
+	vr::VRActionHandle_t trigger = vr::k_ulInvalidActionHandle;
+	vr::VRActionHandle_t squeeze = vr::k_ulInvalidActionHandle;
+	vr::VRActionHandle_t handRight = vr::k_ulInvalidActionHandle;
+	vr::VRActionHandle_t tipRight = vr::k_ulInvalidActionHandle;
+	vr::VRActionHandle_t skeletonLeft = vr::k_ulInvalidActionHandle;
+};
+
+static Actions LoadActions(IVRInput* input, const ManifestFiles& manifest)
+{
+	OC_TEST_CHECK(input->SetActionManifestPath(manifest.ManifestPath().c_str()) == vr::VRInputError_None);
+
+	Actions actions;
+	OC_TEST_CHECK(input->GetActionSetHandle("/actions/main", &actions.main) == vr::VRInputError_None);
+	OC_TEST_CHECK(input->GetActionHandle("/actions/main/in/trigger", &actions.trigger) == vr::VRInputError_None);
+	OC_TEST_CHECK(input->GetActionHandle("/actions/main/in/squeeze", &actions.squeeze) == vr::VRInputError_None);
+	OC_TEST_CHECK(input->GetActionHandle("/actions/main/in/hand_right", &actions.handRight) == vr::VRInputError_None);
+	OC_TEST_CHECK(input->GetActionHandle("/actions/main/in/tip_right", &actions.tipRight) == vr::VRInputError_None);
+	OC_TEST_CHECK(input->GetActionHandle("/actions/main/in/skeleton_left", &actions.skeletonLeft) == vr::VRInputError_None);
+	return actions;
+}
+
+static void RunFrame(HeadlessHarness& harness, IVRCompositor* compositor)
+{
+	vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
+	OC_TEST_CHECK(compositor->WaitGetPoses(poses, vr::k_unMaxTrackedDeviceCount, nullptr, 0) == vr::IVRCompositor_028::VRCompositorError_None);
+	OC_TEST_CHECK(compositor->Submit(vr::Eye_Left, harness.EyeTexture()) == vr::IVRCompositor_028::VRCompositorError_None);
+	OC_TEST_CHECK(compositor->Submit(vr::Eye_Right, harness.EyeTexture()) == vr::IVRCompositor_028::VRCompositorError_None);
+}
+
+static uint32_t GetFrameIndex(IVRCompositor* compositor)
+{
+	vr::Compositor_FrameTiming timing = {};
+	timing.m_nSize = sizeof(timing);
+	OC_TEST_CHECK(compositor->GetFrameTiming(&timing, 0));
+	return timing.m_nFrameIndex;
+}
+
+// ---------------  Benchmarks   --------------- //
+
+// The ranges the tracked device properties are allocated in, from vrtypes.h. Reading every ID in these covers
+// every property OpenComposite knows about, plus the gaps between them which are all misses.
+static const struct {
+	int first, last;
+} propertyRanges[] = {
+	{ 1000, 1054 },
+	{ 2000, 2309 },
+	{ 3000, 3007 },
+	{ 4000, 4008 },
+	{ 5000, 5152 },
+	{ 6000, 6008 },
+	{ 7000, 7002 },
+};
+
+static uint64_t CountProperties()
+{
+	uint64_t count = 0;
+	for (const auto& range : propertyRanges)
+		count += range.last - range.first + 1;
+	return count;
+}
+
+template <typename F>
+static void ForEachProperty(F&& function)
+{
+	for (const auto& range : propertyRanges) {
+		for (int prop = range.first; prop <= range.last; prop++)
+			function((vr::ETrackedDeviceProperty)prop);
+	}
+}
+
+static void RunPropertyBenchmarks(Benchmarks& benchmarks, IVRSystem* system, vr::TrackedDeviceIndex_t device, const std::string& deviceName)
+{
+	// Every property is read with every type, as games often probe for properties they're not sure exist
+	const uint64_t count = CountProperties();
+	const std::string prefix = "GetTrackedDeviceProperty/" + deviceName + "/";
+
+	benchmarks.Run(prefix + "Bool", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			vr::ETrackedPropertyError error;
+			system->GetBoolTrackedDeviceProperty(device, prop, &error);
+		});
+	});
+	benchmarks.Run(prefix + "Float", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			vr::ETrackedPropertyError error;
+			system->GetFloatTrackedDeviceProperty(device, prop, &error);
+		});
+	});
+	benchmarks.Run(prefix + "Int32", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			vr::ETrackedPropertyError error;
+			system->GetInt32TrackedDeviceProperty(device, prop, &error);
+		});
+	});
+	benchmarks.Run(prefix + "Uint64", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			vr::ETrackedPropertyError error;
+			system->GetUint64TrackedDeviceProperty(device, prop, &error);
+		});
+	});
+	benchmarks.Run(prefix + "Matrix34", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			vr::ETrackedPropertyError error;
+			system->GetMatrix34TrackedDeviceProperty(device, prop, &error);
+		});
+	});
+	benchmarks.Run(prefix + "String", 100, count, [&] {
+		ForEachProperty([&](vr::ETrackedDeviceProperty prop) {
+			char value[vr::k_unMaxPropertyStringSize];
+			vr::ETrackedPropertyError error;
+			system->GetStringTrackedDeviceProperty(device, prop, value, sizeof(value), &error);
+		});
+	});
+}
+
+static void RunSystemBenchmarks(Benchmarks& benchmarks, HeadlessHarness& harness, IVRSystem* system)
+{
+	benchmarks.Run("VR_GetGenericInterface", [&] {
+		harness.GetInterface("IVRSystem_022");
+	});
+
+	benchmarks.Run("GetDeviceToAbsoluteTrackingPose", [&] {
+		vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount];
+		system->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, 0, poses, vr::k_unMaxTrackedDeviceCount);
+	});
+
+	vr::TrackedDeviceIndex_t rightHand = system->GetTrackedDeviceIndexForControllerRole(vr::TrackedControllerRole_RightHand);
+	OC_TEST_CHECKF(rightHand != vr::k_unTrackedDeviceIndexInvalid, "The right controller isn't connected");
+
+	benchmarks.Run("GetControllerState", [&] {
+		vr::VRControllerState_t state;
+		system->GetControllerState(rightHand, &state, sizeof(state));
+	});
+
+	benchmarks.Run("PollNextEvent", [&] {
+		vr::VREvent_t event;
+		system->PollNextEvent(&event, sizeof(event));
+	});
+
+	RunPropertyBenchmarks(benchmarks, system, vr::k_unTrackedDeviceIndex_Hmd, "HMD");
+	RunPropertyBenchmarks(benchmarks, system, rightHand, "Controller");
+}
+
+static void RunInputBenchmarks(Benchmarks& benchmarks, IVRInput* input, const Actions& actions)
+{
+	vr::IVRInput_010::VRActiveActionSet_t activeSet = {};
+	activeSet.ulActionSet = actions.main;
+
+	benchmarks.Run("UpdateActionState", [&] {
+		input->UpdateActionState(&activeSet, sizeof(activeSet), 1);
+	});
+
+	benchmarks.Run("GetDigitalActionData", [&] {
+		vr::IVRInput_010::InputDigitalActionData_t data;
+		input->GetDigitalActionData(actions.trigger, &data, sizeof(data), vr::k_ulInvalidInputValueHandle);
+	});
+
+	benchmarks.Run("GetAnalogActionData", [&] {
+		vr::IVRInput_010::InputAnalogActionData_t data;
+		input->GetAnalogActionData(actions.squeeze, &data, sizeof(data), vr::k_ulInvalidInputValueHandle);
+	});
+
+	benchmarks.Run("GetPoseActionDataForNextFrame", [&] {
+		vr::IVRInput_010::InputPoseActionData_t data;
+		input->GetPoseActionDataForNextFrame(actions.handRight, vr::TrackingUniverseStanding, &data, sizeof(data),
+		    vr::k_ulInvalidInputValueHandle);
+	});
+
+	// The headless runtime has no hand tracking, so these estimate the skeleton from the controller's curl values
+	const struct {
+		const char* name;
+		vr::IVRInput_010::EVRSkeletalTransformSpace space;
+		vr::EVRSkeletalMotionRange range;
+	} skeletonQueries[] = {
+		{ "GetSkeletalBoneData/Parent", vr::IVRInput_010::VRSkeletalTransformSpace_Parent, vr::VRSkeletalMotionRange_WithController },
+		{ "GetSkeletalBoneData/Model", vr::IVRInput_010::VRSkeletalTransformSpace_Model, vr::VRSkeletalMotionRange_WithController },
+		{ "GetSkeletalBoneData/ModelWithoutController", vr::IVRInput_010::VRSkeletalTransformSpace_Model, vr::VRSkeletalMotionRange_WithoutController },
+	};
+
+	for (const auto& query : skeletonQueries) {
+		benchmarks.Run(query.name, [&] {
+			vr::VRBoneTransform_t bones[31];
+			input->GetSkeletalBoneData(actions.skeletonLeft, query.space, query.range, bones, 31);
+		});
+	}
+}
+
+// The interaction profile's component transforms and reference poses, which are looked up on every call
+static void RunComponentBenchmarks(Benchmarks& benchmarks, IVRInput* input, IVRRenderModels* renderModels, const Actions& actions)
+{
+	// Bound to the tip component, so this applies its transform to the hand pose
+	benchmarks.Run("GetPoseActionDataForNextFrame/Tip", [&] {
+		vr::IVRInput_010::InputPoseActionData_t data;
+		input->GetPoseActionDataForNextFrame(actions.tipRight, vr::TrackingUniverseStanding, &data, sizeof(data),
+		    vr::k_ulInvalidInputValueHandle);
+	});
+
+	benchmarks.Run("GetComponentStateForDevicePath/Tip", [&] {
+		vr::RenderModel_ComponentState_t state;
+		renderModels->GetComponentStateForDevicePath("renderRightHand", "tip", vr::k_ulInvalidInputValueHandle, nullptr, &state);
+	});
+
+	const struct {
+		const char* name;
+		vr::IVRInput_010::EVRSkeletalReferencePose pose;
+	} referencePoses[] = {
+		{ "BindPose", vr::IVRInput_010::VRSkeletalReferencePose_BindPose },
+		{ "OpenHand", vr::IVRInput_010::VRSkeletalReferencePose_OpenHand },
+		{ "Fist", vr::IVRInput_010::VRSkeletalReferencePose_Fist },
+		{ "GripLimit", vr::IVRInput_010::VRSkeletalReferencePose_GripLimit },
+	};
+
+	// In parent space, so this is only the lookup and not the conversion to model space
+	for (const auto& reference : referencePoses) {
+		benchmarks.Run(std::string("GetSkeletalReferenceTransforms/") + reference.name, [&] {
+			vr::VRBoneTransform_t bones[31];
+			input->GetSkeletalReferenceTransforms(actions.skeletonLeft, vr::IVRInput_010::VRSkeletalTransformSpace_Parent,
+			    reference.pose, bones, 31);
+		});
+	}
+}
+
+static void RunFrameBenchmarks(Benchmarks& benchmarks, HeadlessHarness& harness, IVRCompositor* compositor, IVROverlay* overlay)
+{
+	// A frame blits the eye images on the GPU (or lavapipe), so they're much slower than the other calls
+	const uint64_t frameDivisor = 100;
+
+	benchmarks.Run("Frame", frameDivisor, 1, [&] {
+		RunFrame(harness, compositor);
+	});
+
+	// The runtime accepts 16 layers, one of which is the game's projection layer
+	const int overlayCounts[] = { 1, 4, 15 };
+	std::vector<vr::VROverlayHandle_t> overlays;
+
+	for (int count : overlayCounts) {
+		while ((int)overlays.size() < count) {
+			std::string key = "benchmark." + std::to_string(overlays.size());
+			vr::VROverlayHandle_t handle = vr::k_ulOverlayHandleInvalid;
+			OC_TEST_CHECK(overlay->CreateOverlay(key.c_str(), key.c_str(), &handle) == vr::VROverlayError_None);
+
+			// Spread them out in front of the user
+			vr::HmdMatrix34_t transform = { {
+			    { 1, 0, 0, -1.0f + 0.15f * (float)overlays.size() },
+			    { 0, 1, 0, 1.5f },
+			    { 0, 0, 1, -2.0f },
+			} };
+			OC_TEST_CHECK(overlay->SetOverlayTransformAbsolute(handle, vr::TrackingUniverseStanding, &transform) == vr::VROverlayError_None);
+			OC_TEST_CHECK(overlay->SetOverlayWidthInMeters(handle, 0.1f) == vr::VROverlayError_None);
+			OC_TEST_CHECK(overlay->SetOverlayTexture(handle, harness.EyeTexture()) == vr::VROverlayError_None);
+			OC_TEST_CHECK(overlay->ShowOverlay(handle) == vr::VROverlayError_None);
+			overlays.push_back(handle);
+		}
+
+		benchmarks.Run("Frame/Overlays_" + std::to_string(count), frameDivisor, 1, [&] {
+			RunFrame(harness, compositor);
+		});
+	}
+
+	for (vr::VROverlayHandle_t handle : overlays)
+		overlay->DestroyOverlay(handle);
+}
+
+// ---------------  Main   --------------- //
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: OCBenchmark [--iterations N] [--filter TEXT] [--json FILE]\n");
+}
+
+int main(int argc, char** argv)
+{
+	uint64_t iterations = 10000;
+	std::string filter;
+	std::string jsonFilename;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (i + 1 >= argc) {
+			PrintUsage();
+			return 1;
+		}
+
+		if (arg == "--iterations") {
+			iterations = strtoull(argv[++i], nullptr, 10);
+		} else if (arg == "--filter") {
+			filter = argv[++i];
+		} else if (arg == "--json") {
+			jsonFilename = argv[++i];
+		} else {
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	HeadlessHarness harness(script);
+	ManifestFiles manifest;
+
+	IVRSystem* system = harness.Get<IVRSystem>("IVRSystem_022");
+	IVRCompositor* compositor = harness.Get<IVRCompositor>("IVRCompositor_028");
+	IVRInput* input = harness.Get<IVRInput>("IVRInput_010");
+	IVROverlay* overlay = harness.Get<IVROverlay>("IVROverlay_027");
+	IVRRenderModels* renderModels = harness.Get<IVRRenderModels>("IVRRenderModels_006");
+
+	// Like a game, load the actions before the first frame
+	Actions actions = LoadActions(input, manifest);
+	compositor->SetTrackingSpace(vr::TrackingUniverseStanding);
+
+	// Get OpenComposite to restart its session on our device, and for the controllers to show up
+	for (int frames = 0; GetFrameIndex(compositor) < 10; frames++) {
+		OC_TEST_CHECKF(frames < 200, "Only %u frames were ended after %d frames", GetFrameIndex(compositor), frames);
+		RunFrame(harness, compositor);
+	}
+
+	Benchmarks benchmarks(harness, iterations, filter);
+	RunSystemBenchmarks(benchmarks, harness, system);
+	RunInputBenchmarks(benchmarks, input, actions);
+	RunComponentBenchmarks(benchmarks, input, renderModels, actions);
+	RunFrameBenchmarks(benchmarks, harness, compositor, overlay);
+
+	if (jsonFilename.empty()) {
+		benchmarks.WriteJson(stdout);
+	} else {
+		FILE* file = fopen(jsonFilename.c_str(), "w");
+		OC_TEST_CHECKF(file, "Could not open %s", jsonFilename.c_str());
+		benchmarks.WriteJson(file);
+		fclose(file);
+	}
+
+	return 0;
+}
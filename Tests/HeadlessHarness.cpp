@@ -0,0 +1,250 @@
+#include "HeadlessHarness.h"
+
+#include <dlfcn.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+void oc_test_fail(const char* file, int line, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	fprintf(stderr, "FAILED at %s:%d: ", file, line);
+	vfprintf(stderr, format, args);
+	fprintf(stderr, "\n");
+	va_end(args);
+
+	exit(1);
+}
+
+HeadlessHarness::HeadlessHarness(const std::string& script)
+{
+	// These have to be set before OpenComposite creates its OpenXR instance. Anything the user has set
+	// explicitly is left alone, so the tests can also be pointed at a different runtime.
+	setenv("XR_RUNTIME_JSON", OC_TEST_RUNTIME_JSON, false);
+	setenv("OC_HEADLESS_FRAME_RATE", "0", false);
+
+	if (!script.empty()) {
+		char filename[] = "/tmp/oc_headless_script_XXXXXX";
+		int fd = mkstemp(filename);
+		OC_TEST_CHECKF(fd != -1, "Could not create the script file: %s", strerror(errno));
+		OC_TEST_CHECK(write(fd, script.data(), script.size()) == (ssize_t)script.size());
+		close(fd);
+
+		scriptFilename = filename;
+		setenv("OC_HEADLESS_SCRIPT", filename, true);
+	}
+
+	vrclient = dlopen(OC_TEST_VRCLIENT_PATH, RTLD_NOW | RTLD_LOCAL);
+	OC_TEST_CHECKF(vrclient, "Could not load vrclient: %s", dlerror());
+
+	auto initInternal = (VR_InitInternal2_t)dlsym(vrclient, "VR_InitInternal2");
+	getGenericInterface = (VR_GetGenericInterface_t)dlsym(vrclient, "VR_GetGenericInterface");
+	shutdownInternal = (VR_ShutdownInternal_t)dlsym(vrclient, "VR_ShutdownInternal");
+	OC_TEST_CHECK(initInternal && getGenericInterface && shutdownInternal);
+
+	vr::EVRInitError error = vr::VRInitError_None;
+	initInternal(&error, vr::VRApplication_Scene, nullptr);
+	OC_TEST_CHECKF(error == vr::VRInitError_None, "VR_InitInternal2 failed: %d", error);
+
+	// The runtime has been loaded by now. The loader opens it locally, so look it up by name - RTLD_NOLOAD means
+	// this fails rather than loading a second copy if a different runtime is in use.
+	void* runtime = dlopen(OC_TEST_RUNTIME_LIBRARY, RTLD_NOW | RTLD_LOCAL | RTLD_NOLOAD);
+	if (runtime)
+		getRuntimeCallCount = (OCHeadlessGetCallCount_t)dlsym(runtime, "OCHeadlessGetCallCount");
+
+	CreateVulkanTexture(256, 256);
+}
+
+HeadlessHarness::~HeadlessHarness()
+{
+	// Shut down OpenComposite first, as its session is using our Vulkan device
+	shutdownInternal();
+	DestroyVulkanTexture();
+
+	// Don't dlclose vrclient - like the real openvr_api, we can't be sure nothing it started is still running.
+
+	if (!scriptFilename.empty())
+		unlink(scriptFilename.c_str());
+}
+
+void* HeadlessHarness::GetInterface(const char* version)
+{
+	vr::EVRInitError error = vr::VRInitError_None;
+	void* result = getGenericInterface(version, &error);
+	OC_TEST_CHECKF(result && error == vr::VRInitError_None, "Could not get interface %s: %d", version, error);
+	return result;
+}
+
+int64_t HeadlessHarness::RuntimeCallCount() const
+{
+	if (!getRuntimeCallCount)
+		return -1;
+	return (int64_t)getRuntimeCallCount();
+}
+
+void HeadlessHarness::CreateVulkanTexture(uint32_t width, uint32_t height)
+{
+	VkApplicationInfo appInfo = { VK_STRUCTURE_TYPE_APPLICATION_INFO };
+	appInfo.pApplicationName = "OpenComposite tests";
+	appInfo.apiVersion = VK_API_VERSION_1_0;
+
+	VkInstanceCreateInfo instanceInfo = { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
+	instanceInfo.pApplicationInfo = &appInfo;
+	OC_TEST_CHECK_VK(vkCreateInstance(&instanceInfo, nullptr, &instance));
+
+	// The headless runtime always asks for the first device, and OpenComposite checks the game is using
+	// the same one as the runtime.
+	uint32_t deviceCount = 1;
+	VkResult result = vkEnumeratePhysicalDevices(instance, &deviceCount, &physicalDevice);
+	OC_TEST_CHECKF((result == VK_SUCCESS || result == VK_INCOMPLETE) && deviceCount == 1, "No Vulkan devices available (%d)", result);
+
+	// The compositor blits from our image, so we need a graphics queue
+	uint32_t familyCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, nullptr);
+	std::vector<VkQueueFamilyProperties> families(familyCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &familyCount, families.data());
+
+	queueFamily = familyCount;
+	for (uint32_t i = 0; i < familyCount; i++) {
+		if (families[i].queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+			queueFamily = i;
+			break;
+		}
+	}
+	OC_TEST_CHECKF(queueFamily != familyCount, "No Vulkan graphics queue available");
+
+	float priority = 1.0f;
+	VkDeviceQueueCreateInfo queueInfo = { VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+	queueInfo.queueFamilyIndex = queueFamily;
+	queueInfo.queueCount = 1;
+	queueInfo.pQueuePriorities = &priority;
+
+	VkDeviceCreateInfo deviceInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+	deviceInfo.queueCreateInfoCount = 1;
+	deviceInfo.pQueueCreateInfos = &queueInfo;
+	OC_TEST_CHECK_VK(vkCreateDevice(physicalDevice, &deviceInfo, nullptr, &device));
+	vkGetDeviceQueue(device, queueFamily, 0, &queue);
+
+	VkImageCreateInfo imageInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+	imageInfo.imageType = VK_IMAGE_TYPE_2D;
+	imageInfo.format = VK_FORMAT_R8G8B8A8_SRGB;
+	imageInfo.extent = { width, height, 1 };
+	imageInfo.mipLevels = 1;
+	imageInfo.arrayLayers = 1;
+	imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+	imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+	imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+	imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	OC_TEST_CHECK_VK(vkCreateImage(device, &imageInfo, nullptr, &image));
+
+	VkMemoryRequirements requirements;
+	vkGetImageMemoryRequirements(device, image, &requirements);
+
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+	vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	uint32_t memoryType = memoryProperties.memoryTypeCount;
+	for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+		if ((requirements.memoryTypeBits & (1u << i)) == 0)
+			continue;
+
+		// Prefer device-local memory, but take whatever's allowed
+		if (memoryType == memoryProperties.memoryTypeCount)
+			memoryType = i;
+		if (memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT) {
+			memoryType = i;
+			break;
+		}
+	}
+	OC_TEST_CHECKF(memoryType != memoryProperties.memoryTypeCount, "No usable memory type for the eye texture");
+
+	VkMemoryAllocateInfo allocInfo = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO };
+	allocInfo.allocationSize = requirements.size;
+	allocInfo.memoryTypeIndex = memoryType;
+	OC_TEST_CHECK_VK(vkAllocateMemory(device, &allocInfo, nullptr, &memory));
+	OC_TEST_CHECK_VK(vkBindImageMemory(device, image, memory, 0));
+
+	// Clear the image to grey and leave it in the layout OpenVR requires for submitted images
+	VkCommandPool pool;
+	VkCommandPoolCreateInfo poolInfo = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+	poolInfo.queueFamilyIndex = queueFamily;
+	OC_TEST_CHECK_VK(vkCreateCommandPool(device, &poolInfo, nullptr, &pool));
+
+	VkCommandBuffer commandBuffer;
+	VkCommandBufferAllocateInfo bufferInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+	bufferInfo.commandPool = pool;
+	bufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+	bufferInfo.commandBufferCount = 1;
+	OC_TEST_CHECK_VK(vkAllocateCommandBuffers(device, &bufferInfo, &commandBuffer));
+
+	VkCommandBufferBeginInfo beginInfo = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	OC_TEST_CHECK_VK(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+
+	VkImageSubresourceRange range = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+	VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image;
+	barrier.subresourceRange = range;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkClearColorValue grey = { { 0.5f, 0.5f, 0.5f, 1.0f } };
+	vkCmdClearColorImage(commandBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, &grey, 1, &range);
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	OC_TEST_CHECK_VK(vkEndCommandBuffer(commandBuffer));
+
+	VkSubmitInfo submitInfo = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &commandBuffer;
+	OC_TEST_CHECK_VK(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE));
+	OC_TEST_CHECK_VK(vkQueueWaitIdle(queue));
+
+	vkDestroyCommandPool(device, pool, nullptr);
+
+	vulkanData.m_nImage = (uint64_t)image;
+	vulkanData.m_pDevice = device;
+	vulkanData.m_pPhysicalDevice = physicalDevice;
+	vulkanData.m_pInstance = instance;
+	vulkanData.m_pQueue = queue;
+	vulkanData.m_nQueueFamilyIndex = queueFamily;
+	vulkanData.m_nWidth = width;
+	vulkanData.m_nHeight = height;
+	vulkanData.m_nFormat = VK_FORMAT_R8G8B8A8_SRGB;
+	vulkanData.m_nSampleCount = 1;
+
+	eyeTexture.handle = &vulkanData;
+	eyeTexture.eType = vr::TextureType_Vulkan;
+	eyeTexture.eColorSpace = vr::ColorSpace_Auto;
+}
+
+void HeadlessHarness::DestroyVulkanTexture()
+{
+	if (device) {
+		vkDeviceWaitIdle(device);
+		vkDestroyImage(device, image, nullptr);
+		vkFreeMemory(device, memory, nullptr);
+		vkDestroyDevice(device, nullptr);
+	}
+
+	if (instance)
+		vkDestroyInstance(instance, nullptr);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "generated/interfaces/vrtypes.h"
+
+#include <vulkan/vulkan.h>
+
+#include <string>
+
+// Checks for the tests, which print where they failed and exit. The tests have nothing to clean up that the
+// OS won't do for them, and OpenComposite aborts the same way when something goes wrong inside it.
+[[noreturn]] void oc_test_fail(const char* file, int line, const char* format, ...);
+
+#define OC_TEST_CHECK(expression)                                              \
+	do {                                                                       \
+		if (!(expression)) {                                                   \
+			oc_test_fail(__FILE__, __LINE__, "Check failed: %s", #expression); \
+		}                                                                      \
+	} while (false)
+
+#define OC_TEST_CHECKF(expression, ...)                    \
+	do {                                                   \
+		if (!(expression)) {                               \
+			oc_test_fail(__FILE__, __LINE__, __VA_ARGS__); \
+		}                                                  \
+	} while (false)
+
+#define OC_TEST_CHECK_VK(expression)                                                                         \
+	do {                                                                                                     \
+		VkResult oc_test_vk_result = (expression);                                                           \
+		if (oc_test_vk_result != VK_SUCCESS) {                                                               \
+			oc_test_fail(__FILE__, __LINE__, "Vulkan call failed (%d): %s", oc_test_vk_result, #expression); \
+		}                                                                                                    \
+	} while (false)
+
+/**
+ * Runs OpenComposite against the headless OpenXR runtime, from the point of view of a game.
+ *
+ * This loads vrclient from the build directory and initialises it as a scene application, with XR_RUNTIME_JSON
+ * pointing at the headless runtime. The game's side of things is a Vulkan device on the same physical device the
+ * runtime picks (lavapipe on a machine without a GPU) and a single placeholder image that can be submitted for
+ * both eyes.
+ *
+ * Only one harness can exist at a time, since OpenComposite only supports being initialised once per process.
+ */
+class HeadlessHarness {
+public:
+	/**
+	 * Start OpenComposite. If script is non-empty, it's written out and used as the OC_HEADLESS_SCRIPT. The frame
+	 * rate is unthrottled unless OC_HEADLESS_FRAME_RATE is already set.
+	 */
+	explicit HeadlessHarness(const std::string& script = "");
+	~HeadlessHarness();
+
+	HeadlessHarness(const HeadlessHarness&) = delete;
+	HeadlessHarness& operator=(const HeadlessHarness&) = delete;
+
+	/**
+	 * Get an interface by its version string (eg IVRSystem_022), failing the test if it's not available.
+	 */
+	void* GetInterface(const char* version);
+
+	template <typename T>
+	T* Get(const char* version)
+	{
+		return (T*)GetInterface(version);
+	}
+
+	/**
+	 * A texture for IVRCompositor::Submit. It's left in the layout OpenVR requires of submitted Vulkan
+	 * images, and is never written to after it's created.
+	 */
+	const vr::Texture_t* EyeTexture() const { return &eyeTexture; }
+
+	uint32_t TextureWidth() const { return vulkanData.m_nWidth; }
+	uint32_t TextureHeight() const { return vulkanData.m_nHeight; }
+
+	/**
+	 * The number of OpenXR calls the headless runtime has served so far, or -1 if the tests aren't running against
+	 * the headless runtime (eg, XR_RUNTIME_JSON was set to something else).
+	 */
+	int64_t RuntimeCallCount() const;
+
+private:
+	void CreateVulkanTexture(uint32_t width, uint32_t height);
+	void DestroyVulkanTexture();
+
+	void* vrclient = nullptr;
+	std::string scriptFilename;
+
+	typedef uint32_t (*VR_InitInternal2_t)(vr::EVRInitError* peError, vr::EVRApplicationType eApplicationType, const char* pStartupInfo);
+	typedef void* (*VR_GetGenericInterface_t)(const char* pchInterfaceVersion, vr::EVRInitError* peError);
+	typedef void (*VR_ShutdownInternal_t)();
+
+	VR_GetGenericInterface_t getGenericInterface = nullptr;
+	VR_ShutdownInternal_t shutdownInternal = nullptr;
+
+	typedef uint64_t (*OCHeadlessGetCallCount_t)();
+	OCHeadlessGetCallCount_t getRuntimeCallCount = nullptr;
+
+	VkInstance instance = VK_NULL_HANDLE;
+	VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+	VkDevice device = VK_NULL_HANDLE;
+	VkQueue queue = VK_NULL_HANDLE;
+	uint32_t queueFamily = 0;
+	VkImage image = VK_NULL_HANDLE;
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+
+	vr::VRVulkanTextureData_t vulkanData = {};
+	vr::Texture_t eyeTexture = {};
+};
@@ -0,0 +1,98 @@
+//
+// Runs a game's frame loop through OpenComposite against the headless runtime, and checks the frames reach the
+// runtime and the headset's scripted pose comes back out through OpenVR.
+//
+
+#include "HeadlessHarness.h"
+
+#include "generated/interfaces/IVRCompositor_028.h"
+#include "generated/interfaces/IVRSystem_022.h"
+
+#include <cmath>
+#include <cstdio>
+
+using vr::IVRCompositor_028::IVRCompositor;
+using vr::IVRSystem_022::IVRSystem;
+
+// The headset sits still, turned 90 degrees to the left
+static const char* script = "0 /user/head  0.25 1.5 -0.5  0 0.7071068 0 0.7071068\n";
+
+static const float expectedHeadPose[3][4] = {
+	{ 0, 0, 1, 0.25f },
+	{ 0, 1, 0, 1.5f },
+	{ -1, 0, 0, -0.5f },
+};
+
+static void CheckHeadPose(const vr::TrackedDevicePose_t& pose, const char* source)
+{
+	OC_TEST_CHECKF(pose.bDeviceIsConnected && pose.bPoseIsValid, "%s: the headset pose isn't valid", source);
+	OC_TEST_CHECKF(pose.eTrackingResult == vr::TrackingResult_Running_OK, "%s: wrong tracking result %d", source, pose.eTrackingResult);
+
+	for (int row = 0; row < 3; row++) {
+		for (int col = 0; col < 4; col++) {
+			float actual = pose.mDeviceToAbsoluteTracking.m[row][col];
+			float expected = expectedHeadPose[row][col];
+			OC_TEST_CHECKF(fabsf(actual - expected) < 1e-4f, "%s: headset matrix [%d][%d] is %f, expected %f", source, row, col, actual, expected);
+		}
+	}
+}
+
+static void RunFrame(HeadlessHarness& harness, IVRCompositor* compositor, vr::TrackedDevicePose_t* poses)
+{
+	OC_TEST_CHECK(compositor->WaitGetPoses(poses, vr::k_unMaxTrackedDeviceCount, nullptr, 0) == vr::IVRCompositor_028::VRCompositorError_None);
+	OC_TEST_CHECK(compositor->Submit(vr::Eye_Left, harness.EyeTexture()) == vr::IVRCompositor_028::VRCompositorError_None);
+	OC_TEST_CHECK(compositor->Submit(vr::Eye_Right, harness.EyeTexture()) == vr::IVRCompositor_028::VRCompositorError_None);
+}
+
+static uint32_t GetFrameIndex(IVRCompositor* compositor)
+{
+	vr::Compositor_FrameTiming timing = {};
+	timing.m_nSize = sizeof(timing);
+	OC_TEST_CHECK(compositor->GetFrameTiming(&timing, 0));
+	return timing.m_nFrameIndex;
+}
+
+int main()
+{
+	HeadlessHarness harness(script);
+
+	IVRSystem* system = harness.Get<IVRSystem>("IVRSystem_022");
+	IVRCompositor* compositor = harness.Get<IVRCompositor>("IVRCompositor_028");
+
+	OC_TEST_CHECK(system->GetTrackedDeviceClass(vr::k_unTrackedDeviceIndex_Hmd) == vr::TrackedDeviceClass_HMD);
+
+	uint32_t width = 0, height = 0;
+	system->GetRecommendedRenderTargetSize(&width, &height);
+	OC_TEST_CHECKF(width > 0 && height > 0, "Invalid render target size %ux%u", width, height);
+
+	compositor->SetTrackingSpace(vr::TrackingUniverseStanding);
+
+	vr::TrackedDevicePose_t poses[vr::k_unMaxTrackedDeviceCount] = {};
+
+	// The first submit makes OpenComposite restart its session on our Vulkan device, and the new session then
+	// has to start running before any frames are ended.
+	int warmupFrames = 0;
+	while (GetFrameIndex(compositor) == 0) {
+		OC_TEST_CHECKF(warmupFrames < 100, "No frames were ended after %d frames", warmupFrames);
+		RunFrame(harness, compositor, poses);
+		warmupFrames++;
+	}
+
+	// From here on every frame should be ended
+	const int frameCount = 20;
+	uint32_t startIndex = GetFrameIndex(compositor);
+	for (int i = 0; i < frameCount; i++) {
+		RunFrame(harness, compositor, poses);
+		CheckHeadPose(poses[vr::k_unTrackedDeviceIndex_Hmd], "WaitGetPoses");
+	}
+	uint32_t endIndex = GetFrameIndex(compositor);
+	OC_TEST_CHECKF(endIndex - startIndex == frameCount, "Ran %d frames, but the frame index went from %u to %u", frameCount, startIndex, endIndex);
+
+	// Querying the pose outside the frame loop should give the same result
+	vr::TrackedDevicePose_t pose = {};
+	system->GetDeviceToAbsoluteTrackingPose(vr::TrackingUniverseStanding, 0, &pose, 1);
+	CheckHeadPose(pose, "GetDeviceToAbsoluteTrackingPose");
+
+	printf("Passed: %d warmup frames, %d checked frames\n", warmupFrames, frameCount);
+	return 0;
+}
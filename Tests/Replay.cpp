@@ -0,0 +1,803 @@
+//
+// Replays a capture of a game's OpenVR calls (see the captureOpenVRCalls option) through OpenComposite against the
+// headless runtime, and reports which calls returned something different to what the game saw, and how long each
+// method took compared to the capture.
+//
+// Only the methods registered in RegisterHandlers are replayed: the IVRSystem_022 display, pose, device and property
+// queries, and the IVRCompositor_028 frame loop. Every other call - along with any call whose arguments weren't
+// captured in full - is counted as skipped. Calls are compared byte-for-byte, so a capture is best replayed with the
+// same OC_HEADLESS_SCRIPT it was taken with (see --script). Submitted textures are replaced by the harness's
+// placeholder texture, as the game's graphics handles mean nothing outside its process.
+//
+// The times include a little overhead on both sides: the capture's include recording the arguments, and the
+// replay's include decoding them.
+//
+// Usage: OCReplay <capture> [--script FILE] [--json FILE]
+//
+// Exits with 1 if any of the replayed calls diverged from the capture.
+//
+
+#include "HeadlessHarness.h"
+
+#include "generated/interfaces/IVRCompositor_028.h"
+#include "generated/interfaces/IVRSystem_022.h"
+
+#include "Misc/CallCapture.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using vr::IVRCompositor_028::IVRCompositor;
+using vr::IVRSystem_022::IVRSystem;
+
+using Tag = CallCapture::Tag;
+
+// ---------------  Capture reading   --------------- //
+
+// See scripts/capture_tool.py for the format
+static constexpr uint8_t RECORD_METHOD = 1;
+static constexpr uint8_t RECORD_CALL = 2;
+
+static const uint8_t CAPTURE_MAGIC[8] = { 'O', 'C', 'C', 'A', 'P', 'T', 0, 1 };
+
+struct CapturedItem {
+	Tag tag;
+	std::vector<uint8_t> data;
+};
+
+struct CapturedCall {
+	uint16_t method = 0;
+	uint64_t startNs = 0;
+	uint32_t durationNs = 0;
+	std::vector<CapturedItem> items;
+};
+
+struct Capture {
+	std::vector<std::string> methods; // Indexed by method ID
+	std::vector<CapturedCall> calls;
+};
+
+static bool ReadCapture(const std::string& filename, Capture& capture)
+{
+	FILE* file = fopen(filename.c_str(), "rb");
+	if (!file) {
+		fprintf(stderr, "Could not open %s\n", filename.c_str());
+		return false;
+	}
+
+	std::vector<uint8_t> data;
+	uint8_t chunk[64 * 1024];
+	size_t length;
+	while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		data.insert(data.end(), chunk, chunk + length);
+	fclose(file);
+
+	if (data.size() < sizeof(CAPTURE_MAGIC) || memcmp(data.data(), CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0) {
+		fprintf(stderr, "%s is not an OpenComposite capture\n", filename.c_str());
+		return false;
+	}
+
+	size_t pos = sizeof(CAPTURE_MAGIC);
+	size_t end = data.size();
+
+	auto read = [&](auto& value) {
+		if (end - pos < sizeof(value))
+			return false;
+		memcpy(&value, &data[pos], sizeof(value));
+		pos += sizeof(value);
+		return true;
+	};
+	auto readBytes = [&](std::vector<uint8_t>& bytes, size_t count) {
+		if (end - pos < count)
+			return false;
+		bytes.assign(data.begin() + (ptrdiff_t)pos, data.begin() + (ptrdiff_t)(pos + count));
+		pos += count;
+		return true;
+	};
+
+	// The writer may have been stopped part-way through a record if the game crashed, in which case everything
+	// up to that record is replayed.
+	bool truncated = false;
+	while (pos < data.size()) {
+		uint8_t recordType = data[pos++];
+		end = data.size();
+
+		if (recordType == RECORD_METHOD) {
+			uint16_t id, nameLength;
+			std::vector<uint8_t> name;
+			if (!read(id) || !read(nameLength) || !readBytes(name, nameLength)) {
+				truncated = true;
+				break;
+			}
+
+			if (capture.methods.size() <= id)
+				capture.methods.resize(id + 1);
+			capture.methods[id].assign(name.begin(), name.end());
+		} else if (recordType == RECORD_CALL) {
+			CapturedCall call;
+			uint32_t payloadLength;
+			if (!read(call.method) || !read(call.startNs) || !read(call.durationNs) || !read(payloadLength) || end - pos < payloadLength) {
+				truncated = true;
+				break;
+			}
+
+			if (call.method >= capture.methods.size() || capture.methods[call.method].empty()) {
+				fprintf(stderr, "%s: call to undefined method %u at offset %zu\n", filename.c_str(), call.method, pos);
+				return false;
+			}
+
+			// Items can't run past the end of the payload
+			end = pos + payloadLength;
+			while (pos < end) {
+				CapturedItem item;
+				uint8_t tag;
+				uint32_t itemLength;
+				if (!read(tag) || !read(itemLength) || !readBytes(item.data, itemLength)) {
+					fprintf(stderr, "%s: malformed call record ending at offset %zu\n", filename.c_str(), end);
+					return false;
+				}
+				item.tag = (Tag)tag;
+				call.items.push_back(std::move(item));
+			}
+
+			capture.calls.push_back(std::move(call));
+		} else {
+			fprintf(stderr, "%s: unknown record type %u at offset %zu\n", filename.c_str(), recordType, pos - 1);
+			return false;
+		}
+	}
+
+	if (truncated)
+		fprintf(stderr, "Warning: %s is truncated\n", filename.c_str());
+
+	return true;
+}
+
+// ---------------  Replaying calls   --------------- //
+
+/**
+ * The arguments of a captured call, by their position in the method's parameter list. Asking for an argument in a
+ * form it wasn't captured in - such as a pointer whose contents weren't recorded - marks the call as invalid, and
+ * it's then skipped rather than replayed.
+ */
+class Args {
+public:
+	explicit Args(const CapturedCall& call)
+	    : call(call)
+	{
+	}
+
+	bool Valid() const { return valid; }
+
+	template <typename T>
+	T Value(size_t index)
+	{
+		T value{};
+		const CapturedItem* item = Get(index);
+		if (!item || item->tag != Tag::Value || item->data.size() != sizeof(T)) {
+			valid = false;
+			return value;
+		}
+
+		memcpy(&value, item->data.data(), sizeof(T));
+		return value;
+	}
+
+	/**
+	 * An array count. Counts too large to be real are most likely garbage alongside a null pointer, but are
+	 * treated as invalid anyway so the replay doesn't try to allocate them.
+	 */
+	uint32_t Count(size_t index)
+	{
+		uint32_t count = Value<uint32_t>(index);
+		if (count > MAX_COUNT) {
+			valid = false;
+			return 0;
+		}
+		return count;
+	}
+
+	/**
+	 * A const pointer argument, whose contents are copied into storage. Returns null if the game passed null.
+	 */
+	template <typename T>
+	const T* Pointer(size_t index, std::vector<T>& storage)
+	{
+		const CapturedItem* item = Get(index);
+		if (item && item->tag == Tag::Null)
+			return nullptr;
+
+		if (!item || item->tag != Tag::Value || item->data.empty() || item->data.size() % sizeof(T) != 0) {
+			valid = false;
+			return nullptr;
+		}
+
+		storage.resize(item->data.size() / sizeof(T));
+		memcpy(storage.data(), item->data.data(), item->data.size());
+		return storage.data();
+	}
+
+	/**
+	 * An output pointer. The game's buffer isn't captured, so this returns storage if the game passed a buffer,
+	 * or null if it didn't.
+	 */
+	template <typename T>
+	T* Output(size_t index, T* storage)
+	{
+		const CapturedItem* item = Get(index);
+		if (item && item->tag == Tag::Null)
+			return nullptr;
+
+		if (!item || item->tag != Tag::Opaque) {
+			valid = false;
+			return nullptr;
+		}
+		return storage;
+	}
+
+private:
+	static constexpr uint32_t MAX_COUNT = 64 * 1024;
+
+	const CapturedItem* Get(size_t index) const
+	{
+		// The arguments come first, followed by the outputs and return value
+		if (index >= call.items.size())
+			return nullptr;
+
+		const CapturedItem& item = call.items[index];
+		if (item.tag == Tag::Output || item.tag == Tag::Return || item.tag == Tag::ReturnString)
+			return nullptr;
+		return &item;
+	}
+
+	const CapturedCall& call;
+	bool valid = true;
+};
+
+/**
+ * What a replayed call wrote to its outputs and returned, recorded the same way CallCapture does so it can be
+ * compared to the capture.
+ */
+struct Replayed {
+	std::vector<std::vector<uint8_t>> outputs;
+	std::vector<uint8_t> result;
+	bool hasResult = false;
+
+	template <typename T>
+	void Output(const T* value, uint32_t count = 1)
+	{
+		if (value)
+			outputs.emplace_back((const uint8_t*)value, (const uint8_t*)(value + count));
+	}
+
+	template <typename T>
+	void Return(const T& value)
+	{
+		result.assign((const uint8_t*)&value, (const uint8_t*)&value + sizeof(T));
+		hasResult = true;
+	}
+
+	bool Matches(const CapturedCall& call) const
+	{
+		size_t output = 0;
+		bool foundResult = false;
+		for (const CapturedItem& item : call.items) {
+			if (item.tag == Tag::Output) {
+				if (output >= outputs.size() || outputs[output] != item.data)
+					return false;
+				output++;
+			} else if (item.tag == Tag::Return) {
+				if (!hasResult || result != item.data)
+					return false;
+				foundResult = true;
+			} else if (item.tag == Tag::ReturnString) {
+				// None of the replayed methods return strings
+				return false;
+			}
+		}
+		return output == outputs.size() && foundResult == hasResult;
+	}
+};
+
+/**
+ * Replays one call, returning false if it couldn't be replayed.
+ */
+typedef std::function<bool(Args& args, Replayed& out)> Handler;
+
+typedef std::map<std::string, Handler> Handlers;
+
+template <typename Interface, typename Result>
+static Handler NoArgs(Interface* iface, Result (Interface::*method)())
+{
+	return [iface, method](Args& args, Replayed& out) {
+		if constexpr (std::is_void_v<Result>)
+			(iface->*method)();
+		else
+			out.Return((iface->*method)());
+		return true;
+	};
+}
+
+// Methods which take a device index and return something about it
+template <typename Result>
+static Handler DeviceQuery(IVRSystem* system, Result (IVRSystem::*method)(vr::TrackedDeviceIndex_t))
+{
+	return [system, method](Args& args, Replayed& out) {
+		auto device = args.Value<vr::TrackedDeviceIndex_t>(0);
+		if (!args.Valid())
+			return false;
+		out.Return((system->*method)(device));
+		return true;
+	};
+}
+
+template <typename Result>
+static Handler PropertyQuery(IVRSystem* system, Result (IVRSystem::*method)(vr::TrackedDeviceIndex_t, vr::ETrackedDeviceProperty, vr::ETrackedPropertyError*))
+{
+	return [system, method](Args& args, Replayed& out) {
+		auto device = args.Value<vr::TrackedDeviceIndex_t>(0);
+		auto prop = args.Value<vr::ETrackedDeviceProperty>(1);
+		vr::ETrackedPropertyError errorStorage = vr::TrackedProp_Success;
+		vr::ETrackedPropertyError* error = args.Output(2, &errorStorage);
+		if (!args.Valid())
+			return false;
+
+		out.Return((system->*method)(device, prop, error));
+		out.Output(error);
+		return true;
+	};
+}
+
+template <typename Interface>
+static Handler PoseArrays(Interface* iface, vr::IVRCompositor_028::EVRCompositorError (Interface::*method)(vr::TrackedDevicePose_t*, uint32_t, vr::TrackedDevicePose_t*, uint32_t))
+{
+	return [iface, method](Args& args, Replayed& out) {
+		uint32_t renderCount = args.Count(1);
+		uint32_t gameCount = args.Count(3);
+		std::vector<vr::TrackedDevicePose_t> renderStorage(renderCount);
+		std::vector<vr::TrackedDevicePose_t> gameStorage(gameCount);
+		vr::TrackedDevicePose_t* render = args.Output(0, renderStorage.data());
+		vr::TrackedDevicePose_t* game = args.Output(2, gameStorage.data());
+		if (!args.Valid())
+			return false;
+
+		out.Return((iface->*method)(render, renderCount, game, gameCount));
+		out.Output(render, renderCount);
+		out.Output(game, gameCount);
+		return true;
+	};
+}
+
+static void RegisterSystemHandlers(Handlers& handlers, IVRSystem* system)
+{
+	const std::string prefix = "CVRSystem_022::";
+
+	handlers[prefix + "GetRecommendedRenderTargetSize"] = [system](Args& args, Replayed& out) {
+		uint32_t widthStorage = 0, heightStorage = 0;
+		uint32_t* width = args.Output(0, &widthStorage);
+		uint32_t* height = args.Output(1, &heightStorage);
+		if (!args.Valid())
+			return false;
+
+		system->GetRecommendedRenderTargetSize(width, height);
+		out.Output(width);
+		out.Output(height);
+		return true;
+	};
+
+	handlers[prefix + "GetProjectionMatrix"] = [system](Args& args, Replayed& out) {
+		auto eye = args.Value<vr::EVREye>(0);
+		auto nearZ = args.Value<float>(1);
+		auto farZ = args.Value<float>(2);
+		if (!args.Valid())
+			return false;
+
+		out.Return(system->GetProjectionMatrix(eye, nearZ, farZ));
+		return true;
+	};
+
+	handlers[prefix + "GetProjectionRaw"] = [system](Args& args, Replayed& out) {
+		auto eye = args.Value<vr::EVREye>(0);
+		float storage[4] = {};
+		float* sides[4];
+		for (int i = 0; i < 4; i++)
+			sides[i] = args.Output(1 + i, &storage[i]);
+		if (!args.Valid())
+			return false;
+
+		system->GetProjectionRaw(eye, sides[0], sides[1], sides[2], sides[3]);
+		for (float* side : sides)
+			out.Output(side);
+		return true;
+	};
+
+	handlers[prefix + "GetEyeToHeadTransform"] = [system](Args& args, Replayed& out) {
+		auto eye = args.Value<vr::EVREye>(0);
+		if (!args.Valid())
+			return false;
+
+		out.Return(system->GetEyeToHeadTransform(eye));
+		return true;
+	};
+
+	handlers[prefix + "GetDeviceToAbsoluteTrackingPose"] = [system](Args& args, Replayed& out) {
+		auto origin = args.Value<vr::ETrackingUniverseOrigin>(0);
+		auto predictedSeconds = args.Value<float>(1);
+		uint32_t count = args.Count(3);
+		std::vector<vr::TrackedDevicePose_t> storage(count);
+		vr::TrackedDevicePose_t* poses = args.Output(2, storage.data());
+		if (!args.Valid())
+			return false;
+
+		system->GetDeviceToAbsoluteTrackingPose(origin, predictedSeconds, poses, count);
+		out.Output(poses, count);
+		return true;
+	};
+
+	handlers[prefix + "GetSeatedZeroPoseToStandingAbsoluteTrackingPose"] = NoArgs(system, &IVRSystem::GetSeatedZeroPoseToStandingAbsoluteTrackingPose);
+	handlers[prefix + "GetRawZeroPoseToStandingAbsoluteTrackingPose"] = NoArgs(system, &IVRSystem::GetRawZeroPoseToStandingAbsoluteTrackingPose);
+
+	handlers[prefix + "GetSortedTrackedDeviceIndicesOfClass"] = [system](Args& args, Replayed& out) {
+		auto deviceClass = args.Value<vr::ETrackedDeviceClass>(0);
+		uint32_t count = args.Count(2);
+		auto relativeTo = args.Value<vr::TrackedDeviceIndex_t>(3);
+		std::vector<vr::TrackedDeviceIndex_t> storage(count);
+		vr::TrackedDeviceIndex_t* indices = args.Output(1, storage.data());
+		if (!args.Valid())
+			return false;
+
+		out.Return(system->GetSortedTrackedDeviceIndicesOfClass(deviceClass, indices, count, relativeTo));
+		out.Output(indices, count);
+		return true;
+	};
+
+	handlers[prefix + "GetTrackedDeviceActivityLevel"] = DeviceQuery(system, &IVRSystem::GetTrackedDeviceActivityLevel);
+	handlers[prefix + "GetControllerRoleForTrackedDeviceIndex"] = DeviceQuery(system, &IVRSystem::GetControllerRoleForTrackedDeviceIndex);
+	handlers[prefix + "GetTrackedDeviceClass"] = DeviceQuery(system, &IVRSystem::GetTrackedDeviceClass);
+	handlers[prefix + "IsTrackedDeviceConnected"] = DeviceQuery(system, &IVRSystem::IsTrackedDeviceConnected);
+
+	handlers[prefix + "GetTrackedDeviceIndexForControllerRole"] = [system](Args& args, Replayed& out) {
+		auto role = args.Value<vr::ETrackedControllerRole>(0);
+		if (!args.Valid())
+			return false;
+
+		out.Return(system->GetTrackedDeviceIndexForControllerRole(role));
+		return true;
+	};
+
+	handlers[prefix + "GetBoolTrackedDeviceProperty"] = PropertyQuery(system, &IVRSystem::GetBoolTrackedDeviceProperty);
+	handlers[prefix + "GetFloatTrackedDeviceProperty"] = PropertyQuery(system, &IVRSystem::GetFloatTrackedDeviceProperty);
+	handlers[prefix + "GetInt32TrackedDeviceProperty"] = PropertyQuery(system, &IVRSystem::GetInt32TrackedDeviceProperty);
+	handlers[prefix + "GetUint64TrackedDeviceProperty"] = PropertyQuery(system, &IVRSystem::GetUint64TrackedDeviceProperty);
+	handlers[prefix + "GetMatrix34TrackedDeviceProperty"] = PropertyQuery(system, &IVRSystem::GetMatrix34TrackedDeviceProperty);
+
+	// The string itself isn't captured (see CallCapture::Out), only the error and the return value
+	handlers[prefix + "GetStringTrackedDeviceProperty"] = [system](Args& args, Replayed& out) {
+		auto device = args.Value<vr::TrackedDeviceIndex_t>(0);
+		auto prop = args.Value<vr::ETrackedDeviceProperty>(1);
+		uint32_t size = args.Count(3);
+		std::vector<char> storage(size);
+		char* value = args.Output(2, storage.data());
+		vr::ETrackedPropertyError errorStorage = vr::TrackedProp_Success;
+		vr::ETrackedPropertyError* error = args.Output(4, &errorStorage);
+		if (!args.Valid())
+			return false;
+
+		out.Return(system->GetStringTrackedDeviceProperty(device, prop, value, size, error));
+		out.Output(error);
+		return true;
+	};
+
+	// These pass the size of the struct, so only the return value was captured
+	handlers[prefix + "PollNextEvent"] = [system](Args& args, Replayed& out) {
+		vr::VREvent_t storage = {};
+		vr::VREvent_t* event = args.Output(0, &storage);
+		uint32_t size = args.Value<uint32_t>(1);
+		if (!args.Valid() || size > sizeof(storage))
+			return false;
+
+		out.Return(system->PollNextEvent(event, size));
+		return true;
+	};
+
+	handlers[prefix + "GetControllerState"] = [system](Args& args, Replayed& out) {
+		auto device = args.Value<vr::TrackedDeviceIndex_t>(0);
+		vr::VRControllerState_t storage = {};
+		vr::VRControllerState_t* state = args.Output(1, &storage);
+		uint32_t size = args.Value<uint32_t>(2);
+		if (!args.Valid() || size > sizeof(storage))
+			return false;
+
+		out.Return(system->GetControllerState(device, state, size));
+		return true;
+	};
+
+	handlers[prefix + "IsDisplayOnDesktop"] = NoArgs(system, &IVRSystem::IsDisplayOnDesktop);
+	handlers[prefix + "IsInputAvailable"] = NoArgs(system, &IVRSystem::IsInputAvailable);
+	handlers[prefix + "IsSteamVRDrawingControllers"] = NoArgs(system, &IVRSystem::IsSteamVRDrawingControllers);
+	handlers[prefix + "ShouldApplicationPause"] = NoArgs(system, &IVRSystem::ShouldApplicationPause);
+	handlers[prefix + "ShouldApplicationReduceRenderingWork"] = NoArgs(system, &IVRSystem::ShouldApplicationReduceRenderingWork);
+}
+
+static void RegisterCompositorHandlers(Handlers& handlers, HeadlessHarness& harness, IVRCompositor* compositor)
+{
+	const std::string prefix = "CVRCompositor_028::";
+
+	handlers[prefix + "SetTrackingSpace"] = [compositor](Args& args, Replayed& out) {
+		auto origin = args.Value<vr::ETrackingUniverseOrigin>(0);
+		if (!args.Valid())
+			return false;
+
+		compositor->SetTrackingSpace(origin);
+		return true;
+	};
+	handlers[prefix + "GetTrackingSpace"] = NoArgs(compositor, &IVRCompositor::GetTrackingSpace);
+
+	handlers[prefix + "WaitGetPoses"] = PoseArrays(compositor, &IVRCompositor::WaitGetPoses);
+	handlers[prefix + "GetLastPoses"] = PoseArrays(compositor, &IVRCompositor::GetLastPoses);
+
+	handlers[prefix + "GetLastPoseForTrackedDeviceIndex"] = [compositor](Args& args, Replayed& out) {
+		auto device = args.Value<vr::TrackedDeviceIndex_t>(0);
+		vr::TrackedDevicePose_t renderStorage = {}, gameStorage = {};
+		vr::TrackedDevicePose_t* render = args.Output(1, &renderStorage);
+		vr::TrackedDevicePose_t* game = args.Output(2, &gameStorage);
+		if (!args.Valid())
+			return false;
+
+		out.Return(compositor->GetLastPoseForTrackedDeviceIndex(device, render, game));
+		out.Output(render);
+		out.Output(game);
+		return true;
+	};
+
+	handlers[prefix + "Submit"] = [&harness, compositor](Args& args, Replayed& out) {
+		std::vector<vr::Texture_t> textures;
+		std::vector<vr::VRTextureBounds_t> bounds;
+		auto eye = args.Value<vr::EVREye>(0);
+		const vr::Texture_t* texture = args.Pointer(1, textures);
+		const vr::VRTextureBounds_t* textureBounds = args.Pointer(2, bounds);
+		auto flags = args.Value<vr::EVRSubmitFlags>(3);
+		if (!args.Valid())
+			return false;
+
+		// Whatever graphics API the game used, submit the placeholder instead. It's a plain Texture_t, so drop the
+		// flags saying the game passed one of the larger structs.
+		if (texture && texture->handle) {
+			texture = harness.EyeTexture();
+			flags = (vr::EVRSubmitFlags)(flags & ~(vr::Submit_TextureWithPose | vr::Submit_TextureWithDepth | vr::Submit_GlRenderBuffer));
+		}
+
+		out.Return(compositor->Submit(eye, texture, textureBounds, flags));
+		return true;
+	};
+
+	handlers[prefix + "PostPresentHandoff"] = NoArgs(compositor, &IVRCompositor::PostPresentHandoff);
+	handlers[prefix + "ClearLastSubmittedFrame"] = NoArgs(compositor, &IVRCompositor::ClearLastSubmittedFrame);
+
+	// Compositor_FrameTiming records its own size, so only the return value was captured
+	handlers[prefix + "GetFrameTiming"] = [compositor](Args& args, Replayed& out) {
+		vr::Compositor_FrameTiming storage = {};
+		storage.m_nSize = sizeof(storage);
+		vr::Compositor_FrameTiming* timing = args.Output(0, &storage);
+		auto framesAgo = args.Value<uint32_t>(1);
+		if (!args.Valid())
+			return false;
+
+		out.Return(compositor->GetFrameTiming(timing, framesAgo));
+		return true;
+	};
+
+	handlers[prefix + "CanRenderScene"] = NoArgs(compositor, &IVRCompositor::CanRenderScene);
+	handlers[prefix + "IsFullscreen"] = NoArgs(compositor, &IVRCompositor::IsFullscreen);
+	handlers[prefix + "ShouldAppRenderWithLowResources"] = NoArgs(compositor, &IVRCompositor::ShouldAppRenderWithLowResources);
+	handlers[prefix + "IsMotionSmoothingEnabled"] = NoArgs(compositor, &IVRCompositor::IsMotionSmoothingEnabled);
+	handlers[prefix + "IsMotionSmoothingSupported"] = NoArgs(compositor, &IVRCompositor::IsMotionSmoothingSupported);
+}
+
+// ---------------  Reporting   --------------- //
+
+struct MethodStats {
+	uint64_t replayed = 0;
+	uint64_t skipped = 0;
+	uint64_t diverged = 0;
+	int64_t firstDivergence = -1; // Index of the method's first diverging call
+
+	// Only counted for replayed calls, so the two are comparable
+	uint64_t capturedNs = 0;
+	uint64_t replayedNs = 0;
+};
+
+static double MeanMicroseconds(uint64_t totalNs, uint64_t count)
+{
+	return count ? (double)totalNs / (double)count / 1000.0 : 0;
+}
+
+static void PrintReport(FILE* file, const std::map<std::string, MethodStats>& stats)
+{
+	uint64_t replayed = 0, skipped = 0, diverged = 0;
+
+	fprintf(file, "%-60s %9s %9s %9s %11s %11s %8s\n", "method", "replayed", "skipped", "diverged", "capture us", "replay us", "change");
+	for (const auto& [method, methodStats] : stats) {
+		replayed += methodStats.replayed;
+		skipped += methodStats.skipped;
+		diverged += methodStats.diverged;
+
+		if (!methodStats.replayed) {
+			fprintf(file, "%-60s %9s %9llu\n", method.c_str(), "-", (unsigned long long)methodStats.skipped);
+			continue;
+		}
+
+		double captured = MeanMicroseconds(methodStats.capturedNs, methodStats.replayed);
+		double replayedUs = MeanMicroseconds(methodStats.replayedNs, methodStats.replayed);
+		fprintf(file, "%-60s %9llu %9llu %9llu %11.2f %11.2f %+7.0f%%\n", method.c_str(), (unsigned long long)methodStats.replayed,
+		    (unsigned long long)methodStats.skipped, (unsigned long long)methodStats.diverged, captured, replayedUs,
+		    captured > 0 ? (replayedUs - captured) / captured * 100 : 0);
+
+		if (methodStats.firstDivergence >= 0)
+			fprintf(file, "    first divergence at call %lld\n", (long long)methodStats.firstDivergence);
+	}
+
+	fprintf(file, "\n%llu calls replayed, %llu skipped, %llu returned different results\n", (unsigned long long)replayed,
+	    (unsigned long long)skipped, (unsigned long long)diverged);
+}
+
+static void WriteJson(FILE* file, const std::map<std::string, MethodStats>& stats)
+{
+	fprintf(file, "{\n  \"methods\": [\n");
+	size_t i = 0;
+	for (const auto& [method, methodStats] : stats) {
+		fprintf(file, "    { \"name\": \"%s\", \"replayed\": %llu, \"skipped\": %llu, \"diverged\": %llu, ", method.c_str(),
+		    (unsigned long long)methodStats.replayed, (unsigned long long)methodStats.skipped, (unsigned long long)methodStats.diverged);
+
+		// Null if none of the calls were replayed, so there's nothing to compare
+		if (methodStats.replayed) {
+			fprintf(file, "\"captured_ns_per_call\": %.1f, \"replayed_ns_per_call\": %.1f }",
+			    MeanMicroseconds(methodStats.capturedNs, methodStats.replayed) * 1000.0,
+			    MeanMicroseconds(methodStats.replayedNs, methodStats.replayed) * 1000.0);
+		} else {
+			fprintf(file, "\"captured_ns_per_call\": null, \"replayed_ns_per_call\": null }");
+		}
+
+		fprintf(file, "%s\n", ++i < stats.size() ? "," : "");
+	}
+	fprintf(file, "  ]\n}\n");
+}
+
+// ---------------  Main   --------------- //
+
+static void PrintUsage()
+{
+	fprintf(stderr, "Usage: OCReplay <capture> [--script FILE] [--json FILE]\n");
+}
+
+static bool ReadTextFile(const std::string& filename, std::string& contents)
+{
+	FILE* file = fopen(filename.c_str(), "rb");
+	if (!file)
+		return false;
+
+	char chunk[4096];
+	size_t length;
+	while ((length = fread(chunk, 1, sizeof(chunk), file)) > 0)
+		contents.append(chunk, length);
+	fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	std::string captureFilename;
+	std::string scriptFilename;
+	std::string jsonFilename;
+
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg.rfind("--", 0) != 0) {
+			if (!captureFilename.empty()) {
+				PrintUsage();
+				return 2;
+			}
+			captureFilename = arg;
+			continue;
+		}
+
+		if (i + 1 >= argc) {
+			PrintUsage();
+			return 2;
+		}
+
+		if (arg == "--script") {
+			scriptFilename = argv[++i];
+		} else if (arg == "--json") {
+			jsonFilename = argv[++i];
+		} else {
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	if (captureFilename.empty()) {
+		PrintUsage();
+		return 2;
+	}
+
+	Capture capture;
+	if (!ReadCapture(captureFilename, capture))
+		return 2;
+
+	std::string script;
+	if (!scriptFilename.empty() && !ReadTextFile(scriptFilename, script)) {
+		fprintf(stderr, "Could not read %s\n", scriptFilename.c_str());
+		return 2;
+	}
+
+	HeadlessHarness harness(script);
+
+	Handlers handlers;
+	RegisterSystemHandlers(handlers, harness.Get<IVRSystem>("IVRSystem_022"));
+	RegisterCompositorHandlers(handlers, harness, harness.Get<IVRCompositor>("IVRCompositor_028"));
+
+	// Look the handlers up once per method rather than once per call
+	std::vector<const Handler*> methodHandlers(capture.methods.size());
+	for (size_t i = 0; i < capture.methods.size(); i++) {
+		auto iter = handlers.find(capture.methods[i]);
+		if (iter != handlers.end())
+			methodHandlers[i] = &iter->second;
+	}
+
+	std::map<std::string, MethodStats> stats;
+	std::vector<uint64_t> callIndices(capture.methods.size());
+
+	for (const CapturedCall& call : capture.calls) {
+		MethodStats& methodStats = stats[capture.methods[call.method]];
+		uint64_t index = callIndices[call.method]++;
+
+		const Handler* handler = methodHandlers[call.method];
+		if (!handler) {
+			methodStats.skipped++;
+			continue;
+		}
+
+		Args args(call);
+		Replayed replayed;
+		auto start = std::chrono::steady_clock::now();
+		bool success = (*handler)(args, replayed);
+		auto end = std::chrono::steady_clock::now();
+
+		if (!success) {
+			methodStats.skipped++;
+			continue;
+		}
+
+		methodStats.replayed++;
+		methodStats.capturedNs += call.durationNs;
+		methodStats.replayedNs += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+		if (!replayed.Matches(call)) {
+			methodStats.diverged++;
+			if (methodStats.firstDivergence < 0)
+				methodStats.firstDivergence = (int64_t)index;
+		}
+	}
+
+	PrintReport(stdout, stats);
+
+	if (!jsonFilename.empty()) {
+		FILE* file = fopen(jsonFilename.c_str(), "w");
+		OC_TEST_CHECKF(file, "Could not open %s", jsonFilename.c_str());
+		WriteJson(file, stats);
+		fclose(file);
+	}
+
+	for (const auto& [method, methodStats] : stats) {
+		if (methodStats.diverged)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,359 @@
+//
+// Checks the skeleton blending and model-space conversion in Misc/Input/HandSkeleton.cpp give the same results as
+// the straightforward scalar version they replaced, which is kept here as the reference. Every combination of
+// controller state is run on the Touch and Index reference poses, for both hands and both closed poses.
+//
+// Run with --benchmark to time the full curl-to-skeleton path (weights, blend and model-space conversion) against the
+// scalar reference instead.
+//
+
+#include "Misc/Input/HandSkeleton.h"
+#include "Misc/Input/IndexHandPoses.h"
+#include "Misc/Input/OculusHandPoses.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+using vr::HmdQuaternionf_t;
+using vr::HmdVector4_t;
+using vr::VRBoneTransform_t;
+
+#define OC_SKELETON_CHECKF(expression, ...)                 \
+	do {                                                    \
+		if (!(expression)) {                                \
+			fprintf(stderr, "%s:%d: ", __FILE__, __LINE__); \
+			fprintf(stderr, __VA_ARGS__);                   \
+			fprintf(stderr, "\n");                          \
+			exit(1);                                        \
+		}                                                   \
+	} while (false)
+
+// Positions are in metres, and the quaternions are unit length
+static const float positionTolerance = 1e-5f;
+static const float rotationTolerance = 1e-4f;
+
+// ---------------  Scalar reference   --------------- //
+
+namespace reference {
+
+// https://github.com/ValveSoftware/openvr/blob/master/samples/drivers/utils/vrmath/vrmath.h
+static HmdQuaternionf_t operator*(const HmdQuaternionf_t& lhs, const HmdQuaternionf_t& rhs)
+{
+	return {
+		lhs.w * rhs.w - lhs.x * rhs.x - lhs.y * rhs.y - lhs.z * rhs.z,
+		lhs.w * rhs.x + lhs.x * rhs.w + lhs.y * rhs.z - lhs.z * rhs.y,
+		lhs.w * rhs.y - lhs.x * rhs.z + lhs.y * rhs.w + lhs.z * rhs.x,
+		lhs.w * rhs.z + lhs.x * rhs.y - lhs.y * rhs.x + lhs.z * rhs.w,
+	};
+}
+
+static HmdVector4_t operator+(const HmdVector4_t& a, const HmdVector4_t& b)
+{
+	return {
+		a.v[0] + b.v[0],
+		a.v[1] + b.v[1],
+		a.v[2] + b.v[2],
+		a.v[3] + 1.f // SteamVR seems to accumulate this? Might not be needed
+	};
+}
+
+static HmdQuaternionf_t operator-(const HmdQuaternionf_t& q)
+{
+	return { q.w, -q.x, -q.y, -q.z };
+}
+
+static HmdVector4_t operator*(const HmdVector4_t& vec, const HmdQuaternionf_t& q)
+{
+	const HmdQuaternionf_t qvec = { 0.0, vec.v[0], vec.v[1], vec.v[2] };
+
+	const HmdQuaternionf_t qResult = (q * qvec) * (-q);
+
+	return { qResult.x, qResult.y, qResult.z, vec.v[3] };
+}
+
+static VRBoneTransform_t operator*(const VRBoneTransform_t& a, const VRBoneTransform_t& b)
+{
+	return {
+		a.position + (b.position * a.orientation),
+		a.orientation * b.orientation,
+	};
+}
+
+// converts a range of finger bones to model space.
+static void ConvertJointRange(HandSkeletonBone start, HandSkeletonBone end, VRBoneTransform_t* joints)
+{
+	HandSkeletonBone parentId = eBone_Wrist;
+
+	for (int i = start; i <= end; i++) {
+		joints[i] = joints[parentId] * joints[i];
+		parentId = (HandSkeletonBone)i;
+	}
+}
+
+static void ParentSpaceSkeletonToModelSpace(VRBoneTransform_t* joints)
+{
+	ConvertJointRange(eBone_Thumb0, eBone_Thumb3, joints);
+	ConvertJointRange(eBone_IndexFinger0, eBone_IndexFinger4, joints);
+	ConvertJointRange(eBone_MiddleFinger0, eBone_MiddleFinger4, joints);
+	ConvertJointRange(eBone_RingFinger0, eBone_RingFinger4, joints);
+	ConvertJointRange(eBone_PinkyFinger0, eBone_PinkyFinger4, joints);
+}
+
+static void InterpolateBone(VRBoneTransform_t& bone, const VRBoneTransform_t& targetBone, float pct)
+{
+	glm::vec3 startPos(bone.position.v[0], bone.position.v[1], bone.position.v[2]);
+	glm::quat startRot(bone.orientation.w, bone.orientation.x, bone.orientation.y, bone.orientation.z);
+
+	glm::vec3 targetPos(targetBone.position.v[0], targetBone.position.v[1], targetBone.position.v[2]);
+	glm::quat targetRot(targetBone.orientation.w, targetBone.orientation.x, targetBone.orientation.y, targetBone.orientation.z);
+
+	glm::vec3 resPos = glm::mix(startPos, targetPos, pct);
+	glm::quat resRot = glm::mix(startRot, targetRot, pct);
+
+	bone.position = { resPos.x, resPos.y, resPos.z, 1.f };
+	bone.orientation = { resRot.w, resRot.x, resRot.y, resRot.z };
+}
+
+struct ControllerState {
+	float thumbTouchPct;
+	float triggerTouchPct;
+	float triggerPct;
+	float gripPct;
+};
+
+// Blend each bone one step at a time, as getEstimatedBoneData used to
+static VRBoneTransform_t BlendBone(const ControllerState& state, const BoneArray& openPose, const BoneArray& closedPose, int bone_index)
+{
+	VRBoneTransform_t bone = openPose[bone_index];
+
+	// Put the thumb down on touch
+	if (state.thumbTouchPct != 0.0f) {
+		if ((bone_index >= eBone_Thumb0 && bone_index <= eBone_Thumb3) || bone_index == eBone_Aux_Thumb)
+			InterpolateBone(bone, closedPose[bone_index], state.thumbTouchPct);
+	}
+
+	// Curl fingers on trigger touch
+	if (state.triggerTouchPct != 0.0f || state.triggerPct != 0.0f) {
+		if ((bone_index >= eBone_IndexFinger0 && bone_index <= eBone_IndexFinger4) || bone_index == eBone_Aux_IndexFinger)
+			InterpolateBone(bone, closedPose[bone_index], 0.4f * state.triggerTouchPct);
+		else if ((bone_index >= eBone_MiddleFinger0 && bone_index <= eBone_MiddleFinger4) || bone_index == eBone_Aux_MiddleFinger)
+			InterpolateBone(bone, closedPose[bone_index], 0.2f * state.triggerTouchPct);
+		else if ((bone_index >= eBone_RingFinger0 && bone_index <= eBone_RingFinger4) || bone_index == eBone_Aux_RingFinger)
+			InterpolateBone(bone, closedPose[bone_index], 0.1f * state.triggerTouchPct);
+	}
+
+	// Bend the index finger on trigger
+	if (state.triggerPct != 0.0f) {
+		if ((bone_index >= eBone_IndexFinger0 && bone_index <= eBone_IndexFinger4) || bone_index == eBone_Aux_IndexFinger)
+			InterpolateBone(bone, closedPose[bone_index], state.triggerPct);
+	}
+
+	// Bend the 3 remaining fingers on grip
+	if (state.gripPct != 0.0f) {
+		if ((bone_index >= eBone_MiddleFinger0 && bone_index <= eBone_PinkyFinger4) || (bone_index >= eBone_Aux_MiddleFinger && bone_index <= eBone_Aux_PinkyFinger))
+			InterpolateBone(bone, closedPose[bone_index], state.gripPct);
+	}
+
+	return bone;
+}
+
+} // namespace reference
+
+// ---------------  Comparison   --------------- //
+
+static int comparisons = 0;
+
+static void CheckClose(float actual, float expected, float tolerance, const char* what, const char* testCase, int bone, const char* component)
+{
+	OC_SKELETON_CHECKF(fabsf(actual - expected) <= tolerance, "%s: bone %d %s %s is %f, expected %f", testCase, bone, what,
+	    component, actual, expected);
+	comparisons++;
+}
+
+static void CompareSkeletons(const VRBoneTransform_t* actual, const VRBoneTransform_t* expected, const float* weights, const char* testCase)
+{
+	static const char* axes[] = { "x", "y", "z" };
+
+	for (int bone = 0; bone < eBone_Count; bone++) {
+		const VRBoneTransform_t& a = actual[bone];
+		const VRBoneTransform_t& e = expected[bone];
+
+		for (int i = 0; i < 3; i++)
+			CheckClose(a.position.v[i], e.position.v[i], positionTolerance, "position", testCase, bone, axes[i]);
+
+		CheckClose(a.orientation.w, e.orientation.w, rotationTolerance, "orientation", testCase, bone, "w");
+		CheckClose(a.orientation.x, e.orientation.x, rotationTolerance, "orientation", testCase, bone, "x");
+		CheckClose(a.orientation.y, e.orientation.y, rotationTolerance, "orientation", testCase, bone, "y");
+		CheckClose(a.orientation.z, e.orientation.z, rotationTolerance, "orientation", testCase, bone, "z");
+
+		// The scalar version set the position's w to 1 on every bone it blended, including blends by zero, while the
+		// new one leaves bones with a zero weight alone. That's only allowed to differ on bones which haven't moved.
+		if (a.position.v[3] != e.position.v[3]) {
+			OC_SKELETON_CHECKF(weights && weights[bone] == 0.0f, "%s: bone %d position w is %f, expected %f", testCase, bone,
+			    a.position.v[3], e.position.v[3]);
+		}
+	}
+}
+
+static void TestModelSpace(const BoneArray& pose, const char* name)
+{
+	BoneArray expected = pose;
+	reference::ParentSpaceSkeletonToModelSpace(expected.data());
+
+	BoneSoA bones;
+	bones.Load(pose.data());
+	BonesToModelSpace(bones);
+
+	BoneArray actual;
+	bones.Store(actual.data());
+
+	char testCase[256];
+	snprintf(testCase, sizeof(testCase), "model space %s", name);
+	CompareSkeletons(actual.data(), expected.data(), nullptr, testCase);
+}
+
+static void TestBlend(const BoneArray& open, const BoneArray& closed, const reference::ControllerState& state, const char* name)
+{
+	BoneArray expected;
+	for (int bone = 0; bone < eBone_Count; bone++)
+		expected[bone] = reference::BlendBone(state, open, closed, bone);
+
+	float weights[eBone_Count];
+	GetEstimatedBoneWeights(state.thumbTouchPct, state.triggerTouchPct, state.triggerPct, state.gripPct, weights);
+
+	BoneSoA openBones, closedBones, bones;
+	openBones.Load(open.data());
+	closedBones.Load(closed.data());
+	BlendBones(bones, openBones, closedBones, weights);
+
+	BoneArray actual;
+	bones.Store(actual.data());
+
+	char testCase[256];
+	snprintf(testCase, sizeof(testCase), "%s thumb=%.2f triggerTouch=%.2f trigger=%.2f grip=%.2f", name,
+	    state.thumbTouchPct, state.triggerTouchPct, state.triggerPct, state.gripPct);
+	CompareSkeletons(actual.data(), expected.data(), weights, testCase);
+
+	// And then in model space, as GetSkeletalBoneData does
+	reference::ParentSpaceSkeletonToModelSpace(expected.data());
+	BonesToModelSpace(bones);
+	bones.Store(actual.data());
+
+	strncat(testCase, " (model space)", sizeof(testCase) - strlen(testCase) - 1);
+	CompareSkeletons(actual.data(), expected.data(), weights, testCase);
+}
+
+struct HandPoses {
+	const char* name;
+	const BoneArray* open;
+	const BoneArray* fist;
+	const BoneArray* gripLimit;
+	const BoneArray* bind;
+};
+
+// ---------------  Benchmark   --------------- //
+
+// Volatile sink so the optimiser can't drop the skeletons we never read
+static volatile float benchmarkSink;
+
+template <typename F>
+static double TimeSkeletons(int iterations, F&& buildSkeleton)
+{
+	BoneArray skeleton;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		// Sweep the curl values so neither version can skip work it'd skip for a fixed state
+		float pct = (float)(i % 64) / 63.0f;
+		reference::ControllerState state = { pct, pct, 1.0f - pct, pct * pct };
+		buildSkeleton(state, skeleton);
+		benchmarkSink = skeleton[eBone_PinkyFinger4].position.v[0];
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Times the whole path from controller state to a model-space skeleton, as GetSkeletalBoneData runs it
+static void RunBenchmark(int iterations)
+{
+	const BoneArray& open = oculus::leftOpenHandPose;
+	const BoneArray& closed = oculus::leftFistPose;
+
+	double scalar = TimeSkeletons(iterations, [&](const reference::ControllerState& state, BoneArray& skeleton) {
+		for (int bone = 0; bone < eBone_Count; bone++)
+			skeleton[bone] = reference::BlendBone(state, open, closed, bone);
+		reference::ParentSpaceSkeletonToModelSpace(skeleton.data());
+	});
+
+	double soa = TimeSkeletons(iterations, [&](const reference::ControllerState& state, BoneArray& skeleton) {
+		float weights[eBone_Count];
+		GetEstimatedBoneWeights(state.thumbTouchPct, state.triggerTouchPct, state.triggerPct, state.gripPct, weights);
+
+		BoneSoA openBones, closedBones, bones;
+		openBones.Load(open.data());
+		closedBones.Load(closed.data());
+		BlendBones(bones, openBones, closedBones, weights);
+		BonesToModelSpace(bones);
+		bones.Store(skeleton.data());
+	});
+
+	printf("%d skeletons: scalar %.1f ns, structure-of-arrays %.1f ns (%.2fx)\n", iterations, scalar, soa, scalar / soa);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+		RunBenchmark(argc > 2 ? atoi(argv[2]) : 1000000);
+		return 0;
+	}
+
+	const HandPoses hands[] = {
+		{ "touch left", &oculus::leftOpenHandPose, &oculus::leftFistPose, &oculus::leftGripLimitPose, &oculus::leftBindPose },
+		{ "touch right", &oculus::rightOpenHandPose, &oculus::rightFistPose, &oculus::rightGripLimitPose, &oculus::rightBindPose },
+		{ "index left", &knuckles::leftOpenHandPose, &knuckles::leftFistPose, &knuckles::leftGripLimitPose, &knuckles::leftBindPose },
+		{ "index right", &knuckles::rightOpenHandPose, &knuckles::rightFistPose, &knuckles::rightGripLimitPose, &knuckles::rightBindPose },
+	};
+
+	// Include the ends of the range, since zero skips blends entirely and one is exactly the closed pose
+	const float values[] = { 0.0f, 0.1f, 0.5f, 0.9f, 1.0f };
+
+	int blends = 0;
+	for (const HandPoses& hand : hands) {
+		char name[128];
+
+		const std::pair<const char*, const BoneArray*> poses[] = {
+			{ "open", hand.open },
+			{ "fist", hand.fist },
+			{ "grip limit", hand.gripLimit },
+			{ "bind", hand.bind },
+		};
+		for (const auto& [poseName, pose] : poses) {
+			snprintf(name, sizeof(name), "%s %s", hand.name, poseName);
+			TestModelSpace(*pose, name);
+		}
+
+		for (const BoneArray* closed : { hand.fist, hand.gripLimit }) {
+			snprintf(name, sizeof(name), "%s to %s", hand.name, closed == hand.fist ? "fist" : "grip limit");
+
+			for (float thumbTouch : values) {
+				for (float triggerTouch : values) {
+					for (float trigger : values) {
+						for (float grip : values) {
+							TestBlend(*hand.open, *closed, { thumbTouch, triggerTouch, trigger, grip }, name);
+							blends++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	printf("Passed: %d blended skeletons, %d values compared\n", blends, comparisons);
+	return 0;
+}
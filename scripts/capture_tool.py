@@ -0,0 +1,221 @@
+#!/usr/bin/env python3
+
+# Tool for reading OpenVR call captures
+#
+# When the captureOpenVRCalls config option is enabled, OpenComposite records every OpenVR call the game
+# makes into opencomposite_capture.occap, next to the log. This script can summarise a capture, dump the
+# calls in it, or compare two captures of the same sequence of calls - for example the same game
+# running against the headless runtime before and after a change, to find calls whose results or cost changed.
+#
+# To re-run a capture's calls through OpenComposite rather than compare two captures, see OCReplay (Tests/Replay.cpp),
+# which replays the calls it supports against the headless runtime.
+#
+# Usage:
+#   capture_tool.py summary <capture>
+#   capture_tool.py dump <capture> [method name filter]
+#   capture_tool.py compare <before> <after>
+#
+# The file starts with the eight-byte magic 'OCCAPT\0\1', followed by records. All numbers are little-endian.
+# Each record starts with a one-byte type:
+#
+#   1 (method): u16 method ID, u16 name length, name
+#     Defines the name of a method ID, before that ID's first call.
+#   2 (call):   u16 method ID, u64 start time (ns since the capture started), u32 duration (ns),
+#               u32 payload length, payload
+#
+# The payload is a series of items, each of which is a u8 tag, a u32 length and that many bytes of data.
+# See CallCapture::Tag for the tags. The arguments are recorded in order, then any outputs, then the return value.
+
+import struct
+import sys
+from collections import defaultdict
+from dataclasses import dataclass, field
+from typing import Dict, List, Tuple
+
+MAGIC = b"OCCAPT\0\1"
+
+TAG_NULL = 0
+TAG_OPAQUE = 1
+TAG_VALUE = 2
+TAG_STRING = 3
+TAG_OUTPUT = 4
+TAG_RETURN = 5
+TAG_RETURN_STRING = 6
+
+
+@dataclass
+class Call:
+    method: str
+    start_ns: int
+    duration_ns: int
+    items: List[Tuple[int, bytes]] = field(default_factory=list)
+
+    def args(self):
+        return [i for i in self.items if i[0] not in (TAG_OUTPUT, TAG_RETURN, TAG_RETURN_STRING)]
+
+    def outputs(self):
+        return [i[1] for i in self.items if i[0] == TAG_OUTPUT]
+
+    def result(self):
+        for tag, data in self.items:
+            if tag in (TAG_RETURN, TAG_RETURN_STRING):
+                return data
+        return None
+
+
+def read_capture(filename) -> List[Call]:
+    with open(filename, "rb") as fi:
+        data = fi.read()
+
+    if data[:len(MAGIC)] != MAGIC:
+        raise RuntimeError(f"{filename} is not an OpenComposite capture")
+
+    methods: Dict[int, str] = {}
+    calls = []
+    pos = len(MAGIC)
+
+    # The writer may have been stopped part-way through a record if the game crashed
+    try:
+        while pos < len(data):
+            record_type = data[pos]
+            pos += 1
+
+            if record_type == 1:
+                method_id, length = struct.unpack_from("<HH", data, pos)
+                pos += 4
+                methods[method_id] = data[pos:pos + length].decode()
+                pos += length
+            elif record_type == 2:
+                method_id, start_ns, duration_ns, payload_len = struct.unpack_from("<HQII", data, pos)
+                pos += 18
+                call = Call(methods[method_id], start_ns, duration_ns)
+                end = pos + payload_len
+                while pos < end:
+                    tag, length = struct.unpack_from("<BI", data, pos)
+                    pos += 5
+                    call.items.append((tag, data[pos:pos + length]))
+                    pos += length
+                calls.append(call)
+            else:
+                raise RuntimeError(f"Unknown record type {record_type} at offset {pos - 1}")
+    except struct.error:
+        print(f"Warning: {filename} is truncated", file=sys.stderr)
+
+    return calls
+
+
+def format_item(tag, data: bytes):
+    if tag == TAG_NULL:
+        return "null"
+    if tag == TAG_OPAQUE:
+        return "<...>"
+    if tag in (TAG_STRING, TAG_RETURN_STRING):
+        return repr(data.decode(errors="replace"))
+
+    # Show small values as numbers, since most arguments are integers, enums or floats
+    if len(data) == 4:
+        (i,) = struct.unpack("<i", data)
+        (f,) = struct.unpack("<f", data)
+        return f"{i}" if abs(i) < 0x100000 else f"{f:g}"
+    if len(data) == 8:
+        (i,) = struct.unpack("<q", data)
+        return f"{i:#x}"
+    if len(data) == 1:
+        return str(data[0])
+    return f"<{len(data)} bytes>"
+
+
+def summarise(calls: List[Call]):
+    by_method = defaultdict(list)
+    for call in calls:
+        by_method[call.method].append(call.duration_ns)
+
+    if calls:
+        length = (calls[-1].start_ns - calls[0].start_ns) / 1e9
+        print(f"{len(calls)} calls to {len(by_method)} methods over {length:.1f}s\n")
+
+    print(f"{'method':<60} {'calls':>9} {'total ms':>10} {'mean us':>9} {'max us':>9}")
+    for method, durations in sorted(by_method.items(), key=lambda i: -sum(i[1])):
+        total = sum(durations)
+        print(f"{method:<60} {len(durations):>9} {total / 1e6:>10.2f} {total / len(durations) / 1e3:>9.2f} "
+              f"{max(durations) / 1e3:>9.2f}")
+
+
+def dump(calls: List[Call], name_filter):
+    for call in calls:
+        if name_filter and name_filter not in call.method:
+            continue
+
+        args = ", ".join(format_item(tag, data) for tag, data in call.args())
+        line = f"{call.start_ns / 1e9:12.6f} {call.method}({args})"
+        result = call.result()
+        if result is not None:
+            tag = TAG_RETURN_STRING if any(t == TAG_RETURN_STRING for t, _ in call.items) else TAG_RETURN
+            line += " = " + format_item(tag, result)
+        print(f"{line}  [{call.duration_ns / 1e3:.1f}us]")
+
+
+def compare(before: List[Call], after: List[Call]):
+    """
+    Compare the n-th call to each method in one capture to the n-th call to it in the other. Matching calls
+    by method rather than by position means a few extra or missing calls don't misalign everything after them.
+    """
+
+    def group(calls):
+        grouped = defaultdict(list)
+        for call in calls:
+            grouped[call.method].append(call)
+        return grouped
+
+    before_calls = group(before)
+    after_calls = group(after)
+
+    divergences = 0
+    print(f"{'method':<60} {'calls':>13} {'mean us':>17} {'change':>8} {'diverged':>8}")
+    for method in sorted(set(before_calls) | set(after_calls)):
+        a = before_calls.get(method, [])
+        b = after_calls.get(method, [])
+
+        diverged = 0
+        first = None
+        for index, (x, y) in enumerate(zip(a, b)):
+            # Only compare calls made with the same arguments, otherwise the results are expected to differ
+            if x.args() != y.args():
+                continue
+            if x.result() != y.result() or x.outputs() != y.outputs():
+                diverged += 1
+                if first is None:
+                    first = index
+        divergences += diverged
+
+        mean_a = sum(c.duration_ns for c in a) / len(a) / 1e3 if a else 0
+        mean_b = sum(c.duration_ns for c in b) / len(b) / 1e3 if b else 0
+        change = f"{(mean_b - mean_a) / mean_a * 100:+.0f}%" if mean_a else "-"
+        print(f"{method:<60} {len(a):>6}/{len(b):<6} {mean_a:>8.2f}/{mean_b:<8.2f} {change:>8} {diverged:>8}")
+        if first is not None:
+            print(f"    first divergence at call {first}")
+
+    print(f"\n{divergences} calls returned different results")
+    return divergences
+
+
+def main():
+    if len(sys.argv) < 3:
+        print("Usage: capture_tool.py summary|dump|compare <capture> [...]", file=sys.stderr)
+        sys.exit(2)
+
+    command = sys.argv[1]
+    if command == "summary":
+        summarise(read_capture(sys.argv[2]))
+    elif command == "dump":
+        dump(read_capture(sys.argv[2]), sys.argv[3] if len(sys.argv) > 3 else None)
+    elif command == "compare" and len(sys.argv) == 4:
+        divergences = compare(read_capture(sys.argv[2]), read_capture(sys.argv[3]))
+        sys.exit(1 if divergences else 0)
+    else:
+        print(f"Unknown command '{command}'", file=sys.stderr)
+        sys.exit(2)
+
+
+if __name__ == "__main__":
+    main()
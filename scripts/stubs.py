@@ -91,6 +91,7 @@ with open(output_dir / "stubs.gen.cpp", "w", newline='\n') as impl:
     impl.write('#include "Reimpl/Interfaces.h"\n')
     impl.write(f'#include "{bases_header_fn.name}"\n')
     impl.write('#include "Misc/Config.h"\n')
+    impl.write('#include "Misc/CallCapture.h"\n')
 
     for iface in interfaces:
         codegen.write_stubs(impl, iface)
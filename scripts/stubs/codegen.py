@@ -1,10 +1,17 @@
 import re
 from typing import List
 
+from libparse import arg_t
+
 from stubs.interface import InterfaceDef
 from stubs.interface_spec import InterfaceSpec
 
 cflag_spec = re.compile(r"\[(?P<name>\w+)\]\s*=\s*(?P<value>.*)")
+array_count_spec = re.compile(r"VR_ARRAY_COUNT\(\s*(?P<count>\w+)\s*\)")
+# Only the arguments giving the size of a struct the game passed in, not those giving a string or buffer length
+struct_size_spec = re.compile(r"^uncb|SizeOf|^u?n\w*(Struct|State|Info|View|Header|ActionData)Size$|SizeInBytes$")
+# Structs which store their own size, and so may be shorter than ours
+self_sized_structs = ["Compositor_FrameTiming"]
 
 
 def write_header(filename, iface):
@@ -106,8 +113,9 @@ std::shared_ptr<{cls}> GetCreate{getter_name}() {{
 
             fi.write(f"{f.return_type} {cname}::{f.name}({f.args_str()}) {{\n"
                      "\tif (oovr_global_configuration.LogAllOpenVRCalls())\n"
-                     f"\t\tOOVR_LOG(\"Entered function (from interface {ver.namespace()})\");\n"
-                     f"\t{return_str} base->{f.name}({nargs});\n}}\n")
+                     f"\t\tOOVR_LOG(\"Entered function (from interface {ver.namespace()})\");\n")
+            _build_capture(fi, cname, f, nargs, return_str)
+            fi.write(f"\t{return_str} base->{f.name}({nargs});\n}}\n")
 
         # Generate the fntable
         _build_fntable(fi, ver)
@@ -116,6 +124,50 @@ std::shared_ptr<{cls}> GetCreate{getter_name}() {{
         fi.write(f"void {cname}::Delete() {{ delete this; }}\n")
 
 
+def _build_capture(fi, cname, func, nargs, return_str):
+    """
+    Write the code to record a call with CallCapture, when that's enabled
+    """
+
+    arg_names = [a.name for a in func.args]
+
+    # If the struct pointers are accompanied by their size, the game might be using an older and
+    # smaller version of the struct, so we can't safely copy them.
+    sized = any(struct_size_spec.search(a.name) or any(t in a.type for t in self_sized_structs) for a in func.args)
+
+    def capture_call(method: str, a: arg_t):
+        if sized and a.type.endswith("*") and a.type.replace(" ", "") != "constchar*":
+            return f"InOpaque({a.name})" if method == "In" else None
+
+        match = array_count_spec.search(a.str)
+        if match and match.group("count") in arg_names:
+            return f"{method}({a.name}, (uint32_t){match.group('count')})"
+        return f"{method}({a.name})"
+
+    fi.write("\tif (oovr_global_configuration.CaptureOpenVRCalls()) {\n"
+             f"\t\tCallCapture capture(\"{cname}::{func.name}\");\n")
+    for a in func.args:
+        fi.write(f"\t\tcapture.{capture_call('In', a)};\n")
+
+    if func.return_type == "void":
+        fi.write(f"\t\tbase->{func.name}({nargs});\n")
+    else:
+        fi.write(f"\t\t{func.return_type} result = {return_str[len('return '):]}base->{func.name}({nargs});\n")
+
+    for a in func.args:
+        if not a.type.endswith("*") or a.type.startswith("const "):
+            continue
+        call = capture_call("Out", a)
+        if call:
+            fi.write(f"\t\tcapture.{call};\n")
+
+    if func.return_type == "void":
+        fi.write("\t\treturn;\n")
+    else:
+        fi.write("\t\treturn capture.Return(result);\n")
+    fi.write("\t}\n")
+
+
 def _build_fntable(fi, ver: InterfaceDef):
     cname = ver.proxy_class_name()
     prefix = f"fntable_{ver.varname()}_{ver.version}"